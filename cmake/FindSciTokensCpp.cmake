@@ -28,4 +28,6 @@ IF (SCITOKENS_CPP_INCLUDE_DIR)
   SET( CMAKE_REQUIRED_LIBRARIES ${SCITOKENS_CPP_LIBRARIES} )
   CHECK_SYMBOL_EXISTS(scitoken_config_set_str "scitokens/scitokens.h" HAVE_SCITOKEN_CONFIG_SET_STR)
   MARK_AS_ADVANCED(HAVE_SCITOKEN_CONFIG_SET_STR)
+  CHECK_SYMBOL_EXISTS(scitoken_config_set_int "scitokens/scitokens.h" HAVE_SCITOKEN_CONFIG_SET_INT)
+  MARK_AS_ADVANCED(HAVE_SCITOKEN_CONFIG_SET_INT)
 ENDIF ()
@@ -13,6 +13,7 @@ macro( component_status name flag found )
 endmacro()
 
 set( TRUE_VAR TRUE )
+component_status( BENCHMARKS ENABLE_BENCHMARKS TRUE_VAR )
 component_status( CEPH      ENABLE_CEPH       BUILD_CEPH )
 component_status( FUSE      ENABLE_FUSE       BUILD_FUSE )
 component_status( HTTP      ENABLE_HTTP       BUILD_HTTP )
@@ -132,7 +132,7 @@ XrdBuffer *XrdBuffXL::Obtain(int sz)
 
 // Allocate a chunk of aligned memory
 //
-   if (posix_memalign((void **)&memp, pagsz, buffSz)) return 0;
+   if (!(memp = XrdBuffer::Alloc(buffSz, pagsz))) return 0;
 
 // Wrap the memory with a buffer object
 //
@@ -31,6 +31,9 @@
 #include <unistd.h>
 #include <cstdio>
 #include <cstdlib>
+#include <atomic>
+#include <cstring>
+#include <sys/mman.h>
 #include <sys/types.h>
 
 #include "XrdOuc/XrdOucUtils.hh"
@@ -58,9 +61,14 @@ void *XrdReshaper(void *pp)
 
 const char *XrdBuffManager::TraceID = "BuffManager";
 
+int         XrdBuffer::hugesz = 0;
+
 namespace
 {
 static const int minBuffSz = 1 << XRD_BUSHIFT;
+static const int hugePage  = 2*1024*1024;
+static const int magMax    = 8;   // Maximum buffers per bucket in a magazine
+static const int magSync   = 256; // Operations between statistics updates
 }
 
 namespace XrdGlobal
@@ -71,6 +79,82 @@ extern XrdSysError Log;
 
 using namespace XrdGlobal;
  
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+// Buffers of the bucket pool record the thread that last obtained them so
+// that releases by another thread can be counted. The tag is kept here rather
+// than in XrdBuffer as that class is part of the public interface.
+//
+class XrdBuffTL : public XrdBuffer
+{
+public:
+
+int             owner;                // Id of the thread that last obtained it
+
+                XrdBuffTL(char *bp, int sz, int ix)
+                         : XrdBuffer(bp, sz, ix), owner(0) {}
+};
+
+// A magazine holds the buffers cached by a single thread. Its owner and the
+// reshaper, which drains all magazines before reshaping, serialize on the
+// magazine's own mutex; the owner practically never finds it held.
+//
+class XrdBuffMagazine
+{
+public:
+
+XrdBuffManager  *bMgr;                // Manager owning the cached buffers
+XrdBuffMagazine *prev;                // Registry links (registry mutex)
+XrdBuffMagazine *next;
+XrdSysMutex      magMutex;
+XrdBuffer       *bnext[XRD_BUCKETS];
+int              numbuf[XRD_BUCKETS];
+int              numreq[XRD_BUCKETS]; // Requests satisfied from the magazine
+long long        bytes;               // Bytes held by this magazine
+long long        hits;
+long long        miss;
+long long        xfree;
+int              myID;
+int              numops;
+
+                 XrdBuffMagazine() : bMgr(0), prev(0), next(0), bytes(0),
+                                     hits(0), miss(0), xfree(0), myID(0),
+                                     numops(0)
+                                    {memset(bnext,  0, sizeof(bnext));
+                                     memset(numbuf, 0, sizeof(numbuf));
+                                     memset(numreq, 0, sizeof(numreq));
+                                    }
+
+                ~XrdBuffMagazine() {if (bMgr) bMgr->tlDetach(*this);}
+};
+
+// The thread cache state of a manager, kept out of line so that the layout of
+// XrdBuffManager only grows by a pointer.
+//
+class XrdBuffManagerTL
+{
+public:
+
+long long              tlMax;    // Maximum bytes cached per thread (0 -> off)
+std::atomic<int>       tlIDs;    // Source of thread ids
+std::atomic<long long> tlHits;   // Obtains satisfied by the thread cache
+std::atomic<long long> tlMiss;   // Obtains that went to the global pool
+std::atomic<long long> tlXfree;  // Releases by a thread other than obtainer
+XrdSysMutex            regMutex; // Protects the magazine registry
+XrdBuffMagazine       *regFirst;
+
+                       XrdBuffManagerTL() : tlMax(4*1024*1024), tlIDs(0),
+                                            tlHits(0), tlMiss(0), tlXfree(0),
+                                            regFirst(0) {}
+};
+
+namespace
+{
+thread_local XrdBuffMagazine tlMag;
+}
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
@@ -98,6 +182,7 @@ XrdBuffManager::XrdBuffManager(int minrst) :
    rsinprog = 0;
    minrsw   = minrst;
    memset(static_cast<void *>(bucket), 0, sizeof(bucket));
+   tlCtl    = new XrdBuffManagerTL;
 }
 
 /******************************************************************************/
@@ -111,7 +196,7 @@ XrdBuffManager::~XrdBuffManager()
    for (int i = 0; i < XRD_BUCKETS; i++)
        {while((bP = bucket[i].bnext))
              {bucket[i].bnext = bP->next;
-              delete bP;
+              delete static_cast<XrdBuffTL *>(bP);
              }
         bucket[i].numbuf = 0;
        }
@@ -156,6 +241,30 @@ XrdBuffer *XrdBuffManager::Obtain(int sz)
    if (mk < sz) {bindex++; mk = mk << 1;}
    if (bindex >= slots) return 0;    // Should never happen!
 
+// Try to get a buffer from this thread's magazine. This does not need the
+// global lock.
+//
+   XrdBuffMagazine &mag = tlMag;
+   if (tlCtl->tlMax)
+      {if (!mag.bMgr) tlAttach(mag);
+       if (mag.bMgr == this)
+          {mag.magMutex.Lock();
+           if ((bp = mag.bnext[bindex]))
+              {mag.bnext[bindex] = bp->next;
+               mag.numbuf[bindex]--;
+               mag.numreq[bindex]++;
+               mag.bytes -= bp->bsize;
+               mag.hits++;
+               static_cast<XrdBuffTL *>(bp)->owner = mag.myID;
+               if (++mag.numops >= magSync) tlFlush(mag, false);
+               mag.magMutex.UnLock();
+               return bp;
+              }
+           mag.miss++;
+           mag.magMutex.UnLock();
+          }
+      }
+
 // Obtain a lock on the bucket array and try to give away an existing buffer
 //
     Reshaper.Lock();
@@ -167,16 +276,18 @@ XrdBuffer *XrdBuffManager::Obtain(int sz)
 
 // Check if we really allocated a buffer
 //
-   if (bp) return bp;
+   if (bp) {static_cast<XrdBuffTL *>(bp)->owner = mag.myID; return bp;}
 
 // Allocate a chunk of aligned memory
 //
    pk = (mk < pagsz ? mk : pagsz);
-   if (posix_memalign((void **)&memp, pk, mk)) return 0;
+   if (!(memp = XrdBuffer::Alloc(mk, pk))) return 0;
 
 // Wrap the memory with a buffer object
 //
-   if (!(bp = new XrdBuffer(memp, mk, bindex))) {free(memp); return 0;}
+   XrdBuffTL *tp;
+   if (!(bp = tp = new XrdBuffTL(memp, mk, bindex))) {free(memp); return 0;}
+   tp->owner = mag.myID;
 
 // Update statistics
 //
@@ -226,6 +337,27 @@ void XrdBuffManager::Release(XrdBuffer *bp)
 //
    if (bindex >= slots) {xlBuff.Release(bp); return;}
 
+// Try to place the buffer in this thread's magazine. Buffers obtained by a
+// different thread are counted as they indicate a producer/consumer pattern.
+//
+   if (tlCtl->tlMax)
+      {XrdBuffMagazine &mag = tlMag;
+       if (mag.bMgr == this)
+          {mag.magMutex.Lock();
+           if (static_cast<XrdBuffTL *>(bp)->owner != mag.myID) mag.xfree++;
+           if (mag.numbuf[bindex] < magMax
+           &&  mag.bytes + bp->bsize <= tlCtl->tlMax)
+              {bp->next = mag.bnext[bindex];
+               mag.bnext[bindex] = bp;
+               mag.numbuf[bindex]++;
+               mag.bytes += bp->bsize;
+               mag.magMutex.UnLock();
+               return;
+              }
+           mag.magMutex.UnLock();
+          }
+      }
+
 // Obtain a lock on the bucket array and reclaim the buffer
 //
     Reshaper.Lock();
@@ -260,6 +392,14 @@ while(1)
           Reshaper.Lock();
          }
 
+      // Take back the buffers cached by every thread, including idle ones,
+      // so that the profile below includes their requests and the buffers
+      // can be freed.
+      //
+      Reshaper.UnLock();
+      tlDrain();
+      Reshaper.Lock();
+
       // We have the lock so compute the request profile
       //
       if (totreq > slots)
@@ -281,7 +421,7 @@ while(1)
            while(bucket[i].numbuf > bufprof[i])
                 if ((bp = bucket[i].bnext))
                    {bucket[i].bnext = bp->next;
-                    delete bp;
+                    delete static_cast<XrdBuffTL *>(bp);
                     bucket[i].numbuf--; numfreed++;
                     memhave -= memslot; totalo  -= memslot;
                     totbuf--;
@@ -316,6 +456,22 @@ void XrdBuffManager::Set(int maxmem, int minw)
    Reshaper.UnLock();
 }
  
+/******************************************************************************/
+/*                              S e t C a c h e                               */
+/******************************************************************************/
+
+void XrdBuffManager::SetCache(long long tlmax, int hpmin)
+{
+
+// Set the per-thread cache limit (0 turns it off) and the minimum buffer size
+// that should be backed by huge pages (0 turns it off). Both are only set
+// during configuration.
+//
+   if (tlmax >= 0) tlCtl->tlMax = tlmax;
+   if (hpmin >= 0) XrdBuffer::hugesz = (hpmin && hpmin < hugePage
+                                     ? hugePage : hpmin);
+}
+
 /******************************************************************************/
 /*                                 S t a t s                                  */
 /******************************************************************************/
@@ -323,19 +479,161 @@ void XrdBuffManager::Set(int maxmem, int minw)
 int XrdBuffManager::Stats(char *buff, int blen, int do_sync)
 {
     static char statfmt[] = "<stats id=\"buff\"><reqs>%d</reqs>"
-                "<mem>%lld</mem><buffs>%d</buffs><adj>%d</adj>%s</stats>";
+                "<mem>%lld</mem><buffs>%d</buffs><adj>%d</adj>"
+                "<tlhit>%lld</tlhit><tlmiss>%lld</tlmiss><tlxfr>%lld</tlxfr>"
+                "%s</stats>";
     char xlStats[1024];
     int nlen;
 
 // If only size wanted, return it
 //
-   if (!buff) return sizeof(statfmt) + 16*4 + xlBuff.Stats(0,0);
+   if (!buff) return sizeof(statfmt) + 16*7 + xlBuff.Stats(0,0);
 
-// Return formatted stats
+// Return formatted stats (the thread cache counters are approximate)
 //
    if (do_sync) Reshaper.Lock();
    xlBuff.Stats(xlStats, sizeof(xlStats), do_sync);
-   nlen = snprintf(buff,blen,statfmt,totreq,totalo,totbuf,totadj,xlStats);
+   nlen = snprintf(buff,blen,statfmt,totreq,totalo,totbuf,totadj,
+                   tlCtl->tlHits.load(std::memory_order_relaxed),
+                   tlCtl->tlMiss.load(std::memory_order_relaxed),
+                   tlCtl->tlXfree.load(std::memory_order_relaxed), xlStats);
    if (do_sync) Reshaper.UnLock();
    return nlen;
 }
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                              t l A t t a c h                               */
+/******************************************************************************/
+
+// Bind this thread's magazine to this manager and add it to the registry.
+//
+void XrdBuffManager::tlAttach(XrdBuffMagazine &mag)
+{
+   XrdBuffManagerTL &tlc = *tlCtl;
+
+   mag.myID = ++tlc.tlIDs;
+   tlc.regMutex.Lock();
+   if ((mag.next = tlc.regFirst)) tlc.regFirst->prev = &mag;
+   tlc.regFirst = &mag;
+   mag.bMgr = this;
+   tlc.regMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                              t l D e t a c h                               */
+/******************************************************************************/
+
+// Return the buffers of an exiting thread and remove its magazine from the
+// registry.
+//
+void XrdBuffManager::tlDetach(XrdBuffMagazine &mag)
+{
+   XrdBuffManagerTL &tlc = *tlCtl;
+
+   tlc.regMutex.Lock();
+   if (mag.prev) mag.prev->next = mag.next;
+      else tlc.regFirst = mag.next;
+   if (mag.next) mag.next->prev = mag.prev;
+   mag.prev = mag.next = 0;
+   mag.magMutex.Lock();
+   tlFlush(mag);
+   mag.bMgr = 0;
+   mag.magMutex.UnLock();
+   tlc.regMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                               t l D r a i n                                */
+/******************************************************************************/
+
+// Return the buffers of every magazine to the global pool. The lock order is
+// registry, magazine, and then the Reshaper which must not be held on entry.
+//
+void XrdBuffManager::tlDrain()
+{
+   XrdBuffManagerTL &tlc = *tlCtl;
+   XrdBuffMagazine *mag;
+
+   tlc.regMutex.Lock();
+   for (mag = tlc.regFirst; mag; mag = mag->next)
+       {mag->magMutex.Lock();
+        tlFlush(*mag);
+        mag->magMutex.UnLock();
+       }
+   tlc.regMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                               t l F l u s h                                */
+/******************************************************************************/
+
+// Publish the magazine's request counts and statistics and, if retbuf is
+// true, return all of its buffers to the global pool. The magazine must be
+// locked by the caller.
+//
+void XrdBuffManager::tlFlush(XrdBuffMagazine &mag, bool retbuf)
+{
+   XrdBuffer *bp;
+
+// Move everything under the global lock
+//
+   Reshaper.Lock();
+   for (int i = 0; i < XRD_BUCKETS; i++)
+       {bucket[i].numreq += mag.numreq[i];
+        totreq           += mag.numreq[i];
+        mag.numreq[i]     = 0;
+        if (retbuf)
+           {while((bp = mag.bnext[i]))
+                 {mag.bnext[i] = bp->next;
+                  bp->next = bucket[i].bnext;
+                  bucket[i].bnext = bp;
+                  bucket[i].numbuf++;
+                 }
+            mag.numbuf[i] = 0;
+           }
+       }
+   Reshaper.UnLock();
+
+// Update the statistics
+//
+   tlCtl->tlHits.fetch_add(mag.hits, std::memory_order_relaxed);
+   tlCtl->tlMiss.fetch_add(mag.miss, std::memory_order_relaxed);
+   tlCtl->tlXfree.fetch_add(mag.xfree, std::memory_order_relaxed);
+   mag.hits = mag.miss = mag.xfree = 0;
+   mag.numops = 0;
+
+// Reset the magazine if we emptied it
+//
+   if (retbuf) mag.bytes = 0;
+}
+
+/******************************************************************************/
+/*                     C l a s s   X r d B u f f e r                          */
+/******************************************************************************/
+/******************************************************************************/
+/*                                 A l l o c                                  */
+/******************************************************************************/
+
+char *XrdBuffer::Alloc(int sz, int align)
+{
+   char *memp;
+
+// Large buffers may be backed by transparent huge pages. We align the memory
+// on a huge page boundary so that the kernel can actually use them.
+//
+#ifdef MADV_HUGEPAGE
+   if (hugesz && sz >= hugesz)
+      {if (posix_memalign((void **)&memp, hugePage, sz)) return 0;
+       madvise(memp, sz, MADV_HUGEPAGE);
+       return memp;
+      }
+#endif
+
+// Allocate normal aligned memory
+//
+   if (posix_memalign((void **)&memp, align, sz)) return 0;
+   return memp;
+}
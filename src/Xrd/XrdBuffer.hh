@@ -54,9 +54,12 @@ int      bsize;    // size of this buffer
          friend class XrdBuffXL;
 private:
 
+static char *Alloc(int sz, int align);
+
 int        bindex;
 XrdBuffer *next;
 static int pagesz;
+static int hugesz; // Minimum size backed by huge pages (0 -> never)
 };
   
 /******************************************************************************/
@@ -66,8 +69,14 @@ static int pagesz;
 #define XRD_BUCKETS 12
 #define XRD_BUSHIFT 10
 
-// There should be only one instance of this class per buffer pool.
+// There should be only one instance of this class per buffer pool. Each
+// thread keeps a small cache (magazine) of buffers per bucket so that most
+// Obtain() and Release() calls do not need the global lock. Magazines are
+// returned to the global pool when the reshaper runs.
 //
+class XrdBuffMagazine;
+class XrdBuffManagerTL;
+
 class XrdBuffManager
 {
 public:
@@ -86,6 +95,8 @@ void        Reshape();
 
 void        Set(int maxmem=-1, int minw=-1);
 
+void        SetCache(long long tlmax, int hpmin);
+
 int         Stats(char *buff, int blen, int do_sync=0);
 
             XrdBuffManager(int minrst=20*60);
@@ -114,5 +125,14 @@ int       totadj;
 
 XrdSysCondVar      Reshaper;
 static const char *TraceID;
+
+friend class XrdBuffMagazine;
+
+void  tlAttach(XrdBuffMagazine &mag);
+void  tlDetach(XrdBuffMagazine &mag);
+void  tlDrain();
+void  tlFlush(XrdBuffMagazine &mag, bool retbuf=true);
+
+XrdBuffManagerTL  *tlCtl;       // Thread cache state (out of line)
 };
 #endif
@@ -44,6 +44,7 @@
 #include <cstdio>
 #include <sys/param.h>
 #include <sys/resource.h>
+#include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/un.h>
@@ -59,6 +60,7 @@
 #include "Xrd/XrdInfo.hh"
 #include "Xrd/XrdLink.hh"
 #include "Xrd/XrdLinkCtl.hh"
+#include "Xrd/XrdLinkXeq.hh"
 #include "Xrd/XrdMonitor.hh"
 #include "Xrd/XrdPoll.hh"
 #include "Xrd/XrdScheduler.hh"
@@ -274,14 +276,21 @@ XrdConfig::XrdConfig()
    repInt     = 600;
    repOpts    = 0;
    ppNet      = 0;
-   tlsOpts    = 9ULL | XrdTlsContext::servr | XrdTlsContext::logVF;
+   tlsOpts    = 9ULL | XrdTlsContext::servr | XrdTlsContext::logVF
+              | XrdTlsContext::ktlsOK;
    tlsNoVer   = false;
    tlsNoCAD   = true;
+   tlsTkt     = false;
+   tkFile     = 0;
+   tkRotate   = 0;
+   tkLife     = 0;
+   tkOpts     = 0;
    NetADM     = 0;
    coreV      = 1;
    Specs      = 0;
    isStrict   = false;
    maxFD      = 256*1024;  // 256K default
+   numAcpt    = 1;
 
    Firstcp = Lastcp = 0;
 
@@ -823,6 +832,7 @@ int XrdConfig::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError *eDest)
    TS_Xeq("homepath",      xhpath);
    TS_Xeq("maxfd",         xmaxfd);
    TS_Xeq("pidpath",       xpidf);
+   TS_Xeq("pollers",       xpoll);
    TS_Xeq("port",          xport);
    TS_Xeq("protocol",      xprot);
    TS_Xeq("report",        xrep);
@@ -832,6 +842,7 @@ int XrdConfig::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError *eDest)
    TS_Xeq("tls",           xtls);
    TS_Xeq("tlsca",         xtlsca);
    TS_Xeq("tlsciphers",    xtlsci);
+   TS_Xeq("tlsticket",     xtlstk);
    }
 
    // No match found, complain.
@@ -944,13 +955,15 @@ XrdInet *XrdConfig::getNet(int port, bool isTLS)
    XrdInet *newNet = new XrdInet(&Log, Police);
    NetTCP.push_back(newNet);
 
-// Set options
+// Set options. When multiple acceptors are wanted, every listening socket on
+// the port must be bound with SO_REUSEPORT, including this one.
 //
    if (isTLS)
       {the_Opts = TLS_Opts; the_Blen = TLS_Blen;
       } else {
        the_Opts = Net_Opts; the_Blen = Net_Blen;
       }
+   if (numAcpt > 1) the_Opts |= XRDNET_REUSEPORT;
    if (the_Opts || the_Blen) newNet->setDefaults(the_Opts, the_Blen);
 
 // Set the domain if we have one
@@ -959,9 +972,30 @@ XrdInet *XrdConfig::getNet(int port, bool isTLS)
 
 // Attempt to bind to this socket.
 //
-   if (newNet->BindSD(port, "tcp") == 0) return newNet;
-   delete newNet;
-   return 0;
+   if (newNet->BindSD(port, "tcp") != 0)
+      {NetTCP.pop_back();
+       delete newNet;
+       return 0;
+      }
+
+// Create the additional acceptors for this port. Each gets its own listening
+// socket on the same port. Failure is not fatal as the port is being served.
+//
+   for (int i = 1; i < numAcpt; i++)
+       {XrdInet *acpNet = new XrdInet(&Log, Police);
+        acpNet->setDefaults(the_Opts, the_Blen);
+        if (myDomain) acpNet->setDomain(myDomain);
+        if (acpNet->Bind(newNet->Port(), "tcp") != 0)
+           {char buff[16];
+            snprintf(buff, sizeof(buff), "%d", newNet->Port());
+            Log.Say("Config warning: unable to add acceptor for port ", buff,
+                    "; continuing with fewer acceptors.");
+            delete acpNet;
+            break;
+           }
+        NetAcc.push_back(acpNet);
+       }
+   return newNet;
 }
   
 /******************************************************************************/
@@ -1482,6 +1516,18 @@ bool XrdConfig::SetupTLS()
        XrdTls::SetDebug(tlsdbg, &Logger);
       }
 
+// Set up session tickets before the context exists as they are configured
+// when a server context is created.
+//
+   if (tlsTkt)
+      {std::string eMsg;
+       if (!XrdTlsContext::SetTicketKeys(tkFile, tkRotate, tkLife, tkOpts,
+                                         &eMsg))
+          {Log.Say("Config failure: ", eMsg.c_str());
+           return false;
+          }
+      }
+
 // Create a context
 //
    static XrdTlsContext xrdTLS(tlsCert, tlsKey, caDir, caFile, tlsOpts);
@@ -1645,11 +1691,20 @@ int XrdConfig::xhpath(XrdSysError *eDest, XrdOucStream &Config)
 
 /* Function: xbuf
 
-   Purpose:  To parse the directive: buffers [maxbsz <bsz>] <memsz> [<rint>]
+   Purpose:  To parse the directive: buffers [maxbsz <bsz>] [tlcache <tsz>]
+                                             [hugepages {<hsz>|off}]
+                                             <memsz> [<rint>]
 
              <bsz>      maximum size of an individualbuffer. The default is 2m.
-                        Specify any value 2m < bsz <= 1g; if specified, it must
-                        appear before the <memsz> and <memsz> becomes optional.
+             <tsz>      maximum amount of buffer memory each thread may cache
+                        to avoid the global buffer lock. The default is 4m.
+                        Specify 0 to disable the per-thread cache.
+             <hsz>      buffers of at least this size are backed by huge pages.
+                        Values less than 2m are rounded up to 2m. The default
+                        is off.
+                        Options must appear before the <memsz> and, if any
+                        is specified, <memsz> becomes optional; <bsz> must be
+                        2m < bsz <= 1g.
              <memsz>    maximum amount of memory devoted to buffers
              <rint>     minimum buffer reshape interval in seconds
 
@@ -1660,20 +1715,45 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
     static const long long minBSZ = 1024*1024*2+1;  // 2mb
     static const long long maxBSZ = 1024*1024*1024; // 1gb
     int bint = -1;
-    long long blim;
+    long long blim, tlim = -1, hlim = -1;
     char *val;
 
     if (!(val = Config.GetWord()))
        {eDest->Emsg("Config", "buffer memory limit not specified"); return 1;}
 
-    if (!strcmp("maxbsz", val))
-       {if (!(val = Config.GetWord()))
-           {eDest->Emsg("Config", "max buffer size not specified"); return 1;}
-        if (XrdOuca2x::a2sz(*eDest,"maxbz value",val,&blim,minBSZ,maxBSZ))
-           return 1;
-        XrdGlobal::xlBuff.Init(blim);
-        if (!(val = Config.GetWord())) return 0;
-       }
+    while(val)
+         {if (!strcmp("maxbsz", val))
+             {if (!(val = Config.GetWord()))
+                 {eDest->Emsg("Config", "max buffer size not specified");
+                  return 1;
+                 }
+              if (XrdOuca2x::a2sz(*eDest,"maxbz value",val,&blim,minBSZ,maxBSZ))
+                 return 1;
+              XrdGlobal::xlBuff.Init(blim);
+             }
+          else if (!strcmp("tlcache", val))
+             {if (!(val = Config.GetWord()))
+                 {eDest->Emsg("Config", "thread cache size not specified");
+                  return 1;
+                 }
+              if (XrdOuca2x::a2sz(*eDest,"tlcache value",val,&tlim,0,maxBSZ))
+                 return 1;
+             }
+          else if (!strcmp("hugepages", val))
+             {if (!(val = Config.GetWord()))
+                 {eDest->Emsg("Config", "huge page size not specified");
+                  return 1;
+                 }
+              if (!strcmp("off", val)) hlim = 0;
+                 else if (XrdOuca2x::a2sz(*eDest,"hugepages value",val,&hlim,
+                                          1,maxBSZ)) return 1;
+             }
+          else break;
+          val = Config.GetWord();
+         }
+
+    if (tlim >= 0 || hlim >= 0) BuffPool.SetCache(tlim, (int)hlim);
+    if (!val) return 0;
 
     if (XrdOuca2x::a2sz(*eDest,"buffer limit value",val,&blim,
                        (long long)1024*1024)) return 1;
@@ -1736,6 +1816,7 @@ int XrdConfig::xmaxfd(XrdSysError *eDest, XrdOucStream &Config)
                                          [kaparms parms] [cache <ct>] [[no]dnr]
                                          [routes <rtype> [use <ifn1>,<ifn2>]]
                                          [[no]rpipa] [[no]dyndns]
+                                         [zerocopy <zsz>] [acceptors <an>]
 
              <rtype>: split | common | local
 
@@ -1748,6 +1829,14 @@ int XrdConfig::xmaxfd(XrdSysError *eDest, XrdOucStream &Config)
              routes    specifies the network configuration (see reference)
              [no]rpipa do [not] resolve private IP addresses.
              [no]dyndns This network does [not] use a dynamic DNS.
+             <zsz>     send non-TLS responses of at least <zsz> bytes using
+                       MSG_ZEROCOPY, if supported, when the protocol hands the
+                       buffer holding the data over to the link. Specify 0
+                       (the default) to always copy the data into the kernel.
+             <an>      number of threads accepting connections on each port.
+                       When greater than one, each thread owns its own
+                       listening socket bound with SO_REUSEPORT so that the
+                       kernel spreads incoming connections across them.
 
    Output: 0 upon success or !0 upon failure.
 */
@@ -1756,12 +1845,14 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
 {
     char *val;
     int  i, n, V_keep = -1, V_nodnr = 0, V_istls = 0, V_blen = -1, V_ct = -1;
-    int   V_assumev4 = -1, v_rpip = -1, V_dyndns = -1;
+    int   V_assumev4 = -1, v_rpip = -1, V_dyndns = -1, V_zcmin = -1;
+    int   V_acpt = -1;
     long long llp;
     struct netopts {const char *opname; int hasarg; int opval;
                            int *oploc;  const char *etxt;}
            ntopts[] =
        {
+        {"acceptors",  5, 0, &V_acpt,   "acceptors"},
         {"assumev4",   0, 1, &V_assumev4, "option"},
         {"keepalive",  0, 1, &V_keep,   "option"},
         {"nokeepalive",0, 0, &V_keep,   "option"},
@@ -1775,7 +1866,8 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
         {"routes",     3, 1, 0,         "routes"},
         {"rpipa",      0, 1, &v_rpip,   "rpipa"},
         {"norpipa",    0, 0, &v_rpip,   "norpipa"},
-        {"tls",        0, 1, &V_istls,  "option"}
+        {"tls",        0, 1, &V_istls,  "option"},
+        {"zerocopy",   1, 0, &V_zcmin,  "zerocopy size"}
        };
     int numopts = sizeof(ntopts)/sizeof(struct netopts);
 
@@ -1795,6 +1887,12 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
                          {if (xnkap(eDest, val)) return 1;
                           break;
                          }
+                      if (ntopts[i].hasarg == 5)
+                         {if (XrdOuca2x::a2i(*eDest,"network acceptors",val,
+                                             &n,1,64)) return 1;
+                          *ntopts[i].oploc = n;
+                          break;
+                         }
                       if (ntopts[i].hasarg == 3)
                          {     if (!strcmp(val, "split"))
                                   XrdNetIF::Routing(XrdNetIF::netSplit);
@@ -1850,6 +1948,17 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
          XrdNetAddr::SetDynDNS(V_dyndns != 0);
         }
      if (V_ct >= 0) XrdNetAddr::SetCache(V_ct);
+     if (V_zcmin >= 0) XrdLinkXeq::zcMin = V_zcmin;
+     if (V_acpt  >  0)
+        {
+#ifdef SO_REUSEPORT
+         numAcpt = V_acpt;
+#else
+         if (V_acpt > 1)
+            eDest->Say("Config warning: SO_REUSEPORT not supported; "
+                       "network acceptors ignored.");
+#endif
+        }
 
      if (v_rpip >= 0) XrdInet::netIF.SetRPIPA(v_rpip != 0);
      if (V_assumev4 >= 0) XrdInet::SetAssumeV4(true);
@@ -1933,6 +2042,54 @@ int XrdConfig::xpidf(XrdSysError *eDest, XrdOucStream &Config)
    return 0;
 }
   
+/******************************************************************************/
+/*                                 x p o l l                                  */
+/******************************************************************************/
+
+/* Function: xpoll
+
+   Purpose:  To parse the directive: pollers {<num> | auto} [edge] [pin]
+
+             <num>     the number of poller threads that monitor connections.
+             auto      use one poller per four cores with a minimum of three
+                       and a maximum of 32 (the default).
+             edge      keep links registered edge-triggered instead of
+                       re-arming them after every request (epoll only).
+             pin       bind each poller thread to a distinct cpu.
+
+  Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdConfig::xpoll(XrdSysError *eDest, XrdOucStream &Config)
+{
+    char *val;
+    int  num = 0;
+    bool pin = false, edge = false;
+
+// Get the number of pollers
+//
+   if (!(val = Config.GetWord()) || !val[0])
+      {eDest->Emsg("Config", "pollers value not specified"); return 1;}
+   if (strcmp(val, "auto")
+   &&  XrdOuca2x::a2i(*eDest,"pollers value",val,&num,1,XRD_MAXPOLLERS))
+      return 1;
+
+// Get any options
+//
+   while((val = Config.GetWord()))
+        {     if (!strcmp(val, "pin"))  pin  = true;
+         else if (!strcmp(val, "edge")) edge = true;
+         else {eDest->Emsg("Config", "invalid pollers option -", val);
+               return 1;
+              }
+        }
+
+// Record the values
+//
+   XrdPoll::setPollers(num, pin, edge);
+   return 0;
+}
+
 /******************************************************************************/
 /*                                 x p o r t                                  */
 /******************************************************************************/
@@ -2195,6 +2352,7 @@ int XrdConfig::xrep(XrdSysError *eDest, XrdOucStream &Config)
 
    Purpose:  To parse directive: sched [mint <mint>] [maxt <maxt>] [avlt <at>]
                                        [idle <idle>] [stksz <qnt>] [core <cv>]
+                                       [mode {fifo | steal}]
 
              <mint>   is the minimum number of threads that we need. Once
                       this number of threads is created, it does not decrease.
@@ -2211,6 +2369,9 @@ int XrdConfig::xrep(XrdSysError *eDest, XrdOucStream &Config)
              <idle>   The time (in time spec) between checks for underused
                       threads. Those found will be terminated. Default is 780.
              <qnt>    The thread stack size in bytes or K, M, or G.
+             mode     fifo  - all workers share a single job queue (default).
+                      steal - each worker has its own job deque and steals
+                              work from other workers when it is empty.
 
    Output: 0 upon success or 1 upon failure.
 */
@@ -2237,7 +2398,18 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
        {eDest->Emsg("Config", "sched option not specified"); return 1;}
 
     while (val)
-          {for (i = 0; i < numopts; i++)
+          {if (!strcmp(val, "mode"))
+              {if (!(val = Config.GetWord()))
+                  {eDest->Emsg("Config", "sched mode value not specified");
+                   return 1;
+                  }
+                    if (!strcmp(val, "fifo"))  Sched.setMode(XrdScheduler::modeFifo);
+               else if (!strcmp(val, "steal")) Sched.setMode(XrdScheduler::modeSteal);
+               else {eDest->Emsg("Config", "invalid sched mode -", val); return 1;}
+               val = Config.GetWord();
+               continue;
+              }
+           for (i = 0; i < numopts; i++)
                if (!strcmp(val, scopts[i].opname))
                   {if (!(val = Config.GetWord()))
                       {eDest->Emsg("Config", "sched", scopts[i].opname,
@@ -2393,6 +2565,8 @@ int XrdConfig::xtcpmon(XrdSysError *eDest, XrdOucStream &Config)
              <opts>   options:
                       [no]detail       do [not] print TLS library msgs
                       hsto <sec>       handshake timeout (default 10).
+                      [no]ktls         do [not] use kernel TLS when the
+                                       kernel supports it (default ktls).
 
    Output: 0 upon success or 1 upon failure.
 */
@@ -2422,6 +2596,8 @@ int XrdConfig::xtls(XrdSysError *eDest, XrdOucStream &Config)
 
 do {     if (!strcmp(val,   "detail")) SSLmsgs = true;
     else if (!strcmp(val, "nodetail")) SSLmsgs = false;
+    else if (!strcmp(val,   "ktls")) tlsOpts |=  XrdTlsContext::ktlsOK;
+    else if (!strcmp(val, "noktls")) tlsOpts &= ~XrdTlsContext::ktlsOK;
     else if (!strcmp(val, "hsto" ))
             {if (!(val = Config.GetWord()))
                 {eDest->Emsg("Config", "tls hsto value not specified");
@@ -2582,6 +2758,96 @@ int XrdConfig::xtlsci(XrdSysError *eDest, XrdOucStream &Config)
    return 0;
 }
   
+/******************************************************************************/
+/*                                x t l s t k                                 */
+/******************************************************************************/
+
+/* Function: xtlstk
+
+   Purpose:  To parse directive: tlsticket off | [keyfile <path> [manage]]
+                                           [lifetime <lt>] [rotate <rt>]
+
+             off      do not issue session tickets, clients always do a full
+                      handshake unless a session id cache is in effect.
+             <path>   the file holding the ticket encryption keys. Servers
+                      sharing the file accept each other's tickets. The file
+                      must not be accessible by group or others. Without it,
+                      keys are kept in memory and only honoured by this server.
+             manage   this server creates the key file, if need be, and
+                      rotates the keys in it. Exactly one server sharing the
+                      file should specify manage; the others reload the file
+                      whenever it changes.
+             <lt>     the maximum lifetime of a session (default is 2h). It is
+                      further limited by the expiration of the client's cert.
+             <rt>     the key rotation interval (default is 12h).
+
+   Output: 0 upon success or 1 upon failure.
+*/
+
+int XrdConfig::xtlstk(XrdSysError *eDest, XrdOucStream &Config)
+{
+   char *val;
+   int num;
+
+   if (!(val = Config.GetWord()))
+      {eDest->Emsg("Config", "tlsticket parameter not specified"); return 1;}
+
+   if (tkFile) {free(tkFile); tkFile = 0;}
+   tkOpts = tkRotate = tkLife = 0;
+   tlsTkt = true;
+
+   if (!strcmp(val, "off"))
+      {tkOpts = XrdTlsContext::tkOff;
+       if ((val = Config.GetWord()))
+          {eDest->Emsg("Config","Invalid tlsticket argument -",val);
+           return 1;
+          }
+       return 0;
+      }
+
+   do {     if (!strcmp(val, "keyfile"))
+               {if (!(val = Config.GetWord()))
+                   {eDest->Emsg("Config", "tlsticket keyfile not specified");
+                    return 1;
+                   }
+                if (*val != '/')
+                   {eDest->Emsg("Config", "tlsticket keyfile not absolute");
+                    return 1;
+                   }
+                if (tkFile) free(tkFile);
+                tkFile = strdup(val);
+               }
+       else if (!strcmp(val, "manage"))
+               {if (!tkFile)
+                   {eDest->Emsg("Config", "tlsticket manage requires keyfile");
+                    return 1;
+                   }
+                tkOpts |= XrdTlsContext::tkManage;
+               }
+       else if (!strcmp(val, "lifetime"))
+               {if (!(val = Config.GetWord()))
+                   {eDest->Emsg("Config", "tlsticket lifetime not specified");
+                    return 1;
+                   }
+                if (XrdOuca2x::a2tm(*eDest,"tlsticket lifetime",val,&num,60))
+                   return 1;
+                tkLife = num;
+               }
+       else if (!strcmp(val, "rotate"))
+               {if (!(val = Config.GetWord()))
+                   {eDest->Emsg("Config", "tlsticket rotate not specified");
+                    return 1;
+                   }
+                if (XrdOuca2x::a2tm(*eDest,"tlsticket rotate",val,&num,60))
+                   return 1;
+                tkRotate = num;
+               }
+       else {eDest->Emsg("Config", "invalid tlsticket option -",val); return 1;}
+      } while((val = Config.GetWord()));
+
+   return 0;
+}
+  
 /******************************************************************************/
 /*                                  x t m o                                   */
 /******************************************************************************/
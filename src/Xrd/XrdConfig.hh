@@ -58,6 +58,7 @@ int         ConfigXeq(char *var, XrdOucStream &Config, XrdSysError *eDest=0);
 XrdProtocol_Config    ProtInfo;
 XrdInet              *NetADM;
 std::vector<XrdInet*> NetTCP;
+std::vector<XrdInet*> NetAcc;   // Additional SO_REUSEPORT acceptors
 
 private:
 
@@ -82,6 +83,7 @@ int   xnet(XrdSysError *edest, XrdOucStream &Config);
 int   xnkap(XrdSysError *edest, char *val);
 int   xlog(XrdSysError *edest, XrdOucStream &Config);
 int   xpidf(XrdSysError *edest, XrdOucStream &Config);
+int   xpoll(XrdSysError *edest, XrdOucStream &Config);
 int   xport(XrdSysError *edest, XrdOucStream &Config);
 int   xprot(XrdSysError *edest, XrdOucStream &Config);
 int   xrep(XrdSysError *edest, XrdOucStream &Config);
@@ -91,6 +93,7 @@ int   xtcpmon(XrdSysError *edest, XrdOucStream &Config);
 int   xtls(XrdSysError *edest, XrdOucStream &Config);
 int   xtlsca(XrdSysError *edest, XrdOucStream &Config);
 int   xtlsci(XrdSysError *edest, XrdOucStream &Config);
+int   xtlstk(XrdSysError *edest, XrdOucStream &Config);
 int   xtrace(XrdSysError *edest, XrdOucStream &Config);
 int   xtmo(XrdSysError *edest, XrdOucStream &Config);
 
@@ -111,14 +114,19 @@ char               *tlsCert;
 char               *tlsKey;
 char               *caDir;
 char               *caFile;
+char               *tkFile;
 char               *ConfigFN;
 char               *repDest[2];
 XrdConfigProt      *Firstcp;
 XrdConfigProt      *Lastcp;
 int                 Net_Blen;
 int                 Net_Opts;
+int                 numAcpt;      // Number of acceptors per port
 int                 TLS_Blen;
 int                 TLS_Opts;
+int                 tkRotate;     // Ticket key rotation interval
+int                 tkLife;       // Maximum TLS session lifetime
+int                 tkOpts;       // XrdTlsContext::tkXXX options
 
 int                 PortTCP;      // TCP Port to listen on
 int                 PortUDP;      // UDP Port to listen on (currently unsupported)
@@ -131,6 +139,7 @@ int                 repInt;
 uint64_t            tlsOpts;
 bool                tlsNoVer;
 bool                tlsNoCAD;
+bool                tlsTkt;       // tlsticket directive was specified
 
 char                repOpts;
 char                ppNet;
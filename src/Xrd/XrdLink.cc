@@ -80,7 +80,8 @@
 
 namespace XrdGlobal
 {
-extern XrdSysError  Log;
+extern XrdBuffManager BuffPool;
+extern XrdSysError    Log;
 };
 
 using namespace XrdGlobal;
@@ -207,6 +208,15 @@ int XrdLink::getIOStats(long long &inbytes, long long &outbytes,
                                                  numstall, numtardy);
                        }
   
+/******************************************************************************/
+/*                          g e t K T L S S t a t s                           */
+/******************************************************************************/
+
+bool XrdLink::getKTLSStats(long long &sfbytes)
+                          {bool ktls = linkXQ.getKTLSStats(sfbytes);
+                           return isTLS && ktls;
+                          }
+  
 /******************************************************************************/
 /*                               g e t N a m e                                */
 /******************************************************************************/
@@ -233,6 +243,18 @@ XrdTlsPeerCerts *XrdLink::getPeerCerts()
 
 XrdProtocol *XrdLink::getProtocol() {return linkXQ.getProtocol();}
   
+/******************************************************************************/
+/*                               h a s K T L S                                */
+/******************************************************************************/
+
+bool XrdLink::hasKTLS() const {return isTLS && linkXQ.isKTLS();}
+
+/******************************************************************************/
+/*                                 h a s Z C                                  */
+/******************************************************************************/
+
+bool XrdLink::hasZC(int bytes) const {return !isTLS && linkXQ.zcOK(bytes);}
+
 /******************************************************************************/
 /*                                  H o l d                                   */
 /******************************************************************************/
@@ -347,6 +369,24 @@ int XrdLink::Send(const struct iovec *iov, int iocnt, int bytes)
    if (isTLS) return linkXQ.TLS_Send(iov, iocnt, bytes);
    else       return linkXQ.Send    (iov, iocnt, bytes);
 }
+
+/******************************************************************************/
+
+int XrdLink::Send(const struct iovec *iov, int iocnt, int bytes, XrdBuffer *bP)
+{
+   int retc;
+
+// Allways make sure we have a total byte count
+//
+   if (!bytes) for (int i = 0; i < iocnt; i++) bytes += iov[i].iov_len;
+
+// Execute the send, TLS always copies the data
+//
+   if (!isTLS) return linkXQ.Send(iov, iocnt, bytes, bP);
+   retc = linkXQ.TLS_Send(iov, iocnt, bytes);
+   if (bP) BuffPool.Release(bP);
+   return retc;
+}
  
 /******************************************************************************/
 
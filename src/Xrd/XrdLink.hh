@@ -41,6 +41,7 @@
 /*                      C l a s s   D e f i n i t i o n                       */
 /******************************************************************************/
   
+class XrdBuffer;
 class XrdLinkMatch;
 class XrdLinkXeq;
 class XrdPollInfo;
@@ -150,6 +151,18 @@ static XrdLink *Find(int &curr, XrdLinkMatch *who=0);
        int      getIOStats(long long &inbytes, long long &outbytes,
                                 int  &numstall,     int  &numtardy);
 
+//-----------------------------------------------------------------------------
+//! Get kernel TLS statistics.
+//!
+//! @param  sfbytes  The number of bytes sent with sendfile() and encrypted
+//!                  by the kernel.
+//!
+//! @return true     this link uses kernel TLS (see hasKTLS()).
+//! @return false    this link does not use kernel TLS.
+//-----------------------------------------------------------------------------
+
+       bool     getKTLSStats(long long &sfbytes);
+
 //-----------------------------------------------------------------------------
 //! Find the next client name matching certain attributes.
 //!
@@ -374,6 +387,25 @@ int             Send(const char *buff, int blen);
 
 int             Send(const struct iovec *iov, int iocnt, int bytes=0);
 
+//-----------------------------------------------------------------------------
+//! Send data on a link, handing over the buffer that holds the data. Large
+//! responses may then be sent without copying the data into the kernel (see
+//! hasZC()), in which case the buffer is returned to the buffer pool once the
+//! kernel no longer references it. Otherwise, it is returned after the send.
+//!
+//! @param  iov     pointer to the message vector.
+//! @param  iocnt   number of iov elements in the vector.
+//! @param  bytes   the sum of the sizes in the vector.
+//! @param  bP      the buffer, obtained from the server's buffer pool, that
+//!                 holds the data. It is taken over even if an error occurs.
+//!
+//! @return >=0     number of bytes sent.
+//!         < 0     an error occurred.
+//-----------------------------------------------------------------------------
+
+int             Send(const struct iovec *iov, int iocnt, int bytes,
+                     XrdBuffer *bP);
+
 //-----------------------------------------------------------------------------
 //! Send data on a link using sendfile(). This call always blocks until all
 //! data is sent. It should only be called if sfOK is true (see below).
@@ -562,6 +594,28 @@ bool            hasBridge() const {return isBridged;}
 
 bool            hasTLS() const {return isTLS;}
 
+//-----------------------------------------------------------------------------
+//! Determine if this link uses kernel TLS to send data. If so, Send(sfVec)
+//! uses sendfile() on the TLS connection.
+//!
+//! @return true    this link is using TLS with kernel encryption.
+//! @return false   this link does not use TLS or encrypts in user space.
+//-----------------------------------------------------------------------------
+
+bool            hasKTLS() const;
+
+//-----------------------------------------------------------------------------
+//! Determine if a send of a given size may be done without copying the data
+//! into the kernel, provided the buffer is handed over with Send().
+//!
+//! @param  bytes   the number of bytes to be sent.
+//!
+//! @return true    the data may be sent without copying it.
+//! @return false   the data will be copied.
+//-----------------------------------------------------------------------------
+
+bool            hasZC(int bytes) const;
+
 //-----------------------------------------------------------------------------
 //! Return TLS protocol version being used.
 //!
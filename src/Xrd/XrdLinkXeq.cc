@@ -32,6 +32,7 @@
 #include <signal.h>
 #include <cstdio>
 #include <cstring>
+#include <list>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/uio.h>
@@ -43,6 +44,15 @@
 #endif
 #endif
 
+#if defined(__linux__)
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <linux/errqueue.h>
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+#define XRDLINK_ZEROCOPY 1
+#endif
+#endif
+
 #ifdef HAVE_SENDFILE
 
 #if defined(__solaris__) || defined(__linux__) || defined(__GNU__)
@@ -52,6 +62,7 @@
 #endif
 
 #include "XrdSys/XrdSysAtomics.hh"
+#include "XrdSys/XrdSysE2T.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysFD.hh"
 #include "XrdSys/XrdSysPlatform.hh"
@@ -74,6 +85,7 @@
 
 namespace XrdGlobal
 {
+extern XrdBuffManager BuffPool;
 extern XrdSysError    Log;
 extern XrdScheduler   Sched;
 extern XrdTlsContext *tlsCtx;
@@ -99,7 +111,139 @@ using namespace XrdGlobal;
        int             XrdLinkXeq::LinkTimeOuts  = 0;
        int             XrdLinkXeq::LinkStalls    = 0;
        int             XrdLinkXeq::LinkSfIntr    = 0;
+       long long       XrdLinkXeq::LinkZcBytes   = 0;
+       int             XrdLinkXeq::LinkZcCopied  = 0;
+       int             XrdLinkXeq::LinkKTLS      = 0;
+       long long       XrdLinkXeq::LinkKtlsBytes = 0;
        XrdSysMutex     XrdLinkXeq::statsMutex;
+       int             XrdLinkXeq::zcMin         = 0;
+
+/******************************************************************************/
+/*                  Z e r o - C o p y   C o m p l e t i o n s                 */
+/******************************************************************************/
+
+namespace
+{
+// Consume the zero-copy completions on the socket error queue and recycle the
+// buffers they cover. Completions are posted in order for TCP, each covering
+// a contiguous range of send ids, so we only need to track the next id to be
+// completed. Returns 0 when the error queue was emptied and an errno value
+// otherwise; copied is set when the kernel reports it copied the data anyway.
+//
+int zcCollect(int fd, unsigned int &done, XrdLinkXeq::zcPendQ &pend,
+              long long &pendBytes, bool &copied)
+{
+#ifdef XRDLINK_ZEROCOPY
+   struct sock_extended_err *serr;
+   struct cmsghdr *cmsg;
+   struct msghdr msg;
+   char cbuf[128];
+   int rc = 0;
+
+   while(1)
+        {memset(&msg, 0, sizeof(msg));
+         msg.msg_control    = cbuf;
+         msg.msg_controllen = sizeof(cbuf);
+         if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            {if (errno == EINTR) continue;
+             if (errno != EAGAIN && errno != EWOULDBLOCK) rc = errno;
+             break;
+            }
+         for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+             {if (!(cmsg->cmsg_level == SOL_IP   && cmsg->cmsg_type == IP_RECVERR)
+              &&  !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+                 continue;
+              serr = (struct sock_extended_err *)CMSG_DATA(cmsg);
+              if (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+              if ((int)(serr->ee_data + 1 - done) > 0) done = serr->ee_data + 1;
+              if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) copied = true;
+             }
+         if (msg.msg_flags & MSG_CTRUNC) {rc = EPROTO; break;}
+        }
+
+// Recycle the buffers whose last send has completed
+//
+   while(!pend.empty() && (int)(done - pend.front().first) > 0)
+        {pendBytes -= pend.front().second->bsize;
+         BuffPool.Release(pend.front().second);
+         pend.pop_front();
+        }
+   return rc;
+#else
+   return 0;
+#endif
+}
+
+// Buffers sent without copying on links that have since been closed. Each
+// socket is kept open through a duplicate descriptor until the kernel posts
+// the completions for its buffers, which it does once the data has been
+// acknowledged or the connection has been torn down. The reaper runs once a
+// second while there is anything left to reap, so closing a link never waits.
+//
+class zcReaper : public XrdJob
+{
+public:
+
+void  Add(int fd, unsigned int done, XrdLinkXeq::zcPendQ &pend)
+         {XrdSysMutexHelper rHelp(rMutex);
+          orphans.emplace_back();
+          Orphan &oP = orphans.back();
+          oP.fd = fd; oP.done = done; oP.tEnd = time(0) + maxWait;
+          oP.pend.swap(pend);
+          if (!isSched) {isSched = true; Sched.Schedule(this, time(0)+1);}
+         }
+
+void  DoIt();
+
+      zcReaper() : XrdJob("Zero-copy reaper"), isSched(false) {}
+     ~zcReaper() {}
+
+private:
+
+static const int maxWait = 600;
+
+struct Orphan
+      {int                 fd;
+       unsigned int        done;
+       time_t              tEnd;
+       XrdLinkXeq::zcPendQ pend;
+      };
+
+XrdSysMutex       rMutex;
+std::list<Orphan> orphans;
+bool              isSched;
+};
+
+void zcReaper::DoIt()
+{
+   XrdSysMutexHelper rHelp(rMutex);
+   time_t now = time(0);
+   long long pendBytes = 0;
+   bool copied = false;
+
+// Whatever the kernel still holds after a long while is lost for good, it
+// may still transmit those pages so they cannot be reused.
+//
+   auto it = orphans.begin();
+   while(it != orphans.end())
+        {int rc = zcCollect(it->fd, it->done, it->pend, pendBytes, copied);
+         if (!it->pend.empty() && !rc && now < it->tEnd) {++it; continue;}
+         if (!it->pend.empty())
+            {char buff[80];
+             snprintf(buff, sizeof(buff), "%d zero-copy buffers of a closed "
+                      "link still in use", (int)it->pend.size());
+             Log.Emsg("Link", "Abandoning", buff);
+            }
+         close(it->fd);
+         it = orphans.erase(it);
+        }
+
+   if (orphans.empty()) isSched = false;
+      else Sched.Schedule(this, now+1);
+}
+
+zcReaper zcOrphans;
+}
 
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
@@ -120,6 +264,14 @@ void XrdLinkXeq::Reset()
    stallCnt = stallCntTot = 0;
    tardyCnt = tardyCntTot = 0;
    SfIntr   = 0;
+   ZcBytes  = 0;
+   ZcCopied = 0;
+   zcNext   = zcDone = 0;
+   zcPendBytes = 0;
+   zcState  = 0;
+   zcCopied = false;
+   ktlsOn   = false;
+   KtlsBytes= KtlsBytesTot = 0;
    isIdle   = 0;
    BytesOut = BytesIn = BytesOutTot = BytesInTot = 0;
    LockReads= false;
@@ -275,6 +427,11 @@ int XrdLinkXeq::Close(bool defer)
        TcpMonPin->Monitor(Addr, lnkInfo, sizeof(lnkInfo));
       }
 
+// Have the reaper wait for the kernel to finish with buffers sent without
+// copying them
+//
+   if (zcState && fd > 2) zcDrain(fd);
+
 // Close the file descriptor if it isn't being shared. Do it as the last
 // thing because closes and accepts and not interlocked.
 //
@@ -673,6 +830,35 @@ int XrdLinkXeq::Send(const struct iovec *iov, int iocnt, int bytes)
    wrMutex.UnLock();
    return iolen;
 }
+
+/******************************************************************************/
+
+int XrdLinkXeq::Send(const struct iovec *iov, int iocnt, int bytes,
+                     XrdBuffer *bP)
+{
+   int retc;
+
+// Large responses are sent without copying them into the kernel. The buffer
+// holding the data then stays with the link until the kernel is done with it.
+//
+   if (bP)
+      {wrMutex.Lock();
+       if (zcReady(bytes))
+          {isIdle = 0;
+           AtomicAdd(BytesOut, bytes);
+           retc = SendZC(iov, iocnt, bytes, bP);
+           wrMutex.UnLock();
+           return retc;
+          }
+       wrMutex.UnLock();
+      }
+
+// Otherwise, the data is copied and the buffer can be recycled right away
+//
+   retc = Send(iov, iocnt, bytes);
+   if (bP) BuffPool.Release(bP);
+   return retc;
+}
  
 /******************************************************************************/
 
@@ -871,6 +1057,106 @@ int XrdLinkXeq::SendIOV(const struct iovec *iov, int iocnt, int bytes)
    return -1;
 }
   
+/******************************************************************************/
+/* Protected:                     S e n d Z C                                 */
+/******************************************************************************/
+
+// Send data using MSG_ZEROCOPY. The kernel then references the pages of the
+// buffer instead of copying them, so the buffer is only returned to the pool
+// once the kernel posts the completions for the sends on the socket error
+// queue (see zcReap()). Only the parts of the vector that lie in the buffer
+// are sent without copying; anything else (e.g. a response header) is copied
+// as its memory is reused as soon as we return. The caller must hold the
+// wrMutex and have called zcReady(). The buffer is always taken over.
+//
+int XrdLinkXeq::SendZC(const struct iovec *iov, int iocnt, int bytes,
+                       XrdBuffer *bP)
+{
+#ifdef XRDLINK_ZEROCOPY
+   const int segMax = (maxIOV < zcMaxIOV ? maxIOV : zcMaxIOV);
+   const char *bBeg = bP->buff, *bEnd = bP->buff + bP->bsize;
+   struct iovec  iovx[zcMaxIOV];
+   struct msghdr msg;
+   ssize_t bytesleft, retc = 0;
+   unsigned int zcBeg = zcNext;
+   int segcnt, flags, rc = 0;
+   bool inBuff;
+
+// Send runs of vector elements that either all lie in the buffer or not, in
+// segments of at most segMax elements. Each segment is copied as a partial
+// send requires that we adjust the vector. Each successful zero-copy sendmsg()
+// produces one completion. When the kernel cannot pin any more memory
+// (ENOBUFS) we copy the remainder of the segment.
+//
+   memset(&msg, 0, sizeof(msg));
+   while(iocnt > 0 && retc >= 0)
+        {inBuff = (const char *)iov->iov_base >= bBeg
+               && (const char *)iov->iov_base + iov->iov_len <= bEnd;
+         bytesleft = iov->iov_len;
+         for (segcnt = 1; segcnt < iocnt && segcnt < segMax; segcnt++)
+             {if (inBuff != ((const char *)iov[segcnt].iov_base >= bBeg
+                         &&  (const char *)iov[segcnt].iov_base
+                                          + iov[segcnt].iov_len <= bEnd)) break;
+              bytesleft += iov[segcnt].iov_len;
+             }
+         memcpy(iovx, iov, segcnt*sizeof(struct iovec));
+         msg.msg_iov    = iovx;
+         msg.msg_iovlen = segcnt;
+         iov += segcnt; iocnt -= segcnt;
+         flags = (inBuff ? MSG_ZEROCOPY : 0) | (iocnt ? MSG_MORE : 0);
+
+         while(bytesleft)
+              {do {retc = sendmsg(LinkInfo.FD, &msg, flags);}
+                  while(retc < 0 && errno == EINTR);
+               if (retc < 0)
+                  {if (errno != ENOBUFS || !(flags & MSG_ZEROCOPY)) break;
+                   flags &= ~MSG_ZEROCOPY;
+                   retc = 0;
+                   continue;
+                  }
+               if (flags & MSG_ZEROCOPY) zcNext++;
+               bytesleft -= retc;
+               while(msg.msg_iovlen && retc >= (ssize_t)msg.msg_iov->iov_len)
+                    {retc -= msg.msg_iov->iov_len;
+                     msg.msg_iov++; msg.msg_iovlen--;
+                    }
+               if (retc)
+                  {msg.msg_iov->iov_base = (char *)msg.msg_iov->iov_base+retc;
+                   msg.msg_iov->iov_len -= retc;
+                  }
+              }
+        }
+   if (retc < 0) rc = errno;
+
+// If the kernel references the buffer, park it until the completion for the
+// last send arrives. Otherwise, it can be recycled right away. In either case
+// pick up any completions that have already arrived.
+//
+   zcMutex.Lock();
+   if (zcNext != zcBeg)
+      {zcPend.push_back(std::make_pair(zcNext - 1, bP));
+       zcPendBytes += bP->bsize;
+       AtomicAdd(ZcBytes, bytes);
+       bP = 0;
+      }
+   zcMutex.UnLock();
+   if (bP) BuffPool.Release(bP);
+   zcReap(LinkInfo.FD);
+
+// Diagnose any errors
+//
+   if (rc)
+      {Log.Emsg("Link", rc, "zero-copy send to", ID);
+       return -1;
+      }
+   return bytes;
+#else
+   int retc = SendIOV(iov, iocnt, bytes);
+   BuffPool.Release(bP);
+   return retc;
+#endif
+}
+  
 /******************************************************************************/
 /*                                 s e t I D                                  */
 /******************************************************************************/
@@ -976,6 +1262,7 @@ bool XrdLinkXeq::setTLS(bool enable, XrdTlsContext *ctx)
 //
    if (!enable)
       {tlsIO.Shutdown();
+       ktlsOn = false;
        isTLS = enable;
        Addr.SetTLS(enable);
        return true;
@@ -1004,7 +1291,14 @@ bool XrdLinkXeq::setTLS(bool enable, XrdTlsContext *ctx)
    if (rc != XrdTls::TLS_AOK) Log.Emsg("LinkXeq", eMsg.c_str());
       else {isTLS = enable;
             Addr.SetTLS(enable);
-            Log.Emsg("LinkXeq", ID, "connection upgraded to", verTLS());
+            if ((ktlsOn = tlsIO.isKTLS()))
+               {AtomicBeg(statsMutex);
+                AtomicInc(LinkKTLS);
+                AtomicEnd(statsMutex);
+               }
+            Log.Emsg("LinkXeq", ID, (ktlsOn ? "connection upgraded to ktls"
+                                            : "connection upgraded to"),
+                     verTLS());
            }
    return rc == XrdTls::TLS_AOK;
 }
@@ -1060,12 +1354,13 @@ int XrdLinkXeq::Stats(char *buff, int blen, bool do_sync)
    static const char statfmt[] = "<stats id=\"link\"><num>%d</num>"
           "<maxn>%d</maxn><tot>%lld</tot><in>%lld</in><out>%lld</out>"
           "<ctime>%lld</ctime><tmo>%d</tmo><stall>%d</stall>"
-          "<sfps>%d</sfps></stats>";
+          "<sfps>%d</sfps><zc>%lld</zc><zccp>%d</zccp>"
+          "<ktls>%d</ktls><ktlsb>%lld</ktlsb></stats>";
    int i;
 
 // Check if actual length wanted
 //
-   if (!buff) return sizeof(statfmt)+17*6;
+   if (!buff) return sizeof(statfmt)+17*12;
 
 // We must synchronize the statistical counters
 //
@@ -1082,7 +1377,11 @@ int XrdLinkXeq::Stats(char *buff, int blen, bool do_sync)
                                      AtomicGet(LinkConTime),
                                      AtomicGet(LinkTimeOuts),
                                      AtomicGet(LinkStalls),
-                                     AtomicGet(LinkSfIntr));
+                                     AtomicGet(LinkSfIntr),
+                                     AtomicGet(LinkZcBytes),
+                                     AtomicGet(LinkZcCopied),
+                                     AtomicGet(LinkKTLS),
+                                     AtomicGet(LinkKtlsBytes));
    AtomicEnd(statsMutex);
    return i;
 }
@@ -1133,6 +1432,12 @@ void XrdLinkXeq::syncStats(int *ctime)
    AtomicAdd(LinkBytesOut, tmpLL); AtomicAdd(BytesOutTot, tmpLL);
    tmpI4 = AtomicFAZ(SfIntr);
    AtomicAdd(LinkSfIntr, tmpI4);
+   tmpLL = AtomicFAZ(ZcBytes);
+   AtomicAdd(LinkZcBytes, tmpLL);
+   tmpI4 = AtomicFAZ(ZcCopied);
+   AtomicAdd(LinkZcCopied, tmpI4);
+   tmpLL = AtomicFAZ(KtlsBytes);
+   AtomicAdd(LinkKtlsBytes, tmpLL); AtomicAdd(KtlsBytesTot, tmpLL);
    AtomicEnd(statsMutex); AtomicEnd(wrMutex);
 
 // Make sure the protocol updates it's statistics as well
@@ -1389,8 +1694,10 @@ int XrdLinkXeq::TLS_Send(const sfVec *sfP, int sfN)
    ssize_t totamt = 0;
    char myBuff[65536];
 
-// Convert the sendfile to a regular send. The conversion is not particularly
-// fast and caller are advised to avoid using sendfile on TLS connections.
+// When the kernel does the encryption (kTLS) we can use a real sendfile.
+// Otherwise, convert the sendfile to a regular send. The conversion is not
+// particularly fast and callers are advised to avoid using sendfile on TLS
+// connections unless hasKTLS() is true.
 //
    isIdle = 0;
    for (int i = 0; i < sfN; sfP++, i++)
@@ -1400,6 +1707,10 @@ int XrdLinkXeq::TLS_Send(const sfVec *sfP, int sfN)
            {if (!TLS_Write(sfP->buffer, bytes)) return -1;
             continue;
            }
+        if (ktlsOn)
+           {if (!TLS_SendFile(sfP->fdnum, sfP->offset, bytes)) return -1;
+            continue;
+           }
         offset = sfP->offset;
         fileFD = sfP->fdnum;
         buffsz = (bytes < (int)sizeof(myBuff) ? bytes : sizeof(myBuff));
@@ -1418,6 +1729,36 @@ int XrdLinkXeq::TLS_Send(const sfVec *sfP, int sfN)
    return totamt;
 }
 
+/******************************************************************************/
+/* Protected:               T L S _ S e n d F i l e                           */
+/******************************************************************************/
+
+bool XrdLinkXeq::TLS_SendFile(int fdnum, off_t offset, int bytes)
+{
+   XrdTls::RC retc;
+   int byteswritten;
+
+// Send the data directly from the file. The kernel encrypts it.
+//
+   while(bytes > 0)
+        {retc = tlsIO.SendFile(fdnum, offset, bytes, byteswritten);
+         if (retc != XrdTls::TLS_AOK)
+            {TLS_Error("sendfile to", retc);
+             return false;
+            }
+         if (!byteswritten)
+            {SFError(ECANCELED);
+             return false;
+            }
+         bytes -= byteswritten; offset += byteswritten;
+         AtomicAdd(KtlsBytes, byteswritten);
+        }
+
+// All done
+//
+   return true;
+}
+
 /******************************************************************************/
 /* Protected:                  T L S _ W r i t e                              */
 /******************************************************************************/
@@ -1451,3 +1792,117 @@ const char *XrdLinkXeq::verTLS()
 {
    return tlsIO.Version();
 }
+
+/******************************************************************************/
+/*                                z c R e a p                                 */
+/******************************************************************************/
+
+// Reap the zero-copy completions that the kernel has posted so far, returning
+// buffers it no longer references to the buffer pool. This never waits and is
+// called after each zero-copy send and by the poller when the socket reports
+// an error event, which is how the completions are signalled.
+//
+void XrdLinkXeq::zcReap(int fd)
+{
+   zcMutex.Lock();
+   zcRecv(fd);
+   zcMutex.UnLock();
+}
+
+/******************************************************************************/
+/* Protected:                    z c D r a i n                                */
+/******************************************************************************/
+
+// Hand the buffers of zero-copy sends that have not completed yet over to the
+// reaper before the socket is closed. It keeps the socket open through a
+// duplicate descriptor, so we shut the connection down here for the peer to
+// see it end now. Pending data is still sent. Should the descriptor not be
+// duplicated, the buffers are abandoned rather than recycled, as the kernel
+// may still transmit their pages after the close.
+//
+void XrdLinkXeq::zcDrain(int fd)
+{
+#ifdef XRDLINK_ZEROCOPY
+   int dupFD;
+
+   zcMutex.Lock();
+   zcRecv(fd);
+   if (!zcPend.empty())
+      {if ((dupFD = XrdSysFD_Dup(fd)) >= 0)
+          {if (!KeepFD) shutdown(fd, SHUT_RDWR);
+           zcOrphans.Add(dupFD, zcDone, zcPend);
+          } else {
+           char buff[64];
+           snprintf(buff, sizeof(buff), "%d zero-copy buffers still in use",
+                    (int)zcPend.size());
+           Log.Emsg("Link", errno, "hand over", buff);
+           zcPend.clear();
+          }
+      }
+   zcPendBytes = 0;
+   zcMutex.UnLock();
+#endif
+}
+
+/******************************************************************************/
+/* Protected:                     z c R e c v                                 */
+/******************************************************************************/
+
+// Consume the zero-copy completions of this link and recycle the buffers they
+// cover. If the kernel reports that it had to copy the data anyway (e.g.
+// loopback or a device without scatter-gather) zero-copy is turned off for
+// this link as it only adds cost. The zcMutex must be held. Returns 0 when
+// the error queue was emptied and an errno value otherwise.
+//
+int XrdLinkXeq::zcRecv(int fd)
+{
+   bool copied = false;
+   int  rc = zcCollect(fd, zcDone, zcPend, zcPendBytes, copied);
+
+   if (copied)
+      {AtomicInc(ZcCopied);
+       zcCopied = true;
+      }
+   return rc;
+}
+
+/******************************************************************************/
+/* Protected:                    z c R e a d y                                */
+/******************************************************************************/
+
+// Determine whether a send of bytes should be done without copying. This turns
+// zero-copy on for the socket the first time around. If this fails, or the
+// kernel has been copying the data anyway, we fall back to normal sends for
+// the life of the connection. We also copy when the kernel already holds too
+// many of our buffers (i.e. the peer is slow to acknowledge data). The caller
+// must hold the wrMutex.
+//
+bool XrdLinkXeq::zcReady(int bytes)
+{
+#ifdef XRDLINK_ZEROCOPY
+   static const int setON = 1;
+   bool isOK;
+
+   if (!zcMin || bytes < zcMin || zcState < 0 || sendQ) return false;
+
+   if (!zcState)
+      {if (setsockopt(LinkInfo.FD, SOL_SOCKET, SO_ZEROCOPY,
+                      &setON, sizeof(setON)))
+          {TRACEI(NET, "zero-copy send not supported; " <<XrdSysE2T(errno));
+           zcState = -1;
+           return false;
+          }
+       zcState = 1;
+       PollInfo.zcLink = this;
+      }
+
+   zcMutex.Lock();
+   if (!zcPend.empty()) zcRecv(LinkInfo.FD);
+   if (zcCopied) zcState = -1;
+   isOK = zcState > 0 && zcPendBytes + bytes <= zcMaxPend;
+   zcMutex.UnLock();
+   return isOK;
+#else
+   return false;
+#endif
+}
@@ -32,6 +32,8 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #include <ctime>
+#include <deque>
+#include <utility>
 
 #include "Xrd/XrdLink.hh"
 #include "Xrd/XrdLinkInfo.hh"
@@ -47,6 +49,7 @@
 /*                      C l a s s   D e f i n i t i o n                       */
 /******************************************************************************/
   
+class XrdBuffer;
 class XrdSendQ;
 
 class XrdLinkXeq : protected XrdLink
@@ -74,6 +77,11 @@ void          DoIt(); // Override
                          return LinkInfo.InUse;
                         }
 
+       bool   getKTLSStats(long long &sfbytes)
+                          {sfbytes = KtlsBytes + KtlsBytesTot;
+                           return ktlsOn;
+                          }
+
 XrdTlsPeerCerts *getPeerCerts();
 
 static int    getName(int &curr, char *bname, int blen, XrdLinkMatch *who=0);
@@ -100,6 +108,8 @@ bool          Register(const char *hName);
 int           Send(const char *buff, int blen);
 int           Send(const struct iovec *iov, int iocnt, int bytes=0);
 
+int           Send(const struct iovec *iov, int iocnt, int bytes, XrdBuffer *bP);
+
 int           Send(const sfVec *sdP, int sdn); // Iff sfOK > 0
 
 void          setID(const char *userid, int procid);
@@ -136,8 +146,23 @@ int           TLS_Send(const struct iovec *iov, int iocnt, int bytes);
 
 int           TLS_Send(const sfVec *sfP, int sfN);
 
+inline
+bool          isKTLS() const {return ktlsOn;}
+
 const char   *verTLS();
 
+inline
+bool          zcOK(int bytes) const
+                  {return zcMin && bytes >= zcMin && zcState >= 0;}
+
+void          zcReap(int fd);
+
+static int    zcMin;    // Minimum send size for MSG_ZEROCOPY (0 -> off)
+
+// Buffers sent without copying, each with the id of its last send
+//
+typedef std::deque<std::pair<unsigned int, XrdBuffer *> > zcPendQ;
+
               XrdLinkXeq();
              ~XrdLinkXeq() {}  // Is never deleted!
 
@@ -150,9 +175,14 @@ int    RecvIOV(const struct iovec *iov, int iocnt);
 void   Reset();
 int    sendData(const char *Buff, int Blen);
 int    SendIOV(const struct iovec *iov, int iocnt, int bytes);
+int    SendZC(const struct iovec *iov, int iocnt, int bytes, XrdBuffer *bP);
 int    SFError(int rc);
 int    TLS_Error(const char *act, XrdTls::RC rc);
+bool   TLS_SendFile(int fdnum, off_t offset, int bytes);
 bool   TLS_Write(const char *Buff, int Blen);
+void   zcDrain(int fd);
+int    zcRecv(int fd);
+bool   zcReady(int bytes);
 
 static const char   *TraceID;
 
@@ -167,6 +197,10 @@ static int          LinkCountMax;
 static int          LinkTimeOuts;
 static int          LinkStalls;
 static int          LinkSfIntr;
+static long long    LinkZcBytes;
+static int          LinkZcCopied;
+static int          LinkKTLS;
+static long long    LinkKtlsBytes;
        long long    BytesIn;
        long long    BytesInTot;
        long long    BytesOut;
@@ -176,6 +210,10 @@ static int          LinkSfIntr;
        int          tardyCnt;
        int          tardyCntTot;
        int          SfIntr;
+       long long    ZcBytes;
+       int          ZcCopied;
+       long long    KtlsBytes;
+       long long    KtlsBytesTot;
 static XrdSysMutex  statsMutex;
 
 // Protocol section
@@ -193,9 +231,19 @@ XrdNetAddr          Addr;
 XrdSysMutex         rdMutex;
 XrdSysMutex         wrMutex;
 XrdSendQ           *sendQ;          // Protected by wrMutex && opMutex
+XrdSysMutex         zcMutex;        // Protects the zero-copy completion area
+zcPendQ             zcPend;         // Buffers awaiting completion   (zcMutex)
+long long           zcPendBytes;    // Bytes held by zcPend          (zcMutex)
+unsigned int        zcNext;         // Next zero-copy send id        (wrMutex)
+unsigned int        zcDone;         // Next id to be completed       (zcMutex)
+static const int    zcMaxIOV = 1024;
+static const int    zcMaxPend = 64*1024*1024; // Max bytes held by zcPend
+char                zcState;        // 0 untried, 1 on, -1 off       (wrMutex)
+bool                zcCopied;       // Kernel copied the data        (zcMutex)
 int                 HNlen;
 bool                LockReads;
 bool                KeepFD;
+bool                ktlsOn;          // True -> kernel TLS used for sending
 char                isIdle;
 char                Uname[24];       // Uname and Lname must be adjacent!
 char                Lname[256];
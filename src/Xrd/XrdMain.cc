@@ -216,6 +216,19 @@ int main(int argc, char *argv[])
               }
           }
 
+// Spawn a thread for each additional acceptor. These share the port of one
+// of the above networks, each with its own SO_REUSEPORT listening socket.
+//
+   for (i = 0; i < (int)Main.Config.NetAcc.size(); i++)
+       {XrdMain *Parms = new XrdMain(Main.Config.NetAcc[i]);
+        sprintf(buff, "Port %d acceptor %d", Parms->thePort, i+1);
+        if ((retc = XrdSysThread::Run(&tid, mainAccept, (void *)Parms,
+                                      XRDSYSTHREAD_BIND, strdup(buff))))
+           {Main.Config.ProtInfo.eDest->Emsg("main", retc, "create", buff);
+            _exit(3);
+           }
+       }
+
 // Finally, start accepting connections on the main port
 //
    Main.theNet  = Main.Config.NetTCP[0];
@@ -30,6 +30,10 @@
 #include <unistd.h>
 #include <cstdio>
 #include <cstdlib>
+#include <ctime>
+#ifdef __linux__
+#include <sched.h>
+#endif
   
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysFD.hh"
@@ -76,12 +80,24 @@ int           Stats(char *buff, int blen, int do_sync=0) {return 0;}
 /*                           G l o b a l   D a t a                            */
 /******************************************************************************/
   
-       XrdPoll   *XrdPoll::Pollers[XRD_NUMPOLLERS] = {0, 0, 0};
+       XrdPoll   *XrdPoll::Pollers[XRD_MAXPOLLERS] = {0};
+
+       int        XrdPoll::numPollers = 0;
+
+       bool       XrdPoll::pinPollers = false;
+
+       bool       XrdPoll::edgeTrig   = false;
 
        XrdSysMutex  XrdPoll::doingAttach;
 
        const char *XrdPoll::TraceID = "Poll";
 
+namespace
+{
+XrdSysMutex statMutex;
+time_t      statTime = 0;
+}
+
 namespace XrdGlobal
 {
 extern XrdSysError  Log;
@@ -110,6 +126,40 @@ void *XrdStartPolling(void *parg)
      PArg->Poller->Start(&(PArg->PollSync), PArg->retcode);
      return (void *)0;
 }
+
+/******************************************************************************/
+/*                             P i n P o l l e r                              */
+/******************************************************************************/
+
+// Bind the poller thread to the pnum'th cpu of the process' affinity mask so
+// that pollers are spread over the cpu's we are allowed to run on.
+//
+namespace
+{
+void PinPoller(pthread_t tid, int pnum)
+{
+#ifdef __linux__
+   cpu_set_t pSet, tSet;
+   int cpu, nCPU, rc;
+
+   if (sched_getaffinity(0, sizeof(pSet), &pSet)
+   ||  (nCPU = CPU_COUNT(&pSet)) <= 0) return;
+
+   pnum = pnum % nCPU;
+   for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+       if (CPU_ISSET(cpu, &pSet) && !pnum--) break;
+   if (cpu >= CPU_SETSIZE) return;
+
+   CPU_ZERO(&tSet); CPU_SET(cpu, &tSet);
+   if ((rc = pthread_setaffinity_np(tid, sizeof(tSet), &tSet)))
+      Log.Emsg("Poll", rc, "pin poller thread");
+#else
+   static bool warned = false;
+   if (!warned) {Log.Say("Config warning: poller pinning not supported; "
+                         "pin option ignored."); warned = true;}
+#endif
+}
+}
  
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
@@ -120,7 +170,7 @@ XrdPoll::XrdPoll()
    int fildes[2];
 
    TID=0;
-   numAttached=numEnabled=numEvents=numInterrupts=0;
+   numAttached=numEnabled=numEvents=numInterrupts=lastEvents=0;
 
    if (XrdSysFD_Pipe(fildes) == 0)
       {CmdFD = fildes[1];
@@ -153,7 +203,7 @@ int XrdPoll::Attach(XrdPollInfo &pInfo)
 // Find a poller with the smallest number of entries
 //
    pp = Pollers[0];
-   for (i = 1; i < XRD_NUMPOLLERS; i++)
+   for (i = 1; i < numPollers; i++)
        if (pp->numAttached > Pollers[i]->numAttached) pp = Pollers[i];
 
 // Include this FD into the poll set of the poller
@@ -284,6 +334,17 @@ char *XrdPoll::Poll2Text(short events)
   return (char *)0;
 }
 
+/******************************************************************************/
+/*                            s e t P o l l e r s                             */
+/******************************************************************************/
+
+void XrdPoll::setPollers(int num, bool pin, bool edge)
+{
+   numPollers = (num > XRD_MAXPOLLERS ? XRD_MAXPOLLERS : num);
+   pinPollers = pin;
+   edgeTrig   = edge;
+}
+
 /******************************************************************************/
 /*                                 S e t u p                                  */
 /******************************************************************************/
@@ -294,13 +355,25 @@ int XrdPoll::Setup(int numfd)
    int maxfd, retc, i;
    struct XrdPollArg PArg;
 
+// If the number of pollers was not configured, use one poller per four cores
+// but never less than the three we historically used nor more than 32.
+//
+   if (numPollers < 1)
+      {long nCPU = sysconf(_SC_NPROCESSORS_ONLN);
+       numPollers = static_cast<int>(nCPU / 4);
+       if (numPollers < 3) numPollers = 3;
+          else if (numPollers > 32) numPollers = 32;
+      }
+   TRACE(POLL, "Using " <<numPollers <<(edgeTrig ? " edge-triggered" : "")
+               <<" pollers" <<(pinPollers ? " pinned to cpus" : ""));
+
 // Calculate the number of table entries per poller
 //
-   maxfd  = (numfd / XRD_NUMPOLLERS) + 16;
+   maxfd  = (numfd / numPollers) + 16;
 
 // Verify that we initialized the poller table
 //
-   for (i = 0; i < XRD_NUMPOLLERS; i++)
+   for (i = 0; i < numPollers; i++)
        {if (!(Pollers[i] = newPoller(i, maxfd))) return 0;
         Pollers[i]->PID = i;
 
@@ -313,6 +386,7 @@ int XrdPoll::Setup(int numfd)
                                       XRDSYSTHREAD_BIND, "Poller")))
            {Log.Emsg("Poll", retc, "create poller thread"); return 0;}
         Pollers[i]->TID = tid;
+        if (pinPollers) PinPoller(tid, i);
         PArg.PollSync.Wait();
         if (PArg.retcode)
            {Log.Emsg("Poll", PArg.retcode, "start poller");
@@ -320,6 +394,10 @@ int XrdPoll::Setup(int numfd)
            }
        }
 
+// Establish the base time for event rates
+//
+   statTime = time(0);
+
 // All done
 //
    return 1;
@@ -332,29 +410,52 @@ int XrdPoll::Setup(int numfd)
 int XrdPoll::Stats(char *buff, int blen, int do_sync)
 {
    static const char statfmt[] = "<stats id=\"poll\"><att>%d</att>"
-   "<en>%d</en><ev>%d</ev><int>%d</int></stats>";
-   int i, numatt = 0, numen = 0, numev = 0, numint = 0;
+   "<en>%d</en><ev>%d</ev><int>%d</int><num>%d</num>";
+   static const char pollfmt[] = "<p id=\"%d\"><att>%d</att><ev>%d</ev>"
+   "<evs>%d</evs></p>";
+   static const char statend[] = "</stats>";
+   int i, n, numatt = 0, numen = 0, numev = 0, numint = 0;
+   int bl = blen, evRate[XRD_MAXPOLLERS];
    XrdPoll *pp;
 
 // Return number of bytes if so wanted
 //
-   if (!buff) return (sizeof(statfmt)+(4*16))*XRD_NUMPOLLERS;
+   if (!buff) return sizeof(statfmt) + (5*16) + sizeof(statend)
+                   + (sizeof(pollfmt)+(4*16))*numPollers;
 
 // Get statistics. While we wish we could honor do_sync, doing so would be
 // costly and hardly worth it. So, we do not include code such as:
 //    x = pp->y; if (do_sync) while(x != pp->y) x = pp->y; tot += x;
+// The per-poller event rate is the number of events per second since the
+// previous call, so we serialize callers to keep the interval consistent.
 //
-   for (i = 0; i < XRD_NUMPOLLERS; i++)
+   statMutex.Lock();
+   time_t now = time(0);
+   int    dT  = static_cast<int>(now - statTime);
+   if (dT < 1) dT = 1;
+   for (i = 0; i < numPollers; i++)
        {pp = Pollers[i];
+        int ev  = pp->numEvents;
         numatt += pp->numAttached; 
         numen  += pp->numEnabled;
-        numev  += pp->numEvents;
+        numev  += ev;
         numint += pp->numInterrupts;
+        evRate[i] = (ev - pp->lastEvents) / dT;
+        pp->lastEvents = ev;
        }
+   statTime = now;
+   statMutex.UnLock();
 
 // Format and return
 //
-   return snprintf(buff, blen, statfmt, numatt, numen, numev, numint);
+   n = snprintf(buff, bl, statfmt, numatt, numen, numev, numint, numPollers);
+   for (i = 0; i < numPollers && n < bl; i++)
+       {pp = Pollers[i];
+        n += snprintf(buff+n, bl-n, pollfmt, i, pp->numAttached,
+                      pp->lastEvents, evRate[i]);
+       }
+   if (n < bl) n += snprintf(buff+n, bl-n, statend);
+   return n;
 }
   
 /******************************************************************************/
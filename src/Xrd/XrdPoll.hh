@@ -32,7 +32,9 @@
 #include <poll.h>
 #include "XrdSys/XrdSysPthread.hh"
 
-#define XRD_NUMPOLLERS 3
+// Upper limit on the number of pollers that may be configured
+//
+#define XRD_MAXPOLLERS 64
 
 class XrdPollInfo;
 class XrdSysSemaphore;
@@ -65,6 +67,13 @@ static  int   Finish(XrdPollInfo &pInfo, const char *etxt=0); //Implementation s
 //
 static  char *Poll2Text(short events); // Implementation supplied
 
+// setPollers() is called at config time to set the number of pollers,
+//              whether or not each poller thread is pinned to a cpu, and
+//              whether links should be polled edge-triggered, if supported.
+//              A num less than 1 selects a number that scales with cores.
+//
+static  void  setPollers(int num, bool pin, bool edge=false);
+
 // Setup() is called at config time to perform poller configuration
 //
 static  int   Setup(int numfd);        // Implementation supplied
@@ -84,7 +93,10 @@ static  int   Stats(char *buff, int blen, int do_sync=0);
 
 // The following table reference the pollers in effect
 //
-static     XrdPoll   *Pollers[XRD_NUMPOLLERS];
+static     XrdPoll   *Pollers[XRD_MAXPOLLERS];
+static     int        numPollers;
+static     bool       pinPollers;
+static     bool       edgeTrig;
 
            XrdPoll();
 virtual   ~XrdPoll() {}
@@ -137,5 +149,6 @@ private:
 
 static     XrdSysMutex  doingAttach;
            int          numAttached;    // Number of fd's attached to poller
+           int          lastEvents;     // numEvents at the previous Stats()
 };
 #endif
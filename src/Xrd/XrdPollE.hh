@@ -62,9 +62,12 @@ const  char *x2Text(unsigned int evf, char *buff);
 
 private:
 int  AddWaitFd();
+int  EnableET(XrdPollInfo &pInfo);
+bool etFinish(XrdPollInfo &pInfo);
 void HandleWaitFd(const unsigned int events);
 void remFD(XrdPollInfo &pInfo, unsigned int events);
 void Wait4Poller();
+bool zcIgnore(XrdPollInfo &pInfo);
 
 #ifdef EPOLLONESHOT
    static const int ePollOneShot = EPOLLONESHOT;
@@ -73,6 +76,8 @@ void Wait4Poller();
 #endif
    static const int ePollEvents = EPOLLIN  | EPOLLHUP | EPOLLPRI | EPOLLERR |
                                   EPOLLRDHUP | ePollOneShot;
+   static const unsigned int ePollEdge = EPOLLIN  | EPOLLHUP | EPOLLPRI |
+                                         EPOLLERR | EPOLLRDHUP | EPOLLET;
 
 struct epoll_event *PollTab;
        int          PollDfd;
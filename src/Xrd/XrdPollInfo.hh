@@ -29,7 +29,10 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <cstdlib>
+
 class  XrdLink;
+class  XrdLinkXeq;
 class  XrdPoll;
 struct pollfd;
 
@@ -41,18 +44,21 @@ XrdPollInfo   *Next;        // Chain of links waiting for a PollPoll event
 XrdLink       &Link;        // Link associated with this object (always the same)
 struct pollfd *PollEnt;     // Used only by PollPoll
 XrdPoll       *Poller;      // -> Poller object associated with this object
+XrdLinkXeq    *zcLink;      // -> link reaping zero-copy completions or nil
+char          *etText;      // -> Deferred Disable() reason (PollE only) or nil
 int            FD;          // Associated target file descriptor number
 bool           inQ;         // True -> in a PollPoll event queue
 bool           isEnabled;   // True -> interrupts are enabled
-char           rsv[2];      // Reserved for future flags
+bool           etArmed;     // True -> registered edge-triggered (PollE only)
 
 void           Zorch() {Next      = 0;     PollEnt  = 0;
                         Poller    = 0;     FD       = -1;
                         isEnabled = false; inQ      = false;
-                        rsv[0]    = 0;     rsv[1]   = 0;
+                        zcLink    = 0;     etArmed  = false;
+                        if (etText) {free(etText); etText = 0;}
                        }
 
-               XrdPollInfo(XrdLink &lnk) : Link(lnk) {Zorch();}
+               XrdPollInfo(XrdLink &lnk) : Link(lnk), etText(0) {Zorch();}
               ~XrdPollInfo() {}
 };
 #endif
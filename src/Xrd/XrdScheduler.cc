@@ -27,14 +27,17 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
 #include <cerrno>
 #include <fcntl.h>
+#include <sched.h>
 #include <signal.h>
 #include <cstdio>
 #include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <ctime>
 #ifdef __APPLE__
 #include <AvailabilityMacros.h>
 #endif
@@ -42,6 +45,7 @@
 #include "Xrd/XrdJob.hh"
 #include "Xrd/XrdScheduler.hh"
 #include "XrdOuc/XrdOucTrace.hh"    // For ABI compatibility only!
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysLogger.hh"
 
@@ -67,6 +71,131 @@ class XrdSchedulerPID
                         {next = prev; pid = newpid;}
      ~XrdSchedulerPID() {}
      };
+
+/******************************************************************************/
+
+// This is a bounded Chase-Lev work stealing deque. Only the owning worker
+// pushes and pops at the bottom; any other worker may steal from the top.
+// The statistical counters are only updated by the owner.
+//
+class XrdSchedulerWSQ
+     {public:
+
+      bool    Push(XrdJob *jp)
+                  {long long b = bottom.load(std::memory_order_relaxed);
+                   long long t = top.load(std::memory_order_acquire);
+                   if (b - t >= qSize) return false;
+                   jobs[b & qMask].store(jp, std::memory_order_relaxed);
+                   std::atomic_thread_fence(std::memory_order_release);
+                   bottom.store(b+1, std::memory_order_relaxed);
+                   return true;
+                  }
+
+      XrdJob *Pop()
+                 {long long b = bottom.load(std::memory_order_relaxed) - 1;
+                  bottom.store(b, std::memory_order_relaxed);
+                  std::atomic_thread_fence(std::memory_order_seq_cst);
+                  long long t = top.load(std::memory_order_relaxed);
+                  if (t > b)
+                     {bottom.store(b+1, std::memory_order_relaxed);
+                      return 0;
+                     }
+                  XrdJob *jp = jobs[b & qMask].load(std::memory_order_relaxed);
+                  if (t == b)
+                     {if (!top.compare_exchange_strong(t, t+1,
+                                std::memory_order_seq_cst,
+                                std::memory_order_relaxed)) jp = 0;
+                      bottom.store(b+1, std::memory_order_relaxed);
+                     }
+                  return jp;
+                 }
+
+      XrdJob *Steal(bool &busy)
+                   {long long t = top.load(std::memory_order_acquire);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    long long b = bottom.load(std::memory_order_acquire);
+                    busy = false;
+                    if (t >= b) return 0;
+                    XrdJob *jp = jobs[t & qMask].load(std::memory_order_relaxed);
+                    if (!top.compare_exchange_strong(t, t+1,
+                               std::memory_order_seq_cst,
+                               std::memory_order_relaxed))
+                       {busy = true; return 0;}
+                    return jp;
+                   }
+
+      void    Count(std::atomic<long long> &ctr, long long val=1)
+                   {ctr.store(ctr.load(std::memory_order_relaxed) + val,
+                              std::memory_order_relaxed);
+                   }
+
+      std::atomic<long long> numRun;   // Jobs run by the owner
+      std::atomic<long long> numPush;  // Jobs pushed by the owner
+      std::atomic<long long> numSteal; // Jobs stolen by the owner
+      std::atomic<long long> numBusy;  // Steal attempts that lost a race
+      std::atomic<long long> latTotal; // Total queue latency (nanoseconds)
+      std::atomic<long long> latMax;   // Maximum queue latency (nanoseconds)
+      bool                   inUse;    // Slot owned by a worker (SchedMutex)
+
+      XrdSchedulerWSQ() : numRun(0), numPush(0), numSteal(0), numBusy(0),
+                          latTotal(0), latMax(0), inUse(false),
+                          top(0), bottom(0)
+                         {for (int i = 0; i < qSize; i++) jobs[i] = 0;}
+     ~XrdSchedulerWSQ() {}
+
+      private:
+      static const int       qSize = 1024;  // Must be a power of two
+      static const long long qMask = qSize-1;
+
+      alignas(64) std::atomic<long long> top;
+      alignas(64) std::atomic<long long> bottom;
+      std::atomic<XrdJob *>              jobs[qSize];
+     };
+
+/******************************************************************************/
+
+// The state used in work stealing mode. The injection queue is a lock-free
+// stack of jobs that workers grab in bulk and spread via their own deques.
+// The deque array is allocated at Start() and deques are never freed (they
+// are reused).
+//
+class XrdSchedulerWS
+     {public:
+
+      std::atomic<XrdJob *>  InjectTop;  // Jobs scheduled by non-workers
+      std::atomic<long long> num_Inject; // Number of jobs injected
+      std::atomic<long long> num_InjCas; // Failed injection attempts
+      XrdSchedulerWSQ      **wsQueue;    // Per-worker deques
+      int                    wsSlots;    // Number of slots in wsQueue
+      std::atomic<int>       wsHigh;     // Highest slot used plus one
+
+      XrdSchedulerWS() : InjectTop(0), num_Inject(0), num_InjCas(0),
+                         wsQueue(0), wsSlots(0), wsHigh(0) {}
+     ~XrdSchedulerWS() {}
+     };
+
+/******************************************************************************/
+/*                        L o c a l   F u n c t i o n s                       */
+/******************************************************************************/
+
+namespace
+{
+// Each worker in steal mode records the deque it owns. Since more than one
+// scheduler may exist, the owning scheduler is recorded as well.
+//
+thread_local XrdScheduler    *wsSched = 0;
+thread_local XrdSchedulerWSQ *wsMyQ   = 0;
+
+// Return a monotonic time in nanoseconds used for queue latency statistics.
+// It is stored in the job's SchedTime which is unused for immediate jobs.
+//
+inline long long NowNS()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<long long>(ts.tv_sec)*1000000000LL + ts.tv_nsec;
+}
+}
   
 /******************************************************************************/
 /*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
@@ -216,10 +345,15 @@ void XrdScheduler::DoIt()
 {
    int num_kill, num_idle;
 
-// Now check if there are too many idle threads (kill them if there are)
+// Now check if there are too many idle threads (kill them if there are). In
+// steal mode the idle count is maintained atomically and the queue length is
+// only known approximately; so we use the injection queue as a stand-in.
 //
-   if (!num_JobsinQ)
-      {DispatchMutex.Lock(); num_idle = idl_Workers; DispatchMutex.UnLock();
+   if (wsCtl ? !wsCtl->InjectTop.load(std::memory_order_relaxed) : !num_JobsinQ)
+      {if (wsCtl) num_idle = AtomicGet(idl_Workers);
+          else {DispatchMutex.Lock(); num_idle = idl_Workers;
+                DispatchMutex.UnLock();
+               }
        num_kill = num_idle - min_Workers;
        TRACE(SCHED, num_Workers <<" threads; " <<num_idle <<" idle");
        if (num_kill > 0)
@@ -331,6 +465,10 @@ void XrdScheduler::Run()
    int waiting;
    XrdJob *jp;
 
+// In work stealing mode we use an alternate loop
+//
+   if (wsCtl) {RunSteal(); return;}
+
 // Wait for work then do it (an endless task for a worker thread)
 //
    do {do {DispatchMutex.Lock();          idl_Workers++;DispatchMutex.UnLock();
@@ -365,6 +503,66 @@ void XrdScheduler::Run()
        jp->DoIt();
       } while(1);
 }
+
+/******************************************************************************/
+/* Private:                     R u n S t e a l                               */
+/******************************************************************************/
+
+void XrdScheduler::RunSteal()
+{
+   XrdSchedulerWSQ *myQ = wsAttach();
+   long long qlat;
+   int waiting;
+   XrdJob *jp;
+
+// Wait for work then do it. Each posted token means that a job is somewhere
+// in the system (our deque, the injection queue, or another worker's deque).
+// The job may be briefly invisible while it moves between queues. Tokens are
+// also posted to lay off idle threads.
+//
+   do {AtomicInc(idl_Workers);
+       WorkAvail.Wait();
+       waiting = AtomicDec(idl_Workers) - 1;
+       while(!(jp = wsFind(myQ)))
+            {if (AtomicGet(num_Layoffs) > 0)
+                {SchedMutex.Lock();
+                 if (num_Layoffs > 0)
+                    {num_Layoffs--;
+                     if (waiting)
+                        {num_TDestroy++; num_Workers--;
+                         TRACE(SCHED, "terminating thread; workers=" <<num_Workers);
+                         wsDetach(myQ);
+                         SchedMutex.UnLock();
+                         return;
+                        }
+                     SchedMutex.UnLock();
+                     break;
+                    }
+                 SchedMutex.UnLock();
+                }
+             sched_yield();
+            }
+       if (!jp) continue;
+
+    // Record queue latency for this job
+    //
+       if (myQ)
+          {qlat = NowNS() - static_cast<long long>(jp->SchedTime);
+           myQ->Count(myQ->numRun);
+           myQ->Count(myQ->latTotal, qlat);
+           if (qlat > myQ->latMax.load(std::memory_order_relaxed))
+              myQ->latMax.store(qlat, std::memory_order_relaxed);
+          }
+
+    // Check if we should hire a new worker (we always want 1 idle thread)
+    // before running this job.
+    //
+       if (!waiting) hireWorker();
+       if (TRACING(TRACE_SCHED) && *(jp->Comment) != '.')
+          {TRACE(SCHED, "running " <<jp->Comment <<" stolen");}
+       jp->DoIt();
+      } while(1);
+}
  
 /******************************************************************************/
 /*                              S c h e d u l e                               */
@@ -372,6 +570,18 @@ void XrdScheduler::Run()
   
 void XrdScheduler::Schedule(XrdJob *jp)
 {
+// In steal mode, a worker places the job in its own deque, otherwise the job
+// goes into the injection queue. The time it was queued is recorded for the
+// queue latency statistics.
+//
+   if (wsCtl)
+      {jp->SchedTime = static_cast<time_t>(NowNS());
+       if (wsSched == this && wsMyQ && wsMyQ->Push(jp)) wsMyQ->Count(wsMyQ->numPush);
+          else {jp->NextJob = 0; Inject(1, jp, jp);}
+       WorkAvail.Post();
+       return;
+      }
+
 // Lock down our data area
 //
    SchedMutex.Lock();
@@ -404,6 +614,17 @@ void XrdScheduler::Schedule(XrdJob *jp)
 void XrdScheduler::Schedule(int numjobs, XrdJob *jfirst, XrdJob *jlast)
 {
 
+// In steal mode the whole list goes into the injection queue at once
+//
+   if (wsCtl)
+      {time_t qTime = static_cast<time_t>(NowNS());
+       jlast->NextJob = 0;
+       for (XrdJob *jp = jfirst; jp; jp = jp->NextJob) jp->SchedTime = qTime;
+       Inject(numjobs, jfirst, jlast);
+       while(numjobs--) WorkAvail.Post();
+       return;
+      }
+
 // Lock down our data area
 //
    SchedMutex.Lock();
@@ -467,6 +688,22 @@ void XrdScheduler::Schedule(XrdJob *jp, time_t atime)
    TimerMutex.UnLock();
 }
 
+/******************************************************************************/
+/*                               s e t M o d e                                */
+/******************************************************************************/
+
+void XrdScheduler::setMode(XrdScheduler::schedMode mode)
+{
+// The mode can only be changed before the scheduler is started
+//
+   SchedMutex.Lock();
+   if (num_Workers) XrdLog->Emsg("Scheduler", "Unable to change mode after start!");
+      else if (mode == modeSteal) {if (!wsCtl) wsCtl = new XrdSchedulerWS;}
+      else if (wsCtl) {delete wsCtl; wsCtl = 0;}
+   SchedMutex.UnLock();
+   TRACE(SCHED, "Set mode=" <<(wsCtl ? "steal" : "fifo"));
+}
+
 /******************************************************************************/
 /*                               s e t N p r o c                              */
 /******************************************************************************/
@@ -601,6 +838,14 @@ void XrdScheduler::Start() // Serialized one time call!
    if (getenv("XRDDEBUG") != 0) XrdTrace->What = TRACE_SCHED;
       else if (XrdTraceOld) XrdTrace->What |= XrdTraceOld->What;
 
+// Allocate the deque slots if we will be doing work stealing. The deques
+// themselves are allocated as needed.
+//
+   if (wsCtl)
+      {wsCtl->wsSlots = max_Workers;
+       wsCtl->wsQueue = new XrdSchedulerWSQ*[wsCtl->wsSlots]();
+      }
+
 // Start a time based scheduler
 //
    if ((retc = XrdSysThread::Run(&tid, XrdStartTSched, (void *)this,
@@ -629,15 +874,51 @@ int XrdScheduler::Stats(char *buff, int blen, int do_sync)
 {
     int cnt_Jobs, cnt_JobsinQ, xam_QLength, cnt_Workers, cnt_idl;
     int cnt_TCreate, cnt_TDestroy, cnt_Limited;
+    long long cnt_Contend = 0, cnt_Steals = 0, sum_Lat = 0, cnt_Lat = 0;
+    long long xam_Lat = 0;
     static char statfmt[] = "<stats id=\"sched\"><jobs>%d</jobs>"
                 "<inq>%d</inq><maxinq>%d</maxinq>"
                 "<threads>%d</threads><idle>%d</idle>"
                 "<tcr>%d</tcr><tde>%d</tde>"
-                "<tlimr>%d</tlimr></stats>";
+                "<tlimr>%d</tlimr><mode>%s</mode><cont>%lld</cont>"
+                "<steals>%lld</steals><qlat>%lld</qlat>"
+                "<qlatmax>%lld</qlatmax></stats>";
 
 // If only length wanted, do so
 //
-   if (!buff) return sizeof(statfmt) + 16*8;
+   if (!buff) return sizeof(statfmt) + 16*8 + 24*4;
+
+// In steal mode, counters are kept by each worker and must be summed. This is
+// done without locks so the result is only approximate. In fifo mode the
+// contention and latency figures are not collected (they would add work to
+// the shared queue) and are reported as zero.
+//
+   if (wsCtl)
+      {long long cnt_Push = 0, cnt_Run = 0;
+       int inq;
+       cnt_Contend = wsCtl->num_InjCas.load(std::memory_order_relaxed);
+       int n = wsCtl->wsHigh.load(std::memory_order_acquire);
+       for (int i = 0; i < n; i++)
+           {XrdSchedulerWSQ *wq = wsCtl->wsQueue[i];
+            if (!wq) continue;
+            cnt_Push    += wq->numPush.load(std::memory_order_relaxed);
+            cnt_Run     += wq->numRun.load(std::memory_order_relaxed);
+            cnt_Steals  += wq->numSteal.load(std::memory_order_relaxed);
+            cnt_Contend += wq->numBusy.load(std::memory_order_relaxed);
+            sum_Lat     += wq->latTotal.load(std::memory_order_relaxed);
+            long long qlat = wq->latMax.load(std::memory_order_relaxed);
+            if (qlat > xam_Lat) xam_Lat = qlat;
+           }
+       cnt_Push += wsCtl->num_Inject.load(std::memory_order_relaxed);
+       inq = static_cast<int>(cnt_Push - cnt_Run);
+       if (inq < 0) inq = 0;
+       SchedMutex.Lock();
+       num_Jobs    = static_cast<int>(cnt_Push);
+       num_JobsinQ = inq;
+       if (inq > max_QLength) max_QLength = inq;
+       SchedMutex.UnLock();
+       cnt_Lat = cnt_Run;
+      }
 
 // Get values protected by the Dispatch lock (avoid lock if no sync needed)
 //
@@ -657,11 +938,13 @@ int XrdScheduler::Stats(char *buff, int blen, int do_sync)
    cnt_Limited = num_Limited;
    if (do_sync) SchedMutex.UnLock();
 
-// Format the stats and return them
+// Format the stats and return them (latencies are in microseconds)
 //
    return snprintf(buff, blen, statfmt, cnt_Jobs, cnt_JobsinQ, xam_QLength,
                    cnt_Workers, cnt_idl, cnt_TCreate, cnt_TDestroy,
-                   cnt_Limited);
+                   cnt_Limited, (wsCtl ? "steal" : "fifo"), cnt_Contend,
+                   cnt_Steals, (cnt_Lat ? sum_Lat/cnt_Lat/1000 : 0LL),
+                   xam_Lat/1000);
 }
 
 /******************************************************************************/
@@ -756,6 +1039,121 @@ void XrdScheduler::Init(int minw, int maxw, int maxi)
    num_Limited =  0;
    firstPID    =  0;
    WorkFirst = WorkLast = TimerQueue = 0;
+   wsCtl       =  0;
+}
+
+/******************************************************************************/
+/*                                I n j e c t                                 */
+/******************************************************************************/
+
+// Place a list of jobs on the lock-free injection stack. The list must be
+// terminated, i.e. jlast->NextJob must be zero on entry.
+//
+void XrdScheduler::Inject(int numjobs, XrdJob *jfirst, XrdJob *jlast)
+{
+   XrdJob *oldTop = wsCtl->InjectTop.load(std::memory_order_relaxed);
+
+   do {jlast->NextJob = oldTop;
+       if (wsCtl->InjectTop.compare_exchange_weak(oldTop, jfirst,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) break;
+       wsCtl->num_InjCas.fetch_add(1, std::memory_order_relaxed);
+      } while(true);
+   wsCtl->num_Inject.fetch_add(numjobs, std::memory_order_relaxed);
+}
+
+/******************************************************************************/
+/*                              w s A t t a c h                               */
+/******************************************************************************/
+
+XrdSchedulerWSQ *XrdScheduler::wsAttach()
+{
+   XrdSchedulerWSQ *myQ = 0;
+   int i, n;
+
+// Find a free slot (this happens only when a worker is created)
+//
+   SchedMutex.Lock();
+   for (i = 0; i < wsCtl->wsSlots; i++)
+       if (!wsCtl->wsQueue[i] || !wsCtl->wsQueue[i]->inUse) break;
+
+// If there are no free slots, this worker only uses the injection queue
+//
+   if (i < wsCtl->wsSlots)
+      {if (!wsCtl->wsQueue[i]) wsCtl->wsQueue[i] = new XrdSchedulerWSQ;
+       myQ = wsCtl->wsQueue[i];
+       myQ->inUse = true;
+       n = wsCtl->wsHigh.load(std::memory_order_relaxed);
+       if (i >= n) wsCtl->wsHigh.store(i+1, std::memory_order_release);
+      }
+   SchedMutex.UnLock();
+
+// Record our deque for use by Schedule()
+//
+   wsSched = this;
+   wsMyQ   = myQ;
+   return myQ;
+}
+
+/******************************************************************************/
+/*                              w s D e t a c h                               */
+/******************************************************************************/
+
+// This must be called with the SchedMutex held. The deque is empty as the
+// owner only detaches after failing to find any work in it.
+//
+void XrdScheduler::wsDetach(XrdSchedulerWSQ *myQ)
+{
+   if (myQ) myQ->inUse = false;
+   wsSched = 0;
+   wsMyQ   = 0;
+}
+
+/******************************************************************************/
+/*                                w s F i n d                                 */
+/******************************************************************************/
+
+XrdJob *XrdScheduler::wsFind(XrdSchedulerWSQ *myQ)
+{
+   XrdJob *jp, *jnext;
+   bool busy;
+   int i, k, n;
+
+// First look in our own deque
+//
+   if (myQ && (jp = myQ->Pop())) return jp;
+
+// Next, grab everything in the injection queue. The stack is in LIFO order
+// so the last element is the oldest and that is the one we run. The rest are
+// pushed, newest first, onto our deque so that we pop them oldest first and
+// other workers can steal them. Anything that does not fit is put back.
+//
+   if ((jp = wsCtl->InjectTop.exchange(0, std::memory_order_acquire)))
+      {while((jnext = jp->NextJob))
+            {if (!myQ || !myQ->Push(jp))
+                {jp->NextJob = 0;
+                 Inject(0, jp, jp);
+                }
+             jp = jnext;
+            }
+       return jp;
+      }
+
+// Finally, try to steal work from another worker. Each thread starts at a
+// different spot (derived from its stack address) to spread out the probes.
+//
+   if (!(n = wsCtl->wsHigh.load(std::memory_order_acquire))) return 0;
+   k = static_cast<int>((reinterpret_cast<uintptr_t>(&busy) >> 6) % n);
+   for (i = 0; i < n; i++, k = (k+1 < n ? k+1 : 0))
+       {XrdSchedulerWSQ *wq = wsCtl->wsQueue[k];
+        if (!wq || wq == myQ) continue;
+        if ((jp = wq->Steal(busy)))
+           {if (myQ) myQ->Count(myQ->numSteal);
+            return jp;
+           }
+        if (busy && myQ) myQ->Count(myQ->numBusy);
+       }
+   return 0;
 }
 
 /******************************************************************************/
@@ -37,6 +37,8 @@
 
 class XrdOucTrace;
 class XrdSchedulerPID;
+class XrdSchedulerWS;
+class XrdSchedulerWSQ;
 class XrdSysError;
 class XrdSysTrace;
 
@@ -66,6 +68,14 @@ void          Schedule(XrdJob *jp);
 void          Schedule(int num, XrdJob *jfirst, XrdJob *jlast);
 void          Schedule(XrdJob *jp, time_t atime);
 
+// Scheduling modes: fifo  - a single queue shared by all workers (default).
+//                   steal - per-worker deques with work stealing and a
+//                           lock-free global injection queue.
+//
+enum          schedMode {modeFifo = 0, modeSteal = 1};
+
+void          setMode(schedMode mode); // Must be called prior to Start()
+
 void          setParms(int minw, int maxw, int avlt, int maxi, int once=0);
 
 void          Start();
@@ -130,11 +140,21 @@ XrdSysMutex            TimerMutex; // Protects scheduler area
 XrdSchedulerPID       *firstPID;
 XrdSysMutex            ReaperMutex;
 
+// Work stealing state, allocated by setMode(), is kept out of line so that
+// the class layout only grows by a pointer at its end (nil in fifo mode).
+//
+XrdSchedulerWS        *wsCtl;      // Steal: Injection queue and deques
+
 void Boot(XrdSysError *eP, XrdSysTrace *tP, int minw, int maxw, int maxi);
 void hireWorker(int dotrace=1);
 void Init(int minw, int maxw, int maxi);
+void Inject(int numjobs, XrdJob *jfirst, XrdJob *jlast);
 void Monitor();
+void RunSteal();
 void traceExit(pid_t pid, int status);
+XrdJob          *wsFind(XrdSchedulerWSQ *myQ);
+XrdSchedulerWSQ *wsAttach();
+void             wsDetach(XrdSchedulerWSQ *myQ);
 static const char *TraceID;
 };
 #endif
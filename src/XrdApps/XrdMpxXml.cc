@@ -69,6 +69,9 @@ std::map<const char *, const char *, vCmp> vnMap {
 {"buff.mem",        "Buffer bytes:"},
 {"buff.buffs",      "Buffer count:"},
 {"buff.adj",        "Buffer adjustments:"},
+{"buff.tlhit",      "Buffer thread cache hits:"},
+{"buff.tlmiss",     "Buffer thread cache misses:"},
+{"buff.tlxfr",      "Buffer cross-thread releases:"},
 {"buff.xlreqs",     "Buffer XL requests:"},
 {"buff.xlmem",      "Buffer XL bytes:"},
 {"buff.xlbuffs",    "Buffer XL count:"},
@@ -81,6 +84,10 @@ std::map<const char *, const char *, vCmp> vnMap {
 {"link.tmo",        "Read request timeouts:"},
 {"link.stall",      "Number of partial reads:"},
 {"link.sfps",       "Number of partial sends:"},
+{"link.zc",         "Bytes sent zero-copy:"},
+{"link.zccp",       "Zero-copy sends copied:"},
+{"link.ktls",       "Kernel TLS connections:"},
+{"link.ktlsb",      "Bytes sent by kernel TLS sendfile:"},
 {"poll.att",        "Poll sockets:"},
 {"poll.en",         "Poll enables:"},
 {"poll.ev",         "Poll events: "},
@@ -141,6 +148,11 @@ std::map<const char *, const char *, vCmp> vnMap {
 {"sched.tcr",       "Threads created:"},
 {"sched.tde",       "Threads deleted:"},
 {"sched.tlimr",     "Threads unavail:"},
+{"sched.mode",      "Scheduling mode:"},
+{"sched.cont",      "Queue contention:"},
+{"sched.steals",    "Tasks stolen:   "},
+{"sched.qlat",      "Avg queue usecs:"},
+{"sched.qlatmax",   "Max queue usecs:"},
 {"sgen.as",         "Unsynchronized stats:"},
 {"sgen.et",         "Mills to collect stats:"},
 {"sgen.toe",        "~Time when stats collected:"},
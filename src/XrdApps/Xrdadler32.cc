@@ -46,12 +46,12 @@
 #if defined(__linux__) || defined(__GNU__) || (defined(__FreeBSD_kernel__) && defined(__GLIBC__))
   #include <sys/xattr.h>
 #endif
-#include <zlib.h>
 
 #include "XrdPosix/XrdPosixXrootd.hh"
 #include "XrdPosix/XrdPosixXrootdPath.hh"
 #include "XrdOuc/XrdOucString.hh"
 
+#include "XrdCks/XrdCksKernels.hh"
 #include "XrdCks/XrdCksXAttr.hh"
 #include "XrdOuc/XrdOucXAttr.hh"
 
@@ -165,8 +165,7 @@ int main(int argc, char *argv[])
     const char attr[] = "user.checksum.adler32";
     struct stat stbuf;
     int fd, len, rc;
-    uLong adler;
-    adler = adler32(0L, Z_NULL, 0);
+    uint32_t adler = 1;
 
     if (argc == 2 && ! strcmp(argv[1], "-h"))
     {
@@ -209,15 +208,15 @@ int main(int argc, char *argv[])
             strcpy(path, "-");
         }
         while ( (len = read(fd, buf, N)) > 0 )
-            adler = adler32(adler, (const Bytef*)buf, len);
+            adler = XrdCksKernels::Adler32(adler, buf, len);
 
         if (fd != STDIN_FILENO) 
         {   /* try saving adler32 to attribute before close() */
-            sprintf(adler_str, "%08lx", adler);
+            sprintf(adler_str, "%08x", adler);
             fSetXattrAdler32(path, fd, attr, adler_str);
             close(fd);
         }
-        printf("%08lx %s\n", adler, path);
+        printf("%08x %s\n", adler, path);
         return 0;
     }
     else
@@ -241,14 +240,13 @@ int main(int argc, char *argv[])
             off_t totbytes = 0;
             while ( totbytes < stbuf.st_size && (len = XrdPosixXrootd::Read(fd, buf, N)) > 0 )
             {
-                adler = adler32(adler, 
-                                (const Bytef*)buf, 
+                adler = XrdCksKernels::Adler32(adler, buf,
                                 (len < (stbuf.st_size - totbytes)? len : stbuf.st_size - totbytes ));
                 totbytes += len;
             }
 
             XrdPosixXrootd::Close(fd);
-            printf("%08lx %s\n", adler, argv[1]);
+            printf("%08x %s\n", adler, argv[1]);
             return 0;
         }
     }
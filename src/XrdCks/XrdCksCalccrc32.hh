@@ -36,12 +36,21 @@
 #include <cinttypes>
 
 #include "XrdCks/XrdCksCalc.hh"
+#include "XrdCks/XrdCksKernels.hh"
 #include "XrdSys/XrdSysPlatform.hh"
   
 class XrdCksCalccrc32 : public XrdCksCalc
 {
 public:
 
+//! Merge in the checksum of the data that immediately follows ours.
+//
+void  Combine(const XrdCksCalccrc32 &next, long long nextLen)
+             {C32Result = XrdCksKernels::CRC32Combine(C32Result,
+                                         next.C32Result, nextLen);
+              TotLen += next.TotLen;
+             }
+
 char *Final() {char buff[sizeof(long long)];
                long long tLcs = TotLen;
                int i = 0;
@@ -70,7 +79,6 @@ virtual    ~XrdCksCalccrc32() {}
 private:
 static const unsigned int CRC32_XINIT = 0;
 static const unsigned int CRC32_XOROT = 0xffffffff;
-static       unsigned int crctable[256];
              unsigned int C32Result;
              unsigned int TheResult;
              long long    TotLen;
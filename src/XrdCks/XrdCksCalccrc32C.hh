@@ -38,10 +38,17 @@
 #include "XrdCks/XrdCksCalc.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdOuc/XrdOucCRC.hh"
+#include "XrdCks/XrdCksKernels.hh"
 
 class XrdCksCalccrc32C : public XrdCksCalc
 {
 public:
+    // Merge in the checksum of the data that immediately follows ours.
+    void Combine(const XrdCksCalccrc32C &next, long long nextLen)
+                {C32CResult = XrdCksKernels::CRC32CCombine(C32CResult,
+                                             next.C32CResult, nextLen);
+                }
+
     char *Final();
     
     void Init();
@@ -43,6 +43,7 @@
 #include "XrdCks/XrdCksManager.hh"
 #include "XrdCks/XrdCksManOss.hh"
 #include "XrdCks/XrdCksWrapper.hh"
+#include "XrdOuc/XrdOuca2x.hh"
 #include "XrdOuc/XrdOucPinLoader.hh"
 #include "XrdOuc/XrdOucStream.hh"
 #include "XrdOuc/XrdOucUtils.hh"
@@ -58,7 +59,7 @@ XrdCksConfig::XrdCksConfig(const char *cFN, XrdSysError *Eroute, int &aOK,
                            XrdVersionInfo &vInfo)
                           : eDest(Eroute), cfgFN(cFN), CksLib(0), CksParm(0),
                             CksList(0), CksLast(0), LibList(0), LibLast(0),
-                            myVersion(vInfo), CKSopts(0)
+                            myVersion(vInfo), CKSopts(0), CKSthreads(0)
 {
    static XrdVERSIONINFODEF(myVer, XrdCks, XrdVNUMBER, XrdVERSION);
 
@@ -159,6 +160,7 @@ XrdCks *XrdCksConfig::getCks(XrdOss *ossP, int rdsz)
        if (ossP) manP = new XrdCksManOss (ossP,eDest,rdsz,myVersion);
           else   manP = new XrdCksManager(     eDest,rdsz,myVersion);
        manP->SetOpts(CKSopts);
+       if (CKSthreads) manP->SetThreads(CKSthreads);
        return manP;
       }
 
@@ -306,6 +308,12 @@ int XrdCksConfig::ParseLib(XrdOucStream &Config, int &libType)
 
    Purpose:  To parse the paramneters for the default manager plugin
 
+             [nomtchk] [threads <num>]
+
+             nomtchk   do not check the file modification time.
+             threads   the maximum number of threads used to compute a
+                       checksum of a large file when it can be done in
+                       pieces (adler32, crc32, crc32c). The default is 4.
 
    Output: true upon success or false upon failure.
 */
@@ -313,11 +321,22 @@ int XrdCksConfig::ParseLib(XrdOucStream &Config, int &libType)
 bool XrdCksConfig::ParseOpt(XrdOucStream &Config)
 {
    char* val = Config.GetWord();
+   int num;
 
 // Get the next word, if any
 //
    while(val)
         {if (!strcmp(val, "nomtchk")) CKSopts |= XrdCksManager::Cks_nomtchk;
+            else if (!strcmp(val, "threads"))
+                    {if (!(val = Config.GetWord()) || !*val)
+                        {eDest->Emsg("Config","ckslib threads value not "
+                                              "specified");
+                         return false;
+                        }
+                     if (XrdOuca2x::a2i(*eDest,"ckslib threads",val,&num,1,64))
+                        return false;
+                     CKSthreads = num;
+                    }
             else break;
          val = Config.GetWord();
         }
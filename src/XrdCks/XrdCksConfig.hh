@@ -81,5 +81,6 @@ XrdOucTList    *LibList;
 XrdOucTList    *LibLast;
 XrdVersionInfo &myVersion;
 int            CKSopts;
+int            CKSthreads;
 };
 #endif
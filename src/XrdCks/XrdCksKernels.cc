@@ -0,0 +1,705 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C k s K e r n e l s . c c                       */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstring>
+
+#include "XrdCks/XrdCksKernels.hh"
+#include "XrdOuc/XrdOucCRC32C.hh"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define XRDCKS_X86 1
+#include <immintrin.h>
+#if defined(__clang__) || __GNUC__ >= 9
+#define XRDCKS_VPCLMUL 1
+#endif
+#endif
+
+/******************************************************************************/
+/*                       A d l e r 3 2   K e r n e l s                        */
+/******************************************************************************/
+
+/* The portable implementation of adler32 was derived from zlib and is
+                   * Copyright (C) 1995-1998 Mark Adler
+   Below are the zlib license terms for this implementation.
+*/
+
+/* zlib.h -- interface of the 'zlib' general purpose compression library
+  version 1.1.4, March 11th, 2002
+
+  Copyright (C) 1995-2002 Jean-loup Gailly and Mark Adler
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Jean-loup Gailly        Mark Adler
+  jloup@gzip.org          madler@alumni.caltech.edu
+*/
+
+namespace
+{
+const uint32_t AdlerBase  = 0xFFF1;
+const int      AdlerNMax  = 5552;
+
+/* NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
+
+#define DO1(buf)  {unSum1 += *buf++; unSum2 += unSum1;}
+#define DO2(buf)  DO1(buf); DO1(buf);
+#define DO4(buf)  DO2(buf); DO2(buf);
+#define DO8(buf)  DO4(buf); DO4(buf);
+#define DO16(buf) DO8(buf); DO8(buf);
+
+uint32_t adler32_generic(uint32_t cs, const void *data, size_t count)
+{
+   const unsigned char *buff = (const unsigned char *)data;
+   uint32_t unSum1 = cs & 0xffff, unSum2 = cs >> 16;
+   int k;
+
+   while(count > 0)
+        {k = (count < (size_t)AdlerNMax ? (int)count : AdlerNMax);
+         count -= k;
+         while(k >= 16) {DO16(buff); k -= 16;}
+         if (k != 0) do {DO1(buff);} while (--k);
+         unSum1 %= AdlerBase; unSum2 %= AdlerBase;
+        }
+   return (unSum2 << 16) | unSum1;
+}
+
+#undef DO1
+#undef DO2
+#undef DO4
+#undef DO8
+#undef DO16
+
+#ifdef XRDCKS_X86
+
+/* The vector kernels handle blocks of 32 (or 64) bytes at a time. For each
+   block the byte sum is added to s1 while s2 receives the bytes weighted by
+   their distance from the end of the block (taps 32..1) plus 32 times the
+   value s1 had at the start of the block. The latter is accumulated in v_ps
+   and scaled once per run. Runs are limited so that no lane can overflow
+   before the sums are reduced modulo AdlerBase. Any tail is handed off to
+   the portable implementation.
+*/
+
+inline uint32_t hsum128(__m128i v)
+{
+   v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1,0,3,2)));
+   v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2,3,0,1)));
+   return (uint32_t)_mm_cvtsi128_si32(v);
+}
+
+__attribute__((target("ssse3")))
+uint32_t adler32_ssse3(uint32_t cs, const void *data, size_t count)
+{
+   const unsigned char *buff = (const unsigned char *)data;
+   const __m128i tap1 = _mm_setr_epi8(32,31,30,29,28,27,26,25,
+                                      24,23,22,21,20,19,18,17);
+   const __m128i tap2 = _mm_setr_epi8(16,15,14,13,12,11,10, 9,
+                                       8, 7, 6, 5, 4, 3, 2, 1);
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i ones = _mm_set1_epi16(1);
+   uint32_t s1 = cs & 0xffff, s2 = cs >> 16;
+   size_t blocks = count / 32, n;
+
+   count -= blocks * 32;
+   while(blocks)
+        {n = (blocks < (size_t)AdlerNMax/32 ? blocks : AdlerNMax/32);
+         blocks -= n;
+         __m128i v_ps = _mm_setr_epi32(s1 * n, 0, 0, 0);
+         __m128i v_s2 = _mm_setr_epi32(s2, 0, 0, 0);
+         __m128i v_s1 = zero;
+         do {const __m128i b1 = _mm_loadu_si128((const __m128i *)buff);
+             const __m128i b2 = _mm_loadu_si128((const __m128i *)(buff+16));
+             v_ps = _mm_add_epi32(v_ps, v_s1);
+             v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(b1, zero));
+             v_s2 = _mm_add_epi32(v_s2,
+                    _mm_madd_epi16(_mm_maddubs_epi16(b1, tap1), ones));
+             v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(b2, zero));
+             v_s2 = _mm_add_epi32(v_s2,
+                    _mm_madd_epi16(_mm_maddubs_epi16(b2, tap2), ones));
+             buff += 32;
+            } while(--n);
+         v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+         s1 = (s1 + hsum128(v_s1)) % AdlerBase;
+         s2 = hsum128(v_s2) % AdlerBase;
+        }
+
+   cs = (s2 << 16) | s1;
+   return (count ? adler32_generic(cs, buff, count) : cs);
+}
+
+__attribute__((target("avx2")))
+uint32_t adler32_avx2(uint32_t cs, const void *data, size_t count)
+{
+   const unsigned char *buff = (const unsigned char *)data;
+   const __m256i tap  = _mm256_setr_epi8(32,31,30,29,28,27,26,25,
+                                         24,23,22,21,20,19,18,17,
+                                         16,15,14,13,12,11,10, 9,
+                                          8, 7, 6, 5, 4, 3, 2, 1);
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i ones = _mm256_set1_epi16(1);
+   uint32_t s1 = cs & 0xffff, s2 = cs >> 16;
+   size_t blocks = count / 32, n;
+
+   count -= blocks * 32;
+   while(blocks)
+        {n = (blocks < (size_t)AdlerNMax/32 ? blocks : AdlerNMax/32);
+         blocks -= n;
+         __m256i v_ps = _mm256_setr_epi32(s1 * n, 0, 0, 0, 0, 0, 0, 0);
+         __m256i v_s2 = _mm256_setr_epi32(s2, 0, 0, 0, 0, 0, 0, 0);
+         __m256i v_s1 = zero;
+         do {const __m256i b = _mm256_loadu_si256((const __m256i *)buff);
+             v_ps = _mm256_add_epi32(v_ps, v_s1);
+             v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(b, zero));
+             v_s2 = _mm256_add_epi32(v_s2,
+                    _mm256_madd_epi16(_mm256_maddubs_epi16(b, tap), ones));
+             buff += 32;
+            } while(--n);
+         v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+         s1 = (s1 + hsum128(_mm_add_epi32(_mm256_castsi256_si128(v_s1),
+                            _mm256_extracti128_si256(v_s1, 1)))) % AdlerBase;
+         s2 =       hsum128(_mm_add_epi32(_mm256_castsi256_si128(v_s2),
+                            _mm256_extracti128_si256(v_s2, 1)))  % AdlerBase;
+        }
+
+   cs = (s2 << 16) | s1;
+   return (count ? adler32_generic(cs, buff, count) : cs);
+}
+
+// Many unmasked avx512 intrinsics start from a deliberately undefined vector,
+// which gcc reports as possibly uninitialized. Here and in the crc32 kernel
+// we use the zero-masking forms with all lanes selected instead, they do the
+// same thing starting from zero.
+//
+__attribute__((target("avx512f")))
+inline uint32_t hsum512(__m512i v)
+{
+   __m256i s = _mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xff, v, 0),
+                                _mm512_maskz_extracti64x4_epi64(0xff, v, 1));
+   return hsum128(_mm_add_epi32(_mm256_castsi256_si128(s),
+                                _mm256_extracti128_si256(s, 1)));
+}
+
+__attribute__((target("avx512f,avx512bw")))
+uint32_t adler32_avx512(uint32_t cs, const void *data, size_t count)
+{
+   static const signed char taps[64] =
+          {64,63,62,61,60,59,58,57,56,55,54,53,52,51,50,49,
+           48,47,46,45,44,43,42,41,40,39,38,37,36,35,34,33,
+           32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,
+           16,15,14,13,12,11,10, 9, 8, 7, 6, 5, 4, 3, 2, 1};
+   const unsigned char *buff = (const unsigned char *)data;
+   const __m512i tap  = _mm512_loadu_si512((const void *)taps);
+   const __m512i zero = _mm512_setzero_si512();
+   const __m512i ones = _mm512_set1_epi16(1);
+   uint32_t s1 = cs & 0xffff, s2 = cs >> 16;
+   size_t blocks = count / 64, n;
+
+   count -= blocks * 64;
+   while(blocks)
+        {n = (blocks < (size_t)AdlerNMax/64 ? blocks : AdlerNMax/64);
+         blocks -= n;
+         __m512i v_ps = _mm512_zextsi128_si512(_mm_cvtsi32_si128(s1 * n));
+         __m512i v_s2 = _mm512_zextsi128_si512(_mm_cvtsi32_si128(s2));
+         __m512i v_s1 = zero;
+         do {const __m512i b = _mm512_loadu_si512((const void *)buff);
+             v_ps = _mm512_add_epi32(v_ps, v_s1);
+             v_s1 = _mm512_add_epi32(v_s1, _mm512_sad_epu8(b, zero));
+             v_s2 = _mm512_add_epi32(v_s2,
+                    _mm512_madd_epi16(_mm512_maddubs_epi16(b, tap), ones));
+             buff += 64;
+            } while(--n);
+         v_s2 = _mm512_add_epi32(v_s2,
+                _mm512_maskz_slli_epi32(0xffff, v_ps, 6));
+         s1 = (s1 + hsum512(v_s1)) % AdlerBase;
+         s2 =       hsum512(v_s2)  % AdlerBase;
+        }
+
+   cs = (s2 << 16) | s1;
+   return (count ? adler32_generic(cs, buff, count) : cs);
+}
+#endif
+}
+
+/******************************************************************************/
+/*                         C R C 3 2   K e r n e l s                          */
+/******************************************************************************/
+
+/* This is the Posix 1003.2 crc (non-reflected, polynomial 0x04C11DB7). The
+   length bits and final inversion are applied by the caller. The portable
+   implementation uses slicing-by-8 tables generated at compile time. The
+   vector implementations fold 128 bit blocks using carry-less multiplication
+   by x^n mod P and finish the last block and any tail with the tables.
+*/
+
+namespace
+{
+const uint32_t CrcPoly = 0x04C11DB7;
+
+struct CrcTables
+      {uint32_t T[8][256];
+
+       constexpr CrcTables() : T()
+                 {for (int i = 0; i < 256; i++)
+                      {uint32_t c = (uint32_t)i << 24;
+                       for (int j = 0; j < 8; j++)
+                           c = (c & 0x80000000 ? (c << 1) ^ CrcPoly : c << 1);
+                       T[0][i] = c;
+                      }
+                  for (int k = 1; k < 8; k++)
+                      for (int i = 0; i < 256; i++)
+                          T[k][i] = (T[k-1][i] << 8) ^ T[0][T[k-1][i] >> 24];
+                 }
+      };
+
+constexpr CrcTables crcTab;
+
+uint32_t crc32_slice8(uint32_t crc, const void *data, size_t count)
+{
+   const unsigned char *p = (const unsigned char *)data;
+   const uint32_t (*T)[256] = crcTab.T;
+
+   while(count >= 8)
+        {crc ^= ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)
+              | ((uint32_t)p[2] <<  8) |  (uint32_t)p[3];
+         crc  = T[7][crc >> 24] ^ T[6][(crc >> 16) & 0xff]
+              ^ T[5][(crc >> 8) & 0xff] ^ T[4][crc & 0xff]
+              ^ T[3][p[4]] ^ T[2][p[5]] ^ T[1][p[6]] ^ T[0][p[7]];
+         p += 8; count -= 8;
+        }
+   while(count--) crc = (crc << 8) ^ T[0][(crc >> 24) ^ *p++];
+   return crc;
+}
+
+#ifdef XRDCKS_X86
+
+// Return x^n mod P
+//
+constexpr uint64_t xmodp(int n)
+{
+   uint32_t r = 1;
+   while(n--) r = (r & 0x80000000 ? (r << 1) ^ CrcPoly : r << 1);
+   return r;
+}
+
+// Folding a 128 bit block forward by n bits multiplies its low half by
+// x^n mod P and its high half by x^(n+64) mod P.
+//
+#define XRDCKS_FOLDK(n) (long long)xmodp(n+64), (long long)xmodp(n)
+
+__attribute__((target("pclmul,sse4.1")))
+inline __m128i fold128(__m128i a, __m128i k, __m128i b)
+{
+   return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(a, k, 0x00),
+                                      _mm_clmulepi64_si128(a, k, 0x11)), b);
+}
+
+__attribute__((target("pclmul,sse4.1")))
+uint32_t crc32_finish(__m128i x, __m128i bswap, uint32_t crc,
+                      const unsigned char *p, size_t count)
+{
+   const __m128i k128 = _mm_set_epi64x(XRDCKS_FOLDK(128));
+   alignas(16) unsigned char last[16];
+
+   while(count >= 16)
+        {x = fold128(x, k128, _mm_shuffle_epi8(
+                     _mm_loadu_si128((const __m128i *)p), bswap));
+         p += 16; count -= 16;
+        }
+   _mm_store_si128((__m128i *)last, _mm_shuffle_epi8(x, bswap));
+   crc = crc32_slice8(0, last, sizeof(last));
+   return (count ? crc32_slice8(crc, p, count) : crc);
+}
+
+__attribute__((target("pclmul,sse4.1")))
+uint32_t crc32_pclmul(uint32_t crc, const void *data, size_t count)
+{
+   const unsigned char *p = (const unsigned char *)data;
+   const __m128i bswap = _mm_setr_epi8(15,14,13,12,11,10, 9, 8,
+                                        7, 6, 5, 4, 3, 2, 1, 0);
+   const __m128i k512  = _mm_set_epi64x(XRDCKS_FOLDK(512));
+   const __m128i k128  = _mm_set_epi64x(XRDCKS_FOLDK(128));
+   __m128i x0, x1, x2, x3;
+
+   if (count < 64) return crc32_slice8(crc, data, count);
+
+// Load the first 64 bytes and merge in the running crc
+//
+   x0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p +  0)), bswap);
+   x1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 16)), bswap);
+   x2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 32)), bswap);
+   x3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 48)), bswap);
+   x0 = _mm_xor_si128(x0, _mm_setr_epi32(0, 0, 0, (int)crc));
+   p += 64; count -= 64;
+
+// Fold four blocks at a time
+//
+   while(count >= 64)
+        {x0 = fold128(x0, k512, _mm_shuffle_epi8(
+                      _mm_loadu_si128((const __m128i *)(p +  0)), bswap));
+         x1 = fold128(x1, k512, _mm_shuffle_epi8(
+                      _mm_loadu_si128((const __m128i *)(p + 16)), bswap));
+         x2 = fold128(x2, k512, _mm_shuffle_epi8(
+                      _mm_loadu_si128((const __m128i *)(p + 32)), bswap));
+         x3 = fold128(x3, k512, _mm_shuffle_epi8(
+                      _mm_loadu_si128((const __m128i *)(p + 48)), bswap));
+         p += 64; count -= 64;
+        }
+
+// Combine the four accumulators into one and finish up
+//
+   x0 = fold128(x0, k128, x1);
+   x0 = fold128(x0, k128, x2);
+   x0 = fold128(x0, k128, x3);
+   return crc32_finish(x0, bswap, crc, p, count);
+}
+
+#ifdef XRDCKS_VPCLMUL
+__attribute__((target("avx512f,avx512bw,vpclmulqdq,pclmul,sse4.1")))
+inline __m512i fold512(__m512i a, __m512i k, __m512i b)
+{
+   return _mm512_ternarylogic_epi64(_mm512_clmulepi64_epi128(a, k, 0x00),
+                                    _mm512_clmulepi64_epi128(a, k, 0x11),
+                                    b, 0x96);
+}
+
+__attribute__((target("avx512f,avx512bw,vpclmulqdq,pclmul,sse4.1")))
+uint32_t crc32_vpclmul(uint32_t crc, const void *data, size_t count)
+{
+   const unsigned char *p = (const unsigned char *)data;
+   const __m128i bswap = _mm_setr_epi8(15,14,13,12,11,10, 9, 8,
+                                        7, 6, 5, 4, 3, 2, 1, 0);
+   const __m512i bsw4  = _mm512_maskz_broadcast_i32x4(0xffff, bswap);
+   const __m512i k2048 = _mm512_maskz_broadcast_i32x4(0xffff,
+                         _mm_set_epi64x(XRDCKS_FOLDK(2048)));
+   const __m512i k512  = _mm512_maskz_broadcast_i32x4(0xffff,
+                         _mm_set_epi64x(XRDCKS_FOLDK(512)));
+   const __m128i k128  = _mm_set_epi64x(XRDCKS_FOLDK(128));
+   __m512i z0, z1, z2, z3;
+   __m128i x;
+
+   if (count < 256) return crc32_pclmul(crc, data, count);
+
+// Load the first 256 bytes and merge in the running crc
+//
+   z0 = _mm512_shuffle_epi8(_mm512_loadu_si512(p +   0), bsw4);
+   z1 = _mm512_shuffle_epi8(_mm512_loadu_si512(p +  64), bsw4);
+   z2 = _mm512_shuffle_epi8(_mm512_loadu_si512(p + 128), bsw4);
+   z3 = _mm512_shuffle_epi8(_mm512_loadu_si512(p + 192), bsw4);
+   z0 = _mm512_xor_si512(z0, _mm512_zextsi128_si512(
+                             _mm_setr_epi32(0, 0, 0, (int)crc)));
+   p += 256; count -= 256;
+
+// Fold sixteen blocks at a time
+//
+   while(count >= 256)
+        {z0 = fold512(z0, k2048,
+              _mm512_shuffle_epi8(_mm512_loadu_si512(p +   0), bsw4));
+         z1 = fold512(z1, k2048,
+              _mm512_shuffle_epi8(_mm512_loadu_si512(p +  64), bsw4));
+         z2 = fold512(z2, k2048,
+              _mm512_shuffle_epi8(_mm512_loadu_si512(p + 128), bsw4));
+         z3 = fold512(z3, k2048,
+              _mm512_shuffle_epi8(_mm512_loadu_si512(p + 192), bsw4));
+         p += 256; count -= 256;
+        }
+
+// Combine the accumulators and fold any remaining 64 byte chunks
+//
+   z0 = fold512(z0, k512, z1);
+   z0 = fold512(z0, k512, z2);
+   z0 = fold512(z0, k512, z3);
+   while(count >= 64)
+        {z0 = fold512(z0, k512,
+              _mm512_shuffle_epi8(_mm512_loadu_si512(p), bsw4));
+         p += 64; count -= 64;
+        }
+
+// Reduce the four lanes to a single block and finish up
+//
+   x = fold128(_mm512_maskz_extracti32x4_epi32(0xf, z0, 0), k128,
+               _mm512_maskz_extracti32x4_epi32(0xf, z0, 1));
+   x = fold128(x, k128, _mm512_maskz_extracti32x4_epi32(0xf, z0, 2));
+   x = fold128(x, k128, _mm512_maskz_extracti32x4_epi32(0xf, z0, 3));
+   return crc32_finish(x, bswap, crc, p, count);
+}
+#endif
+#undef XRDCKS_FOLDK
+#endif
+}
+
+/******************************************************************************/
+/*                       C o m b i n e   H e l p e r s                        */
+/******************************************************************************/
+
+/* Combining crcs requires multiplying the first crc by x^(8*len2) modulo the
+   polynomial. The non-reflected (Posix) form has x^31 in the high order bit
+   while the reflected (crc32c) form has x^0 in the high order bit.
+*/
+
+namespace
+{
+const uint32_t Crc32cRPoly = 0x82F63B78;
+
+uint32_t mulmodp(uint32_t a, uint32_t b)
+{
+   uint32_t p = 0;
+
+   for (int i = 31; i >= 0; i--)
+       {p = (p & 0x80000000 ? (p << 1) ^ CrcPoly : p << 1);
+        if ((a >> i) & 1) p ^= b;
+       }
+   return p;
+}
+
+uint32_t mulmodpR(uint32_t a, uint32_t b)
+{
+   uint32_t p = 0;
+
+   for (uint32_t m = 0x80000000; m; m >>= 1)
+       {if (a & m) p ^= b;
+        b = (b & 1 ? (b >> 1) ^ Crc32cRPoly : b >> 1);
+       }
+   return p;
+}
+
+// Return x^(8*len) mod P using the supplied representation
+//
+uint32_t xpowmod(uint64_t len, uint32_t one, uint32_t x,
+                 uint32_t (*mul)(uint32_t, uint32_t))
+{
+   uint32_t r = one;
+
+   for (int i = 0; i < 3; i++) x = mul(x, x);
+   while(len)
+        {if (len & 1) r = mul(r, x);
+         x = mul(x, x);
+         len >>= 1;
+        }
+   return r;
+}
+}
+
+/******************************************************************************/
+/*                      K e r n e l   S e l e c t i o n                       */
+/******************************************************************************/
+
+namespace
+{
+struct KernelDesc
+      {const char            *name;
+       XrdCksKernels::Kernel  func;
+       bool                 (*isOK)();
+      };
+
+bool always() {return true;}
+
+#ifdef XRDCKS_X86
+bool hasSSSE3()  {return __builtin_cpu_supports("ssse3");}
+bool hasAVX2()   {return __builtin_cpu_supports("avx2");}
+bool hasAVX512() {return __builtin_cpu_supports("avx512f")
+                      && __builtin_cpu_supports("avx512bw");}
+bool hasPCLMUL() {return __builtin_cpu_supports("pclmul")
+                      && __builtin_cpu_supports("sse4.1");}
+bool hasSSE42()  {return __builtin_cpu_supports("sse4.2");}
+#ifdef XRDCKS_VPCLMUL
+bool hasVPCLMUL(){return hasAVX512() && hasPCLMUL()
+                      && __builtin_cpu_supports("vpclmulqdq");}
+#endif
+#endif
+
+// The lists are ordered from best to worst and must end with a portable
+// implementation followed by a null entry.
+//
+const KernelDesc adlerList[] =
+   {
+#ifdef XRDCKS_X86
+    {"avx512",  adler32_avx512,  hasAVX512},
+    {"avx2",    adler32_avx2,    hasAVX2},
+    {"ssse3",   adler32_ssse3,   hasSSSE3},
+#endif
+    {"generic", adler32_generic, always},
+    {0, 0, 0}
+   };
+
+const KernelDesc crc32List[] =
+   {
+#ifdef XRDCKS_X86
+#ifdef XRDCKS_VPCLMUL
+    {"vpclmul", crc32_vpclmul,   hasVPCLMUL},
+#endif
+    {"pclmul",  crc32_pclmul,    hasPCLMUL},
+#endif
+    {"slice8",  crc32_slice8,    always},
+    {0, 0, 0}
+   };
+
+const KernelDesc crc32cList[] =
+   {
+#ifdef XRDCKS_X86
+    {"sse4.2",  crc32c,          hasSSE42},
+#endif
+    {"generic", crc32c_sw,       always},
+    {0, 0, 0}
+   };
+
+const KernelDesc *getList(const char *csName)
+{
+   if (!strcmp(csName, "adler32")) return adlerList;
+   if (!strcmp(csName, "crc32"))   return crc32List;
+   if (!strcmp(csName, "crc32c"))  return crc32cList;
+   return 0;
+}
+
+const KernelDesc *getBest(const KernelDesc *kP)
+{
+   while(!(kP->isOK())) kP++;
+   return kP;
+}
+}
+
+/******************************************************************************/
+/*                               A d l e r 3 2                                */
+/******************************************************************************/
+
+// Each checksum selects the best implementation the first time it is used.
+// The function-local statics are initialized exactly once, even when several
+// threads get here at the same time.
+//
+uint32_t XrdCksKernels::Adler32(uint32_t cs, const void *data, size_t count)
+{
+   static const Kernel adlerK = getBest(adlerList)->func;
+
+   return adlerK(cs, data, count);
+}
+
+/******************************************************************************/
+/*                        A d l e r 3 2 C o m b i n e                         */
+/******************************************************************************/
+
+uint32_t XrdCksKernels::Adler32Combine(uint32_t cs1, uint32_t cs2, uint64_t len2)
+{
+   uint32_t rem  = (uint32_t)(len2 % AdlerBase);
+   uint32_t sum1 = cs1 & 0xffff;
+   uint32_t sum2 = (rem * sum1) % AdlerBase;
+
+// This is the zlib adler32_combine() algorithm
+//
+   sum1 += (cs2 & 0xffff) + AdlerBase - 1;
+   sum2 += (cs1 >> 16) + (cs2 >> 16) + AdlerBase - rem;
+   if (sum1 >= AdlerBase) sum1 -= AdlerBase;
+   if (sum1 >= AdlerBase) sum1 -= AdlerBase;
+   if (sum2 >= (AdlerBase << 1)) sum2 -= (AdlerBase << 1);
+   if (sum2 >= AdlerBase) sum2 -= AdlerBase;
+   return (sum2 << 16) | sum1;
+}
+
+/******************************************************************************/
+/*                                 C R C 3 2                                  */
+/******************************************************************************/
+
+uint32_t XrdCksKernels::CRC32(uint32_t cs, const void *data, size_t count)
+{
+   static const Kernel crc32K = getBest(crc32List)->func;
+
+   return crc32K(cs, data, count);
+}
+
+/******************************************************************************/
+/*                                C R C 3 2 C                                 */
+/******************************************************************************/
+
+uint32_t XrdCksKernels::CRC32C(uint32_t cs, const void *data, size_t count)
+{
+   static const Kernel crc32cK = getBest(crc32cList)->func;
+
+   return crc32cK(cs, data, count);
+}
+
+/******************************************************************************/
+/*                         C R C 3 2 C C o m b i n e                          */
+/******************************************************************************/
+
+uint32_t XrdCksKernels::CRC32CCombine(uint32_t cs1, uint32_t cs2, uint64_t len2)
+{
+// The pre- and post-conditioning of crc32c cancel out so only the first crc
+// needs to be shifted over the second piece.
+//
+   return mulmodpR(xpowmod(len2, 0x80000000, 0x40000000, mulmodpR), cs1) ^ cs2;
+}
+
+/******************************************************************************/
+/*                          C R C 3 2 C o m b i n e                           */
+/******************************************************************************/
+
+uint32_t XrdCksKernels::CRC32Combine(uint32_t cs1, uint32_t cs2, uint64_t len2)
+{
+   return mulmodp(xpowmod(len2, 1, 2, mulmodp), cs1) ^ cs2;
+}
+
+/******************************************************************************/
+/*                                  I m p l                                   */
+/******************************************************************************/
+
+const char *XrdCksKernels::Impl(const char *csName, int num, Kernel &func)
+{
+   const KernelDesc *kP = getList(csName);
+
+// Skip over any implementations the cpu cannot run
+//
+   if (!kP || num < 0) return 0;
+   while(kP->name)
+        {if (kP->isOK() && !num--) {func = kP->func; return kP->name;}
+         kP++;
+        }
+   return 0;
+}
+
+/******************************************************************************/
+/*                                 U s i n g                                  */
+/******************************************************************************/
+
+const char *XrdCksKernels::Using(const char *csName)
+{
+   const KernelDesc *kP = getList(csName);
+
+   return (kP ? getBest(kP)->name : 0);
+}
@@ -0,0 +1,119 @@
+#ifndef __XRDCKSKERNELS_HH__
+#define __XRDCKSKERNELS_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C k s K e r n e l s . h h                       */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+//! This class provides the low level checksum kernels (adler32, crc32 and
+//! crc32c) shared by the checksum calculators, the page checksum utilities
+//! and the checksum apps. Each checksum has several implementations; the best
+//! one the cpu supports is selected the first time the checksum is used.
+//-----------------------------------------------------------------------------
+
+class XrdCksKernels
+{
+public:
+
+//-----------------------------------------------------------------------------
+//! Signature of a checksum kernel.
+//!
+//! @param  cs     the running checksum value (see the individual methods).
+//! @param  data   pointer to the data.
+//! @param  count  number of bytes of data.
+//!
+//! @return The updated running checksum value.
+//-----------------------------------------------------------------------------
+
+typedef uint32_t (*Kernel)(uint32_t cs, const void *data, size_t count);
+
+//-----------------------------------------------------------------------------
+//! Update an adler32 checksum. Start with a value of 1. The result is the
+//! same as zlib's adler32().
+//-----------------------------------------------------------------------------
+
+static uint32_t Adler32(uint32_t cs, const void *data, size_t count);
+
+//-----------------------------------------------------------------------------
+//! Update a POSIX 1003.2 (i.e. cksum) crc32. Start with a value of 0. This
+//! is the unfinished crc; the length and final complement are not applied.
+//-----------------------------------------------------------------------------
+
+static uint32_t CRC32(uint32_t cs, const void *data, size_t count);
+
+//-----------------------------------------------------------------------------
+//! Update a crc32c checksum. Start with a value of 0.
+//-----------------------------------------------------------------------------
+
+static uint32_t CRC32C(uint32_t cs, const void *data, size_t count);
+
+//-----------------------------------------------------------------------------
+//! Combine the checksums of two adjacent pieces of data into the checksum of
+//! the whole, as if the pieces had been checksummed one after the other.
+//! This allows pieces of a file to be checksummed in parallel.
+//!
+//! @param  cs1    checksum of the first piece.
+//! @param  cs2    checksum of the second piece, computed from the start value.
+//! @param  len2   length of the second piece in bytes.
+//!
+//! @return The checksum of both pieces.
+//-----------------------------------------------------------------------------
+
+static uint32_t Adler32Combine(uint32_t cs1, uint32_t cs2, uint64_t len2);
+
+static uint32_t CRC32Combine(  uint32_t cs1, uint32_t cs2, uint64_t len2);
+
+static uint32_t CRC32CCombine( uint32_t cs1, uint32_t cs2, uint64_t len2);
+
+//-----------------------------------------------------------------------------
+//! Describe the implementations available for a checksum.
+//!
+//! @param  csName the checksum name: "adler32", "crc32" or "crc32c".
+//! @param  num    which implementation, starting at 0. The list is ordered
+//!                from best to worst and only contains implementations that
+//!                the cpu supports. The last one is always the portable one.
+//! @param  func   receives the implementation.
+//!
+//! @return The name of the implementation or nil when num is out of range.
+//-----------------------------------------------------------------------------
+
+static const char *Impl(const char *csName, int num, Kernel &func);
+
+//-----------------------------------------------------------------------------
+//! Return the name of the implementation in use for a checksum.
+//!
+//! @param  csName the checksum name: "adler32", "crc32" or "crc32c".
+//!
+//! @return The name of the implementation or nil for an unknown checksum.
+//-----------------------------------------------------------------------------
+
+static const char *Using(const char *csName);
+};
+#endif
@@ -65,7 +65,132 @@
 
 namespace
 {
-int CksOpts = 0;
+int CksOpts    = 0;
+int CksThreads = 4;
+}
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+namespace
+{
+// Checksum Size bytes starting at Offset using a moving mmap window. While a
+// window is being checksummed the kernel is asked to start reading the next.
+//
+int calcRange(XrdSysError *eDest, const char *Pfn, int fd, off_t Offset,
+              off_t Size, int segSize, XrdCksCalc *csP)
+{
+   char *inBuff;
+   size_t ioSize = (Size < (off_t)segSize ? Size : segSize);
+   int rc;
+
+   while(Size)
+        {if ((inBuff = (char *)mmap(0, ioSize, PROT_READ,
+#if defined(__FreeBSD__)
+                       MAP_RESERVED0040|MAP_PRIVATE, fd, Offset)) == MAP_FAILED)
+#elif defined(__GNU__)
+                       MAP_PRIVATE, fd, Offset)) == MAP_FAILED)
+#else
+                       MAP_NORESERVE|MAP_PRIVATE, fd, Offset)) == MAP_FAILED)
+#endif
+            {rc = errno; eDest->Emsg("Cks", rc, "memory map", Pfn); return -rc;}
+         madvise(inBuff, ioSize, MADV_SEQUENTIAL);
+#ifdef POSIX_FADV_WILLNEED
+         if (Size > (off_t)ioSize)
+            {off_t nxtSize = Size - ioSize;
+             if (nxtSize > segSize) nxtSize = segSize;
+             posix_fadvise(fd, Offset+ioSize, nxtSize, POSIX_FADV_WILLNEED);
+            }
+#endif
+         csP->Update(inBuff, ioSize);
+         Size -= ioSize; Offset += ioSize;
+         if (munmap(inBuff, ioSize) < 0)
+            {rc = errno; eDest->Emsg("Cks",rc,"unmap memory for",Pfn);
+             return -rc;
+            }
+         if (Size < (off_t)segSize) ioSize = Size;
+        }
+   return 0;
+}
+
+// Combinable checksums (i.e. adler32, crc32, and crc32c) of large files are
+// computed in parallel. The file is split into slices, each checksummed by
+// its own thread, and the slice checksums are then combined in file order.
+//
+template<class T>
+struct calcSlice
+      {XrdSysError *eDest;
+       const char  *Pfn;
+       T           *csP;
+       off_t        Offset;
+       off_t        Size;
+       pthread_t    tid;
+       int          fd;
+       int          segSize;
+       int          rc;
+       bool         isRun;
+      };
+
+template<class T>
+void *calcRun(void *arg)
+{
+   calcSlice<T> *sP = (calcSlice<T> *)arg;
+
+   sP->rc = calcRange(sP->eDest, sP->Pfn, sP->fd, sP->Offset, sP->Size,
+                      sP->segSize, sP->csP);
+   return 0;
+}
+
+template<class T>
+int calcPar(XrdSysError *eDest, const char *Pfn, int fd, off_t fileSize,
+            int segSize, T *csP, int numThreads)
+{
+   off_t sliceSize = (fileSize + numThreads - 1) / numThreads;
+   int i, rc = 0, numSlices;
+
+// Slices must start on a page boundary as they are memory mapped
+//
+   sliceSize = (sliceSize + 65535) & ~(off_t)65535;
+   numSlices = (fileSize + sliceSize - 1) / sliceSize;
+   calcSlice<T> *sTab = new calcSlice<T>[numSlices];
+
+// Launch a thread for every slice but the first, which we do ourselves. If
+// a thread cannot be started, the slice is done inline when we wait for it.
+//
+   for (i = 0; i < numSlices; i++)
+       {sTab[i].eDest   = eDest;
+        sTab[i].Pfn     = Pfn;
+        sTab[i].csP     = (i ? (T *)csP->New() : csP);
+        sTab[i].Offset  = sliceSize * i;
+        sTab[i].Size    = (i < numSlices-1 ? sliceSize
+                                           : fileSize - sliceSize * i);
+        sTab[i].fd      = fd;
+        sTab[i].segSize = segSize;
+        sTab[i].rc      = 0;
+        sTab[i].isRun   = i && !XrdSysThread::Run(&sTab[i].tid, calcRun<T>,
+                                         (void *)&sTab[i], XRDSYSTHREAD_HOLD,
+                                         "checksum calculation");
+       }
+   calcRun<T>((void *)&sTab[0]);
+
+// Wait for each slice in turn and merge it into the final checksum
+//
+   for (i = 0; i < numSlices; i++)
+       {if (i)
+           {if (sTab[i].isRun) XrdSysThread::Join(sTab[i].tid, 0);
+               else calcRun<T>((void *)&sTab[i]);
+            if (!rc) csP->Combine(*sTab[i].csP, sTab[i].Size);
+            sTab[i].csP->Recycle();
+           }
+        if (sTab[i].rc && !rc) rc = sTab[i].rc;
+       }
+
+// All done
+//
+   delete [] sTab;
+   return rc;
+}
 }
   
 /******************************************************************************/
@@ -167,10 +292,7 @@ int XrdCksManager::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
             ~ioFD() {if (FD >= 0) close(FD);}
         } In;
    struct stat Stat;
-   char *inBuff;
-   off_t  Offset=0, fileSize;
-   size_t ioSize, calcSize;
-   int rc;
+   off_t  fileSize;
 
 // Open the input file
 //
@@ -180,34 +302,32 @@ int XrdCksManager::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
 //
    if (fstat(In.FD, &Stat)) return -errno;
    if (!(Stat.st_mode & S_IFREG)) return -EPERM;
-   calcSize = fileSize = Stat.st_size;
+   fileSize = Stat.st_size;
    MTime = Stat.st_mtime;
 
-// We now compute checksum 64MB at a time using mmap I/O
-//
-   ioSize = (fileSize < (off_t)segSize ? fileSize : segSize); rc = 0;
-   while(calcSize)
-        {if ((inBuff = (char *)mmap(0, ioSize, PROT_READ, 
-#if defined(__FreeBSD__)
-                       MAP_RESERVED0040|MAP_PRIVATE, In.FD, Offset)) == MAP_FAILED)
-#elif defined(__GNU__)
-                       MAP_PRIVATE, In.FD, Offset)) == MAP_FAILED)
-#else
-                       MAP_NORESERVE|MAP_PRIVATE, In.FD, Offset)) == MAP_FAILED)
-#endif
-            {rc = errno; eDest->Emsg("Cks", rc, "memory map", Pfn); break;}
-         madvise(inBuff, ioSize, MADV_SEQUENTIAL);
-         csP->Update(inBuff, ioSize);
-         calcSize -= ioSize; Offset += ioSize;
-         if (munmap(inBuff, ioSize) < 0)
-            {rc = errno; eDest->Emsg("Cks",rc,"unmap memory for",Pfn); break;}
-         if (calcSize < (size_t)segSize) ioSize = calcSize;
-        }
+// Large files use multiple threads when the checksum can be pieced together
+//
+   if (CksThreads > 1 && fileSize >= 2*(off_t)segSize)
+      {XrdCksCalcadler32 *adlerP;
+       XrdCksCalccrc32   *crc32P;
+       XrdCksCalccrc32C  *crc32cP;
+       off_t n = fileSize / segSize;
+       int numThreads = (n < CksThreads ? (int)n : CksThreads);
+
+       if ((adlerP = dynamic_cast<XrdCksCalcadler32 *>(csP)))
+          return calcPar(eDest, Pfn, In.FD, fileSize, segSize, adlerP,
+                         numThreads);
+       if ((crc32P = dynamic_cast<XrdCksCalccrc32 *>(csP)))
+          return calcPar(eDest, Pfn, In.FD, fileSize, segSize, crc32P,
+                         numThreads);
+       if ((crc32cP = dynamic_cast<XrdCksCalccrc32C *>(csP)))
+          return calcPar(eDest, Pfn, In.FD, fileSize, segSize, crc32cP,
+                         numThreads);
+      }
 
-// Return if we failed
+// Otherwise we compute the checksum 64MB at a time using mmap I/O
 //
-   if (calcSize) return (rc ? -rc : -EIO);
-   return 0;
+   return calcRange(eDest, Pfn, In.FD, 0, fileSize, segSize, csP);
 }
 
 /******************************************************************************/
@@ -630,6 +750,12 @@ int XrdCksManager::Set(const char *Pfn, XrdCksData &Cks, int myTime)
 /******************************************************************************/
 
 void XrdCksManager::SetOpts(int opt) {CksOpts = opt;}
+
+/******************************************************************************/
+/*                            S e t T h r e a d s                             */
+/******************************************************************************/
+
+void XrdCksManager::SetThreads(int num) {CksThreads = (num > 0 ? num : 1);}
   
 /******************************************************************************/
 /*                                   V e r                                    */
@@ -74,6 +74,11 @@ virtual int         Set(  const char *Pfn, XrdCksData &Cks, int myTime=0);
 
         void        SetOpts(int opt);
 
+// Set the maximum number of threads used to calculate a checksum that can be
+// computed piecewise (i.e. adler32, crc32, crc32c) for a large file.
+//
+        void        SetThreads(int num);
+
 virtual int         Ver(  const char *Pfn, XrdCksData &Cks);
 
                     XrdCksManager(XrdSysError *erP, int iosz,
@@ -86,6 +91,7 @@ protected:
               supplied CksObj and places the file's modification time in MTime.
               Otherwise, it returns -errno. The default implementation uses
               open(), fstat(), mmap(), and unmap() to calculate the results.
+              Large files may be split into slices computed in parallel.
 */
 virtual int         Calc(const char *Pfn, time_t &MTime, XrdCksCalc *CksObj);
 
@@ -0,0 +1,229 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_ADAPTIVE_WINDOW_HH__
+#define __XRD_CL_ADAPTIVE_WINDOW_HH__
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Adaptive read window of a copy job: tunes the chunk size and the number
+  //! of chunks in flight from the measured throughput and per-chunk latency.
+  //!
+  //! Completions are grouped in rounds of roughly one window. A round that
+  //! raises the best throughput seen so far grows the window: the number of
+  //! chunks in flight first (doubling until the first round without a gain,
+  //! one at a time afterwards), then the chunk size once the parallelism
+  //! ceiling has been reached. A round without a gain whose latency has risen
+  //! well above the minimum is queueing in the pipe, not filling it, so the
+  //! window is shrunk by one step. A sharp drop in throughput halves the
+  //! parallelism. Every few steady rounds the window is probed upwards in
+  //! case the path got faster.
+  //!
+  //! The window never grows beyond a byte ceiling, counting the chunks in
+  //! flight on all the streams of the connection.
+  //----------------------------------------------------------------------------
+  class AdaptiveWindow
+  {
+    public:
+      typedef std::chrono::steady_clock clock_t;
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param chunkSize    : initial chunk size
+      //! @param parallel     : initial number of chunks in flight per stream
+      //! @param maxChunkSize : chunk size ceiling
+      //! @param maxParallel  : ceiling of the chunks in flight per stream
+      //! @param maxWindow    : ceiling of the bytes in flight on all streams
+      //------------------------------------------------------------------------
+      AdaptiveWindow( uint32_t chunkSize, uint16_t parallel,
+                      uint32_t maxChunkSize, uint16_t maxParallel,
+                      uint64_t maxWindow ) :
+        pChunkSize( chunkSize ), pParallel( parallel ), pStreams( 1 ),
+        pMinChunkSize( std::min<uint32_t>( chunkSize, 1024 * 1024 ) ),
+        pMaxChunkSize( std::max( chunkSize, maxChunkSize ) ),
+        pMaxParallel( std::max( parallel, maxParallel ) ),
+        pMaxWindow( std::max( maxWindow, uint64_t( chunkSize ) * parallel ) ),
+        pGen( 0 ), pSlowStart( true ), pSteady( 0 ), pRoundOpen( false ),
+        pRoundBytes( 0 ), pRoundLat( 0 ), pRoundCnt( 0 ), pMinLat( 0 ),
+        pBestRate( 0 ), pPeakRate( 0 )
+      {
+      }
+
+      uint32_t ChunkSize()  const { return pChunkSize; }
+      uint16_t Parallel()   const { return pParallel; }
+      uint32_t Generation() const { return pGen; }
+      uint64_t PeakRate()   const { return pPeakRate; }
+
+      //------------------------------------------------------------------------
+      //! Number of chunks that may be in flight on all streams together
+      //------------------------------------------------------------------------
+      uint32_t InFlight() const
+      {
+        uint64_t n = uint64_t( pParallel ) * pStreams;
+        return std::max<uint64_t>( std::min( n, pMaxWindow / pChunkSize ), 1 );
+      }
+
+      //------------------------------------------------------------------------
+      //! Set the number of streams the chunks are spread over
+      //------------------------------------------------------------------------
+      void Streams( uint16_t streams )
+      {
+        pStreams = std::max<uint16_t>( streams, 1 );
+      }
+
+      //------------------------------------------------------------------------
+      //! Account for a completed chunk
+      //!
+      //! @param gen    : generation the chunk was issued in
+      //! @param bytes  : number of bytes read
+      //! @param issued : time the request was sent
+      //! @param done   : time the response arrived
+      //------------------------------------------------------------------------
+      void Sample( uint32_t gen, uint64_t bytes, clock_t::time_point issued,
+                   clock_t::time_point done )
+      {
+        //----------------------------------------------------------------------
+        // Chunks issued with the previous parameters only mark where the
+        // next round starts
+        //----------------------------------------------------------------------
+        if( gen != pGen || !pRoundOpen )
+        {
+          if( !pRoundOpen || done > pRoundStart ) pRoundStart = done;
+          pRoundOpen = true;
+          return;
+        }
+
+        uint64_t lat = ToUsec( done - issued );
+        if( !pMinLat || lat < pMinLat ) pMinLat = lat;
+        pRoundBytes += bytes;
+        pRoundLat   += lat;
+        ++pRoundCnt;
+        if( pRoundCnt < std::max<uint32_t>( InFlight(), 4 ) ) return;
+
+        uint64_t elapsed = std::max<uint64_t>( ToUsec( done - pRoundStart ), 1 );
+        uint64_t rate    = pRoundBytes * 1000000 / elapsed;
+        uint64_t avgLat  = pRoundLat / pRoundCnt;
+        pRoundStart = done;
+        pRoundBytes = pRoundLat = pRoundCnt = 0;
+        if( rate > pPeakRate ) pPeakRate = rate;
+
+        if( rate > pBestRate + pBestRate / 10 )
+        {
+          pBestRate = rate;
+          pSteady   = 0;
+          Grow();
+        }
+        else if( rate < pBestRate - pBestRate / 3 )
+        {
+          pBestRate  = rate;
+          pSteady    = 0;
+          pSlowStart = false;
+          if( pParallel > 1 ) SetWindow( pChunkSize, pParallel / 2 );
+        }
+        else if( avgLat > pMinLat + pMinLat / 2 )
+        {
+          pSteady    = 0;
+          pSlowStart = false;
+          Shrink();
+        }
+        else if( ++pSteady >= 8 )
+        {
+          pSteady   = 0;
+          pBestRate = rate;
+          Grow();
+        }
+        else pSlowStart = false;
+      }
+
+    private:
+
+      static uint64_t ToUsec( clock_t::duration d )
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>( d ).count();
+      }
+
+      bool Fits( uint64_t chunkSize, uint64_t parallel ) const
+      {
+        return chunkSize * parallel * pStreams <= pMaxWindow;
+      }
+
+      void Grow()
+      {
+        if( pParallel < pMaxParallel )
+        {
+          uint32_t p = pSlowStart ? pParallel * 2 : pParallel + 1;
+          p = std::min<uint32_t>( p, pMaxParallel );
+          while( p > pParallel && !Fits( pChunkSize, p ) ) --p;
+          if( p > pParallel )
+          {
+            SetWindow( pChunkSize, p );
+            return;
+          }
+        }
+        if( pChunkSize < pMaxChunkSize )
+        {
+          uint64_t c = std::min<uint64_t>( uint64_t( pChunkSize ) * 2, pMaxChunkSize );
+          if( Fits( c, pParallel ) ) SetWindow( c, pParallel );
+        }
+      }
+
+      void Shrink()
+      {
+        if( pParallel > 1 )
+          SetWindow( pChunkSize, pParallel - 1 );
+        else if( pChunkSize > pMinChunkSize )
+          SetWindow( std::max( pChunkSize / 2, pMinChunkSize ), pParallel );
+      }
+
+      void SetWindow( uint32_t chunkSize, uint16_t parallel )
+      {
+        // latency scales with the chunk size, start over with a new baseline
+        if( chunkSize != pChunkSize ) pMinLat = 0;
+        pChunkSize = chunkSize;
+        pParallel  = parallel;
+        pRoundBytes = pRoundLat = pRoundCnt = 0;
+        ++pGen;
+      }
+
+      uint32_t            pChunkSize;
+      uint16_t            pParallel;
+      uint16_t            pStreams;
+      uint32_t            pMinChunkSize;
+      uint32_t            pMaxChunkSize;
+      uint16_t            pMaxParallel;
+      uint64_t            pMaxWindow;
+      uint32_t            pGen;
+      bool                pSlowStart;
+      uint32_t            pSteady;
+      bool                pRoundOpen;
+      clock_t::time_point pRoundStart;
+      uint64_t            pRoundBytes;
+      uint64_t            pRoundLat;
+      uint32_t            pRoundCnt;
+      uint64_t            pMinLat;
+      uint64_t            pBestRate;
+      uint64_t            pPeakRate;
+  };
+}
+
+#endif // __XRD_CL_ADAPTIVE_WINDOW_HH__
@@ -0,0 +1,174 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_BUFFER_POOL_HH__
+#define __XRD_CL_BUFFER_POOL_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Pool of page-aligned chunk buffers shared by the copy jobs of a process
+  //!
+  //! Buffers are recycled instead of being freed, so a steady transfer does
+  //! not allocate (and fault in) a fresh chunk for every read, and the buffers
+  //! meet the alignment required for direct I/O on a local destination. Each
+  //! job attaching to the pool adds its budget to the idle bytes the pool may
+  //! keep; a buffer returned beyond that is freed. The idle buffers are given
+  //! back when the last job detaches. Put() also takes buffers that were not
+  //! allocated by the pool (e.g. by XCpCtx) and deletes those.
+  //----------------------------------------------------------------------------
+  class BufferPool
+  {
+    public:
+
+      static constexpr size_t PageSize = 4096;
+
+      BufferPool() : pIdleBytes( 0 ), pBudget( 0 ), pJobs( 0 ) { }
+
+      ~BufferPool()
+      {
+        for( auto &idle : pIdle ) free( idle.second );
+      }
+
+      //------------------------------------------------------------------------
+      //! The pool shared by the copy jobs of the process
+      //------------------------------------------------------------------------
+      static BufferPool& Instance()
+      {
+        static BufferPool *pool = new BufferPool(); // never destroyed
+        return *pool;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get a page-aligned buffer of at least size bytes
+      //------------------------------------------------------------------------
+      char* Get( size_t size )
+      {
+        std::unique_lock<std::mutex> lck( pMutex );
+        //----------------------------------------------------------------------
+        // Reuse the smallest idle buffer that fits, unless it is so large
+        // that we would be pinning memory for nothing
+        //----------------------------------------------------------------------
+        auto itr = pIdle.lower_bound( size );
+        if( itr != pIdle.end() && itr->first <= 2 * size )
+        {
+          char *buffer = itr->second;
+          pIdleBytes -= itr->first;
+          pIdle.erase( itr );
+          return buffer;
+        }
+        lck.unlock();
+
+        size_t capacity = std::max<size_t>( ( size + PageSize - 1 ) & ~( PageSize - 1 ),
+                                            PageSize );
+        void *buffer = 0;
+        if( posix_memalign( &buffer, PageSize, capacity ) )
+          throw std::bad_alloc();
+
+        lck.lock();
+        pOwned[(char*)buffer] = capacity;
+        return (char*)buffer;
+      }
+
+      //------------------------------------------------------------------------
+      //! Give a buffer back, it is kept for reuse if the budget allows
+      //------------------------------------------------------------------------
+      void Put( char *buffer )
+      {
+        if( !buffer ) return;
+        std::unique_lock<std::mutex> lck( pMutex );
+        auto itr = pOwned.find( buffer );
+        if( itr == pOwned.end() )
+        {
+          lck.unlock();
+          delete [] buffer;
+          return;
+        }
+
+        if( pIdleBytes + itr->second > pBudget )
+        {
+          pOwned.erase( itr );
+          lck.unlock();
+          free( buffer );
+          return;
+        }
+        pIdle.emplace( itr->second, buffer );
+        pIdleBytes += itr->second;
+      }
+
+      //------------------------------------------------------------------------
+      //! A copy job starts, allow it to keep up to budget bytes of idle buffers
+      //------------------------------------------------------------------------
+      void Attach( uint64_t budget )
+      {
+        std::unique_lock<std::mutex> lck( pMutex );
+        pBudget += budget;
+        ++pJobs;
+      }
+
+      //------------------------------------------------------------------------
+      //! A copy job is done, release the idle buffers if it was the last one,
+      //! otherwise trim them to what the remaining jobs may keep
+      //------------------------------------------------------------------------
+      void Detach( uint64_t budget )
+      {
+        std::unique_lock<std::mutex> lck( pMutex );
+        pBudget -= budget;
+        --pJobs;
+        while( !pIdle.empty() && ( !pJobs || pIdleBytes > pBudget ) )
+        {
+          auto itr = std::prev( pIdle.end() );
+          pIdleBytes -= itr->first;
+          pOwned.erase( itr->second );
+          free( itr->second );
+          pIdle.erase( itr );
+        }
+      }
+
+      //------------------------------------------------------------------------
+      //! Number of bytes held in idle buffers
+      //------------------------------------------------------------------------
+      uint64_t IdleBytes()
+      {
+        std::unique_lock<std::mutex> lck( pMutex );
+        return pIdleBytes;
+      }
+
+    private:
+
+      BufferPool( const BufferPool& ) = delete;
+      BufferPool& operator=( const BufferPool& ) = delete;
+
+      std::mutex                         pMutex;
+      std::multimap<size_t, char*>       pIdle;
+      std::unordered_map<char*, size_t>  pOwned;
+      uint64_t                           pIdleBytes;
+      uint64_t                           pBudget;
+      uint32_t                           pJobs;
+  };
+}
+
+#endif // __XRD_CL_BUFFER_POOL_HH__
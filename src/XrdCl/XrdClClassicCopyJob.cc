@@ -39,6 +39,8 @@
 #include "XrdCl/XrdClXRootDTransport.hh"
 #include "XrdClXCpCtx.hh"
 #include "XrdCl/XrdClCheckSumHelper.hh"
+#include "XrdCl/XrdClAdaptiveWindow.hh"
+#include "XrdCl/XrdClBufferPool.hh"
 #include "XrdSys/XrdSysE2T.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
@@ -49,6 +51,10 @@
 #include <chrono>
 #include <thread>
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <new>
+#include <cstdlib>
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -84,6 +90,34 @@ namespace
   using timer_sec_t  = mytimer_t<>;
   using timer_nsec_t = mytimer_t<std::nano>;
 
+  inline char* AllocChunk( size_t size )
+  {
+    return XrdCl::BufferPool::Instance().Get( size );
+  }
+
+  inline void FreeChunk( const void *buffer )
+  {
+    XrdCl::BufferPool::Instance().Put( (char*)buffer );
+  }
+
+  //----------------------------------------------------------------------------
+  //! Keeps a copy job attached to the buffer pool for the scope's lifetime
+  //----------------------------------------------------------------------------
+  struct buffer_pool_guard_t
+  {
+    buffer_pool_guard_t( uint64_t budget ) : budget( budget )
+    {
+      XrdCl::BufferPool::Instance().Attach( budget );
+    }
+
+    ~buffer_pool_guard_t()
+    {
+      XrdCl::BufferPool::Instance().Detach( budget );
+    }
+
+    uint64_t budget;
+  };
+
 
   inline XrdCl::XRootDStatus Translate( std::vector<XrdCl::XAttr>   &in,
                                            std::vector<XrdCl::xattr_t> &out )
@@ -215,6 +249,18 @@ namespace
         return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errNotImplemented );
       }
 
+      //------------------------------------------------------------------------
+      //! Get the read window chosen by the adaptive mode
+      //!
+      //! @return false if the source does not adapt its read window
+      //------------------------------------------------------------------------
+      virtual bool GetAdaptiveWindow( uint32_t &/*chunkSize*/,
+                                      uint16_t &/*parallel*/,
+                                      uint64_t &/*peakRate*/ )
+      {
+        return false;
+      }
+
     protected:
 
       XrdCl::CheckSumHelper               *pCkSumHelper;
@@ -423,7 +469,7 @@ namespace
         Log *log = DefaultEnv::GetLog();
 
         uint32_t toRead = pChunkSize;
-        char *buffer = new char[toRead];
+        char *buffer = AllocChunk( toRead );
 
         int64_t  bytesRead = 0;
         uint32_t offset    = 0;
@@ -434,7 +480,7 @@ namespace
           {
             log->Debug( UtilityMsg, "Unable to read from stdin: %s",
                         XrdSysE2T( errno ) );
-            delete [] buffer;
+            FreeChunk( buffer );
             return XRootDStatus( stError, errOSError, errno );
           }
 
@@ -448,7 +494,7 @@ namespace
 
         if( bytesRead == 0 )
         {
-          delete [] buffer;
+          FreeChunk( buffer );
           return XRootDStatus( stOK, suDone );
         }
 
@@ -572,6 +618,31 @@ namespace
         return pFile->TryOtherServer();
       }
 
+      //------------------------------------------------------------------------
+      //! Let the chunk size and the number of chunks in flight adapt to the
+      //! link, starting from the configured values
+      //------------------------------------------------------------------------
+      void EnableAdaptive( uint32_t maxChunkSize, uint16_t maxParallel,
+                           uint64_t maxWindow )
+      {
+        pWindow.reset( new XrdCl::AdaptiveWindow( pChunkSize, pParallel,
+                                                  maxChunkSize, maxParallel,
+                                                  maxWindow ) );
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the read window chosen by the adaptive mode
+      //------------------------------------------------------------------------
+      virtual bool GetAdaptiveWindow( uint32_t &chunkSize, uint16_t &parallel,
+                                      uint64_t &peakRate )
+      {
+        if( !pWindow ) return false;
+        chunkSize = pWindow->ChunkSize();
+        parallel  = pWindow->Parallel();
+        peakRate  = pWindow->PeakRate();
+        return true;
+      }
+
       //------------------------------------------------------------------------
       //! Constructor
       //------------------------------------------------------------------------
@@ -734,7 +805,7 @@ namespace
           ChunkHandler *ch = pChunks.front();
           pChunks.pop();
           ch->sem->Wait();
-          delete [] (char *)ch->chunk.GetBuffer();
+          FreeChunk( ch->chunk.GetBuffer() );
           delete ch;
         }
       }
@@ -808,27 +879,42 @@ namespace
         //----------------------------------------------------------------------
         // Get the number of connected streams
         //----------------------------------------------------------------------
-        uint16_t parallel = pParallel;
+        uint32_t parallel  = pParallel;
+        uint32_t chunkSize = pWindow ? pWindow->ChunkSize() : pChunkSize;
         if( pNbConn < pMaxNbConn )
         {
           pNbConn = XrdCl::DefaultEnv::GetPostMaster()->
                                                  NbConnectedStrm( pDataServer );
         }
-        if( pNbConn ) parallel *= pNbConn;
+        if( pWindow )
+        {
+          //--------------------------------------------------------------------
+          // The adaptive window counts the chunks of all the streams against
+          // its byte ceiling
+          //--------------------------------------------------------------------
+          pWindow->Streams( pNbConn );
+          parallel = pWindow->InFlight();
+        }
+        else if( pNbConn ) parallel *= pNbConn;
 
         while( pChunks.size() < parallel && pCurrentOffset < pSize )
         {
-          uint64_t chunkSize = pChunkSize;
-          if( pCurrentOffset + chunkSize > (uint64_t)pSize )
-            chunkSize = pSize - pCurrentOffset;
+          uint64_t toRead = chunkSize;
+          if( pCurrentOffset + toRead > (uint64_t)pSize )
+            toRead = pSize - pCurrentOffset;
 
-          char *buffer = new char[chunkSize];
+          char *buffer = AllocChunk( toRead );
           ChunkHandler *ch = new ChunkHandler();
+          if( pWindow )
+          {
+            ch->gen    = pWindow->Generation();
+            ch->issued = XrdCl::AdaptiveWindow::clock_t::now();
+          }
           ch->status = pUsePgRead
-                     ? reader->PgRead( pCurrentOffset, chunkSize, buffer, ch )
-                     : reader->Read( pCurrentOffset, chunkSize, buffer, ch );
+                     ? reader->PgRead( pCurrentOffset, toRead, buffer, ch )
+                     : reader->Read( pCurrentOffset, toRead, buffer, ch );
           pChunks.push( ch );
-          pCurrentOffset += chunkSize;
+          pCurrentOffset += toRead;
           if( !ch->status.IsOK() )
           {
             ch->sem->Post();
@@ -893,11 +979,21 @@ namespace
           log->Debug( UtilityMsg, "Unable read %d bytes at %llu from %s: %s",
                       ch->chunk.GetLength(), (unsigned long long) ch->chunk.GetOffset(),
                       pUrl->GetObfuscatedURL().c_str(), ch->status.ToStr().c_str() );
-          delete [] (char *)ch->chunk.GetBuffer();
+          FreeChunk( ch->chunk.GetBuffer() );
           CleanUpChunks();
           return ch->status;
         }
 
+        //----------------------------------------------------------------------
+        // Feed the completion to the adaptive window, if any
+        //----------------------------------------------------------------------
+        if( pWindow )
+        {
+          lck.lock();
+          pWindow->Sample( ch->gen, ch->chunk.GetLength(), ch->issued, ch->done );
+          lck.unlock();
+        }
+
         ci = std::move( ch->chunk );
         // if it is a local file update the checksum
         if( pUrl->IsLocalFile() && !pUrl->IsMetalink() && !pContinue )
@@ -918,11 +1014,12 @@ namespace
       class ChunkHandler: public XrdCl::ResponseHandler
       {
         public:
-          ChunkHandler(): sem( new XrdSysSemaphore(0) ) {}
+          ChunkHandler(): sem( new XrdSysSemaphore(0) ), gen( 0 ) {}
           virtual ~ChunkHandler() { delete sem; }
           virtual void HandleResponse( XrdCl::XRootDStatus *statusval,
                                        XrdCl::AnyObject    *response )
           {
+            done = XrdCl::AdaptiveWindow::clock_t::now();
             this->status = *statusval;
             delete statusval;
             if( response )
@@ -953,6 +1050,9 @@ namespace
         XrdSysSemaphore     *sem;
         XrdCl::PageInfo      chunk;
         XrdCl::XRootDStatus  status;
+        uint32_t             gen;
+        XrdCl::AdaptiveWindow::clock_t::time_point issued;
+        XrdCl::AdaptiveWindow::clock_t::time_point done;
       };
 
       const XrdCl::URL          *pUrl;
@@ -968,7 +1068,8 @@ namespace
       bool                       pUsePgRead;
       bool                       pDoServer;
 
-      std::shared_ptr<CancellableJob> pDataConnCB;
+      std::shared_ptr<CancellableJob>    pDataConnCB;
+      std::unique_ptr<XrdCl::AdaptiveWindow> pWindow;
   };
 
   //----------------------------------------------------------------------------
@@ -1286,7 +1387,7 @@ namespace
         //----------------------------------------------------------------------
         // Fill the queue
         //----------------------------------------------------------------------
-        char     *buffer = new char[pChunkSize];
+        char     *buffer = AllocChunk( pChunkSize );
         uint32_t  bytesRead = 0;
 
         std::vector<uint32_t> cksums;
@@ -1296,13 +1397,13 @@ namespace
 
         if( !st.IsOK() )
         {
-          delete [] buffer;
+          FreeChunk( buffer );
           return st;
         }
 
         if( !bytesRead )
         {
-          delete [] buffer;
+          FreeChunk( buffer );
           return XRootDStatus( stOK, suDone );
         }
 
@@ -1633,7 +1734,7 @@ namespace
           {
             log->Debug( UtilityMsg, "Unable to write to stdout: %s",
                         XrdSysE2T( errno ) );
-            delete [] (char*)ci.GetBuffer();
+            FreeChunk( ci.GetBuffer() );
             return XRootDStatus( stError, errOSError, errno );
           }
           pCurrentOffset += wr;
@@ -1644,7 +1745,7 @@ namespace
 
         if( pCkSumHelper )
           pCkSumHelper->Update( ci.GetBuffer(), ci.GetLength() );
-        delete [] (char*)ci.GetBuffer();
+        FreeChunk( ci.GetBuffer() );
         return XRootDStatus();
       }
 
@@ -1839,7 +1940,7 @@ namespace
         using namespace XrdCl;
         if( !pFile->IsOpen() )
         {
-          delete[] (char*)ci.GetBuffer(); // we took the ownership of the buffer
+          FreeChunk( ci.GetBuffer() ); // we took the ownership of the buffer
           return XRootDStatus( stError, errUninitialized );
         }
 
@@ -1856,14 +1957,14 @@ namespace
         std::unique_ptr<ChunkHandler> ch( pChunks.front() );
         pChunks.pop();
         ch->sem->Wait();
-        delete [] (char*)ch->chunk.GetBuffer();
+        FreeChunk( ch->chunk.GetBuffer() );
         if( !ch->status.IsOK() )
         {
           Log *log = DefaultEnv::GetLog();
           log->Debug( UtilityMsg, "Unable write %d bytes at %llu from %s: %s",
                       ch->chunk.GetLength(), (unsigned long long) ch->chunk.GetOffset(),
                       pUrl.GetObfuscatedURL().c_str(), ch->status.ToStr().c_str() );
-          delete[] (char*)ci.GetBuffer(); // we took the ownership of the buffer
+          FreeChunk( ci.GetBuffer() ); // we took the ownership of the buffer
           CleanUpChunks();
 
           //--------------------------------------------------------------------
@@ -1894,7 +1995,7 @@ namespace
           ChunkHandler *ch = pChunks.front();
           pChunks.pop();
           ch->sem->Wait();
-          delete [] (char *)ch->chunk.GetBuffer();
+          FreeChunk( ch->chunk.GetBuffer() );
           delete ch;
         }
       }
@@ -1917,7 +2018,7 @@ namespace
         if( !st.IsOK() )
         {
           CleanUpChunks();
-          delete [] (char*)ch->chunk.GetBuffer();
+          FreeChunk( ch->chunk.GetBuffer() );
           delete ch;
           return st;
         }
@@ -1944,7 +2045,7 @@ namespace
             //--------------------------------------------------------------------
             st = CheckIfRetriable( ch->status );
           }
-          delete [] (char *)ch->chunk.GetBuffer();
+          FreeChunk( ch->chunk.GetBuffer() );
           delete ch;
         }
         return st;
@@ -2186,7 +2287,7 @@ namespace
         std::unique_ptr<ChunkHandler> ch( pChunks.front() );
         pChunks.pop();
         ch->sem->Wait();
-        delete [] (char*)ch->chunk.GetBuffer();
+        FreeChunk( ch->chunk.GetBuffer() );
         if( !ch->status.IsOK() )
         {
           Log *log = DefaultEnv::GetLog();
@@ -2223,7 +2324,7 @@ namespace
           ChunkHandler *ch = pChunks.front();
           pChunks.pop();
           ch->sem->Wait();
-          delete [] (char *)ch->chunk.GetBuffer();
+          FreeChunk( ch->chunk.GetBuffer() );
           delete ch;
         }
       }
@@ -2249,7 +2350,7 @@ namespace
         if( !st.IsOK() )
         {
           CleanUpChunks();
-          delete [] (char*)ch->chunk.GetBuffer();
+          FreeChunk( ch->chunk.GetBuffer() );
           delete ch;
           return st;
         }
@@ -2276,7 +2377,7 @@ namespace
             //--------------------------------------------------------------------
             st = CheckIfRetriable( ch->status );
           }
-          delete [] (char *)ch->chunk.GetBuffer();
+          FreeChunk( ch->chunk.GetBuffer() );
           delete ch;
         }
         return st;
@@ -2436,6 +2537,11 @@ namespace XrdCl
     std::string zipSource;
     uint16_t    parallelChunks;
     uint32_t    chunkSize;
+    bool        adaptive = false;
+    uint32_t    maxChunkSize = 0;
+    uint16_t    maxParallelChunks = 0;
+    uint64_t    maxWindow = 0;
+    bool        directIO = false;
     uint64_t    blockSize;
     bool        posc, force, coerce, makeDir, dynamicSource, zip, xcp, preserveXAttr,
                 rmOnBadCksum, continue_, zipappend, doserver;
@@ -2450,6 +2556,11 @@ namespace XrdCl
     pProperties->Get( "checkSumPreset",  checkSumPreset );
     pProperties->Get( "parallelChunks",  parallelChunks );
     pProperties->Get( "chunkSize",       chunkSize );
+    pProperties->Get( "adaptive",        adaptive );
+    pProperties->Get( "maxChunkSize",    maxChunkSize );
+    pProperties->Get( "maxParallelChunks", maxParallelChunks );
+    pProperties->Get( "maxWindow",       maxWindow );
+    pProperties->Get( "directIO",        directIO );
     pProperties->Get( "posc",            posc );
     pProperties->Get( "force",           force );
     pProperties->Get( "coerce",          coerce );
@@ -2508,6 +2619,16 @@ namespace XrdCl
     if( cptimer && cptimer->elapsed() > cpTimeout ) // check the CP timeout
       return SetResult( stError, errOperationExpired, 0, "CPTimeout exceeded." );
 
+    //--------------------------------------------------------------------------
+    // Chunk buffers come from a shared pool, declared before the source and
+    // the destination so that it outlives the buffers they hold. The pool
+    // keeps at most one window of idle buffers for this job; in adaptive mode
+    // the window may grow up to the byte ceiling.
+    //--------------------------------------------------------------------------
+    uint64_t window = uint64_t( chunkSize ) * parallelChunks;
+    if( adaptive ) window = std::max( window, maxWindow );
+    buffer_pool_guard_t poolGuard( window );
+
     //--------------------------------------------------------------------------
     // Initialize the source and the destination
     //--------------------------------------------------------------------------
@@ -2524,7 +2645,11 @@ namespace XrdCl
       if( dynamicSource )
         src.reset( new XRootDSourceDynamic( &GetSource(), chunkSize, checkSumType, addcksums ) );
       else
-        src.reset( new XRootDSource( &GetSource(), chunkSize, parallelChunks, checkSumType, addcksums, doserver ) );
+      {
+        XRootDSource *xsrc = new XRootDSource( &GetSource(), chunkSize, parallelChunks, checkSumType, addcksums, doserver );
+        if( adaptive ) xsrc->EnableAdaptive( maxChunkSize, maxParallelChunks, maxWindow );
+        src.reset( xsrc );
+      }
     }
 
     XRootDStatus st = src->Initialize();
@@ -2561,6 +2686,12 @@ namespace XrdCl
         newDestUrl.SetParams( params );
  //     makeDir = true; // Backward compatibility for xroot destinations!!!
       }
+      if( directIO && newDestUrl.IsLocalFile() )
+      {
+        URL::ParamsMap params = newDestUrl.GetParams();
+        params["xrdcl.directio"] = "1";
+        newDestUrl.SetParams( params );
+      }
       dest.reset( new XRootDDestination( newDestUrl, parallelChunks, checkSumType, *this ) );
     }
 
@@ -2708,6 +2839,20 @@ namespace XrdCl
     }
     pResults->Set( "size", total_processed );
 
+    uint32_t adaptiveChunkSize;
+    uint16_t adaptiveParallel;
+    uint64_t adaptivePeakRate;
+    if( src->GetAdaptiveWindow( adaptiveChunkSize, adaptiveParallel, adaptivePeakRate ) )
+    {
+      log->Info( UtilityMsg, "Adaptive read window for %s: chunk size %u, "
+                 "%u chunks in flight, peak rate %llu B/s",
+                 GetSource().GetObfuscatedURL().c_str(), adaptiveChunkSize,
+                 (unsigned) adaptiveParallel, (unsigned long long) adaptivePeakRate );
+      pResults->Set( "adaptiveChunkSize",      adaptiveChunkSize );
+      pResults->Set( "adaptiveParallelChunks", adaptiveParallel );
+      pResults->Set( "adaptivePeakRate",       adaptivePeakRate );
+    }
+
     //--------------------------------------------------------------------------
     // Finalize the destination
     //--------------------------------------------------------------------------
@@ -60,6 +60,11 @@ namespace XrdCl
   const int DefaultWorkerThreads           = 3;
   const int DefaultCPChunkSize             = 8388608;
   const int DefaultCPParallelChunks        = 4;
+  const int DefaultCPAdaptive              = 0;
+  const int DefaultCPMaxChunkSize          = 16777216;
+  const int DefaultCPMaxParallelChunks     = 16;
+  const int DefaultCPMaxWindow             = 67108864;
+  const int DefaultCPDirectIO              = 0;
   const int DefaultDataServerTTL           = 300;
   const int DefaultLoadBalancerTTL         = 1200;
   const int DefaultCPInitTimeout           = 600;
@@ -89,6 +94,7 @@ namespace XrdCl
   const int DefaultPreserveXAttrs          = 0;
   const int DefaultNoTlsOK                 = 0;
   const int DefaultTlsNoData               = 0;
+  const int DefaultTlsResume               = 1;
   const int DefaultTlsMetalink             = 0;
   const int DefaultZipMtlnCksum            = 0;
   const int DefaultIPNoShuffle             = 0;
@@ -112,6 +118,7 @@ namespace XrdCl
   const char * const DefaultClConfFile         = "";
   const char * const DefaultCpTarget           = "";
   const char * const DefaultCpRetryPolicy      = "force";
+  const char * const DefaultWorkerThreadsMode  = "fifo";
 
   inline static std::string to_lower( std::string str )
   {
@@ -133,6 +140,11 @@ namespace XrdCl
       { to_lower( "WorkerThreads" ),           DefaultWorkerThreads },
       { to_lower( "CPChunkSize" ),             DefaultCPChunkSize },
       { to_lower( "CPParallelChunks" ),        DefaultCPParallelChunks },
+      { to_lower( "CPAdaptive" ),              DefaultCPAdaptive },
+      { to_lower( "CPMaxChunkSize" ),          DefaultCPMaxChunkSize },
+      { to_lower( "CPMaxParallelChunks" ),     DefaultCPMaxParallelChunks },
+      { to_lower( "CPMaxWindow" ),             DefaultCPMaxWindow },
+      { to_lower( "CPDirectIO" ),              DefaultCPDirectIO },
       { to_lower( "DataServerTTL" ),           DefaultDataServerTTL },
       { to_lower( "LoadBalancerTTL" ),         DefaultLoadBalancerTTL },
       { to_lower( "CPInitTimeout" ),           DefaultCPInitTimeout },
@@ -157,6 +169,7 @@ namespace XrdCl
       { to_lower( "PreserveXAttrs" ),          DefaultPreserveXAttrs },
       { to_lower( "NoTlsOK" ),                 DefaultNoTlsOK },
       { to_lower( "TlsNoData" ),               DefaultTlsNoData },
+      { to_lower( "TlsResume" ),               DefaultTlsResume },
       { to_lower( "TlsMetalink" ),             DefaultTlsMetalink },
       { to_lower( "ZipMtlnCksum" ),            DefaultZipMtlnCksum },
       { to_lower( "IPNoShuffle" ),             DefaultIPNoShuffle },
@@ -179,7 +192,8 @@ namespace XrdCl
       { to_lower( "TlsDbgLvl" ),          DefaultTlsDbgLvl },
       { to_lower( "ClConfDir" ),          DefaultClConfDir },
       { to_lower( "DefaultClConfFile" ),  DefaultClConfFile },
-      { to_lower( "CpTarget" ),           DefaultCpTarget }
+      { to_lower( "CpTarget" ),           DefaultCpTarget },
+      { to_lower( "WorkerThreadsMode" ),  DefaultWorkerThreadsMode }
     };
 }
 
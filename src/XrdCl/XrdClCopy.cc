@@ -52,7 +52,7 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     //--------------------------------------------------------------------------
     ProgressDisplay(): pPrevious(0), pPrintProgressBar(true),
       pPrintSourceCheckSum(false), pPrintTargetCheckSum(false),
-      pPrintAdditionalCheckSum(false)
+      pPrintAdditionalCheckSum(false), pPrintAdaptiveWindow(false)
     {}
 
     //--------------------------------------------------------------------------
@@ -139,6 +139,21 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
           PrintCheckSum( d.source, cks, size );
       }
 
+      uint32_t chunkSize;
+      uint16_t parallel;
+      uint64_t peakRate;
+      if( pPrintAdaptiveWindow &&
+          results->Get( "adaptiveChunkSize",      chunkSize ) &&
+          results->Get( "adaptiveParallelChunks", parallel  ) &&
+          results->Get( "adaptivePeakRate",       peakRate  ) )
+      {
+        std::cerr << "Adaptive window: chunk size ";
+        std::cerr << XrdCl::Utils::BytesToString( chunkSize ) << "B, ";
+        std::cerr << parallel << " chunks in flight, peak rate ";
+        std::cerr << XrdCl::Utils::BytesToString( peakRate ) << "B/s";
+        std::cerr << std::endl;
+      }
+
       pOngoingJobs.erase(it);
     }
 
@@ -282,6 +297,7 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     void PrintSourceCheckSum( bool print ) { pPrintSourceCheckSum = print; }
     void PrintTargetCheckSum( bool print ) { pPrintTargetCheckSum = print; }
     void PrintAdditionalCheckSum( bool print ) { pPrintAdditionalCheckSum = print; }
+    void PrintAdaptiveWindow( bool print ) { pPrintAdaptiveWindow = print; }
 
   private:
     struct JobData
@@ -300,6 +316,7 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     bool                        pPrintSourceCheckSum;
     bool                        pPrintTargetCheckSum;
     bool                        pPrintAdditionalCheckSum;
+    bool                        pPrintAdaptiveWindow;
     std::map<uint16_t, JobData> pOngoingJobs;
     XrdSysRecMutex              pMutex;
 };
@@ -592,6 +609,9 @@ int main( int argc, char **argv )
   if( !config.AddCksVal.empty() )
     progress.PrintAdditionalCheckSum( true );
 
+  if( config.Verbose )
+    progress.PrintAdaptiveWindow( true );
+
   //----------------------------------------------------------------------------
   // ZIP archive
   //----------------------------------------------------------------------------
@@ -309,6 +309,41 @@ namespace XrdCl
       p.Set( "chunkSize", val );
     }
 
+    if( !p.HasProperty( "adaptive" ) )
+    {
+      int val = DefaultCPAdaptive;
+      env->GetInt( "CPAdaptive", val );
+      p.Set( "adaptive", (bool)val );
+    }
+
+    if( !p.HasProperty( "maxChunkSize" ) )
+    {
+      int val = DefaultCPMaxChunkSize;
+      env->GetInt( "CPMaxChunkSize", val );
+      p.Set( "maxChunkSize", val );
+    }
+
+    if( !p.HasProperty( "maxParallelChunks" ) )
+    {
+      int val = DefaultCPMaxParallelChunks;
+      env->GetInt( "CPMaxParallelChunks", val );
+      p.Set( "maxParallelChunks", val );
+    }
+
+    if( !p.HasProperty( "maxWindow" ) )
+    {
+      int val = DefaultCPMaxWindow;
+      env->GetInt( "CPMaxWindow", val );
+      p.Set( "maxWindow", val );
+    }
+
+    if( !p.HasProperty( "directIO" ) )
+    {
+      int val = DefaultCPDirectIO;
+      env->GetInt( "CPDirectIO", val );
+      p.Set( "directIO", (bool)val );
+    }
+
     if( !p.HasProperty( "xcpBlockSize" ) )
     {
       int val = DefaultXCpBlockSize;
@@ -144,6 +144,15 @@ namespace XrdCl
       //! chunkSize      [uint32_t] - size of a copy chunks in bytes
       //! parallelChunks [uint8_t]  - number of chunks that should be requested
       //!                             in parallel
+      //! adaptive       [bool]     - tune chunkSize and parallelChunks during
+      //!                             the transfer
+      //! maxChunkSize   [uint32_t] - ceiling for chunkSize in adaptive mode
+      //! maxParallelChunks [uint16_t] - ceiling for parallelChunks in
+      //!                             adaptive mode
+      //! maxWindow      [uint64_t] - ceiling for the bytes in flight on all
+      //!                             streams in adaptive mode
+      //! directIO       [bool]     - bypass the page cache when writing to
+      //!                             a local file
       //! initTimeout    [uint16_t] - time limit for successfull initialization
       //!                             of the copy job
       //! tpcTimeout     [uint16_t] - time limit for the actual copy to finish
@@ -163,6 +172,11 @@ namespace XrdCl
       //! status         [XRootDStatus] - status of the copy operation
       //! sources        [vector<string>] - all sources used
       //! realTarget     [string]   - the actual disk server target
+      //! adaptiveChunkSize      [uint32_t] - final chunk size, adaptive mode
+      //! adaptiveParallelChunks [uint16_t] - final number of chunks in
+      //!                                     flight, adaptive mode
+      //! adaptivePeakRate       [uint64_t] - best measured rate in B/s,
+      //!                                     adaptive mode
       //------------------------------------------------------------------------
       XRootDStatus AddJob( const PropertyList &properties,
                            PropertyList       *results );
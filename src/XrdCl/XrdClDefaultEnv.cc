@@ -275,6 +275,11 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "WorkerThreads",           DefaultWorkerThreads           );
     REGISTER_VAR_INT( varsInt, "CPChunkSize",             DefaultCPChunkSize             );
     REGISTER_VAR_INT( varsInt, "CPParallelChunks",        DefaultCPParallelChunks        );
+    REGISTER_VAR_INT( varsInt, "CPAdaptive",              DefaultCPAdaptive              );
+    REGISTER_VAR_INT( varsInt, "CPMaxChunkSize",          DefaultCPMaxChunkSize          );
+    REGISTER_VAR_INT( varsInt, "CPMaxParallelChunks",     DefaultCPMaxParallelChunks     );
+    REGISTER_VAR_INT( varsInt, "CPMaxWindow",             DefaultCPMaxWindow             );
+    REGISTER_VAR_INT( varsInt, "CPDirectIO",              DefaultCPDirectIO              );
     REGISTER_VAR_INT( varsInt, "DataServerTTL",           DefaultDataServerTTL           );
     REGISTER_VAR_INT( varsInt, "LoadBalancerTTL",         DefaultLoadBalancerTTL         );
     REGISTER_VAR_INT( varsInt, "CPInitTimeout",           DefaultCPInitTimeout           );
@@ -298,6 +303,7 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "PreserveXAttrs",          DefaultPreserveXAttrs          );
     REGISTER_VAR_INT( varsInt, "NoTlsOK",                 DefaultNoTlsOK                 );
     REGISTER_VAR_INT( varsInt, "TlsNoData",               DefaultTlsNoData               );
+    REGISTER_VAR_INT( varsInt, "TlsResume",               DefaultTlsResume               );
     REGISTER_VAR_INT( varsInt, "TlsMetalink",             DefaultTlsMetalink             );
     REGISTER_VAR_INT( varsInt, "ZipMtlnCksum",            DefaultZipMtlnCksum            );
     REGISTER_VAR_INT( varsInt, "IPNoShuffle",             DefaultIPNoShuffle             );
@@ -319,6 +325,7 @@ namespace XrdCl
     REGISTER_VAR_STR( varsStr, "TlsDbgLvl",               DefaultTlsDbgLvl               );
     REGISTER_VAR_STR( varsStr, "CpTarget",                DefaultCpTarget                );
     REGISTER_VAR_STR( varsStr, "CpRetryPolicy",           DefaultCpRetryPolicy           );
+    REGISTER_VAR_STR( varsStr, "WorkerThreadsMode",       DefaultWorkerThreadsMode       );
 
     //--------------------------------------------------------------------------
     // Process the configuration files
@@ -48,15 +48,77 @@ namespace XrdCl
     return false;
   }
 
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  InQueue::InQueue()
+  {
+    for( uint32_t i = 0; i < NumChunks; ++i )
+      pChunks[i].store( nullptr, std::memory_order_relaxed );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  InQueue::~InQueue()
+  {
+    for( uint32_t i = 0; i < NumChunks; ++i )
+      delete [] pChunks[i].load( std::memory_order_relaxed );
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the slot for a SID
+  //----------------------------------------------------------------------------
+  InQueue::HandlerAndExpire &InQueue::GetSlot( uint16_t sid )
+  {
+    std::atomic<HandlerAndExpire*> &chunk = pChunks[sid / SlotChunk];
+    HandlerAndExpire *slots = chunk.load( std::memory_order_acquire );
+    if( !slots )
+    {
+      HandlerAndExpire *newSlots = new HandlerAndExpire[SlotChunk];
+      for( uint32_t i = 0; i < SlotChunk; ++i )
+        newSlots[i] = HandlerAndExpire( nullptr, 0 );
+      if( chunk.compare_exchange_strong( slots, newSlots,
+                                         std::memory_order_acq_rel ) )
+        slots = newSlots;
+      else
+        delete [] newSlots;
+    }
+    return slots[sid % SlotChunk];
+  }
+
+  //----------------------------------------------------------------------------
+  // Call func for every registered handler. Only one thread at a time walks
+  // the table and it holds one stripe at a time; the callbacks may therefore
+  // re-enter the queue without risking a lock order inversion.
+  //----------------------------------------------------------------------------
+  template<typename Func>
+  void InQueue::ForEachHandler( Func func )
+  {
+    XrdSysMutexHelper reportLock( pReportMutex );
+    for( uint32_t s = 0; s < NumStripes; ++s )
+    {
+      XrdSysMutexHelper scopedLock( pStripes[s].mtx );
+      for( uint32_t c = 0; c < NumChunks; ++c )
+      {
+        HandlerAndExpire *slots = pChunks[c].load( std::memory_order_acquire );
+        if( !slots ) continue;
+        for( uint32_t i = s; i < SlotChunk; i += NumStripes )
+          if( slots[i].first )
+            func( uint16_t( c * SlotChunk + i ), slots[i] );
+      }
+    }
+  }
+
   //----------------------------------------------------------------------------
   // Add a listener that should be notified about incoming messages
   //----------------------------------------------------------------------------
   void InQueue::AddMessageHandler( MsgHandler *handler, bool &rmMsg )
   {
     uint16_t handlerSid = handler->GetSid();
-    XrdSysMutexHelper scopedLock( pMutex );
+    XrdSysMutexHelper scopedLock( StripeMutex( handlerSid ) );
 
-    pHandlers[handlerSid] = HandlerAndExpire( handler, 0 );
+    GetSlot( handlerSid ) = HandlerAndExpire( handler, 0 );
   }
 
   //----------------------------------------------------------------------------
@@ -77,27 +139,27 @@ namespace XrdCl
       return handler;
     }
 
-    XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.find(msgSid);
+    XrdSysMutexHelper scopedLock( StripeMutex( msgSid ) );
+    HandlerAndExpire &slot = GetSlot( msgSid );
 
-    if (it != pHandlers.end())
+    if (slot.first)
     {
       Log *log = DefaultEnv::GetLog();
-      handler = it->second.first;
+      handler = slot.first;
       act     = handler->Examine( msg );
-      if( it->second.second == 0 ) {
-        it->second.second = handler->GetExpiration();
+      if( slot.second == 0 ) {
+        slot.second = handler->GetExpiration();
         log->Debug( ExDbgMsg, "[handler: %p] Assigned expiration %lld.",
-                    handler, (long long)it->second.second );
+                    handler, (long long)slot.second );
       }
-      exp     = it->second.second;
+      exp     = slot.second;
       log->Debug( ExDbgMsg, "[msg: %p] Assigned MsgHandler: %p.",
                   msg.get(), handler );
 
 
       if( act & MsgHandler::RemoveHandler )
       {
-        pHandlers.erase( it );
+        slot = HandlerAndExpire( nullptr, 0 );
         log->Debug( ExDbgMsg, "[handler: %p] Removed MsgHandler: %p from the in-queue.",
                     handler, handler );
       }
@@ -119,8 +181,8 @@ namespace XrdCl
 				     time_t              expires )
   {
     uint16_t handlerSid = handler->GetSid();
-    XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+    XrdSysMutexHelper scopedLock( StripeMutex( handlerSid ) );
+    GetSlot( handlerSid ) = HandlerAndExpire( handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -129,8 +191,8 @@ namespace XrdCl
   void InQueue::RemoveMessageHandler( MsgHandler *handler )
   {
     uint16_t handlerSid = handler->GetSid();
-    XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers.erase(handlerSid);
+    XrdSysMutexHelper scopedLock( StripeMutex( handlerSid ) );
+    GetSlot( handlerSid ) = HandlerAndExpire( nullptr, 0 );
     Log *log = DefaultEnv::GetLog();
     log->Debug( ExDbgMsg, "[handler: %p] Removed MsgHandler: %p from the in-queue.",
                 handler, handler );
@@ -143,21 +205,13 @@ namespace XrdCl
   void InQueue::ReportStreamEvent( MsgHandler::StreamEvent event,
 				   XRootDStatus                    status )
   {
-    uint8_t action = 0;
-    XrdSysMutexHelper scopedLock( pMutex );
-    for( HandlerMap::iterator it = pHandlers.begin(); it != pHandlers.end(); )
+    ForEachHandler( [&]( uint16_t, HandlerAndExpire &slot )
     {
-      action = it->second.first->OnStreamEvent( event, status );
+      uint8_t action = slot.first->OnStreamEvent( event, status );
 
       if( action & MsgHandler::RemoveHandler )
-      {
-        auto next = it; ++next;
-        pHandlers.erase( it );
-        it = next;
-      }
-      else
-        ++it;
-    }
+        slot = HandlerAndExpire( nullptr, 0 );
+    } );
   }
 
   //----------------------------------------------------------------------------
@@ -168,22 +222,16 @@ namespace XrdCl
     if( !now )
       now = ::time(0);
 
-    XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.begin();
-    while( it != pHandlers.end() )
+    ForEachHandler( [&]( uint16_t, HandlerAndExpire &slot )
     {
-      if( it->second.second && it->second.second <= now )
+      if( slot.second && slot.second <= now )
       {
-        uint8_t act = it->second.first->OnStreamEvent( MsgHandler::Timeout,
+        uint8_t act = slot.first->OnStreamEvent( MsgHandler::Timeout,
                                          Status( stError, errOperationExpired ) );
-        auto next = it; ++next;
         if( act & MsgHandler::RemoveHandler )
-          pHandlers.erase( it );
-        it = next;
+          slot = HandlerAndExpire( nullptr, 0 );
       }
-      else
-        ++it;
-    }
+    } );
   }
 
   //----------------------------------------------------------------------------
@@ -192,17 +240,17 @@ namespace XrdCl
   void InQueue::AssignTimeout( MsgHandler *handler )
   {
     uint16_t handlerSid = handler->GetSid();
-    XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.find( handlerSid );
-    if( it != pHandlers.end() )
+    XrdSysMutexHelper scopedLock( StripeMutex( handlerSid ) );
+    HandlerAndExpire &slot = GetSlot( handlerSid );
+    if( slot.first )
     {
-      if( it->second.second == 0 )
+      if( slot.second == 0 )
       {
-        it->second.second   = handler->GetExpiration();
+        slot.second   = handler->GetExpiration();
 
         Log *log = DefaultEnv::GetLog();
         log->Debug( ExDbgMsg, "[handler: %p] Assigned expiration %lld.",
-                    handler, (long long)it->second.second );
+                    handler, (long long)slot.second );
 
       }
     }
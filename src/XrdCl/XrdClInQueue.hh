@@ -20,7 +20,7 @@
 #define __XRD_CL_IN_QUEUE_HH__
 
 #include <XrdSys/XrdSysPthread.hh>
-#include <map>
+#include <atomic>
 #include <memory>
 #include <utility>
 #include "XrdCl/XrdClXRootDResponses.hh"
@@ -32,10 +32,24 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! A synchronize queue for incoming data
+  //!
+  //! Handlers are kept in a table indexed directly by the 16-bit SID. The
+  //! table is split into chunks allocated on first use and access to a slot
+  //! is serialized by one of several lock stripes selected by the SID, so
+  //! responses for different requests can be matched concurrently.
   //----------------------------------------------------------------------------
   class InQueue
   {
     public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      InQueue();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~InQueue();
       //------------------------------------------------------------------------
       //! Add a listener that should be notified about incoming messages.
       //! Freshly added handlers have no expire time set and will not trigger
@@ -107,10 +121,35 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool DiscardMessage(Message& msg, uint16_t& sid) const;
 
+      //------------------------------------------------------------------------
+      //! Get the slot for a SID, creating its chunk if needed
+      //------------------------------------------------------------------------
       typedef std::pair<MsgHandler *, time_t> HandlerAndExpire;
-      typedef std::map<uint16_t, HandlerAndExpire> HandlerMap;
-      HandlerMap pHandlers;
-      XrdSysRecMutex pMutex;
+      HandlerAndExpire &GetSlot( uint16_t sid );
+
+      //------------------------------------------------------------------------
+      //! Call func( sid, slot ) for every registered handler, the stripe of
+      //! the slot is locked during the call
+      //------------------------------------------------------------------------
+      template<typename Func> void ForEachHandler( Func func );
+
+      static const uint32_t SlotChunk  = 256;
+      static const uint32_t NumChunks  = 65536 / SlotChunk;
+      static const uint32_t NumStripes = 16;
+
+      struct alignas(64) Stripe
+      {
+        XrdSysRecMutex mtx;
+      };
+
+      XrdSysRecMutex &StripeMutex( uint16_t sid )
+      {
+        return pStripes[sid % NumStripes].mtx;
+      }
+
+      std::atomic<HandlerAndExpire*> pChunks[NumChunks];
+      Stripe                         pStripes[NumStripes];
+      XrdSysRecMutex                 pReportMutex;
   };
 }
 
@@ -22,6 +22,10 @@
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdSys/XrdSysE2T.hh"
 
+#include <atomic>
+#include <deque>
+#include <memory>
+
 //------------------------------------------------------------------------------
 // The thread
 //------------------------------------------------------------------------------
@@ -36,8 +40,140 @@ extern "C"
   }
 }
 
+namespace
+{
+  //----------------------------------------------------------------------------
+  // The job manager the calling thread works for and its index
+  //----------------------------------------------------------------------------
+  thread_local XrdCl::JobManager *myManager = 0;
+  thread_local uint32_t           myIndex   = 0;
+}
+
 namespace XrdCl
 {
+  //----------------------------------------------------------------------------
+  // Work-stealing state: a queue per worker and a semaphore counting the jobs
+  // queued in all of them
+  //----------------------------------------------------------------------------
+  struct JobManager::StealQueues
+  {
+    struct alignas(64) WorkerQueue
+    {
+      XrdSysMutex           mtx;
+      std::deque<JobHelper> jobs;
+    };
+
+    StealQueues( uint32_t workers ): queues( new WorkerQueue[workers] ),
+      pending( 0 ), nextQueue( 0 ), nextWorker( 0 ) { }
+
+    std::unique_ptr<WorkerQueue[]> queues;
+    XrdSysSemaphore                pending;
+    std::atomic<uint32_t>          nextQueue;
+    std::atomic<uint32_t>          nextWorker;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  JobManager::JobManager( uint32_t workers, bool steal ):
+    pRunning( false ), pSteal( 0 )
+  {
+    pWorkers.resize( workers );
+    if( steal && workers > 1 )
+      pSteal = new StealQueues( workers );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  JobManager::~JobManager()
+  {
+    delete pSteal;
+  }
+
+  //----------------------------------------------------------------------------
+  // Add a job to be run
+  //----------------------------------------------------------------------------
+  void JobManager::QueueJob( Job *job, void *arg )
+  {
+    if( !pSteal )
+    {
+      pJobs.Put( JobHelper( job, arg ) );
+      return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Jobs spawned by a worker stay local, others are spread round robin
+    //--------------------------------------------------------------------------
+    uint32_t q = ( myManager == this ? myIndex
+                 : pSteal->nextQueue.fetch_add( 1, std::memory_order_relaxed ) );
+    PutJob( q % pWorkers.size(), JobHelper( job, arg ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Add a job to be run by the worker associated with the affinity key
+  //----------------------------------------------------------------------------
+  void JobManager::QueueJob( Job *job, void *arg, uintptr_t affinity )
+  {
+    if( !pSteal )
+    {
+      pJobs.Put( JobHelper( job, arg ) );
+      return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Keys are usually object addresses, mix the bits before taking a modulo
+    //--------------------------------------------------------------------------
+    uint64_t h = (uint64_t)affinity * 0x9E3779B97F4A7C15ULL;
+    PutJob( ( h >> 32 ) % pWorkers.size(), JobHelper( job, arg ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Check if the calling thread is one of our workers
+  //----------------------------------------------------------------------------
+  bool JobManager::IsWorker()
+  {
+    return myManager == this;
+  }
+
+  //----------------------------------------------------------------------------
+  // Put a job in the given worker queue
+  //----------------------------------------------------------------------------
+  void JobManager::PutJob( uint32_t queue, const JobHelper &h )
+  {
+    StealQueues::WorkerQueue &q = pSteal->queues[queue];
+    {
+      XrdSysMutexHelper scopedLock( q.mtx );
+      q.jobs.push_back( h );
+    }
+    pSteal->pending.Post();
+  }
+
+  //----------------------------------------------------------------------------
+  // Take a job, from our own queue if possible, otherwise steal one. The
+  // semaphore counts queued jobs so once we get past it there is a job for
+  // us in one of the queues.
+  //----------------------------------------------------------------------------
+  JobManager::JobHelper JobManager::TakeJob( uint32_t self )
+  {
+    pSteal->pending.Wait();
+    const uint32_t n = pWorkers.size();
+    for( ;; )
+    {
+      for( uint32_t i = 0; i < n; ++i )
+      {
+        StealQueues::WorkerQueue &q = pSteal->queues[( self + i ) % n];
+        XrdSysMutexHelper scopedLock( q.mtx );
+        if( !q.jobs.empty() )
+        {
+          JobHelper h = q.jobs.front();
+          q.jobs.pop_front();
+          return h;
+        }
+      }
+    }
+  }
+
   //----------------------------------------------------------------------------
   // Initialize the job manager
   //----------------------------------------------------------------------------
@@ -52,6 +188,15 @@ namespace XrdCl
   bool JobManager::Finalize()
   {
     pJobs.Clear();
+    if( pSteal )
+    {
+      for( uint32_t i = 0; i < pWorkers.size(); ++i )
+      {
+        XrdSysMutexHelper scopedLock( pSteal->queues[i].mtx );
+        pSteal->queues[i].jobs.clear();
+      }
+      while( pSteal->pending.CondWait() ) { }
+    }
     return true;
   }
 
@@ -83,7 +228,8 @@ namespace XrdCl
       }
     }
     pRunning = true;
-    log->Debug( JobMgrMsg, "Job manager started, %zu workers", pWorkers.size() );
+    log->Debug( JobMgrMsg, "Job manager started, %zu workers%s", pWorkers.size(),
+                pSteal ? " with work stealing" : "" );
     return true;
   }
 
@@ -145,10 +291,15 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void JobManager::RunJobs()
   {
+    myManager = this;
+    if( pSteal )
+      myIndex = pSteal->nextWorker.fetch_add( 1, std::memory_order_relaxed )
+              % pWorkers.size();
+
     pthread_setcanceltype( PTHREAD_CANCEL_DEFERRED, 0 );
     for( ;; )
     {
-      JobHelper h = pJobs.Get();
+      JobHelper h = pSteal ? TakeJob( myIndex ) : pJobs.Get();
       pthread_setcancelstate( PTHREAD_CANCEL_DISABLE, 0 );
       h.job->Run( h.arg );
       pthread_setcancelstate( PTHREAD_CANCEL_ENABLE, 0 );
@@ -46,25 +46,28 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! A synchronized queue
+  //!
+  //! By default all workers share a single FIFO queue. In work-stealing mode
+  //! each worker owns a queue; jobs queued with an affinity key always go to
+  //! the same worker, jobs queued by a worker go to its own queue, and idle
+  //! workers take jobs from the queues of busy ones.
   //----------------------------------------------------------------------------
   class JobManager
   {
     public:
       //------------------------------------------------------------------------
       //! Constructor
+      //!
+      //! @param workers number of worker threads
+      //! @param steal   give every worker its own queue and let idle workers
+      //!                steal from busy ones
       //------------------------------------------------------------------------
-      JobManager( uint32_t workers )
-      {
-        pRunning = false;
-        pWorkers.resize( workers );
-      }
+      JobManager( uint32_t workers, bool steal = false );
 
       //------------------------------------------------------------------------
       //! Destructor
       //------------------------------------------------------------------------
-      ~JobManager()
-      {
-      }
+      ~JobManager();
 
       //------------------------------------------------------------------------
       //! Initialize the job manager
@@ -89,23 +92,25 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Add a job to be run
       //------------------------------------------------------------------------
-      void QueueJob( Job *job, void *arg = 0 )
-      {
-        pJobs.Put( JobHelper( job, arg ) );
-      }
+      void QueueJob( Job *job, void *arg = 0 );
+
+      //------------------------------------------------------------------------
+      //! Add a job to be run by the worker associated with the affinity key,
+      //! e.g. the address of the stream that produced a response, so that
+      //! related jobs keep hitting the same worker. The key is ignored unless
+      //! work stealing is enabled.
+      //------------------------------------------------------------------------
+      void QueueJob( Job *job, void *arg, uintptr_t affinity );
 
       //------------------------------------------------------------------------
       //! Run the jobs
       //------------------------------------------------------------------------
       void RunJobs();
 
-      bool IsWorker()
-      {
-        pthread_t thread = pthread_self();
-        std::vector<pthread_t>::iterator itr =
-            std::find( pWorkers.begin(), pWorkers.end(), thread );
-        return itr != pWorkers.end();
-      }
+      //------------------------------------------------------------------------
+      //! Check if the calling thread is one of our workers
+      //------------------------------------------------------------------------
+      bool IsWorker();
 
     private:
       //------------------------------------------------------------------------
@@ -120,10 +125,23 @@ namespace XrdCl
         void *arg;
       };
 
+      //------------------------------------------------------------------------
+      //! Work-stealing state, defined in the implementation so that the
+      //! layout of the class only grows by a pointer
+      //------------------------------------------------------------------------
+      struct StealQueues;
+
+      //------------------------------------------------------------------------
+      //! Work-stealing helpers
+      //------------------------------------------------------------------------
+      void      PutJob( uint32_t queue, const JobHelper &h );
+      JobHelper TakeJob( uint32_t self );
+
       std::vector<pthread_t> pWorkers;
       SyncQueue<JobHelper>   pJobs;
       XrdSysMutex            pMutex;
       bool                   pRunning;
+      StealQueues           *pSteal; //!< null unless work stealing is enabled
   };
 }
 
@@ -41,6 +41,10 @@
 #include <arpa/inet.h>
 #include <aio.h>
 
+#ifndef O_DIRECT
+#define O_DIRECT 0
+#endif
+
 namespace
 {
 
@@ -224,7 +228,7 @@ namespace XrdCl
   // Constructor
   //------------------------------------------------------------------------
   LocalFileHandler::LocalFileHandler() :
-      fd( -1 )
+      fd( -1 ), pDirectIO( false )
   {
   }
 
@@ -316,6 +320,7 @@ namespace XrdCl
   XRootDStatus LocalFileHandler::Read( uint64_t offset, uint32_t size,
       void* buffer, ResponseHandler* handler, uint16_t timeout )
   {
+    CheckDirectIO( offset, size, buffer );
 #if defined(__APPLE__)
     Log *log = DefaultEnv::GetLog();
     int read = 0;
@@ -356,6 +361,7 @@ namespace XrdCl
                                         ResponseHandler *handler,
                                         uint16_t         timeout )
   {
+    if( pDirectIO ) DisableDirectIO();
     Log *log = DefaultEnv::GetLog();
 #if defined(__APPLE__)
     ssize_t ret = lseek( fd, offset, SEEK_SET );
@@ -393,6 +399,7 @@ namespace XrdCl
   XRootDStatus LocalFileHandler::Write( uint64_t offset, uint32_t size,
       const void* buffer, ResponseHandler* handler, uint16_t timeout )
   {
+    CheckDirectIO( offset, size, buffer );
 #if defined(__APPLE__)
     const char *buff = reinterpret_cast<const char*>( buffer );
     size_t bytesWritten = 0;
@@ -483,6 +490,7 @@ namespace XrdCl
   XRootDStatus LocalFileHandler::VectorRead( const ChunkList& chunks,
       void* buffer, ResponseHandler* handler, uint16_t timeout )
   {
+    if( pDirectIO ) DisableDirectIO();
     std::unique_ptr<VectorReadInfo> info( new VectorReadInfo() );
     size_t totalSize = 0;
     bool useBuffer( buffer );
@@ -520,6 +528,7 @@ namespace XrdCl
   XRootDStatus LocalFileHandler::VectorWrite( const ChunkList &chunks,
       ResponseHandler *handler, uint16_t timeout )
   {
+    if( pDirectIO ) DisableDirectIO();
 
     for( auto itr = chunks.begin(); itr != chunks.end(); ++itr )
     {
@@ -547,6 +556,7 @@ namespace XrdCl
                                          ResponseHandler    *handler,
                                          uint16_t            timeout )
   {
+    if( pDirectIO ) DisableDirectIO();
     size_t iovcnt = chunks->size();
     iovec iovcp[iovcnt];
     ssize_t size = 0;
@@ -832,7 +842,7 @@ namespace XrdCl
     //---------------------------------------------------------------------
     // Prepare Flags
     //---------------------------------------------------------------------
-    uint16_t openflags = 0;
+    int openflags = 0;
     if( flags & kXR_new )
       openflags |= O_CREAT | O_EXCL;
     if( flags & kXR_open_wrto )
@@ -860,7 +870,22 @@ namespace XrdCl
     //---------------------------------------------------------------------
     if( mode == Access::Mode::None)
       mode = 0644;
-    fd = XrdSysFD_Open( path.c_str(), openflags, mode );
+
+    //---------------------------------------------------------------------
+    // Direct I/O is requested with xrdcl.directio=1, if the file system
+    // does not support it we silently open the file for buffered I/O
+    //---------------------------------------------------------------------
+    URL::ParamsMap params = fileUrl.GetParams();
+    URL::ParamsMap::const_iterator itr = params.find( "xrdcl.directio" );
+    pDirectIO = O_DIRECT && itr != params.end() && itr->second == "1";
+    fd = XrdSysFD_Open( path.c_str(), openflags | ( pDirectIO ? O_DIRECT : 0 ), mode );
+    if( fd == -1 && pDirectIO && errno == EINVAL )
+    {
+      log->Debug( FileMsg, "Open: direct I/O not supported for %s",
+                  path.c_str() );
+      pDirectIO = false;
+      fd = XrdSysFD_Open( path.c_str(), openflags, mode );
+    }
     if( fd == -1 )
     {
       log->Error( FileMsg, "Open: open failed: %s: %s", path.c_str(),
@@ -892,6 +917,22 @@ namespace XrdCl
       return XRootDStatus( stError, errLocalError, kXR_FSError );
     }
 
+#ifdef __linux__
+    //---------------------------------------------------------------------
+    // Honour the oss.asize hint for newly created files the way the server
+    // does: reserve the space up front so that the file is laid out in as
+    // few extents as possible. The file size is left untouched.
+    //---------------------------------------------------------------------
+    itr = params.find( "oss.asize" );
+    if( itr != params.end() && ( flags & ( kXR_new | kXR_delete ) ) )
+    {
+      long long asize = atoll( itr->second.c_str() );
+      if( asize > 0 && fallocate( fd, FALLOC_FL_KEEP_SIZE, 0, asize ) )
+        log->Debug( FileMsg, "Open: could not preallocate %lld bytes for %s: %s",
+                    asize, path.c_str(), XrdSysE2T( errno ) );
+    }
+#endif
+
     // add the URL to hosts list
     pHostList.push_back( HostInfo( pUrl, false ) );
 
@@ -903,6 +944,21 @@ namespace XrdCl
     return XRootDStatus();
   }
 
+  //------------------------------------------------------------------------
+  // Clear O_DIRECT, all further I/O on this file will be buffered
+  //------------------------------------------------------------------------
+  void LocalFileHandler::DisableDirectIO()
+  {
+    if( !pDirectIO.exchange( false ) ) return;
+    int flags = fcntl( fd, F_GETFL );
+    if( flags == -1 || fcntl( fd, F_SETFL, flags & ~O_DIRECT ) == -1 )
+    {
+      Log *log = DefaultEnv::GetLog();
+      log->Warning( FileMsg, "Unable to switch off direct I/O for %s: %s",
+                    pUrl.c_str(), XrdSysE2T( errno ) );
+    }
+  }
+
   //------------------------------------------------------------------------
   // Parses kXR_fattr request and calls respective XAttr operation
   //------------------------------------------------------------------------
@@ -23,6 +23,7 @@
 #include "XrdCl/XrdClLog.hh"
 
 #include <sys/uio.h>
+#include <atomic>
 
 namespace XrdCl
 {
@@ -321,6 +322,21 @@ namespace XrdCl
       XRootDStatus OpenImpl( const std::string &url, uint16_t flags,
                              uint16_t mode, AnyObject *&resp );
 
+      //------------------------------------------------------------------------
+      //! Fall back to buffered I/O if the file was opened for direct I/O and
+      //! the request does not meet its alignment constraints
+      //------------------------------------------------------------------------
+      inline void CheckDirectIO( uint64_t offset, uint64_t size, const void *buffer )
+      {
+        if( pDirectIO &&
+            ( ( offset | size | (uintptr_t)buffer ) & ( DirectIOAlign - 1 ) ) )
+          DisableDirectIO();
+      }
+
+      void DisableDirectIO();
+
+      static const uint64_t DirectIOAlign = 4096;
+
       //------------------------------------------------------------------------
       //! Parses kXR_fattr request and calls respective XAttr operation
       //------------------------------------------------------------------------
@@ -345,6 +361,11 @@ namespace XrdCl
       //---------------------------------------------------------------------
       HostList pHostList;
 
+      //---------------------------------------------------------------------
+      // True while the file descriptor has O_DIRECT set
+      //---------------------------------------------------------------------
+      std::atomic<bool> pDirectIO;
+
   };
 }
 #endif
@@ -62,9 +62,11 @@ namespace XrdCl
       Env *env = DefaultEnv::GetEnv();
       int workerThreads = DefaultWorkerThreads;
       env->GetInt( "WorkerThreads", workerThreads );
+      std::string workerMode = DefaultWorkerThreadsMode;
+      env->GetString( "WorkerThreadsMode", workerMode );
 
       pTaskManager = new TaskManager();
-      pJobManager  = new JobManager(workerThreads);
+      pJobManager  = new JobManager( workerThreads, workerMode == "steal" );
     }
 
     ~PostMasterImpl()
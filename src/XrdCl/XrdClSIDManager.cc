@@ -18,40 +18,109 @@
 
 #include "XrdCl/XrdClSIDManager.hh"
 
-#include <algorithm>
+#include <cstring>
 
 namespace XrdCl
 {
   //----------------------------------------------------------------------------
-  // Allocate a SID
-  //---------------------------------------------------------------------------
-  Status SIDManager::AllocateSID( uint8_t sid[2] )
+  // Constructor
+  //----------------------------------------------------------------------------
+  SIDManager::SIDManager(): pHint( 0 ), pNumAlloc( 0 ), pNumTimedOut( 0 ),
+    pRefCount( 0 )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-
-    uint16_t allocSID = 1;
+    for( uint32_t i = 0; i < MapWords; ++i )
+    {
+      pAllocMap[i].store( 0, std::memory_order_relaxed );
+      pTimeOutMap[i].store( 0, std::memory_order_relaxed );
+    }
+    for( uint32_t i = 0; i < TimeChunks; ++i )
+      pAllocTime[i].store( nullptr, std::memory_order_relaxed );
 
     //--------------------------------------------------------------------------
-    // Get a SID from the list of free SIDs if it's not empty
+    // SID 0 and 0xffff are never handed out
     //--------------------------------------------------------------------------
-    if( !pFreeSIDs.empty() )
+    pAllocMap[0].store( 1ULL, std::memory_order_relaxed );
+    pAllocMap[MapWords - 1].store( 1ULL << 63, std::memory_order_relaxed );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  SIDManager::~SIDManager()
+  {
+    for( uint32_t i = 0; i < TimeChunks; ++i )
+      delete [] pAllocTime[i].load( std::memory_order_relaxed );
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the allocation time slot of a SID
+  //----------------------------------------------------------------------------
+  std::atomic<time_t> &SIDManager::AllocTime( uint16_t sid )
+  {
+    std::atomic<std::atomic<time_t>*> &chunk = pAllocTime[sid / TimeChunk];
+    std::atomic<time_t> *times = chunk.load( std::memory_order_acquire );
+    if( !times )
     {
-      allocSID = pFreeSIDs.front();
-      pFreeSIDs.pop_front();
+      std::atomic<time_t> *newTimes = new std::atomic<time_t>[TimeChunk]();
+      if( chunk.compare_exchange_strong( times, newTimes,
+                                         std::memory_order_acq_rel ) )
+        times = newTimes;
+      else
+        delete [] newTimes;
     }
+    return times[sid % TimeChunk];
+  }
+
+  //----------------------------------------------------------------------------
+  // Return a SID to the free pool
+  //----------------------------------------------------------------------------
+  void SIDManager::FreeSID( uint16_t sid )
+  {
+    uint32_t word = sid / 64;
+    uint64_t bit  = 1ULL << ( sid % 64 );
+    if( pAllocMap[word].fetch_and( ~bit, std::memory_order_release ) & bit )
+      pNumAlloc.fetch_sub( 1, std::memory_order_relaxed );
+
+    //--------------------------------------------------------------------------
+    // Prefer reusing low SIDs, the hint is advisory so races are harmless
+    //--------------------------------------------------------------------------
+    if( word < pHint.load( std::memory_order_relaxed ) )
+      pHint.store( word, std::memory_order_relaxed );
+  }
+
+  //----------------------------------------------------------------------------
+  // Allocate a SID
+  //---------------------------------------------------------------------------
+  Status SIDManager::AllocateSID( uint8_t sid[2] )
+  {
+    uint32_t start = pHint.load( std::memory_order_relaxed );
+
     //--------------------------------------------------------------------------
-    // Allocate a new SID if possible
+    // Find the first word with a clear bit starting at the hint and claim
+    // its lowest clear bit
     //--------------------------------------------------------------------------
-    else
+    for( uint32_t n = 0; n < MapWords; ++n )
     {
-      if( pSIDCeiling == 0xffff )
-        return Status( stError, errNoMoreFreeSIDs );
-      allocSID = pSIDCeiling++;
+      uint32_t word = ( start + n ) % MapWords;
+      uint64_t bits = pAllocMap[word].load( std::memory_order_relaxed );
+      while( bits != ~0ULL )
+      {
+        uint64_t bit = ~bits & ( bits + 1 );
+        if( pAllocMap[word].compare_exchange_weak( bits, bits | bit,
+                                                   std::memory_order_acquire,
+                                                   std::memory_order_relaxed ) )
+        {
+          uint16_t allocSID = word * 64 + __builtin_ctzll( bit );
+          pNumAlloc.fetch_add( 1, std::memory_order_relaxed );
+          if( word != start ) pHint.store( word, std::memory_order_relaxed );
+          AllocTime( allocSID ).store( time(0), std::memory_order_relaxed );
+          memcpy( sid, &allocSID, 2 );
+          return Status();
+        }
+      }
     }
 
-    memcpy( sid, &allocSID, 2 );
-    pAllocTime[allocSID] = time(0);
-    return Status();
+    return Status( stError, errNoMoreFreeSIDs );
   }
 
   //----------------------------------------------------------------------------
@@ -59,11 +128,10 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void SIDManager::ReleaseSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t relSID = 0;
     memcpy( &relSID, sid, 2 );
-    pFreeSIDs.push_back( relSID );
-    pAllocTime.erase( relSID );
+    AllocTime( relSID ).store( 0, std::memory_order_relaxed );
+    FreeSID( relSID );
   }
 
   //----------------------------------------------------------------------------
@@ -71,11 +139,12 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void SIDManager::TimeOutSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.insert( tiSID );
-    pAllocTime.erase( tiSID );
+    uint64_t bit = 1ULL << ( tiSID % 64 );
+    if( !( pTimeOutMap[tiSID / 64].fetch_or( bit ) & bit ) )
+      pNumTimedOut.fetch_add( 1, std::memory_order_relaxed );
+    AllocTime( tiSID ).store( 0, std::memory_order_relaxed );
   }
 
   //----------------------------------------------------------------------------
@@ -83,12 +152,17 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   bool SIDManager::IsAnySIDOldAs( const time_t tlim ) const
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-    return std::any_of( pAllocTime.begin(), pAllocTime.end(),
-                        [tlim](const auto& p)
+    for( uint32_t c = 0; c < TimeChunks; ++c )
     {
-      return p.second <= tlim;
-    } );
+      std::atomic<time_t> *times = pAllocTime[c].load( std::memory_order_acquire );
+      if( !times ) continue;
+      for( uint32_t i = 0; i < TimeChunk; ++i )
+      {
+        time_t t = times[i].load( std::memory_order_relaxed );
+        if( t && t <= tlim ) return true;
+      }
+    }
+    return false;
   }
 
   //----------------------------------------------------------------------------
@@ -96,13 +170,10 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   bool SIDManager::IsTimedOut( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    std::set<uint16_t>::iterator it = pTimeOutSIDs.find( tiSID );
-    if( it != pTimeOutSIDs.end() )
-      return true;
-    return false;
+    uint64_t bit = 1ULL << ( tiSID % 64 );
+    return pTimeOutMap[tiSID / 64].load( std::memory_order_acquire ) & bit;
   }
 
   //----------------------------------------------------------------------------
@@ -110,11 +181,12 @@ namespace XrdCl
   //-----------------------------------------------------------------------------
   void SIDManager::ReleaseTimedOut( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.erase( tiSID );
-    pFreeSIDs.push_back( tiSID );
+    uint64_t bit = 1ULL << ( tiSID % 64 );
+    if( pTimeOutMap[tiSID / 64].fetch_and( ~bit ) & bit )
+      pNumTimedOut.fetch_sub( 1, std::memory_order_relaxed );
+    FreeSID( tiSID );
   }
 
   //------------------------------------------------------------------------
@@ -122,11 +194,19 @@ namespace XrdCl
   //------------------------------------------------------------------------
   void SIDManager::ReleaseAllTimedOut()
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-    std::set<uint16_t>::iterator it;
-    for( it = pTimeOutSIDs.begin(); it != pTimeOutSIDs.end(); ++it )
-      pFreeSIDs.push_back( *it );
-    pTimeOutSIDs.clear();
+    for( uint32_t word = 0; word < MapWords; ++word )
+    {
+      if( !pTimeOutMap[word].load( std::memory_order_relaxed ) ) continue;
+      uint64_t bits = pTimeOutMap[word].exchange( 0 );
+      if( !bits ) continue;
+      pNumTimedOut.fetch_sub( __builtin_popcountll( bits ),
+                              std::memory_order_relaxed );
+      while( bits )
+      {
+        FreeSID( word * 64 + __builtin_ctzll( bits ) );
+        bits &= bits - 1;
+      }
+    }
   }
 
   //----------------------------------------------------------------------------
@@ -134,8 +214,9 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   uint16_t SIDManager::GetNumberOfAllocatedSIDs() const
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-    return pSIDCeiling - pFreeSIDs.size() - pTimeOutSIDs.size() - 1;
+    int64_t n = (int64_t)pNumAlloc.load( std::memory_order_relaxed )
+              - (int64_t)pNumTimedOut.load( std::memory_order_relaxed );
+    return n > 0 ? n : 0;
   }
 
   //----------------------------------------------------------------------------
@@ -19,12 +19,12 @@
 #ifndef __XRD_CL_SID_MANAGER_HH__
 #define __XRD_CL_SID_MANAGER_HH__
 
-#include <list>
-#include <set>
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <string>
 #include <cstdint>
+#include <ctime>
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdCl/XrdClStatus.hh"
 #include "XrdCl/XrdClURL.hh"
@@ -38,6 +38,12 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! Handle XRootD stream IDs
+  //!
+  //! The 16-bit SID space is tracked by two bitmaps, one for allocated and
+  //! one for timed out SIDs, whose words are updated with atomic operations.
+  //! Allocation and release do not take a lock, they pick the lowest free
+  //! bit at or after a hint so that the SIDs in use stay densely packed.
+  //! Allocation times are kept in chunks that are created on first use.
   //----------------------------------------------------------------------------
   class SIDManager
   {
@@ -48,7 +54,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Constructor
       //------------------------------------------------------------------------
-      SIDManager(): pSIDCeiling(1), pRefCount(0) { }
+      SIDManager();
 
 #if __cplusplus < 201103L
     //------------------------------------------------------------------------
@@ -61,7 +67,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Destructor
       //------------------------------------------------------------------------
-      ~SIDManager() { }
+      ~SIDManager();
 
     public:
 
@@ -108,8 +114,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       uint32_t NumberOfTimedOutSIDs() const
       {
-        XrdSysMutexHelper scopedLock( pMutex );
-        return pTimeOutSIDs.size();
+        return pNumTimedOut.load( std::memory_order_relaxed );
       }
 
       //------------------------------------------------------------------------
@@ -118,12 +123,28 @@ namespace XrdCl
       uint16_t GetNumberOfAllocatedSIDs() const;
 
     private:
-      std::unordered_map<uint16_t, time_t> pAllocTime;
-      std::list<uint16_t>  pFreeSIDs;
-      std::set<uint16_t>   pTimeOutSIDs;
-      uint16_t             pSIDCeiling;
-      mutable XrdSysMutex  pMutex;
-      mutable size_t       pRefCount;
+      static const uint32_t MapWords   = 65536 / 64;
+      static const uint32_t TimeChunk  = 1024;
+      static const uint32_t TimeChunks = 65536 / TimeChunk;
+
+      //------------------------------------------------------------------------
+      //! Get the allocation time slot of a SID, creating its chunk if needed
+      //------------------------------------------------------------------------
+      std::atomic<time_t> &AllocTime( uint16_t sid );
+
+      //------------------------------------------------------------------------
+      //! Return a SID to the free pool
+      //------------------------------------------------------------------------
+      void FreeSID( uint16_t sid );
+
+      std::atomic<uint64_t>             pAllocMap[MapWords];
+      std::atomic<uint64_t>             pTimeOutMap[MapWords];
+      std::atomic<std::atomic<time_t>*> pAllocTime[TimeChunks];
+      std::atomic<uint32_t>             pHint;
+      std::atomic<uint32_t>             pNumAlloc;
+      std::atomic<uint32_t>             pNumTimedOut;
+      mutable XrdSysMutex               pMutex;
+      mutable size_t                    pRefCount;
   };
 
   //----------------------------------------------------------------------------
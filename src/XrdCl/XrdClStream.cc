@@ -535,7 +535,7 @@ namespace XrdCl
     }
 
     Job *job = new HandleIncMsgJob( handler );
-    pJobManager->QueueJob( job );
+    pJobManager->QueueJob( job, 0, (uintptr_t)this );
   }
 
   //----------------------------------------------------------------------------
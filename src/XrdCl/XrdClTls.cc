@@ -135,6 +135,15 @@ namespace XrdCl
       return false;
     }
 
+    //----------------------------------------------------------------------
+    // Remember the sessions servers hand out so that reconnecting to the
+    // same endpoint can skip the full handshake
+    //----------------------------------------------------------------------
+    int resume = XrdCl::DefaultTlsResume;
+    env->GetInt("TlsResume", resume);
+    if (resume)
+      tlsContext->SessionCache(XrdTlsContext::scClnt);
+
     return true;
   }
 
@@ -2311,7 +2311,7 @@ namespace XrdCl
       log->Debug( ExDbgMsg, "[%s] Passing to the thread-pool MsgHandler: %p (message: %s ).",
                   pUrl.GetHostId().c_str(), this,
                   pRequest->GetObfuscatedDescription().c_str() );
-      jobMgr->QueueJob( new HandleRspJob( this ), 0 );
+      jobMgr->QueueJob( new HandleRspJob( this ), 0, (uintptr_t)pSidMgr.get() );
     }
   }
   
@@ -8,7 +8,7 @@
 #ifndef SRC_XRDEC_XRDECOBJCFG_HH_
 #define SRC_XRDEC_XRDECOBJCFG_HH_
 
-#include "XrdOuc/XrdOucCRC32C.hh"
+#include "XrdOuc/XrdOucCRC.hh"
 
 #include <isa-l/crc.h>
 
@@ -29,6 +29,14 @@ namespace XrdEc
     return crc32_gzip_refl( crc, buffer, len );
   }
 
+  //---------------------------------------------------------------------------
+  //! crc32c, using the best implementation the cpu supports
+  //---------------------------------------------------------------------------
+  inline static uint32_t kernel_crc32c(uint32_t crc, void const *buf, size_t len)
+  {
+    return XrdOucCRC::Calc32C( buf, len, crc );
+  }
+
   static const std::string ObjStr = "obj";
   struct ObjCfg
   {
@@ -45,7 +53,7 @@ namespace XrdEc
         blksize( datasize + paritysize ),
         nomtfile( nomtfile )
       {
-        digest = usecrc32c ? crc32c : isal_crc32;
+        digest = usecrc32c ? kernel_crc32c : isal_crc32;
       }
 
       ObjCfg( const ObjCfg &objcfg ) : obj( objcfg.obj ),
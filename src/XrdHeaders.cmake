@@ -47,6 +47,8 @@ set( XROOTD_PUBLIC_HEADERS
   XrdOuc/XrdOucGMap.hh
   XrdOuc/XrdOucHash.hh
   XrdOuc/XrdOucHash.icc
+  XrdOuc/XrdOucHashMT.hh
+  XrdOuc/XrdOucHashMT.icc
   XrdOuc/XrdOucIOVec.hh
   XrdOuc/XrdOucLock.hh
   XrdOuc/XrdOucName2Name.hh
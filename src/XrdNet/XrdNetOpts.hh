@@ -90,6 +90,10 @@
 //
 #define XRDNET_USETLS    0x01000000
 
+// Allow multiple listening sockets on the same port (SO_REUSEPORT)
+//
+#define XRDNET_REUSEPORT 0x02000000
+
 /******************************************************************************/
 /*                  X r d N e t S o c k e t   O p t i o n s                   */
 /******************************************************************************/
@@ -55,6 +55,7 @@
 
 #include "XrdOfs/XrdOfs.hh"
 #include "XrdOfs/XrdOfsChkPnt.hh"
+#include "XrdOfs/XrdOfsCksInline.hh"
 #include "XrdOfs/XrdOfsConfigCP.hh"
 #include "XrdOfs/XrdOfsEvs.hh"
 #include "XrdOfs/XrdOfsHandle.hh"
@@ -209,6 +210,7 @@ XrdOfs::XrdOfs() : dMask{0000,0775}, fMask{0000,0775}, // Legacy
    Cks       = 0;
    CksPfn    = true;
    CksRdr    = true;
+   CksWrite  = 0;
 
 // Prepare handling
 //
@@ -757,6 +759,8 @@ int XrdOfsFile::open(const char          *path,      // In
       {oP.hP->isCompressed = 1;
        dorawio = (open_mode & SFS_O_RAWIO ? 1 : 0);
       }
+   if (isRW && !oP.hP->isCompressed && XrdOfsCksInline::Enabled())
+      oP.hP->cksIL = XrdOfsCksInline::Alloc();
    oP.hP->Activate(oP.fP);
    oP.hP->UnLock();
 
@@ -879,6 +883,11 @@ int XrdOfsFile::close()  // In
        myCKP = 0;
       }
 
+// If checksums were computed as the file was written, record them now if we
+// are the last writer. This must be done before the file is actually closed.
+//
+   if (hP->cksIL) XrdOfsCksInline::Close(hP);
+
 // We need to handle the cunudrum that an event may have to be sent upon
 // the final close. However, that would cause the path name to be destroyed.
 // So, we have two modes of logic where we copy out the pathname if a final
@@ -1231,6 +1240,7 @@ XrdSfsXferSize XrdOfsFile::pgWrite(XrdSfsFileOffset   offset,
                             (off_t)offset, (size_t)wrlen, csvec, pgOpts));
    if (nbytes < 0)
       return XrdOfsFS->Emsg(epname, error, (int)nbytes, "pgwrite", oh);
+   if (oh->cksIL) oh->cksIL->Update(offset, buffer, nbytes);
 
 // Return number of bytes written
 //
@@ -1258,8 +1268,9 @@ XrdSfsXferSize XrdOfsFile::pgWrite(XrdSfsAio *aioparm, uint64_t opts)
 
 // If this is a POSC file, we must convert the async call to a sync call as we
 // must trap any errors that unpersist the file. We can't do that via aio i/f.
+// The same applies when checksums are computed as the file is written.
 //
-   if (oh->isRW == XrdOfsHandle::opPC)
+   if (oh->isRW == XrdOfsHandle::opPC || oh->cksIL)
       {aioparm->Result = XrdOfsFile::pgWrite(aioparm->sfsAio.aio_offset,
                                      (char *)aioparm->sfsAio.aio_buf,
                                              aioparm->sfsAio.aio_nbytes,
@@ -1513,6 +1524,7 @@ XrdSfsXferSize XrdOfsFile::write(XrdSfsFileOffset  offset,    // In
                             (off_t)offset, (size_t)blen));
    if (nbytes < 0)
       return XrdOfsFS->Emsg(epname, error, (int)nbytes, "write", oh);
+   if (oh->cksIL) oh->cksIL->Update(offset, buff, nbytes);
 
 // Return number of bytes written
 //
@@ -1536,8 +1548,9 @@ int XrdOfsFile::write(XrdSfsAio *aiop)
 
 // If this is a POSC file, we must convert the async call to a sync call as we
 // must trap any errors that unpersist the file. We can't do that via aio i/f.
+// The same applies when checksums are computed as the file is written.
 //
-   if (oh->isRW == XrdOfsHandle::opPC)
+   if (oh->isRW == XrdOfsHandle::opPC || oh->cksIL)
       {aiop->Result = this->write(aiop->sfsAio.aio_offset,
                                   (const char *)aiop->sfsAio.aio_buf,
                                   aiop->sfsAio.aio_nbytes);
@@ -1719,6 +1732,7 @@ int XrdOfsFile::truncate(XrdSfsFileOffset  flen)  // In
    oh->isPending = 1;
    if ((retc = oh->Select().Ftruncate(flen)))
       return XrdOfsFS->Emsg(epname, error, retc, "truncate", oh);
+   if (oh->cksIL) oh->cksIL->Truncate(flen);
 
 // Indicate Success
 //
@@ -466,6 +466,7 @@ XrdOfsPrepare    *prepHandler;    // Plugin   prepare
 XrdCks           *Cks;            // Checksum manager
 bool              CksPfn;         // Checksum needs a pfn
 bool              CksRdr;         // Checksum may be redirected (i.e. not local)
+char             *CksWrite;       // Checksums to compute as files are written
 bool              prepAuth;       // Prepare requires authorization
 char              OssIsProxy;     // !0 if we detect the oss plugin is a proxy
 char              myRType[4];     // Role type for consistency with the cms
@@ -515,6 +516,7 @@ int           FSctl(XrdOfsFile &file, int cmd, int alen, const char *args,
                     const XrdSecEntity *client);
 int           Reformat(XrdOucErrInfo &);
 const char   *theRole(int opts);
+int           xckw(XrdOucStream &, XrdSysError &);
 int           xcrds(XrdOucStream &, XrdSysError &);
 int           xcrm(XrdOucStream &, XrdSysError &);
 int           xdirl(XrdOucStream &, XrdSysError &);
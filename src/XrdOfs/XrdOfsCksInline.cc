@@ -0,0 +1,256 @@
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d O f s C k s I n l i n e . c c                     */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <sys/param.h>
+#include <sys/stat.h>
+
+#include "XrdCks/XrdCks.hh"
+#include "XrdCks/XrdCksCalc.hh"
+#include "XrdCks/XrdCksData.hh"
+#include "XrdOfs/XrdOfsCksInline.hh"
+#include "XrdOfs/XrdOfsHandle.hh"
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucTokenizer.hh"
+#include "XrdSys/XrdSysError.hh"
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+extern XrdSysError OfsEroute;
+extern XrdOss     *XrdOfsOss;
+
+/******************************************************************************/
+/*                        S t a t i c   M e m b e r s                         */
+/******************************************************************************/
+
+XrdCks *XrdOfsCksInline::Cks = 0;
+char   *XrdOfsCksInline::cksName[XrdOfsCksInline::maxCks] = {0};
+int     XrdOfsCksInline::numCks = 0;
+bool    XrdOfsCksInline::cksPfn = true;
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdOfsCksInline::XrdOfsCksInline() : nextOff(0), isBad(false)
+{
+   for (int i = 0; i < maxCks; i++) cksCalc[i] = 0;
+}
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdOfsCksInline::~XrdOfsCksInline()
+{
+   for (int i = 0; i < maxCks; i++) if (cksCalc[i]) cksCalc[i]->Recycle();
+}
+
+/******************************************************************************/
+/*                      P r i v a t e :   A b a n d o n                       */
+/******************************************************************************/
+
+// The mutex must be held upon entry.
+
+void XrdOfsCksInline::Abandon()
+{
+   for (int i = 0; i < maxCks; i++)
+       if (cksCalc[i]) {cksCalc[i]->Recycle(); cksCalc[i] = 0;}
+   isBad = true;
+}
+
+/******************************************************************************/
+/*                                 A l l o c                                  */
+/******************************************************************************/
+
+XrdOfsCksInline *XrdOfsCksInline::Alloc()
+{
+   XrdOfsCksInline *ilP;
+   int i;
+
+// Make sure we are enabled
+//
+   if (!numCks) return 0;
+
+// Get a calculation object for each checksum
+//
+   ilP = new XrdOfsCksInline;
+   for (i = 0; i < numCks; i++)
+       if (!(ilP->cksCalc[i] = Cks->Object(cksName[i])))
+          {delete ilP; return 0;}
+   return ilP;
+}
+
+/******************************************************************************/
+/*                                 C l o s e                                  */
+/******************************************************************************/
+
+void XrdOfsCksInline::Close(XrdOfsHandle *hP)
+{
+// Only the last writer may record the checksums as others may still write
+//
+   if (hP->Usage() == 1)
+      {hP->cksIL->Finish(hP->Name(), hP->Select());
+       delete hP->cksIL;
+       hP->cksIL = 0;
+      }
+}
+
+/******************************************************************************/
+/*                                F i n i s h                                 */
+/******************************************************************************/
+
+void XrdOfsCksInline::Finish(const char *lfn, XrdOssDF &ossDF)
+{
+   XrdCksData  cksData;
+   struct stat Stat;
+   const char *path = lfn;
+   char pfnBuff[MAXPATHLEN+8], *csVal;
+   int i, rc, csLen;
+
+// If the checksum does not cover the file then there is nothing to record.
+// This happens for files that were only partially overwritten.
+//
+   cksMutex.Lock();
+   if (isBad || ossDF.Fstat(&Stat) || Stat.st_size != nextOff)
+      {cksMutex.UnLock(); return;}
+
+// Convert the lfn to a pfn if the checksum manager needs one
+//
+   if (cksPfn && !(path = XrdOfsOss->Lfn2Pfn(lfn, pfnBuff, MAXPATHLEN, rc)))
+      {OfsEroute.Emsg("CksInline", rc, "convert lfn for", lfn);
+       cksMutex.UnLock();
+       return;
+      }
+
+// Record each checksum. The checksum manager supplies the file's current
+// modification time so that the checksum is considered valid.
+//
+   for (i = 0; i < numCks; i++)
+       {cksData.Set(cksName[i]);
+        csVal = cksCalc[i]->Final();
+        cksCalc[i]->Type(csLen);
+        cksData.Set((const void *)csVal, csLen);
+        if ((rc = Cks->Set(path, cksData)))
+           OfsEroute.Emsg("CksInline", rc, "set checksum for", lfn);
+       }
+   Abandon();
+   cksMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+bool XrdOfsCksInline::Init(XrdCks *cksP, bool usePfn, const char *names,
+                           XrdSysError &eDest)
+{
+   XrdOucTokenizer nameList((char *)0);
+   char *nBuff = strdup(names), *name;
+   const char *csName;
+   int i;
+
+// Reset any previous configuration
+//
+   for (i = 0; i < numCks; i++) free(cksName[i]);
+   numCks = 0;
+
+// We need a checksum manager
+//
+   if (!cksP)
+      {eDest.Emsg("Config", "Inline checksums require a checksum manager.");
+       free(nBuff);
+       return false;
+      }
+
+// Validate each checksum name
+//
+   nameList.Attach(nBuff); nameList.GetLine();
+   while((name = nameList.GetToken()))
+        {csName = (strcmp(name, "default") ? name : cksP->Name());
+         if (!csName || cksP->Size(csName) <= 0)
+            {eDest.Emsg("Config", name, "checksum is not supported; "
+                                        "inline checksums not enabled.");
+             free(nBuff);
+             return false;
+            }
+         for (i = 0; i < numCks; i++) if (!strcmp(cksName[i], csName)) break;
+         if (i < numCks) continue;
+         if (numCks >= maxCks)
+            {eDest.Emsg("Config", "Too many inline checksums specified.");
+             free(nBuff);
+             return false;
+            }
+         cksName[numCks++] = strdup(csName);
+        }
+
+// All done
+//
+   free(nBuff);
+   Cks    = cksP;
+   cksPfn = usePfn;
+   return true;
+}
+
+/******************************************************************************/
+/*                              T r u n c a t e                               */
+/******************************************************************************/
+
+void XrdOfsCksInline::Truncate(long long flen)
+{
+// Truncating to the current checksummed length changes nothing. Anything
+// else means the checksum can no longer be computed from the writes.
+//
+   cksMutex.Lock();
+   if (flen != nextOff && !isBad) Abandon();
+   cksMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                                U p d a t e                                 */
+/******************************************************************************/
+
+void XrdOfsCksInline::Update(long long offset, const char *buff, int blen)
+{
+   int i;
+
+// Only writes that extend the contiguous prefix can be checksummed. A write
+// that skips ahead or rewrites data abandons the inline checksum.
+//
+   cksMutex.Lock();
+   if (!isBad && blen > 0)
+      {if (offset != nextOff) Abandon();
+          else {for (i = 0; i < numCks; i++) cksCalc[i]->Update(buff, blen);
+                nextOff += blen;
+               }
+      }
+   cksMutex.UnLock();
+}
@@ -0,0 +1,140 @@
+#ifndef __XRDOFSCKSINLINE_HH__
+#define __XRDOFSCKSINLINE_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d O f s C k s I n l i n e . h h                     */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdSys/XrdSysPthread.hh"
+
+//-----------------------------------------------------------------------------
+//! The XrdOfsCksInline class computes the configured checksums of a file as
+//! it is being written sequentially. Each write extends the contiguous prefix
+//! of the file that has been checksummed. When the last writer closes the
+//! file and the prefix covers the whole file, the checksums are recorded via
+//! the checksum manager so that a subsequent checksum query need not read
+//! the file. Any out of order write or truncation abandons the computation;
+//! the checksum is then calculated from the data when it is first requested.
+//-----------------------------------------------------------------------------
+
+class XrdCks;
+class XrdCksCalc;
+class XrdOfsHandle;
+class XrdOssDF;
+class XrdSysError;
+
+class XrdOfsCksInline
+{
+public:
+
+//-----------------------------------------------------------------------------
+//! Obtain a new checksum state object for a file being opened for writing.
+//!
+//! @return Pointer to the object or nil if inline checksums are not enabled.
+//-----------------------------------------------------------------------------
+
+static XrdOfsCksInline *Alloc();
+
+//-----------------------------------------------------------------------------
+//! Handle a close of a file with inline checksums. When this is the last
+//! open of the file, the checksums are recorded (see Finish()) and the
+//! checksum state is released. Otherwise nothing happens.
+//!
+//! @param  hP     - the handle of the file being closed, which must be
+//!                  locked and have a checksum state.
+//-----------------------------------------------------------------------------
+
+static void  Close(XrdOfsHandle *hP);
+
+//-----------------------------------------------------------------------------
+//! Check whether inline checksums are enabled.
+//-----------------------------------------------------------------------------
+
+static bool  Enabled() {return numCks > 0;}
+
+//-----------------------------------------------------------------------------
+//! Record the checksums if they cover the whole file. This is called when the
+//! last writer closes the file but before the file is actually closed.
+//!
+//! @param  lfn    - the logical file name.
+//! @param  ossDF  - the storage system object for the open file.
+//-----------------------------------------------------------------------------
+
+       void  Finish(const char *lfn, XrdOssDF &ossDF);
+
+//-----------------------------------------------------------------------------
+//! Configure inline checksums.
+//!
+//! @param  cksP   - the checksum manager.
+//! @param  usePfn - true if the checksum manager needs the physical file name.
+//! @param  names  - space separated list of checksum names; the name
+//!                  "default" refers to the default checksum.
+//! @param  eDest  - the message routing object.
+//!
+//! @return true upon success and false otherwise.
+//-----------------------------------------------------------------------------
+
+static bool  Init(XrdCks *cksP, bool usePfn, const char *names,
+                  XrdSysError &eDest);
+
+//-----------------------------------------------------------------------------
+//! Account for a successful truncate.
+//!
+//! @param  flen   - the new length of the file.
+//-----------------------------------------------------------------------------
+
+       void  Truncate(long long flen);
+
+//-----------------------------------------------------------------------------
+//! Account for data successfully written.
+//!
+//! @param  offset - the offset at which the data was written.
+//! @param  buff   - pointer to the data.
+//! @param  blen   - the number of bytes written.
+//-----------------------------------------------------------------------------
+
+       void  Update(long long offset, const char *buff, int blen);
+
+            ~XrdOfsCksInline();
+
+private:
+             XrdOfsCksInline();
+
+       void  Abandon();
+
+static const int  maxCks = 4;
+
+static XrdCks    *Cks;
+static char      *cksName[maxCks];
+static int        numCks;
+static bool       cksPfn;
+
+XrdSysMutex       cksMutex;
+XrdCksCalc       *cksCalc[maxCks];
+long long         nextOff;
+bool              isBad;
+};
+#endif
@@ -50,6 +50,7 @@
 #include "XrdSfs/XrdSfsFlags.hh"
 
 #include "XrdOfs/XrdOfs.hh"
+#include "XrdOfs/XrdOfsCksInline.hh"
 #include "XrdOfs/XrdOfsConfigCP.hh"
 #include "XrdOfs/XrdOfsConfigPI.hh"
 #include "XrdOfs/XrdOfsEvs.hh"
@@ -382,6 +383,16 @@ int XrdOfs::Configure(XrdSysError &Eroute, XrdOucEnv *EnvInfo) {
 //
    OssHasPGrw = (ossFeatures & XRDOSS_HASPGRW) != 0;
 
+// Set up inline checksums if so wanted. These make no sense for a proxy or a
+// manager as neither writes files locally.
+//
+   if (CksWrite && !NoGo)
+      {if (OssIsProxy || (Options & isManager))
+          Eroute.Say("Config warning: ckswrite ignored; files are not local.");
+          else if (!XrdOfsCksInline::Init(Cks, CksPfn, CksWrite, Eroute))
+                  NoGo = 1;
+      }
+
 // If POSC processing is enabled (as by default) do it. Warning! This must be
 // the last item in the configuration list as we need a working filesystem.
 // Note that in proxy mode we always disable posc!
@@ -439,6 +450,9 @@ void XrdOfs::Config_Display(XrdSysError &Eroute)
      Eroute.Say(buff);
      ofsConfig->Display();
 
+     if (CksWrite && XrdOfsCksInline::Enabled())
+        Eroute.Say("       ofs.ckswrite   ", CksWrite);
+
      if (Options & Forwarding)
         {*fwbuff = 0;
          if (ConfigDispFwd(buff, fwdCHMOD))
@@ -809,6 +823,7 @@ int XrdOfs::ConfigXeq(char *var, XrdOucStream &Config,
     TS_XPI("authlib",       theAutLib);
     TS_XPI("ckslib",        theCksLib);
     TS_Xeq("cksrdsz",       xcrds);
+    TS_Xeq("ckswrite",      xckw);
     TS_XPI("cmslib",        theCmsLib);
     TS_Xeq("crmode",        xcrm);
     TS_XPI("ctllib",        theCtlLib);
@@ -881,6 +896,50 @@ int XrdOfs::xcrds(XrdOucStream &Config, XrdSysError &Eroute)
    return 0;
 }
   
+/******************************************************************************/
+/*                                  x c k w                                   */
+/******************************************************************************/
+
+/* Function: xckw
+
+   Purpose:  To parse the directive: ckswrite {off | <digest> [<digest> ...]}
+
+             off       do not compute checksums while files are written.
+             <digest>  the name of a checksum to compute as a file is written
+                       sequentially and to record when it is closed. The name
+                       "default" refers to the default checksum.
+
+  Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdOfs::xckw(XrdOucStream &Config, XrdSysError &Eroute)
+{
+   char *val, nBuff[1024];
+   int n, nLen = 0;
+
+// Get the first token
+//
+   if (!(val = Config.GetWord()) || !val[0])
+      {Eroute.Emsg("Config", "ckswrite digest not specified"); return 1;}
+
+// Check for turning this off
+//
+   if (CksWrite) {free(CksWrite); CksWrite = 0;}
+   if (!strcmp(val, "off")) return 0;
+
+// Collect the names, they are verified once the checksum manager is loaded
+//
+   do {n = strlen(val);
+       if (nLen + n + 1 >= (int)sizeof(nBuff))
+          {Eroute.Emsg("Config", "ckswrite digest list is too long"); return 1;}
+       if (nLen) nBuff[nLen++] = ' ';
+       strcpy(nBuff+nLen, val); nLen += n;
+      } while((val = Config.GetWord()) && val[0]);
+
+   CksWrite = strdup(nBuff);
+   return 0;
+}
+
 /******************************************************************************/
 /*                                  x c r m                                   */
 /******************************************************************************/
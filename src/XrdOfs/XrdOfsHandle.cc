@@ -33,6 +33,7 @@
 #include <errno.h>
 #include <sys/types.h>
 
+#include "XrdOfs/XrdOfsCksInline.hh"
 #include "XrdOfs/XrdOfsHandle.hh"
 #include "XrdOfs/XrdOfsStats.hh"
 #include "XrdOss/XrdOss.hh"
@@ -244,11 +245,8 @@ extern XrdOfsStats OfsStats;
 /*                        S t a t i c   O b j e c t s                         */
 /******************************************************************************/
   
-XrdSysMutex   XrdOfsHandle::myMutex;
-XrdOfsHanTab  XrdOfsHandle::roTable;
-XrdOfsHanTab  XrdOfsHandle::rwTable;
+XrdOfsHandle::HanShard XrdOfsHandle::Shard[XrdOfsHandle::nShards];
 XrdOssDF     *XrdOfsHandle::ossDF = (XrdOssDF *)new XrdOfsHanOss;
-XrdOfsHandle *XrdOfsHandle::Free = 0;
 
 /******************************************************************************/
 /*                    c l a s s   X r d O f s H a n d l e                     */
@@ -260,12 +258,15 @@ XrdOfsHandle *XrdOfsHandle::Free = 0;
 int XrdOfsHandle::Alloc(const char *thePath, int Opts, XrdOfsHandle **Handle)
 {
    XrdOfsHandle *hP;
-   XrdOfsHanTab *theTable = (Opts & opRW ? &rwTable : &roTable);
    XrdOfsHanKey theKey(thePath, (int)strlen(thePath));
+   HanShard    &theShard = ShardFor(theKey.Hash);
+   XrdOfsHanTab *theTable = (Opts & opRW ? &theShard.rwTable
+                                         : &theShard.roTable);
+   XrdSysMutex &myMutex = theShard.myMutex;
    int          retc;
 
 // Lock the search table and try to find the key. If found, increment the
-// the link count (can only be done with the global lock) then release the
+// the link count (can only be done with the shard lock) then release the
 // lock and try to lock the handle. It can't escape between lock calls because
 // the link count is positive. If we can't lock the handle then it must be the
 // that a long running operation is occuring. Return the handle to its former
@@ -281,7 +282,8 @@ int XrdOfsHandle::Alloc(const char *thePath, int Opts, XrdOfsHandle **Handle)
 
 // Get a new handle
 //
-   if (!(retc = Alloc(theKey, Opts, Handle))) theTable->Add(*Handle);
+   if (!(retc = Alloc(theKey, Opts, Handle, theShard.Free)))
+      theTable->Add(*Handle);
    OfsStats.Add(OfsStats.Data.numHandles);
 
 // All done
@@ -297,12 +299,13 @@ int XrdOfsHandle::Alloc(const char *thePath, int Opts, XrdOfsHandle **Handle)
 int XrdOfsHandle::Alloc(XrdOfsHandle **Handle)
 {
     XrdOfsHanKey myKey("dummy", 5);
+    HanShard &theShard = ShardFor(myKey.Hash);
     int retc;
 
-    myMutex.Lock();
-    if (!(retc = Alloc(myKey, 0, Handle))) 
+    theShard.myMutex.Lock();
+    if (!(retc = Alloc(myKey, 0, Handle, theShard.Free)))
        {(*Handle)->Path.Links = 0; (*Handle)->UnLock();}
-    myMutex.UnLock();
+    theShard.myMutex.UnLock();
     return retc;
 }
 
@@ -310,7 +313,8 @@ int XrdOfsHandle::Alloc(XrdOfsHandle **Handle)
 /* private                      A l l o c   # 3                               */
 /******************************************************************************/
   
-int XrdOfsHandle::Alloc(XrdOfsHanKey theKey, int Opts, XrdOfsHandle **Handle)
+int XrdOfsHandle::Alloc(XrdOfsHanKey theKey, int Opts, XrdOfsHandle **Handle,
+                        XrdOfsHandle *&Free)
 {
    static const int minAlloc = 4096/sizeof(XrdOfsHandle);
    XrdOfsHandle *hP;
@@ -332,6 +336,7 @@ int XrdOfsHandle::Alloc(XrdOfsHanKey theKey, int Opts, XrdOfsHandle **Handle)
        hP->isRW         = (Opts & opPC);           // File mode
        hP->ssi          = ossDF;                   // No storage system yet
        hP->Posc         = 0;                       // No creator
+       hP->cksIL        = 0;                       // No inline checksum
        hP->Lock();                                 // Wait is not possible
        *Handle = hP;
        return 0;
@@ -347,14 +352,15 @@ void XrdOfsHandle::Hide(const char *thePath)
 {
    XrdOfsHandle *hP;
    XrdOfsHanKey theKey(thePath, (int)strlen(thePath));
+   HanShard    &theShard = ShardFor(theKey.Hash);
 
 // Lock the search table and try to find the key in each table. If found,
 // clear the length field to effectively hide the item.
 //
-   myMutex.Lock();
-   if ((hP = roTable.Find(theKey))) hP->Path.Len = 0;
-   if ((hP = rwTable.Find(theKey))) hP->Path.Len = 0;
-   myMutex.UnLock();
+   theShard.myMutex.Lock();
+   if ((hP = theShard.roTable.Find(theKey))) hP->Path.Len = 0;
+   if ((hP = theShard.rwTable.Find(theKey))) hP->Path.Len = 0;
+   theShard.myMutex.UnLock();
 }
 
 /******************************************************************************/
@@ -373,7 +379,10 @@ int XrdOfsHandle::PoscGet(short &Mode, int Done)
        Mode = Posc->Mode;
        if (Done)
           {pP = Posc; Posc = 0;
-           if (pP->xprP) {myMutex.Lock(); Path.Links--; myMutex.UnLock();}
+           if (pP->xprP)
+              {XrdSysMutex &myMutex = myShard().myMutex;
+               myMutex.Lock(); Path.Links--; myMutex.UnLock();
+              }
            pP->Recycle();
           }
        return pnum;
@@ -458,9 +467,11 @@ const char *XrdOfsHandle::PoscUsr()
 int XrdOfsHandle::Retire(int &retc, long long *retsz, char *buff, int blen)
 {
    XrdOssDF *mySSI;
+   HanShard &theShard = myShard();
+   XrdSysMutex &myMutex = theShard.myMutex;
    int numLeft;
 
-// Get the global lock as the links field can only be manipulated with it.
+// Get the shard lock as the links field can only be manipulated with it.
 // Decrement the links count and if zero, remove it from the table and
 // place it on the free list. Otherwise, it is still in use.
 //
@@ -469,11 +480,14 @@ int XrdOfsHandle::Retire(int &retc, long long *retsz, char *buff, int blen)
    if (Path.Links == 1)
       {if (buff) strlcpy(buff, Path.Val, blen);
        numLeft = 0; OfsStats.Dec(OfsStats.Data.numHandles);
-       if ( (isRW ? rwTable.Remove(this) : roTable.Remove(this)) )
+       if ( (isRW ? theShard.rwTable.Remove(this)
+                  : theShard.roTable.Remove(this)) )
          {if (Posc) {Posc->Recycle(); Posc = 0;}
+          if (cksIL) {delete cksIL; cksIL = 0;}
           if (Path.Val) {free((void *)Path.Val); Path.Val = (char *)"";}
           Path.Len = 0; mySSI = ssi; ssi = ossDF;
-          Next = Free; Free = this; UnLock(); myMutex.UnLock();
+          Next = theShard.Free; theShard.Free = this;
+          UnLock(); myMutex.UnLock();
           if (mySSI && mySSI != ossDF)
              {retc = mySSI->Close(retsz); delete mySSI;}
          } else {
@@ -489,6 +503,7 @@ int XrdOfsHandle::Retire(int &retc, long long *retsz, char *buff, int blen)
 int XrdOfsHandle::Retire(XrdOfsHanCB *cbP, int hTime)
 {
    static int allOK = StartXpr(1);
+   XrdSysMutex &myMutex = myShard().myMutex;
    XrdOfsHanXpr *xP;
    int retc;
 
@@ -554,11 +569,12 @@ do{xP = XrdOfsHanXpr::Get(); hP = xP->Handle;
             hP->UnLock(); delete xP; continue;
            }
 
-// As the handle is locked we can get the global handle lock to prevent
-// additions and removals of handles as we need a stable reference count to
-// effect the callout, if any. Do so only if the reference count is one (for us)
-// and the handle is active. In all cases, drop the global lock.
+// As the handle is locked we can get the shard lock to prevent additions
+// and removals of handles as we need a stable reference count to effect the
+// callout, if any. Do so only if the reference count is one (for us) and the
+// handle is active. In all cases, drop the shard lock.
 //
+   XrdSysMutex &myMutex = hP->myShard().myMutex;
    myMutex.Lock();
    if (hP->Path.Links != 1 || !xP->Call) myMutex.UnLock();
       else {myMutex.UnLock();
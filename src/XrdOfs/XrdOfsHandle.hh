@@ -119,6 +119,7 @@ int              Threshold;
 /******************************************************************************/
   
 class XrdOssDF;
+class XrdOfsCksInline;
 class XrdOfsHanCB;
 class XrdOfsHanPsc;
 
@@ -132,6 +133,7 @@ char                isPending;    // 1-> File  is pending sync()
 char                isChanged;    // 1-> File was modified
 char                isCompressed; // 1-> File  is compressed
 char                isRW;         // T-> File  is open in r/w mode
+XrdOfsCksInline    *cksIL;        // -> Checksums computed as file is written
 
 void                Activate(XrdOssDF *ssP) {ssi = ssP;}
 
@@ -174,7 +176,8 @@ inline       void   UnLock() {hMutex.UnLock();}
          ~XrdOfsHandle() {int retc; Retire(retc);}
 
 private:
-static int           Alloc(XrdOfsHanKey, int Opts, XrdOfsHandle **Handle);
+static int           Alloc(XrdOfsHanKey, int Opts, XrdOfsHandle **Handle,
+                           XrdOfsHandle *&Free);
        int           WaitLock(void);
 
 static const int     LockTries =   3; // Times to try for a lock
@@ -182,11 +185,28 @@ static const int     LockWait  = 333; // Mills to wait between tries
 static const int     nolokDelay=   3; // Secs to delay client when lock failed
 static const int     nomemDelay=  15; // Secs to delay client when ENOMEM
 
-static XrdSysMutex   myMutex;
-static XrdOfsHanTab  roTable;    // File handles open r/o
-static XrdOfsHanTab  rwTable;    // File Handles open r/w
+// The handle tables are split into shards selected by the path hash so that
+// opens and closes of different files do not contend on a single lock. All
+// handles for a given path live in the same shard, which preserves sharing.
+//
+struct alignas(64) HanShard
+      {XrdSysMutex   myMutex;    // Protects the tables and link counts
+       XrdOfsHanTab  roTable;    // File handles open r/o
+       XrdOfsHanTab  rwTable;    // File Handles open r/w
+       XrdOfsHandle *Free;       // List of free handles
+
+       HanShard() : roTable(21, 34), rwTable(21, 34), Free(0) {}
+      };
+
+static const int     nShards = 64; // Must be a power of two
+
+static HanShard      Shard[nShards];
+
+static HanShard     &ShardFor(unsigned int hash)
+                             {return Shard[hash & (nShards-1)];}
+       HanShard     &myShard() {return ShardFor(Path.Hash);}
+
 static XrdOssDF     *ossDF;      // Dummy storage sysem
-static XrdOfsHandle *Free;       // List of free handles
 
        XrdSysMutex   hMutex;
        XrdOssDF     *ssi;        // Storage System Interface
@@ -45,6 +45,8 @@
 
 #include "XrdOss/XrdOssApi.hh"
 #include "XrdOss/XrdOssTrace.hh"
+#include "XrdOss/XrdOssUring.hh"
+#include "XrdOuc/XrdOucPgrwUtils.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdSys/XrdSysPthread.hh"
@@ -101,13 +103,20 @@ const int OSS_AIO_WRITE_DONE = SIGRTMAX;
 
 int XrdOssFile::Fsync(XrdSfsAio *aiop)
 {
+   int rc;
 
+// If we are using io_uring then queue the request there
+//
+   if (XrdOssSys::AioEngine)
+      {aiop->TIdent = tident;
+       if (!(rc = XrdOssUring::Submit(aiop, fd, XrdOssUring::opFsync))) return 0;
+       if (rc < 0) return rc;
+      }
 #ifdef _POSIX_ASYNCHRONOUS_IO
-   int rc;
 
 // Complete the aio request block and do the operation
 //
-   if (XrdOssSys::AioAllOk)
+      else if (XrdOssSys::AioAllOk)
       {aiop->sfsAio.aio_fildes = fd;
        aiop->sfsAio.aio_sigevent.sigev_signo  = OSS_AIO_WRITE_DONE;
        aiop->TIdent = tident;
@@ -153,14 +162,21 @@ int XrdOssFile::Fsync(XrdSfsAio *aiop)
   
 int XrdOssFile::Read(XrdSfsAio *aiop)
 {
-
-#ifdef _POSIX_ASYNCHRONOUS_IO
    EPNAME("AioRead");
    int rc;
 
+// If we are using io_uring then queue the request there
+//
+   if (XrdOssSys::AioEngine && !cxobj)
+      {aiop->TIdent = tident;
+       if (!(rc = XrdOssUring::Submit(aiop, fd, XrdOssUring::opRead))) return 0;
+       if (rc < 0) return rc;
+      }
+#ifdef _POSIX_ASYNCHRONOUS_IO
+
 // Complete the aio request block and do the operation
 //
-   if (XrdOssSys::AioAllOk)
+      else if (XrdOssSys::AioAllOk)
       {aiop->sfsAio.aio_fildes = fd;
        aiop->sfsAio.aio_sigevent.sigev_signo  = OSS_AIO_READ_DONE;
        aiop->TIdent = tident;
@@ -211,13 +227,21 @@ int XrdOssFile::Read(XrdSfsAio *aiop)
   
 int XrdOssFile::Write(XrdSfsAio *aiop)
 {
-#ifdef _POSIX_ASYNCHRONOUS_IO
    EPNAME("AioWrite");
    int rc;
 
+// If we are using io_uring then queue the request there
+//
+   if (XrdOssSys::AioEngine)
+      {aiop->TIdent = tident;
+       if (!(rc = XrdOssUring::Submit(aiop, fd, XrdOssUring::opWrite))) return 0;
+       if (rc < 0) return rc;
+      }
+#ifdef _POSIX_ASYNCHRONOUS_IO
+
 // Complete the aio request block and do the operation
 //
-   if (XrdOssSys::AioAllOk)
+      else if (XrdOssSys::AioAllOk)
       {aiop->sfsAio.aio_fildes = fd;
        aiop->sfsAio.aio_sigevent.sigev_signo  = OSS_AIO_WRITE_DONE;
        aiop->TIdent = tident;
@@ -251,6 +275,87 @@ int XrdOssFile::Write(XrdSfsAio *aiop)
    return 0;
 }
 
+/******************************************************************************/
+/*                                p g R e a d                                 */
+/******************************************************************************/
+
+/*
+  Function: Async read `blen' bytes from the associated file, placing in 'buff'
+            and computing the page checksums, if wanted.
+
+  Input:    aioparm   - An aio request object
+            opts      - Processing options (see XrdOssDF).
+
+   Output:  <0 -> Operation failed, value is negative errno value.
+            =0 -> Operation queued or completed synchronously.
+*/
+
+int XrdOssFile::pgRead(XrdSfsAio *aioparm, uint64_t opts)
+{
+   int rc;
+
+// Only io_uring supports async pgRead; the checksums are computed upon
+// completion by the reaper.
+//
+   if (XrdOssSys::AioEngine && !cxobj)
+      {aioparm->TIdent = tident;
+       if (!(rc = XrdOssUring::Submit(aioparm, fd, XrdOssUring::opPgRead)))
+          return 0;
+       if (rc < 0) return rc;
+      }
+
+// Execute this request in a synchronous fashion
+//
+   return XrdOssDF::pgRead(aioparm, opts);
+}
+
+/******************************************************************************/
+/*                               p g W r i t e                                */
+/******************************************************************************/
+
+/*
+  Function: Async write `blen' bytes from 'buff' into the associated file after
+            verifying the page checksums, if so wanted.
+
+  Input:    aioparm   - An aio request object
+            opts      - Processing options (see XrdOssDF).
+
+   Output:  <0 -> Operation failed, value is negative errno value.
+            =0 -> Operation queued or completed synchronously.
+*/
+
+int XrdOssFile::pgWrite(XrdSfsAio *aioparm, uint64_t opts)
+{
+   int rc;
+
+// Only io_uring supports async pgWrite. Verify the data before queuing it.
+//
+   if (XrdOssSys::AioEngine)
+      {if (aioparm->cksVec && (opts & Verify))
+          {XrdOucPgrwUtils::dataInfo dInfo((const char *)aioparm->sfsAio.aio_buf,
+                                           aioparm->cksVec,
+                                    (off_t)aioparm->sfsAio.aio_offset,
+                                   (size_t)aioparm->sfsAio.aio_nbytes);
+           off_t bado;
+           int   badc;
+           if (!XrdOucPgrwUtils::csVer(dInfo, bado, badc))
+              {aioparm->Result = -EDOM;
+               aioparm->doneWrite();
+               return 0;
+              }
+           opts &= ~Verify;
+          }
+       aioparm->TIdent = tident;
+       if (!(rc = XrdOssUring::Submit(aioparm, fd, XrdOssUring::opWrite)))
+          return 0;
+       if (rc < 0) return rc;
+      }
+
+// Execute this request in a synchronous fashion
+//
+   return XrdOssDF::pgWrite(aioparm, opts);
+}
+
 /******************************************************************************/
 /*                 X r d O s s S y s   A I O   M e t h o d s                  */
 /******************************************************************************/
@@ -259,6 +364,8 @@ int XrdOssFile::Write(XrdSfsAio *aiop)
 /******************************************************************************/
 
 int   XrdOssSys::AioAllOk = 0;
+
+char  XrdOssSys::AioEngine = 0;
   
 #if defined(_POSIX_ASYNCHRONOUS_IO) && !defined(HAVE_SIGWTI)
 // The folowing is for sigwaitinfo() emulation
@@ -280,6 +387,16 @@ extern "C" {extern void XrdOssAioWSH(int, siginfo_t *, void *);}
 
 int XrdOssSys::AioInit()
 {
+
+// If io_uring was requested, use it. Should that fail, we fall back to
+// POSIX aio (which is disabled at the xroot level for disk files).
+//
+   if (AioEngine)
+      {if (XrdOssUring::Init(OssEroute)) return 1;
+       OssEroute.Say("Config warning: io_uring unavailable; using default aio.");
+       AioEngine = 0;
+      }
+
 #if defined(_POSIX_ASYNCHRONOUS_IO)
    EPNAME("AioInit");
    extern void *XrdOssAioWait(void *carg);
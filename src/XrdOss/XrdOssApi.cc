@@ -40,6 +40,7 @@
 #include <sys/file.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/param.h>
 #ifdef __solaris__
 #include <sys/vnode.h>
@@ -54,6 +55,7 @@
 #include "XrdOss/XrdOssError.hh"
 #include "XrdOss/XrdOssMio.hh"
 #include "XrdOss/XrdOssTrace.hh"
+#include "XrdOss/XrdOssUring.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucName2Name.hh"
 #include "XrdOuc/XrdOucPinLoader.hh"
@@ -403,7 +405,7 @@ int XrdOssSys::Stats(char *buff, int blen)
 
 // If only size wanted, return what size we need
 //
-   if (!buff) return statflen + getStats(0,0);
+   if (!buff) return statflen + getStats(0,0) + XrdOssUring::Stats(0,0);
 
 // Make sure we have enough space
 //
@@ -416,6 +418,11 @@ int XrdOssSys::Stats(char *buff, int blen)
    n = getStats(bp, blen);
    bp += n; blen -= n;
 
+// Generate async I/O statistics, if any
+//
+   n = XrdOssUring::Stats(bp, blen);
+   bp += n; blen -= n;
+
 // Add trailer
 //
    if (blen >= (int)sizeof(statfmt2))
@@ -771,6 +778,12 @@ int XrdOssFile::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &Env)
                    {close(fd); fd=-ETXTBSY;}
                 FSize = -1; cacheP = 0;
                }
+       if (fd >= 0 && XrdOssCache::ioTrack
+       && (ioLoad = XrdOssCache::Load(buf.st_dev))
+       && (ioWrite = (Oflag & (O_WRONLY | O_RDWR)) != 0))
+          {ioLoad->Writers++;
+           if (Oflag & O_TRUNC) ioLoad->Unpend(); // Created by Alloc()
+          }
       } else if (fd == -EEXIST)
                 {do {retc = stat(local_path,&buf);} while(retc && errno==EINTR);
                  if (!retc && (buf.st_mode & S_IFDIR)) fd = -EISDIR;
@@ -826,7 +839,8 @@ int XrdOssFile::Close(long long *retsz)
 #ifdef XRDOSSCX
     if (cxobj) {delete cxobj; cxobj = 0;}
 #endif
-    fd = -1; FSize = -1; cacheP = 0;
+    if (ioWrite) {ioLoad->Writers--; ioWrite = false;}
+    fd = -1; FSize = -1; cacheP = 0; ioLoad = 0;
     return XrdOssOK;
 }
 
@@ -878,6 +892,8 @@ ssize_t XrdOssFile::Read(void *buff, off_t offset, size_t blen)
 
      if (fd < 0) return (ssize_t)-XRDOSS_E8004;
 
+     XrdOssCache_LoadIO ioAcct(ioLoad, blen);
+
 #ifdef XRDOSSCX
      if (cxobj)  
         if (XrdOssSS->DirFlags & XrdOssNOSSDEC) return (ssize_t)-XRDOSS_E8021;
@@ -943,7 +959,8 @@ ssize_t XrdOssFile::ReadV(XrdOucIOVec *readV, int n)
 // Read in the vector and do a pre-advise if we support that
 //
    for (i = 0; i < n; i++)
-       {do {rdsz = pread(fd, readV[i].data, readV[i].size, readV[i].offset);}
+       {XrdOssCache_LoadIO ioAcct(ioLoad, readV[i].size);
+        do {rdsz = pread(fd, readV[i].data, readV[i].size, readV[i].offset);}
            while(rdsz < 0 && errno == EINTR);
         if (rdsz < 0 || rdsz != readV[i].size)
            {totBytes =  (rdsz < 0 ? -errno : -ESPIPE); break;}
@@ -994,6 +1011,8 @@ ssize_t XrdOssFile::ReadRaw(void *buff, off_t offset, size_t blen)
 
      if (fd < 0) return (ssize_t)-XRDOSS_E8004;
 
+     XrdOssCache_LoadIO ioAcct(ioLoad, blen);
+
 #ifdef XRDOSSCX
      if (cxobj)   retval = cxobj->ReadRaw((char *)buff, blen, offset);
         else 
@@ -1028,6 +1047,8 @@ ssize_t XrdOssFile::Write(const void *buff, off_t offset, size_t blen)
      if (XrdOssSS->MaxSize && (long long)(offset+blen) > XrdOssSS->MaxSize)
         return (ssize_t)-XRDOSS_E8007;
 
+     XrdOssCache_LoadIO ioAcct(ioLoad, blen);
+
      do { retval = pwrite(fd, buff, blen, offset); }
           while(retval < 0 && errno == EINTR);
 
@@ -1035,6 +1056,72 @@ ssize_t XrdOssFile::Write(const void *buff, off_t offset, size_t blen)
      return retval;
 }
 
+/******************************************************************************/
+/*                                W r i t e V                                 */
+/******************************************************************************/
+
+/*
+  Function: Write file bytes as directed by the write vector.
+
+  Input:    writeV    - A description of the writes to perform; includes the
+                        absolute offset, the size of the write, and the buffer
+                        holding the data.
+            n         - The size of the writeV vector.
+
+  Output:   Returns the number of bytes written upon success and -errno o/w.
+            If fewer bytes than requested were written, -ESPIPE is returned.
+
+  Notes:    Elements that are contiguous in the file are gathered into a
+            single pwritev() so that callers handing in adjacent buffers
+            (e.g. the proxy file cache write queue) issue one system call.
+*/
+
+ssize_t XrdOssFile::WriteV(XrdOucIOVec *writeV, int n)
+{
+   static const int maxIOV = 64;
+   struct iovec iov[maxIOV];
+   ssize_t retval, totBytes = 0;
+   long long runOff, runLen;
+   int i = 0, k, niov;
+
+   if (fd < 0) return (ssize_t)-XRDOSS_E8004;
+
+// Compressed files have their own write restrictions, let the base handle it
+//
+   if (cxobj) return XrdOssDF::WriteV(writeV, n);
+
+   while(i < n)
+        {runOff = writeV[i].offset; runLen = 0; niov = 0;
+         do {iov[niov].iov_base = (void *)writeV[i].data;
+             iov[niov].iov_len  = writeV[i].size;
+             runLen += writeV[i].size; niov++; i++;
+            } while(i < n && niov < maxIOV
+                 && writeV[i].offset == runOff + runLen);
+
+         if (XrdOssSS->MaxSize && runOff + runLen > XrdOssSS->MaxSize)
+            return (ssize_t)-XRDOSS_E8007;
+
+     // Write out the run, restarting after any partial write
+     //
+         XrdOssCache_LoadIO ioAcct(ioLoad, runLen);
+         k = 0;
+         while(runLen > 0)
+              {do {retval = pwritev(fd, iov+k, niov-k, runOff);}
+                  while(retval < 0 && errno == EINTR);
+               if (retval <= 0) return (retval < 0 ? (ssize_t)-errno
+                                                   : (ssize_t)-ESPIPE);
+               totBytes += retval; runOff += retval; runLen -= retval;
+               while(k < niov && retval >= (ssize_t)iov[k].iov_len)
+                    {retval -= iov[k].iov_len; k++;}
+               if (retval)
+                  {iov[k].iov_base = (char *)iov[k].iov_base + retval;
+                   iov[k].iov_len -= retval;
+                  }
+              }
+        }
+   return totBytes;
+}
+
 /******************************************************************************/
 /*                                F c h m o d                                 */
 /******************************************************************************/
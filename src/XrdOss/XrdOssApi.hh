@@ -83,6 +83,7 @@ static const int    noDread  = 0x04;
 class oocx_CXFile;
 class XrdSfsAio;
 class XrdOssCache_FS;
+class XrdOssCache_Load;
 class XrdOssMioFile;
   
 class XrdOssFile : public XrdOssDF
@@ -105,6 +106,10 @@ int     Ftruncate(unsigned long long);
 int     getFD() {return fd;}
 off_t   getMmap(void **addr);
 int     isCompressed(char *cxidp=0);
+using   XrdOssDF::pgRead;
+int     pgRead (XrdSfsAio *aioparm, uint64_t opts);
+using   XrdOssDF::pgWrite;
+int     pgWrite(XrdSfsAio *aioparm, uint64_t opts);
 ssize_t Read(               off_t, size_t);
 ssize_t Read(       void *, off_t, size_t);
 int     Read(XrdSfsAio *aiop);
@@ -112,12 +117,13 @@ ssize_t ReadV(XrdOucIOVec *readV, int);
 ssize_t ReadRaw(    void *, off_t, size_t);
 ssize_t Write(const void *, off_t, size_t);
 int     Write(XrdSfsAio *aiop);
+ssize_t WriteV(XrdOucIOVec *writeV, int);
  
         // Constructor and destructor
         XrdOssFile(const char *tid, int fdnum=-1)
                   : XrdOssDF(tid, DF_isFile, fdnum),
-                    cxobj(0), cacheP(0), mmFile(0),
-                    rawio(0), cxpgsz(0) {cxid[0] = '\0';}
+                    cxobj(0), cacheP(0), ioLoad(0), mmFile(0),
+                    rawio(0), cxpgsz(0), ioWrite(false) {cxid[0] = '\0';}
 
 virtual ~XrdOssFile() {if (fd >= 0) Close();}
 
@@ -127,10 +133,12 @@ int     Open_ufs(const char *, int, int, unsigned long long);
 static int      AioFailure;
 oocx_CXFile    *cxobj;
 XrdOssCache_FS *cacheP;
+XrdOssCache_Load *ioLoad;
 XrdOssMioFile  *mmFile;
 long long       FSize;
 int             rawio;
 int             cxpgsz;
+bool            ioWrite;
 char            cxid[4];
 };
 
@@ -163,7 +171,7 @@ int       Configure(const char *, XrdSysError &, XrdOucEnv *envP);
 void      Config_Display(XrdSysError &);
 virtual
 int       Create(const char *, const char *, mode_t, XrdOucEnv &, int opts=0);
-uint64_t  Features() {return XRDOSS_HASNAIO;} // Turn async I/O off for disk
+uint64_t  Features() {return (AioEngine ? 0 : XRDOSS_HASNAIO);} // Only io_uring
 int       GenLocalPath(const char *, char *);
 int       GenRemotePath(const char *, char *);
 int       Init(XrdSysLogger *, const char *, XrdOucEnv *envP);
@@ -199,6 +207,7 @@ int       Stats(char *bp, int bl);
 
 static int   AioInit();
 static int   AioAllOk;
+static char  AioEngine;         // Async I/O done via io_uring (1) or POSIX (0)
 
 static char  tryMmap;           // Memory mapped files enabled
 static char  chkMmap;           // Memory mapped files are selective
@@ -346,6 +355,7 @@ void   ConfigStats(XrdSysError &Eroute);
 void   ConfigStats(dev_t Devnum, char *lP);
 int    ConfigXeq(char *, XrdOucStream &, XrdSysError &);
 void   List_Path(const char *, const char *, unsigned long long, XrdSysError &);
+int    xaio(XrdOucStream &Config, XrdSysError &Eroute);
 int    xalloc(XrdOucStream &Config, XrdSysError &Eroute);
 int    xcache(XrdOucStream &Config, XrdSysError &Eroute);
 int    xcachescan(XrdOucStream &Config, XrdSysError &Eroute);
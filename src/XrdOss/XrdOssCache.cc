@@ -30,7 +30,9 @@
 
 #include <unistd.h>
 #include <dirent.h>
+#include <algorithm>
 #include <cerrno>
+#include <climits>
 #include <fcntl.h>
 #include <map>
 #include <cstdio>
@@ -82,6 +84,7 @@ int                 XrdOssCache::fsCount = 0;
 int                 XrdOssCache::ovhAlloc= 0;
 int                 XrdOssCache::Quotas  = 0;
 int                 XrdOssCache::Usage   = 0;
+bool                XrdOssCache::ioTrack = false;
 
 namespace XrdOssCacheDevs
 {
@@ -93,6 +96,8 @@ struct devID
 
 std::map<dev_t, devID> dev2ID;
 
+std::map<std::string, int> spPolicy;
+
 int devNMax = 1;
 int prtNMax = 1;
 }
@@ -135,6 +140,67 @@ XrdOssCache_FSData::XrdOssCache_FSData(const char *fsp,
          partID = static_cast<unsigned short>(prtNMax++);
          devN = "dev";
         }
+
+// Partitions on the same block device share the load of that device
+//
+     ioLoad = 0;
+     if (bdevID)
+        {XrdOssCache_FSData *fdp = XrdOssCache::fsdata;
+         while(fdp && fdp->bdevID != bdevID) fdp = fdp->next;
+         if (fdp) ioLoad = fdp->ioLoad;
+        }
+     if (!ioLoad) ioLoad = new XrdOssCache_Load;
+}
+
+/******************************************************************************/
+/*              X r d O s s C a c h e _ L o a d   M e t h o d s               */
+/******************************************************************************/
+
+void XrdOssCache_Load::End(long long blen, long long usec)
+{
+   int avg = ioTime.load(std::memory_order_relaxed);
+
+// Keep a running average giving the latest request a weight of 1/8. Racing
+// updates may lose a sample which hardly matters for an average.
+//
+   if (usec > INT_MAX) usec = INT_MAX;
+   ioTime.store(avg + (static_cast<int>(usec) - avg) / 8,
+                std::memory_order_relaxed);
+   ioLast.store(time(0), std::memory_order_relaxed);
+   ioBytes -= blen;
+   ioActive--;
+}
+
+/******************************************************************************/
+
+void XrdOssCache_Load::Unpend()
+{
+   int n = Pending.load();
+
+   while(n > 0 && !Pending.compare_exchange_weak(n, n-1)) {}
+}
+
+/******************************************************************************/
+
+long long XrdOssCache_Load::Score(time_t now)
+{
+   long long avg = ioTime.load(std::memory_order_relaxed);
+   time_t idle = now - ioLast.load(std::memory_order_relaxed);
+
+// Files allocated here count as writers until they are opened. Should nothing
+// have been allocated for a minute, whatever is still pending never will be.
+//
+   if (now - pendLast.load() >= 60) Pending = 0;
+
+// The score estimates how long a new request would wait: the requests ahead
+// of it, counting open writers and each megabyte in flight as one, times the
+// average request time. The average is halved for every 10 seconds the device
+// has been idle so that a device once slow is not shunned forever. Times
+// below 100 microseconds are served from memory and count as an idle device.
+//
+   if (idle >= 10) avg >>= std::min(idle / 10, static_cast<time_t>(62));
+   return (1 + Writers + Pending + ioActive + (ioBytes >> 20))
+          * std::max(avg, 100LL);
 }
   
 /******************************************************************************/
@@ -496,10 +562,12 @@ int XrdOssCache::Alloc(XrdOssCache::allocInfo &aInfo)
    XrdSysMutexHelper myMutex(&Mutex);
    double diffree;
    XrdOssPath::fnInfo Info;
-   XrdOssCache_FS *fsp, *fspend, *fsp_sel;
+   XrdOssCache_FS *fsp, *fspend, *fsp_sel, *fsp_big;
    XrdOssCache_Group *cgp = 0;
-   long long size, maxfree, curfree;
+   long long size, maxfree, curfree, bigfree, minload = 0, curload;
+   time_t now = 0;
    int rc, madeDir, datfd = 0;
+   bool byLoad;
 
 // Compute appropriate allocation size
 //
@@ -515,9 +583,13 @@ int XrdOssCache::Alloc(XrdOssCache::allocInfo &aInfo)
 
 // Find a cache that will fit this allocation request. We start with the next
 // entry past the last one we selected and go full round looking for a
-// compatable entry (enough space and in the right space group).
+// compatable entry (enough space and in the right space group). When the
+// space allocates by load we pick the least loaded device, using the fuzz to
+// decide when loads are close enough for free space to choose instead. We
+// also note the one with the most free space to report how often load won.
 //
-   fsp_sel = 0; maxfree = 0;
+   fsp_sel = fsp_big = 0; maxfree = bigfree = 0;
+   if ((byLoad = (cgp->Policy == XrdOssCache_Group::byLoad))) now = time(0);
    fsp = cgp->curr->next; fspend = fsp; // End when we hit the start again
    do {
        if (strcmp(aInfo.cgName, fsp->group)
@@ -526,6 +598,21 @@ int XrdOssCache::Alloc(XrdOssCache::allocInfo &aInfo)
        curfree = fsp->fsdata->frsz;
        if (size > curfree) continue;
 
+       if (byLoad)
+          {if (curfree > bigfree) {fsp_big = fsp; bigfree = curfree;}
+           curload = fsp->fsdata->ioLoad->Score(now);
+           if (fsp_sel)
+              {long long difload = minload - curload;
+               diffree = (!(curload + minload) ? 0.0
+                       : static_cast<double>(XRDABS(difload)) /
+                         static_cast<double>(minload + curload));
+               if (diffree > fuzAlloc ? curload >= minload : curfree <= maxfree)
+                  continue;
+              }
+           fsp_sel = fsp; minload = curload; maxfree = curfree;
+           continue;
+          }
+
              if (fuzAlloc > 0.999) {fsp_sel = fsp; break;}
        else  if (!fuzAlloc || !fsp_sel)
                 {if (curfree > maxfree) {fsp_sel = fsp; maxfree = curfree;}}
@@ -540,6 +627,8 @@ int XrdOssCache::Alloc(XrdOssCache::allocInfo &aInfo)
 //
    if (!fsp_sel) return -ENOSPC;
    cgp->curr = fsp_sel;
+   cgp->Allocs++;
+   if (byLoad && fsp_sel->fsdata != fsp_big->fsdata) cgp->Steered++;
 
 // Construct the target filename
 //
@@ -566,6 +655,16 @@ int XrdOssCache::Alloc(XrdOssCache::allocInfo &aInfo)
        if (datfd < 0) return (errno ? -errno : -EFAULT);
       }
 
+// When allocating by load, charge the device with the writer to come right
+// away. Otherwise concurrent allocations would all see the same load and pick
+// the same device until the files actually get opened.
+//
+   if (byLoad)
+      {DEBUG("load=" <<minload <<" path=" <<fsp_sel->fsdata->path);
+       aInfo.cgLoad = fsp_sel->fsdata->ioLoad;
+       aInfo.cgLoad->Pend(now);
+      }
+
 // All done (temporarily adjust down the free space)x
 //
    DEBUG("free=" <<fsp_sel->fsdata->frsz <<'-' <<size <<" path=" 
@@ -672,6 +771,23 @@ int XrdOssCache::Init(long long aMin, int ovhd, int aFuzz)
    minAlloc = aMin;
    ovhAlloc = ovhd;
    fuzAlloc = static_cast<double>(aFuzz)/100.0;
+
+// Apply the allocation policy of each space. Device load is only tracked if
+// some space needs it.
+//
+   std::map<std::string, int>::iterator it;
+   XrdOssCache_Group *cgp;
+   for (it = spPolicy.begin(); it != spPolicy.end(); it++)
+       {cgp = XrdOssCache_Group::fsgroups;
+        while(cgp && strcmp(it->first.c_str(), cgp->group)) cgp = cgp->next;
+        if (!cgp)
+           {OssEroute.Say("Config warning: ignoring allocation policy for "
+                          "undefined space ", it->first.c_str());
+            continue;
+           }
+        cgp->Policy = static_cast<short>(it->second);
+        if (it->second == XrdOssCache_Group::byLoad) ioTrack = true;
+       }
    return 0;
 }
 
@@ -700,6 +816,29 @@ void XrdOssCache::List(const char *lname, XrdSysError &Eroute)
          Eroute.Say(buff);
          fsp = fsp->next;
         } while(fsp != fsfirst);
+
+// List the spaces that allocate by load
+//
+   XrdOssCache_Group *cgp = XrdOssCache_Group::fsgroups;
+   while(cgp)
+        {if (cgp->Policy == XrdOssCache_Group::byLoad)
+            Eroute.Say(lname, "space ", cgp->group, " alloc load");
+         cgp = cgp->next;
+        }
+}
+
+/******************************************************************************/
+/*                                  L o a d                                   */
+/******************************************************************************/
+
+// The list of partitions only changes during configuration so we need no lock.
+
+XrdOssCache_Load *XrdOssCache::Load(dev_t devid)
+{
+   XrdOssCache_FSData *fdp = fsdata;
+
+   while(fdp && fdp->fsid != devid) fdp = fdp->next;
+   return (fdp ? fdp->ioLoad : 0);
 }
   
 /******************************************************************************/
@@ -836,6 +975,18 @@ char *XrdOssCache::Parse(const char *token, char *cbuff, int cblen)
    return Path;
 }
 
+/******************************************************************************/
+/*                             S e t P o l i c y                              */
+/******************************************************************************/
+
+// SetPolicy() is only called during configuration and no locks are needed.
+// The policy is applied by Init() once all of the spaces are known.
+
+void XrdOssCache::SetPolicy(const char *sname, int policy)
+{
+   spPolicy[sname] = policy;
+}
+
 /******************************************************************************/
 /*                                  S c a n                                   */
 /******************************************************************************/
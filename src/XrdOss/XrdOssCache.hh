@@ -30,6 +30,8 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
+#include <chrono>
 #include <ctime>
 #include <sys/stat.h>
 #include "XrdOuc/XrdOucDLlist.hh"
@@ -93,6 +95,66 @@ long long          Quota;
     ~XrdOssCache_Space() {}
 };
   
+/******************************************************************************/
+/*                      X r d O s s C a c h e _ L o a d                       */
+/******************************************************************************/
+
+// The I/O load on a device. It is only tracked when some space allocates by
+// load. Partitions that live on the same block device share one object.
+//
+class XrdOssCache_Load
+{
+public:
+
+std::atomic<int>       Writers;  // Files open for writing
+std::atomic<int>       Pending;  // Files allocated here but not yet opened
+std::atomic<time_t>    pendLast; // When a file was last allocated here
+std::atomic<int>       ioActive; // Requests in progress
+std::atomic<long long> ioBytes;  // Bytes requested by those in progress
+std::atomic<int>       ioTime;   // Average request time in microseconds
+std::atomic<time_t>    ioLast;   // When a request last completed
+
+void       Begin(long long blen) {ioActive++; ioBytes += blen;}
+
+void       End(long long blen, long long usec);
+
+void       Pend(time_t now) {pendLast.store(now); Pending++;}
+
+void       Unpend();
+
+long long  Score(time_t now);
+
+           XrdOssCache_Load() : Writers(0), Pending(0), pendLast(0),
+                                ioActive(0), ioBytes(0), ioTime(0), ioLast(0) {}
+          ~XrdOssCache_Load() {}
+};
+
+// Accounts for a single request against a device's load, if any
+//
+class XrdOssCache_LoadIO
+{
+public:
+
+      XrdOssCache_LoadIO(XrdOssCache_Load *lP, long long blen)
+                        : loadP(lP), ioLen(blen)
+                        {if (lP) {lP->Begin(blen);
+                                  ioBeg = std::chrono::steady_clock::now();
+                                 }
+                        }
+
+     ~XrdOssCache_LoadIO()
+                        {if (loadP)
+                            loadP->End(ioLen,
+                                std::chrono::duration_cast<std::chrono::microseconds>
+                                (std::chrono::steady_clock::now() - ioBeg).count());
+                        }
+private:
+
+XrdOssCache_Load                     *loadP;
+long long                             ioLen;
+std::chrono::steady_clock::time_point ioBeg;
+};
+
 /******************************************************************************/
 /*                    X r d O s s C a c h e _ F S D a t a                     */
 /******************************************************************************/
@@ -114,6 +176,7 @@ dev_t               fsid;
 const char         *path;
 const char         *pact;
 const char         *devN;
+XrdOssCache_Load   *ioLoad;
 time_t              updt;
 int                 stat;
 unsigned short      bdevID;
@@ -189,9 +252,14 @@ XrdOssCache_FS      *curr;
 XrdOssCache_FSAP    *fsVec; // Partitions where space may be allocated
 long long            Usage;
 long long            Quota;
+long long            Allocs;  // Allocations made in this space
+long long            Steered; // Allocations placed by load, not by free space
 int                  GRPid;
 short                fsNum;
-short                rsvd;
+short                Policy;  // How a partition is selected (allocPolicy)
+
+enum allocPolicy {byFree = 0, byLoad = 1};
+
 static
 XrdOssCache_Group   *PubGroup;
 static long long     PubQuota;
@@ -200,7 +268,8 @@ static XrdOssCache_Group *fsgroups;
 
        XrdOssCache_Group(const char *grp, XrdOssCache_FS *fsp=0) 
                         : next(0), group(strdup(grp)), curr(fsp), fsVec(0),
-                          Usage(0), Quota(-1), GRPid(-1), fsNum(0), rsvd(0)
+                          Usage(0), Quota(-1), Allocs(0), Steered(0),
+                          GRPid(-1), fsNum(0), Policy(byFree)
                         {if (!strcmp("public", grp)) PubGroup = this;}
       ~XrdOssCache_Group() {if (group) free((void *)group);}
 };
@@ -230,10 +299,13 @@ struct allocInfo
        char           *cgPsfx;   // Out: -> pfn suffix area. If 0, non-xa cache
        XrdOssCache_FS *cgFSp;    // Out: -> Cache file system definition
        mode_t          aMode;    // Opt: Create mode; if 0, pfn file not created
+       XrdOssCache_Load *cgLoad; // Out: -> Device load charged with a pending
+                                 //      writer; Unpend() it if not opened
 
        allocInfo(const char *pP, char *bP, int bL)
                 : Path(pP),   cgName(0), cgSize(0), cgPath(0), cgPlen(0),
-                  cgPFsz(bL), cgPFbf(bP), cgPsfx(0), cgFSp(0), aMode(0) {}
+                  cgPFsz(bL), cgPFbf(bP), cgPsfx(0), cgFSp(0), aMode(0),
+                  cgLoad(0) {}
       ~allocInfo() {}
       };
 
@@ -250,12 +322,16 @@ static int             Init(long long aMin, int ovhd, int aFuzz);
 
 static void            List(const char *lname, XrdSysError &Eroute);
 
+static XrdOssCache_Load *Load(dev_t devid);
+
 static void            MapDevs(bool dBug=false);
 
 static char           *Parse(const char *token, char *cbuff, int cblen);
 
 static void           *Scan(int cscanint);
 
+static void            SetPolicy(const char *sname, int policy);
+
                        XrdOssCache() {}
                       ~XrdOssCache() {}
 
@@ -270,6 +346,7 @@ static XrdOssCache_FS     *fsfirst;  // -> First  filesystem
 static XrdOssCache_FS     *fslast;   // -> Last   filesystem
 static XrdOssCache_FSData *fsdata;   // -> Filesystem data
 static int                 fsCount;  // Number of file systems
+static bool                ioTrack;  // Device load is being tracked
 
 private:
 static bool MapDM(const char *ldm, char *buff, int blen);
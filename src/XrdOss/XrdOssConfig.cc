@@ -53,6 +53,7 @@
 #include "XrdOss/XrdOssOpaque.hh"
 #include "XrdOss/XrdOssSpace.hh"
 #include "XrdOss/XrdOssTrace.hh"
+#include "XrdOss/XrdOssUring.hh"
 #include "XrdOuc/XrdOuca2x.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdSys/XrdSysError.hh"
@@ -442,6 +443,8 @@ void XrdOssSys::Config_Display(XrdSysError &Eroute)
 
      XrdOssMio::Display(Eroute);
 
+     XrdOssUring::Display(Eroute);
+
      XrdOssCache::List("       oss.", Eroute);
            List_Path("       oss.defaults ", "", DirFlags, Eroute);
      fp = RPList.First();
@@ -1046,6 +1049,7 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
     int nosubs;
     XrdOucEnv *myEnv = 0;
 
+   TS_Xeq("aio",           xaio);
    TS_Xeq("alloc",         xalloc);
    TS_Xeq("cache",         xcache);
    TS_Xeq("cachescan",     xcachescan); // Backward compatibility
@@ -1114,6 +1118,60 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
    return 0;
 }
 
+/******************************************************************************/
+/*                                  x a i o                                   */
+/******************************************************************************/
+
+/* Function: xaio
+
+   Purpose:  To parse the directive: aio engine {posix | uring} [depth <n>]
+                                                [sqpoll]
+
+             engine   the asynchronous I/O engine to use for disk files:
+                      posix - POSIX aio which, by default, is not used.
+                      uring - Linux io_uring with batched submission and
+                              direct completion handling.
+             depth    the number of entries in the submission ring. The
+                      default is 256. Requests that do not fit are done
+                      synchronously.
+             sqpoll   use a kernel thread to poll the submission ring.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdOssSys::xaio(XrdOucStream &Config, XrdSysError &Eroute)
+{
+    char *val;
+    int  depth = 256;
+    bool sqpoll = false, uring = false;
+
+    if (!(val = Config.GetWord()) || strcmp(val, "engine"))
+       {Eroute.Emsg("Config", "aio engine not specified"); return 1;}
+
+    if (!(val = Config.GetWord()))
+       {Eroute.Emsg("Config", "aio engine type not specified"); return 1;}
+         if (!strcmp(val, "uring")) uring = true;
+    else if ( strcmp(val, "posix"))
+            {Eroute.Emsg("Config", "invalid aio engine -", val); return 1;}
+
+    while((val = Config.GetWord()))
+         {     if (!strcmp(val, "depth"))
+                  {if (!(val = Config.GetWord()))
+                      {Eroute.Emsg("Config", "aio depth not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2i(Eroute,"aio depth",val,&depth,8,32768))
+                      return 1;
+                  }
+          else if (!strcmp(val, "sqpoll")) sqpoll = true;
+          else {Eroute.Emsg("Config", "invalid aio option -", val); return 1;}
+         }
+
+    AioEngine = (uring ? 1 : 0);
+    XrdOssUring::Set(depth, sqpoll);
+    return 0;
+}
+
 /******************************************************************************/
 /*                                x a l l o c                                 */
 /******************************************************************************/
@@ -1542,10 +1600,14 @@ int XrdOssSys::xprerd(XrdOucStream &Config, XrdSysError &Eroute)
 
    Purpose:  To parse the directive: space <name> <path> {chkmount <id> [nofail]
                                  or: space <name> {assign}default} <lfn> [...]
+                                 or: space <name> alloc {free | load}
 
              <name>   logical name for the filesystem.
              <path>   path to the filesystem.
              <id>     mountpoint name in order to be considered valid
+             free     select the partition with the most free space (default).
+             load     select the partition on the least loaded device, using
+                      free space when loads are within the alloc fuzz.
 
    Output: 0 upon success or !0 upon failure.
 
@@ -1573,6 +1635,21 @@ int XrdOssSys::xspace(XrdOucStream &Config, XrdSysError &Eroute, int *isCD)
    if (!(val = Config.GetWord()) || !(*val))
       {Eroute.Emsg("Config", "space path not specified"); return 1;}
 
+// Check if this sets the allocation policy
+//
+   if (!strcmp("alloc", val) && !isCD)
+      {if (!(val = Config.GetWord()))
+          {Eroute.Emsg("Config", "space alloc policy not specified"); return 1;}
+            if (!strcmp("free", val))
+               XrdOssCache::SetPolicy(grp.c_str(), XrdOssCache_Group::byFree);
+       else if (!strcmp("load", val))
+               XrdOssCache::SetPolicy(grp.c_str(), XrdOssCache_Group::byLoad);
+       else {Eroute.Emsg("Config", "invalid space alloc policy -", val);
+             return 1;
+            }
+       return 0;
+      }
+
 // Check if assignment
 //
    if (((isAsgn = !strcmp("assign",val)) || ! strcmp("default",val)) && !isCD)
@@ -264,18 +264,27 @@ int XrdOssSys::Alloc_Cache(XrdOssCreateInfo &crInfo, XrdOucEnv &env)
    if (!(crInfo.pOpts & XRDEXP_NOXATTR)
    &&  (rc = XrdSysFAttr::Xat->Set(XrdFrcXAttrPfn::Name(), crInfo.Path,
                                    strlen(crInfo.Path)+1, pbuff, datfd)))
-      {close(datfd); return rc;}
+      {close(datfd);
+       if (aInfo.cgLoad) aInfo.cgLoad->Unpend();
+       return rc;
+      }
 
 // Set extended attributes for this newly created file if allowed to do so.
 // SetFattr() alaways closes the provided file descriptor!
 //
-   if ((rc = SetFattr(crInfo, datfd, 1))) return rc;
+   if ((rc = SetFattr(crInfo, datfd, 1)))
+      {if (aInfo.cgLoad) aInfo.cgLoad->Unpend();
+       return rc;
+      }
 
-// Now create a symbolic link to the target
+// Now create a symbolic link to the target. Should that fail, the file will
+// never be opened and the device must not count it as a writer to come.
 //
    if ((symlink(pbuff, crInfo.Path) && errno != EEXIST)
    ||  unlink(crInfo.Path) || symlink(pbuff, crInfo.Path))
-      {rc = -errno; unlink(pbuff);}
+      {rc = -errno; unlink(pbuff);
+       if (aInfo.cgLoad) aInfo.cgLoad->Unpend();
+      }
 
 // All done
 //
@@ -143,9 +143,12 @@ int XrdOssSys::Reloc(const char *tident, const char *path,
    if (!aInfo.cgPsfx) return -ENOTSUP;
 
 // Copy the original file to the new location. Copy() always closes the fd.
+// The copy is the only writer of the new file, so it is no longer pending.
 //
    PF.datfd = -1;
-   if ((rc_c = XrdOssCopy::Copy(local_path, pbuff, datfd)) < 0) return (int)rc_c;
+   rc_c = XrdOssCopy::Copy(local_path, pbuff, datfd);
+   if (aInfo.cgLoad) aInfo.cgLoad->Unpend();
+   if (rc_c < 0) return (int)rc_c;
 
 // If the file is to be merely copied, substitute the desired destination
 //
@@ -502,18 +502,20 @@ int XrdOssSys::getStats(char *buff, int blen)
                 "<tot>%lld</tot><free>%lld</free><maxf>%lld</maxf>"
                 "<fsn>%d</fsn><usg>%lld</usg>";
    static const char stagq[] = "<qta>%lld</qta>";
+   static const char stagl[] = "<alc>%lld</alc><ldsel>%lld</ldsel>";
    static const char stags[] = "</stats>";
    static const char stag3[] = "</space>";
 
    static const int stag1sz = sizeof(stag1);
    static const int stag2sz = sizeof(stag2) + XrdOssSpace::maxSNlen + (16*5);
    static const int stagqsz = sizeof(stagq) + 16;
+   static const int staglsz = sizeof(stagl) + (16*2);
    static const int stagssz = sizeof(stags);
    static const int stag3sz = sizeof(stag3);
 
    static const int stagsz  = ptag1sz + ptag2sz + ptag3sz + 1024 +
                             + stag1sz + stag2sz + stag3sz
-                            + stagqsz + stagssz;
+                            + stagqsz + staglsz + stagssz;
 
    XrdOssCache_Group  *fsg = XrdOssCache_Group::fsgroups;
    OssDPath           *dpP = DPList;
@@ -524,7 +526,7 @@ int XrdOssSys::getStats(char *buff, int blen)
 // do one-time initialization here.
 //
    if (!buff) return ptag1sz + (ptag2sz * numDP) + stag3sz + lenDP
-                   + stag1sz + (stag2sz * numCG) + stag3sz
+                   + stag1sz + ((stag2sz + staglsz) * numCG) + stag3sz
                    + stagqsz + stagssz;
 
 // Make sure we have enough space for one entry
@@ -568,6 +570,12 @@ int XrdOssSys::getStats(char *buff, int blen)
          bp += flen; blen -= flen; spNum++;
          if (CSpace.Quota >= 0 && blen > stagqsz)
             {flen = sprintf(bp, stagq, CSpace.Quota); bp += flen; blen -= flen;}
+         if (fsg->Policy == XrdOssCache_Group::byLoad && blen > staglsz)
+            {XrdOssCache::Mutex.Lock();
+             flen = sprintf(bp, stagl, fsg->Allocs, fsg->Steered);
+             XrdOssCache::Mutex.UnLock();
+             bp += flen; blen -= flen;
+            }
          if (blen < stagssz) return dpNum;
          strcpy(bp, stags); bp += (stagssz-1); blen -= (stagssz-1);
          fsg = fsg->next;
@@ -0,0 +1,501 @@
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O s s U r i n g . c c                         */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(HAVE_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include "XrdOss/XrdOssTrace.hh"
+#include "XrdOss/XrdOssUring.hh"
+#include "XrdOuc/XrdOucPgrwUtils.hh"
+#include "XrdSfs/XrdSfsAio.hh"
+#include "XrdSys/XrdSysAtomics.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                               G l o b a l s                                */
+/******************************************************************************/
+
+extern XrdSysTrace OssTrace;
+
+extern XrdSysError OssEroute;
+
+int   XrdOssUring::Depth  = 256;
+bool  XrdOssUring::SQPoll = false;
+bool  XrdOssUring::ringOK = false;
+
+/******************************************************************************/
+/*                           L o c a l   S t a t e                            */
+/******************************************************************************/
+
+namespace
+{
+// The operation type is encoded in the low order bits of the user data. This
+// works because XrdSfsAio objects are always at least 8-byte aligned.
+//
+const uint64_t opMask = 0x07;
+
+struct RingStats
+      {std::atomic<long long> subCnt{0}; // Requests placed on the submission ring
+       std::atomic<long long> endCnt{0}; // Requests reaped from the completion ring
+       std::atomic<long long> entCnt{0}; // Number of io_uring_enter() submission calls
+       std::atomic<long long> synCnt{0}; // Requests that had to be done synchronously
+       std::atomic<long long> errCnt{0}; // Requests that failed to be submitted
+      } Stat;
+
+#if defined(__linux__) && defined(HAVE_IO_URING)
+struct RingInfo
+      {XrdSysMutex          sqMutex;
+       int                  ringFD;
+       bool                 flushing;
+       unsigned int         sqTail;     // Local copy of the submission tail
+       unsigned int         sqMask;
+       unsigned int         sqEntries;
+       unsigned int        *sqHead;
+       unsigned int        *sqKTail;
+       unsigned int        *sqFlags;
+       unsigned int        *sqArray;
+       struct io_uring_sqe *sqes;
+       unsigned int         cqMask;
+       unsigned int         cqEntries;
+       unsigned int        *cqHead;
+       unsigned int        *cqTail;
+       struct io_uring_cqe *cqes;
+       int                  inFlight;
+
+       RingInfo() : ringFD(-1), flushing(false), sqTail(0), inFlight(0) {}
+      } Ring;
+
+int Enter(unsigned int toSub, unsigned int minDone, unsigned int flags)
+{
+   return static_cast<int>(syscall(__NR_io_uring_enter, Ring.ringFD,
+                                   toSub, minDone, flags, 0, 0));
+}
+
+// Do a request that could not be submitted synchronously, returning what its
+// completion would have held: the byte count or -errno.
+//
+int SyncIO(const struct io_uring_sqe &sqe)
+{
+   void   *buff = (void *)(uintptr_t)sqe.addr;
+   ssize_t rc;
+
+   do {switch(sqe.opcode)
+             {case IORING_OP_READ:  rc = pread (sqe.fd, buff, sqe.len, sqe.off);
+                                    break;
+              case IORING_OP_WRITE: rc = pwrite(sqe.fd, buff, sqe.len, sqe.off);
+                                    break;
+              default:              rc = fsync(sqe.fd);
+                                    break;
+             }
+      } while(rc < 0 && errno == EINTR);
+   return (rc < 0 ? -errno : static_cast<int>(rc));
+}
+#endif
+}
+
+/******************************************************************************/
+/*                               D i s p l a y                                */
+/******************************************************************************/
+
+void XrdOssUring::Display(XrdSysError &Eroute)
+{
+   char buff[128];
+
+   if (!ringOK) return;
+   snprintf(buff, sizeof(buff), "       oss.aio          engine uring "
+                                "depth %d%s", Depth, (SQPoll ? " sqpoll" : ""));
+   Eroute.Say(buff);
+}
+
+/******************************************************************************/
+/* Private:                         D o n e                                   */
+/******************************************************************************/
+
+void XrdOssUring::Done(uint64_t udata, int result)
+{
+   EPNAME("UringDone");
+   XrdSfsAio *aiop = (XrdSfsAio *)(udata & ~opMask);
+   OpType     opType = static_cast<OpType>(udata & opMask);
+
+// Set the result and, for pgRead, compute the checksums for what was read
+//
+   aiop->Result = result;
+   if (opType == opPgRead && result > 0 && aiop->cksVec)
+      XrdOucPgrwUtils::csCalc((const char *)aiop->sfsAio.aio_buf,
+                              (off_t)aiop->sfsAio.aio_offset,
+                              (size_t)result, aiop->cksVec);
+
+   DEBUG((opType == opWrite ? "write" : (opType == opFsync ? "fsync" : "read"))
+         <<" completed for " <<aiop->TIdent <<"; result=" <<result
+         <<" aiocb=" <<Xrd::hex1 <<aiop);
+
+// Call the appropriate completion routine
+//
+   if (opType == opRead || opType == opPgRead) aiop->doneRead();
+      else aiop->doneWrite();
+}
+
+/******************************************************************************/
+/* Private:                        F l u s h                                  */
+/******************************************************************************/
+
+// Flush() must be called with the submission mutex held. Only one thread at a
+// time submits entries; any thread that adds entries while a submission is in
+// progress leaves them for that thread which picks them up before returning.
+// This naturally batches requests under load. Should the submission fail for
+// any reason other than a temporary shortage of kernel resources, the entries
+// that were not submitted are taken back off the ring and their requests are
+// failed via their completion routine. A temporary shortage is left for the
+// reaper to retry once it has reaped a completion. When nothing is left in
+// the kernel to complete, the entries are instead taken back and done
+// synchronously. Both are done with the mutex released.
+//
+void XrdOssUring::Flush()
+{
+#if defined(__linux__) && defined(HAVE_IO_URING)
+   std::vector<struct io_uring_sqe> failed;
+   unsigned int toSub, sqHead;
+   int rc, ecode = 0;
+   bool doSync = false;
+
+// With kernel side polling we only need to wake up the polling thread
+//
+   if (SQPoll)
+      {if (__atomic_load_n(Ring.sqFlags, __ATOMIC_ACQUIRE) & IORING_SQ_NEED_WAKEUP)
+          Enter(0, 0, IORING_ENTER_SQ_WAKEUP);
+       return;
+      }
+
+// If someone else is already submitting, they will pick up our entries
+//
+   if (Ring.flushing) return;
+   Ring.flushing = true;
+
+// Submit everything that is pending, including any new arrivals
+//
+   while((toSub = Ring.sqTail - __atomic_load_n(Ring.sqHead, __ATOMIC_ACQUIRE)))
+        {Ring.sqMutex.UnLock();
+         do {rc = Enter(toSub, 0, 0);} while(rc < 0 && errno == EINTR);
+         Ring.sqMutex.Lock();
+         Stat.entCnt++;
+         if (rc < 0)
+            {ecode = errno;
+             toSub = Ring.sqTail - __atomic_load_n(Ring.sqHead, __ATOMIC_ACQUIRE);
+             if (ecode == EAGAIN || ecode == EBUSY)
+                {if (AtomicGet(Ring.inFlight) > (int)toSub) break;
+                 doSync = true;
+                } else OssEroute.Emsg("Uring", ecode, "submit aio requests");
+             sqHead = __atomic_load_n(Ring.sqHead, __ATOMIC_ACQUIRE);
+             while(Ring.sqTail != sqHead)
+                  {Ring.sqTail--;
+                   failed.push_back(Ring.sqes[Ring.sqArray[Ring.sqTail
+                                    & Ring.sqMask]]);
+                  }
+             __atomic_store_n(Ring.sqKTail, Ring.sqTail, __ATOMIC_RELEASE);
+             break;
+            }
+        }
+
+   Ring.flushing = false;
+
+// Fail or do the requests that could not be submitted. The completion routine
+// may well submit another request, so this cannot be done holding the mutex.
+//
+   if (!failed.empty())
+      {Ring.sqMutex.UnLock();
+       for (auto it = failed.rbegin(); it != failed.rend(); ++it)
+           {AtomicDec(Ring.inFlight);
+            if (doSync)
+               {Stat.synCnt++;
+                Done(it->user_data, SyncIO(*it));
+               } else {
+                Stat.errCnt++;
+                Done(it->user_data, -ecode);
+               }
+           }
+       Ring.sqMutex.Lock();
+      }
+#endif
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+bool XrdOssUring::Init(XrdSysError &Eroute)
+{
+#if defined(__linux__) && defined(HAVE_IO_URING)
+   EPNAME("UringInit");
+   struct io_uring_params parms;
+   size_t sqSize, cqSize;
+   char *sqPtr, *cqPtr;
+   pthread_t tid;
+   int retc;
+
+// Create the ring
+//
+   memset(&parms, 0, sizeof(parms));
+   if (SQPoll) {parms.flags |= IORING_SETUP_SQPOLL; parms.sq_thread_idle = 1000;}
+   Ring.ringFD = static_cast<int>(syscall(__NR_io_uring_setup, Depth, &parms));
+   if (Ring.ringFD < 0)
+      {Eroute.Emsg("AioInit", errno, "create io_uring");
+       return false;
+      }
+
+// We need IORING_OP_READ and IORING_OP_WRITE which came with the feature below
+//
+   if (!(parms.features & IORING_FEAT_RW_CUR_POS))
+      {Eroute.Emsg("AioInit", "io_uring is not fully supported by this kernel");
+       close(Ring.ringFD); Ring.ringFD = -1;
+       return false;
+      }
+
+// Map the submission and completion rings (they may be in a single map)
+//
+   sqSize = parms.sq_off.array + parms.sq_entries * sizeof(unsigned int);
+   cqSize = parms.cq_off.cqes  + parms.cq_entries * sizeof(struct io_uring_cqe);
+   if (parms.features & IORING_FEAT_SINGLE_MMAP)
+      {if (cqSize > sqSize) sqSize = cqSize;
+       cqSize = sqSize;
+      }
+
+   sqPtr = (char *)mmap(0, sqSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                        Ring.ringFD, IORING_OFF_SQ_RING);
+   if (sqPtr == MAP_FAILED)
+      {Eroute.Emsg("AioInit", errno, "map io_uring submission ring");
+       close(Ring.ringFD); Ring.ringFD = -1;
+       return false;
+      }
+
+   if (parms.features & IORING_FEAT_SINGLE_MMAP) cqPtr = sqPtr;
+      else {cqPtr = (char *)mmap(0, cqSize, PROT_READ|PROT_WRITE,
+                                 MAP_SHARED|MAP_POPULATE, Ring.ringFD,
+                                 IORING_OFF_CQ_RING);
+            if (cqPtr == MAP_FAILED)
+               {Eroute.Emsg("AioInit", errno, "map io_uring completion ring");
+                close(Ring.ringFD); Ring.ringFD = -1;
+                return false;
+               }
+           }
+
+   Ring.sqes = (struct io_uring_sqe *)mmap(0, parms.sq_entries
+                                     * sizeof(struct io_uring_sqe),
+                                     PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                                     Ring.ringFD, IORING_OFF_SQES);
+   if (Ring.sqes == MAP_FAILED)
+      {Eroute.Emsg("AioInit", errno, "map io_uring submission entries");
+       close(Ring.ringFD); Ring.ringFD = -1;
+       return false;
+      }
+
+// Record the addresses of the ring fields we need
+//
+   Ring.sqHead    = (unsigned int *)(sqPtr + parms.sq_off.head);
+   Ring.sqKTail   = (unsigned int *)(sqPtr + parms.sq_off.tail);
+   Ring.sqFlags   = (unsigned int *)(sqPtr + parms.sq_off.flags);
+   Ring.sqArray   = (unsigned int *)(sqPtr + parms.sq_off.array);
+   Ring.sqMask    = *(unsigned int *)(sqPtr + parms.sq_off.ring_mask);
+   Ring.sqEntries = parms.sq_entries;
+   Ring.sqTail    = *Ring.sqKTail;
+   Ring.cqHead    = (unsigned int *)(cqPtr + parms.cq_off.head);
+   Ring.cqTail    = (unsigned int *)(cqPtr + parms.cq_off.tail);
+   Ring.cqMask    = *(unsigned int *)(cqPtr + parms.cq_off.ring_mask);
+   Ring.cqEntries = parms.cq_entries;
+   Ring.cqes      = (struct io_uring_cqe *)(cqPtr + parms.cq_off.cqes);
+
+// Start the thread that reaps completions
+//
+   if ((retc = XrdSysThread::Run(&tid, XrdOssUring::Reaper, 0, 0, "aio reaper")))
+      {Eroute.Emsg("AioInit", retc, "create io_uring reaper thread");
+       return false;
+      }
+   DEBUG("io_uring started; sq=" <<parms.sq_entries <<" cq=" <<parms.cq_entries);
+
+// All done
+//
+   ringOK = true;
+   return true;
+#else
+   Eroute.Say("Config warning: io_uring is not supported on this platform.");
+   return false;
+#endif
+}
+
+/******************************************************************************/
+/*                                R e a p e r                                 */
+/******************************************************************************/
+
+void *XrdOssUring::Reaper(void *carg)
+{
+#if defined(__linux__) && defined(HAVE_IO_URING)
+   struct io_uring_cqe *cqe;
+   unsigned int cqHead, cqTail;
+   uint64_t udata;
+   int rc, result;
+
+// Wait for completions and process every completion that is available. This
+// lets us handle many completions per system call when the load is high.
+//
+   do {rc = Enter(0, 1, IORING_ENTER_GETEVENTS);
+       if (rc < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+          {OssEroute.Emsg("AioReap", errno, "wait for io_uring completion");
+           sleep(1);
+          }
+
+       cqHead = *Ring.cqHead;
+       cqTail = __atomic_load_n(Ring.cqTail, __ATOMIC_ACQUIRE);
+       while(cqHead != cqTail)
+            {cqe    = &Ring.cqes[cqHead & Ring.cqMask];
+             udata  = cqe->user_data;
+             result = cqe->res;
+             cqHead++;
+             __atomic_store_n(Ring.cqHead, cqHead, __ATOMIC_RELEASE);
+             AtomicDec(Ring.inFlight);
+             Stat.endCnt++;
+             Done(udata, result);
+             if (cqHead == cqTail)
+                cqTail = __atomic_load_n(Ring.cqTail, __ATOMIC_ACQUIRE);
+            }
+
+   // Submit anything left behind by a failed submission (e.g. EBUSY)
+   //
+       if (!SQPoll)
+          {Ring.sqMutex.Lock();
+           Flush();
+           Ring.sqMutex.UnLock();
+          }
+      } while(true);
+#endif
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                                 S t a t s                                  */
+/******************************************************************************/
+
+int XrdOssUring::Stats(char *buff, int blen)
+{
+   static const char statfmt[] = "<aio><eng>uring</eng><sub>%lld</sub>"
+          "<done>%lld</done><enter>%lld</enter><sync>%lld</sync>"
+          "<err>%lld</err></aio>";
+
+// If only size wanted, return the maximum size needed
+//
+   if (!ringOK) return 0;
+   if (!buff) return sizeof(statfmt) + (5*16);
+
+// Format the statistics
+//
+   int n = snprintf(buff, blen, statfmt, Stat.subCnt.load(), Stat.endCnt.load(),
+                                         Stat.entCnt.load(), Stat.synCnt.load(),
+                                         Stat.errCnt.load());
+   return (n < blen ? n : 0);
+}
+
+/******************************************************************************/
+/*                                S u b m i t                                 */
+/******************************************************************************/
+
+int XrdOssUring::Submit(XrdSfsAio *aiop, int fd, OpType opType)
+{
+#if defined(__linux__) && defined(HAVE_IO_URING)
+   EPNAME("UringSubmit");
+   const char *tident = aiop->TIdent;
+   struct io_uring_sqe *sqe;
+   unsigned int sqIdx;
+
+// Make sure the ring is usable
+//
+   if (!ringOK) return 1;
+
+// Make sure we have room in both rings. If not, have the caller do this
+// request synchronously.
+//
+   Ring.sqMutex.Lock();
+   if (Ring.sqTail - __atomic_load_n(Ring.sqHead, __ATOMIC_ACQUIRE)
+       >= Ring.sqEntries
+   ||  AtomicGet(Ring.inFlight) >= (int)Ring.cqEntries)
+      {Ring.sqMutex.UnLock();
+       Stat.synCnt++;
+       return 1;
+      }
+
+// Fill out the submission entry
+//
+   sqIdx = Ring.sqTail & Ring.sqMask;
+   sqe   = &Ring.sqes[sqIdx];
+   memset(sqe, 0, sizeof(struct io_uring_sqe));
+   sqe->fd = fd;
+   switch(opType)
+         {case opRead:
+          case opPgRead: sqe->opcode = IORING_OP_READ;
+                         break;
+          case opWrite:  sqe->opcode = IORING_OP_WRITE;
+                         break;
+          case opFsync:  sqe->opcode = IORING_OP_FSYNC;
+                         break;
+          default:       Ring.sqMutex.UnLock();
+                         Stat.errCnt++;
+                         return -EINVAL;
+         }
+   if (opType != opFsync)
+      {sqe->addr = (uint64_t)(uintptr_t)aiop->sfsAio.aio_buf;
+       sqe->len  = (uint32_t)aiop->sfsAio.aio_nbytes;
+       sqe->off  = (uint64_t)aiop->sfsAio.aio_offset;
+      }
+   sqe->user_data = (uint64_t)(uintptr_t)aiop | opType;
+
+   TRACE(Debug, "fd=" <<fd <<" op " <<opType <<' ' <<aiop->sfsAio.aio_nbytes
+                <<'@' <<aiop->sfsAio.aio_offset <<" queued; aiocb="
+                <<Xrd::hex1 <<aiop);
+
+// Publish the entry and submit it (possibly along with others)
+//
+   Ring.sqArray[sqIdx] = sqIdx;
+   Ring.sqTail++;
+   __atomic_store_n(Ring.sqKTail, Ring.sqTail, __ATOMIC_RELEASE);
+   AtomicInc(Ring.inFlight);
+   Stat.subCnt++;
+   Flush();
+   Ring.sqMutex.UnLock();
+   return 0;
+#else
+   return 1;
+#endif
+}
@@ -0,0 +1,76 @@
+#ifndef __XRDOSSURING_H__
+#define __XRDOSSURING_H__
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O s s U r i n g . h h                         */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstdint>
+
+class XrdSfsAio;
+class XrdSysError;
+
+// The XrdOssUring class implements the io_uring asynchronous I/O engine. It
+// is selected via "oss.aio engine uring" and replaces POSIX aio (and its
+// signal based completion) for XrdOssFile async reads, writes, and fsyncs.
+// Requests are placed on a single submission ring and submitted in batches;
+// a reaper thread polls the completion ring and directly invokes the
+// request's doneRead() or doneWrite() method.
+//
+class XrdOssUring
+{
+public:
+
+enum OpType {opRead = 0, opWrite = 1, opFsync = 2, opPgRead = 3};
+
+static void  Display(XrdSysError &Eroute);
+
+static bool  Init(XrdSysError &Eroute);
+
+static bool  isOn() {return ringOK;}
+
+static void *Reaper(void *carg);
+
+static void  Set(int V_depth, bool V_sqpoll) {Depth = V_depth;
+                                              SQPoll = V_sqpoll;
+                                             }
+
+static int   Stats(char *buff, int blen);
+
+// Submit() returns 0 if the request was queued, -errno if it failed, and
+// a positive value if it could not be queued (caller must do it sync).
+//
+static int   Submit(XrdSfsAio *aiop, int fd, OpType opType);
+
+private:
+static void  Done(uint64_t udata, int result);
+static void  Flush();
+
+static int   Depth;
+static bool  SQPoll;
+static bool  ringOK;
+};
+#endif
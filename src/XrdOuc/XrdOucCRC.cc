@@ -45,8 +45,8 @@
       Public Domain
 */
 
+#include "XrdCks/XrdCksKernels.hh"
 #include "XrdOuc/XrdOucCRC.hh"
-#include "XrdOuc/XrdOucCRC32C.hh"
 
 /*****************************************************************/
 /*                                                               */
@@ -192,7 +192,7 @@ uint32_t XrdOucCRC::Calc32C(const void* data, size_t count, uint32_t prevcs)
 
 // Return the checksum
 //
-   return crc32c(prevcs, data, count);
+   return XrdCksKernels::CRC32C(prevcs, data, count);
 }
 
 /******************************************************************************/
@@ -205,14 +205,14 @@ void XrdOucCRC::Calc32C(const void* data, size_t count, uint32_t* csval)
 // Calculate the CRC32C for each page
 //
    for (i = 0; i < numpages; i++)
-       {csval[i] = crc32c(0, dataP, XrdSys::PageSize);
+       {csval[i] = XrdCksKernels::CRC32C(0, dataP, XrdSys::PageSize);
         count -= XrdSys::PageSize;
         dataP += XrdSys::PageSize;
        }
 
 // if there is anything left, calculate that as well
 //
-   if (count > 0) csval[i] = crc32c(0, dataP, count);
+   if (count > 0) csval[i] = XrdCksKernels::CRC32C(0, dataP, count);
 }
 
 /******************************************************************************/
@@ -226,7 +226,7 @@ bool XrdOucCRC::Ver32C(const void*    data,  size_t    count,
 
 // Verify the checksum
 //
-   actualCS = crc32c(0, data, count);
+   actualCS = XrdCksKernels::CRC32C(0, data, count);
    if (valcs) *valcs = actualCS;
    return csval == actualCS;
 }
@@ -244,7 +244,7 @@ int  XrdOucCRC::Ver32C(const void*     data,  size_t    count,
 //
    for (i = 0; i < numpages; i++)
        {
-        actualCS = crc32c(0, dataP, XrdSys::PageSize);
+        actualCS = XrdCksKernels::CRC32C(0, dataP, XrdSys::PageSize);
         if (csval[i] != actualCS)
            {valcs = actualCS;
             return i;
@@ -257,7 +257,7 @@ int  XrdOucCRC::Ver32C(const void*     data,  size_t    count,
 //
    if (count > 0)
       {
-       actualCS = crc32c(0, dataP, count);
+       actualCS = XrdCksKernels::CRC32C(0, dataP, count);
        if (csval[i] != actualCS)
           {valcs = actualCS;
            return i;
@@ -283,7 +283,7 @@ bool XrdOucCRC::Ver32C(const void*     data,  size_t count,
 //
    for (i = 0; i < numpages; i++)
        {
-        actualCS = crc32c(0, dataP, XrdSys::PageSize);
+        actualCS = XrdCksKernels::CRC32C(0, dataP, XrdSys::PageSize);
         if (csval[i] == actualCS) valok[i] = true;
            else valok[i] = retval = false;
         count -= XrdSys::PageSize;
@@ -294,7 +294,7 @@ bool XrdOucCRC::Ver32C(const void*     data,  size_t count,
 //
    if (count > 0)
       {
-       actualCS = crc32c(0, dataP, count);
+       actualCS = XrdCksKernels::CRC32C(0, dataP, count);
        if (csval[i] == actualCS) valok[i] = true;
            else valok[i] = retval = false;
       }
@@ -317,7 +317,7 @@ bool XrdOucCRC::Ver32C(const void*     data,  size_t    count,
 //
    for (i = 0; i < numpages; i++)
        {
-        valcs[i] = crc32c(0, dataP, XrdSys::PageSize);
+        valcs[i] = XrdCksKernels::CRC32C(0, dataP, XrdSys::PageSize);
         if (csval[i] != valcs[i]) retval = false;
         count -= XrdSys::PageSize;
         dataP += XrdSys::PageSize;
@@ -327,7 +327,7 @@ bool XrdOucCRC::Ver32C(const void*     data,  size_t    count,
 //
    if (count > 0)
       {
-       valcs[i] = crc32c(0, dataP, count);
+       valcs[i] = XrdCksKernels::CRC32C(0, dataP, count);
        if (csval[i] != valcs[i]) retval = false;
       }
 
@@ -0,0 +1,167 @@
+#ifndef __OOUC_HASHMT__
+#define __OOUC_HASHMT__
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d O u c H a s h M T . h h                        */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <atomic>
+#include <cstdlib>
+#include <sys/types.h>
+#include <cstring>
+#include <ctime>
+
+#include "XrdOuc/XrdOucHash.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                          X r d O u c H a s h M T                           */
+/******************************************************************************/
+
+// XrdOucHashMT is a thread-safe counterpart of XrdOucHash with the same
+// Add/Rep/Del/Find/Apply/Purge/Num surface and the same XrdOucHash_Options.
+// It is meant for tables that are otherwise wrapped in a single mutex.
+//
+// The table is split into a power of two number of stripes, each protected
+// by its own mutex, so threads looking up different keys rarely contend.
+// Each stripe is an open addressed (linear probing) table whose slots hold
+// the key, data, and lifetime inline, so a lookup touches contiguous memory
+// instead of walking a chain of separately allocated items. Deletion shifts
+// entries back so that no tombstones are needed.
+//
+// A stripe that passes its load limit doubles in size incrementally: a new
+// table is allocated and every later Add() or Del() of the stripe moves a few
+// entries over, lookups consult both tables until the old one is empty. No
+// single operation ever rehashes more than a handful of entries.
+//
+// Note that Find() returns the data pointer after the stripe is unlocked. As
+// with XrdOucHash, the caller must make sure the data is not deleted by some
+// other thread while being used (e.g. by using Hash_keepdata and managing
+// the data's lifetime separately).
+//
+template<class T>
+class XrdOucHashMT
+{
+public:
+
+// Add() adds a new item to the hash. If it exists and Hash_replace is not
+//       specified then the old data is returned and the new data is not added.
+//       Otherwise, the entry is replaced and 0 is returned. See XrdOucHash for
+//       a description of LifeTime and the options.
+//
+T           *Add(const char *KeyVal, T *KeyData, const int LifeTime=0,
+                 XrdOucHash_Options opt=Hash_default);
+
+// Apply() applies the specified function to every item in the hash, a stripe
+//         at a time, with the stripe locked. The function must not call back
+//         into the same table. Return values are as for XrdOucHash::Apply().
+//
+T           *Apply(int (*func)(const char *, T *, void *), void *Arg);
+
+// Del() deletes the item from the hash. If it doesn't exist, it returns
+//       -ENOENT. Otherwise 0 is returned. An item added with Hash_count is
+//       only deleted when its count drops below zero.
+//
+int          Del(const char *KeyVal, XrdOucHash_Options opt = Hash_default);
+
+// Find() looks up an entry, optionally returning its expiration time. Expired
+//        entries are deleted and not returned.
+//
+T           *Find(const char *KeyVal, time_t *KeyTime=0);
+
+// Num() returns the number of items in the hash table
+//
+int          Num() {return hashnum.load(std::memory_order_relaxed);}
+
+// Purge() deletes all of the items in the table.
+//
+void         Purge();
+
+// Rep() is simply Add() that allows replacement.
+//
+T           *Rep(const char *KeyVal, T *KeyData, const int LifeTime=0,
+                 XrdOucHash_Options opt=Hash_default)
+                {return Add(KeyVal, KeyData, LifeTime,
+                            (XrdOucHash_Options)(opt | Hash_replace));}
+
+// The number of stripes is rounded up to a power of two and size is the
+// initial number of slots per stripe (also rounded up to a power of two).
+// The load is the percentage of slots that may be used before growing.
+//
+    XrdOucHashMT(int stripes=16, int size=64, int load=75);
+   ~XrdOucHashMT();
+
+private:
+
+struct Slot
+      {unsigned long      hash;
+       const char        *key;     // Nil if the slot is empty
+       T                 *data;
+       time_t             time;
+       int                count;
+       XrdOucHash_Options opts;
+      };
+
+struct Table
+      {Slot          *slot;
+       unsigned long  mask;
+       int            num;
+      };
+
+struct alignas(64) Stripe
+      {XrdSysMutex    mtx;
+       Table          cur;
+       Table          old;        // Being drained if old.slot is not nil
+       unsigned long  drain;      // Next old slot to move
+      };
+
+static const int drainStep = 4;   // Entries moved per Add/Del while growing
+
+void          Drain(Stripe &sp, int n);
+void          Erase(Table &tab, unsigned long ent);
+long          Locate(Table &tab, unsigned long khash, const char *kval);
+void          Place(Table &tab, const Slot &item);
+void          Release(Slot &item);
+void          Grow(Stripe &sp);
+unsigned long Home(const Table &tab, unsigned long khash)
+                  {return (khash >> stripeBits) & tab.mask;}
+unsigned long HashVal(const char *KeyVal);
+Stripe       &StripeOf(unsigned long khash)
+                      {return stripe[khash & stripeMask];}
+
+Stripe             *stripe;
+unsigned long       stripeMask;
+int                 stripeBits;
+int                 numStripes;
+int                 hashload;
+std::atomic<int>    hashnum;
+};
+
+/******************************************************************************/
+/*                 A c t u a l   I m p l e m e n t a t i o n                  */
+/******************************************************************************/
+
+#include "XrdOuc/XrdOucHashMT.icc"
+#endif
@@ -272,35 +272,73 @@ void Cache::RemoveWriteQEntriesFor(File *file)
 
 void Cache::ProcessWriteTasks()
 {
-   std::vector<Block*> blks_to_write(m_configuration.m_wqueue_blocks);
+   // Each batch holds blocks of a single file so that adjacent blocks can be
+   // coalesced into one write and the cinfo updated once per batch. A writer
+   // claims the file of its batch until the batch is written and the other
+   // writers skip blocks of claimed files. Each file is thus written by one
+   // thread at a time and a slow file system only holds up one writer per
+   // file written to it.
+
+   const int max_blocks = m_configuration.m_wqueue_blocks;
+   const int max_scan   = 4 * max_blocks;
+
+   std::vector<Block*> blks_to_write;
+   blks_to_write.reserve(max_blocks);
+   File *file     = 0;
+   int   n_writes = 0;
+
+   auto unclaimed = [&](const Block *b) { return m_writeQ.claimed.count(b->m_file) == 0; };
 
    while (true)
    {
       m_writeQ.condVar.Lock();
-      while (m_writeQ.size == 0)
+      m_writeQ.n_writes += n_writes;
+      if (file)
+      {
+         m_writeQ.claimed.erase(file);
+         if (m_writeQ.size) m_writeQ.condVar.Signal();
+      }
+
+      std::list<Block*>::iterator i;
+      while ((i = std::find_if(m_writeQ.queue.begin(), m_writeQ.queue.end(), unclaimed)) == m_writeQ.queue.end())
       {
          m_writeQ.condVar.Wait();
       }
 
-      // MT -- optimize to pop several blocks if they are available (or swap the list).
-      // This makes sense especially for smallish block sizes.
+      ++m_writeQ.depth_hist[WriteQ::hist_bin(m_writeQ.size)];
+
+      file = (*i)->m_file;
+      m_writeQ.claimed.insert(file);
 
-      int       n_pushed = std::min(m_writeQ.size, m_configuration.m_wqueue_blocks);
       long long sum_size = 0;
+      int       n_pushed = 0;
+      int       n_scan   = 0;
 
-      for (int bi = 0; bi < n_pushed; ++bi)
+      blks_to_write.clear();
+
+      while (i != m_writeQ.queue.end() && n_pushed < max_blocks && n_scan < max_scan)
       {
-         Block* block = m_writeQ.queue.front();
-         m_writeQ.queue.pop_front();
+         ++n_scan;
+         if ((*i)->m_file != file)
+         {
+            ++i;
+            continue;
+         }
+         Block* block = *i;
+         i = m_writeQ.queue.erase(i);
          m_writeQ.writes_between_purges += block->get_size();
          sum_size += block->get_size();
 
-         blks_to_write[bi] = block;
+         blks_to_write.push_back(block);
+         ++n_pushed;
 
          TRACE(Dump, "ProcessWriteTasks for block " <<  (void*)(block) << " path " << block->m_file->lPath());
       }
       m_writeQ.size -= n_pushed;
 
+      ++m_writeQ.batch_hist[WriteQ::hist_bin(n_pushed)];
+      ++m_writeQ.n_batches;
+
       m_writeQ.condVar.UnLock();
 
       {
@@ -308,12 +346,10 @@ void Cache::ProcessWriteTasks()
          m_RAM_write_queue -= sum_size;
       }
 
-      for (int bi = 0; bi < n_pushed; ++bi)
-      {
-         Block* block = blks_to_write[bi];
+      std::sort(blks_to_write.begin(), blks_to_write.end(),
+                [](const Block *a, const Block *b) { return a->m_offset < b->m_offset; });
 
-         block->m_file->WriteBlockToDisk(block);
-      }
+      n_writes = file->WriteBlocksToDisk(blks_to_write);
    }
 }
 
@@ -326,6 +362,58 @@ long long Cache::WritesSinceLastCall()
    return ret;
 }
 
+void Cache::ReportWriteQStats()
+{
+   long long depth_hist[WriteQ::s_n_hist_bins];
+   long long batch_hist[WriteQ::s_n_hist_bins];
+   long long n_batches, n_writes;
+   int       size;
+   {
+      XrdSysCondVarHelper lock(&m_writeQ.condVar);
+      std::copy(m_writeQ.depth_hist, m_writeQ.depth_hist + WriteQ::s_n_hist_bins, depth_hist);
+      std::copy(m_writeQ.batch_hist, m_writeQ.batch_hist + WriteQ::s_n_hist_bins, batch_hist);
+      std::fill(m_writeQ.depth_hist, m_writeQ.depth_hist + WriteQ::s_n_hist_bins, 0);
+      std::fill(m_writeQ.batch_hist, m_writeQ.batch_hist + WriteQ::s_n_hist_bins, 0);
+      n_batches = m_writeQ.n_batches;
+      n_writes  = m_writeQ.n_writes;
+      size      = m_writeQ.size;
+      m_writeQ.n_batches = m_writeQ.n_writes = 0;
+   }
+
+   TRACE(Debug, "ReportWriteQStats queue_size=" << size << ", n_batches=" << n_batches << ", n_writes=" << n_writes);
+
+   if ( ! m_gstream) return;
+
+   char buf[1024];
+   int  len = snprintf(buf, sizeof(buf), "{\"event\":\"write_queue\","
+                       "\"size\":%d,\"n_batches\":%lld,\"n_writes\":%lld,",
+                       size, n_batches, n_writes);
+
+   // Histograms use log2 bins, bin i counts values in [2^i, 2^(i+1)).
+   const char       *hname[2] = { "depth_hist", "batch_hist" };
+   const long long  *hist[2]  = { depth_hist, batch_hist };
+   for (int h = 0; h < 2 && len < (int) sizeof(buf); ++h)
+   {
+      len += snprintf(buf + len, sizeof(buf) - len, "%s\"%s\":[", h ? "," : "", hname[h]);
+      for (int b = 0; b < WriteQ::s_n_hist_bins && len < (int) sizeof(buf); ++b)
+      {
+         len += snprintf(buf + len, sizeof(buf) - len, "%s%lld", b ? "," : "", hist[h][b]);
+      }
+      if (len < (int) sizeof(buf)) len += snprintf(buf + len, sizeof(buf) - len, "]");
+   }
+   if (len < (int) sizeof(buf)) len += snprintf(buf + len, sizeof(buf) - len, "}");
+
+   bool suc = false;
+   if (len < (int) sizeof(buf))
+   {
+      suc = m_gstream->Insert(buf, len + 1);
+   }
+   if ( ! suc)
+   {
+      TRACE(Error, "Failed g-stream insertion of write_queue record, len=" << len);
+   }
+}
+
 //==============================================================================
 
 char* Cache::RequestRAM(long long size)
@@ -650,13 +738,13 @@ void Cache::dec_ref_cnt(File* f, bool high_debug)
                               "\"lfn\":\"%s\",\"size\":%lld,\"blk_size\":%d,\"n_blks\":%d,\"n_blks_done\":%d,"
                               "\"access_cnt\":%lu,\"attach_t\":%lld,\"detach_t\":%lld,\"remotes\":%s,"
                               "\"b_hit\":%lld,\"b_miss\":%lld,\"b_bypass\":%lld,"
-                              "\"b_todisk\":%lld,\"b_prefetch\":%lld,\"n_cks_errs\":%d}",
+                              "\"b_todisk\":%lld,\"b_prefetch\":%lld,\"b_prefetch_useful\":%lld,\"n_cks_errs\":%d}",
                               f->GetLocalPath().c_str(), f->GetFileSize(), f->GetBlockSize(),
                               f->GetNBlocks(), f->GetNDownloadedBlocks(),
                               (unsigned long) f->GetAccessCnt(), (long long) as->AttachTime, (long long) as->DetachTime,
                               f->GetRemoteLocations().c_str(),
                               as->BytesHit, as->BytesMissed, as->BytesBypassed,
-                              st.m_BytesWritten, f->GetPrefetchedBytes(), st.m_NCksumErrors
+                              st.m_BytesWritten, f->GetPrefetchedBytes(), f->GetPrefetchUsefulBytes(), st.m_NCksumErrors
          );
          bool suc = false;
          if (len < 4096)
@@ -737,11 +825,25 @@ File* Cache::GetNextFileToPrefetch()
       m_prefetch_condVar.Wait();
    }
 
-   //  std::sort(m_prefetchList.begin(), m_prefetchList.end(), myobject);
+   // Weighted lottery over the prefetch priorities, so files whose
+   // prefetched blocks get read are served more often.
+   float sum = 0;
+   for (File *pf : m_prefetchList)
+   {
+      sum += pf->GetPrefetchPriority();
+   }
 
-   size_t l = m_prefetchList.size();
-   int idx = rand() % l;
-   File* f = m_prefetchList[idx];
+   float  pick = sum * (rand() / (RAND_MAX + 1.0f));
+   File  *f    = m_prefetchList.back();
+   for (File *pf : m_prefetchList)
+   {
+      pick -= pf->GetPrefetchPriority();
+      if (pick < 0)
+      {
+         f = pf;
+         break;
+      }
+   }
 
    m_prefetch_condVar.UnLock();
    return f;
@@ -83,6 +83,8 @@ struct Configuration
 
    bool m_hdfsmode;                     //!< flag for enabling block-level operation
    bool m_allow_xrdpfc_command;         //!< flag for enabling access to /xrdpfc-command/ functionality.
+   bool m_nsIndex;                      //!< flag for maintaining a persistent index of cached files;
+                                        //!< costs ~100 bytes of RAM per file plus its LFN, see XrdPfcNsIndex.hh
 
    std::string m_username;              //!< username passed to oss plugin
    std::string m_data_space;            //!< oss space for data files
@@ -255,6 +257,12 @@ public:
 
    long long WritesSinceLastCall();
 
+   //---------------------------------------------------------------------
+   //! Report write-queue depth and batch size histograms accumulated
+   //! since the last call to the g-stream, if configured, and reset them.
+   //---------------------------------------------------------------------
+   void ReportWriteQStats();
+
    char* RequestRAM(long long size);
    void  ReleaseRAM(char* buf, long long size);
 
@@ -333,12 +341,29 @@ private:
 
    struct WriteQ
    {
-      WriteQ() : condVar(0), writes_between_purges(0), size(0) {}
+      static const int s_n_hist_bins = 12; //!< log2 bins: 1, 2-3, 4-7, ..., >= 2048
+
+      WriteQ() : condVar(0), writes_between_purges(0), size(0),
+                 depth_hist(), batch_hist(), n_batches(0), n_writes(0) {}
 
       XrdSysCondVar     condVar;      //!< write list condVar
       std::list<Block*> queue;        //!< container
+      std::set<File*>   claimed;      //!< files a writer thread is currently writing to
       long long         writes_between_purges; //!< upper bound on amount of bytes written between two purge passes
       int               size;         //!< current size of write queue
+
+      // Statistics since the last ReportWriteQStats(), protected by condVar.
+      long long         depth_hist[s_n_hist_bins]; //!< queue depth seen by writer threads when taking a batch
+      long long         batch_hist[s_n_hist_bins]; //!< number of blocks in a batch
+      long long         n_batches;    //!< number of batches taken
+      long long         n_writes;     //!< number of write calls issued for those batches
+
+      static int hist_bin(int n)
+      {
+         int b = 0;
+         while (n > 1 && b < s_n_hist_bins - 1) { n >>= 1; ++b; }
+         return b;
+      }
    };
 
    WriteQ m_writeQ;
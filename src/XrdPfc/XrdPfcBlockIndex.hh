@@ -0,0 +1,148 @@
+#ifndef __XRDPFC_BLOCKINDEX_HH__
+#define __XRDPFC_BLOCKINDEX_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace XrdPfc
+{
+
+//----------------------------------------------------------------------------
+//! Flat, open-addressed index of in-flight blocks keyed by block number.
+//!
+//! Replaces a std::map<int, T*>: the set of in-flight blocks per file is
+//! small (bounded by prefetch max blocks plus outstanding client requests)
+//! and is looked up once per requested block on every Read / ReadV, so a
+//! linear-probing table with contiguous slots avoids the pointer chasing and
+//! per-node allocation of a red-black tree. Deletion uses backward shifting,
+//! so there are no tombstones and probe sequences stay short.
+//!
+//! Not thread-safe, callers serialize access (File::m_state_cond).
+//----------------------------------------------------------------------------
+
+template<typename T>
+class BlockIndex
+{
+public:
+   BlockIndex() : m_slots(s_min_cap), m_mask(s_min_cap - 1), m_size(0) {}
+
+   //! Returns the block registered under idx or nullptr.
+   T* find(int idx) const
+   {
+      for (size_t i = slot(idx); ; i = (i + 1) & m_mask)
+      {
+         const Slot &s = m_slots[i];
+         if (s.m_block == nullptr) return nullptr;
+         if (s.m_idx   == idx)     return s.m_block;
+      }
+   }
+
+   //! Registers (or replaces) block b under idx; b must not be nullptr.
+   void insert(int idx, T *b)
+   {
+      if ((m_size + 1) * 2 > m_slots.size()) rehash(m_slots.size() * 2);
+
+      for (size_t i = slot(idx); ; i = (i + 1) & m_mask)
+      {
+         Slot &s = m_slots[i];
+         if (s.m_block == nullptr) { s.m_idx = idx; s.m_block = b; ++m_size; return; }
+         if (s.m_idx   == idx)     { s.m_block = b; return; }
+      }
+   }
+
+   //! Removes idx from the index, returns the number of erased entries (0 or 1).
+   size_t erase(int idx)
+   {
+      size_t i = slot(idx);
+      for ( ; ; i = (i + 1) & m_mask)
+      {
+         if (m_slots[i].m_block == nullptr) return 0;
+         if (m_slots[i].m_idx   == idx)     break;
+      }
+
+      // Backward-shift the following entries of the cluster into the hole.
+      size_t hole = i;
+      for (size_t j = (i + 1) & m_mask; m_slots[j].m_block != nullptr; j = (j + 1) & m_mask)
+      {
+         size_t home = slot(m_slots[j].m_idx);
+         // Move j into hole unless its home lies cyclically in (hole, j].
+         if (((j - home) & m_mask) >= ((j - hole) & m_mask))
+         {
+            m_slots[hole] = m_slots[j];
+            hole = j;
+         }
+      }
+      m_slots[hole] = Slot();
+      --m_size;
+
+      if (m_slots.size() > s_min_cap && m_size * 8 < m_slots.size()) rehash(m_slots.size() / 2);
+      return 1;
+   }
+
+   //! Calls f(idx, block) for every registered block, in unspecified order.
+   template<typename F>
+   void for_each(F f) const
+   {
+      for (const Slot &s : m_slots)
+         if (s.m_block) f(s.m_idx, s.m_block);
+   }
+
+   size_t size()  const { return m_size; }
+   bool   empty() const { return m_size == 0; }
+
+private:
+   struct Slot
+   {
+      int  m_idx   = 0;
+      T   *m_block = nullptr;
+   };
+
+   static constexpr size_t s_min_cap = 64;
+
+   // Fibonacci hashing spreads the consecutive block numbers of a sequential
+   // or strided access pattern without clustering.
+   size_t slot(int idx) const
+   {
+      return (size_t) (((uint64_t) (uint32_t) idx * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
+   }
+
+   void rehash(size_t cap)
+   {
+      std::vector<Slot> old;
+      old.swap(m_slots);
+      m_slots.resize(cap);
+      m_mask = cap - 1;
+      for (const Slot &s : old)
+      {
+         if (s.m_block == nullptr) continue;
+         size_t i = slot(s.m_idx);
+         while (m_slots[i].m_block) i = (i + 1) & m_mask;
+         m_slots[i] = s;
+      }
+   }
+
+   std::vector<Slot> m_slots;
+   size_t            m_mask;
+   size_t            m_size;
+};
+
+}
+
+#endif
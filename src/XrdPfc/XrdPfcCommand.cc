@@ -186,6 +186,8 @@ void Cache::ExecuteCommandUrl(const std::string& command_url)
 
          // Create the data file.
 
+         m_res_mon->index_touch(file_path);
+
          char size_str[32]; sprintf(size_str, "%lld", file_size);
          myEnv.Put("oss.asize",  size_str);
          myEnv.Put("oss.cgroup", conf.m_data_space.c_str());
@@ -269,7 +271,7 @@ void Cache::ExecuteCommandUrl(const std::string& command_url)
             m_writeQ.writes_between_purges += file_size;
          }
          {
-            int token = m_res_mon->register_file_open(file_path, time_now, false);
+            int token = m_res_mon->register_file_open(file_path, time_now, 0, false);
             XrdPfc::Stats stats;
             stats.m_BytesWritten  = file_size;
             stats.m_StBlocksAdded = dstat.st_blocks;
@@ -33,6 +33,7 @@ XrdVERSIONINFO(XrdOucGetCache, XrdPfc);
 Configuration::Configuration() :
    m_hdfsmode(false),
    m_allow_xrdpfc_command(false),
+   m_nsIndex(false),
    m_data_space("public"),
    m_meta_space("public"),
    m_diskTotalSpace(-1),
@@ -691,6 +692,11 @@ bool Cache::Config(const char *config_filename, const char *parameters)
          loff += snprintf(buff + loff, sizeof(buff) - loff, "       pfc.hdfsmode hdfsbsize %lld\n", m_configuration.m_hdfsbsize);
       }
 
+      if (m_configuration.m_nsIndex)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "       pfc.nsindex on\n");
+      }
+
       if (m_configuration.m_username.empty())
       {
          char unameBuff[256];
@@ -989,6 +995,23 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
          return false;
       }
    }
+   else if ( part == "nsindex" )
+   {
+      const char *p = cwg.GetWord();
+      if (cwg.HasLast() && strcmp(p, "on") == 0)
+      {
+         m_configuration.m_nsIndex = true;
+      }
+      else if (cwg.HasLast() && strcmp(p, "off") == 0)
+      {
+         m_configuration.m_nsIndex = false;
+      }
+      else
+      {
+         m_log.Emsg("Config", "Error: pfc.nsindex requires a parameter, on or off.");
+         return false;
+      }
+   }
    else if ( part == "hdfsmode" )
    {
       m_log.Emsg("Config", "pfc.hdfsmode is currently unsupported.");
@@ -2,6 +2,7 @@
 #include "XrdPfcFsTraversal.hh"
 #include "XrdPfcInfo.hh"
 #include "XrdPfc.hh"
+#include "XrdPfcResourceMonitor.hh"
 #include "XrdPfcTrace.hh"
 
 #include "XrdOuc/XrdOucEnv.hh"
@@ -52,7 +53,18 @@ void FPurgeState::MoveListEntriesToMap()
 //----------------------------------------------------------------------------
 void FPurgeState::CheckFile(const FsTraversal &fst, const char *fname, time_t atime, struct stat &fstat)
 {
-   long long nblocks = fstat.st_blocks;
+   CheckFile(fst.m_current_path, fname, atime, fstat.st_blocks);
+}
+
+//----------------------------------------------------------------------------
+//! Store the file in sorted map or in a list.
+//! @param dname directory of the file, with trailing '/'
+//! @param fname name of cache-info file
+//! @param atime time of last access
+//! @param nblocks usage of the data file in 512-byte blocks
+//----------------------------------------------------------------------------
+void FPurgeState::CheckFile(const std::string &dname, const char *fname, time_t atime, long long nblocks)
+{
    // TRACE(Dump, trc_pfx << "FPurgeState::CheckFile checking " << fname << " accessTime  " << atime);
 
    m_nStBlocksTotal += nblocks;
@@ -65,12 +77,12 @@ void FPurgeState::CheckFile(const FsTraversal &fst, const char *fname, time_t at
 
    if (m_tMinTimeStamp > 0 && atime < m_tMinTimeStamp)
    {
-      m_flist.push_back(PurgeCandidate(fst.m_current_path, fname, nblocks, 0));
+      m_flist.push_back(PurgeCandidate(dname, fname, nblocks, 0));
       m_nStBlocksAccum += nblocks;
    }
    else if (m_nStBlocksAccum < m_nStBlocksReq || (!m_fmap.empty() && atime < m_fmap.rbegin()->first))
    {
-      m_fmap.insert(std::make_pair(atime, PurgeCandidate(fst.m_current_path, fname, nblocks, atime)));
+      m_fmap.insert(std::make_pair(atime, PurgeCandidate(dname, fname, nblocks, atime)));
       m_nStBlocksAccum += nblocks;
 
       // remove newest files from map if necessary
@@ -137,6 +149,22 @@ bool FPurgeState::TraverseNamespace(const char *root_path)
    return success_p;
 }
 
+//----------------------------------------------------------------------------
+//! Collect purge candidates from the namespace index instead of traversing
+//! the directory tree.
+//! @return false if the index is not in use
+//----------------------------------------------------------------------------
+bool FPurgeState::TraverseIndex(const char *root_path)
+{
+   return Cache::ResMon().index_traverse(root_path,
+      [&](const std::string &lfn, const NsIndex::Entry &e)
+      {
+         size_t      dlen   = lfn.rfind('/') + 1;
+         std::string i_name = lfn.substr(dlen) + Info::s_infoExtension;
+         CheckFile(lfn.substr(0, dlen), i_name.c_str(), e.m_AccessTime, e.m_StBlocks);
+      });
+}
+
 /*
 void FPurgeState::UnlinkInfoAndData(const char *fname, long long nblocks, XrdOssDF *iOssDF)
 {
@@ -66,10 +66,12 @@ public:
 
    void MoveListEntriesToMap();
 
+   void CheckFile(const std::string &dname, const char *fname, time_t atime, long long nblocks);
    void CheckFile(const FsTraversal &fst, const char *fname, time_t atime, struct stat &fstat);
 
    void ProcessDirAndRecurse(FsTraversal &fst);
    bool TraverseNamespace(const char *root_path);
+   bool TraverseIndex(const char *root_path);
 };
 
 } // namespace XrdPfc
@@ -29,7 +29,10 @@
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
 
+#include <algorithm>
+#include <climits>
 #include <cstdio>
+#include <cstdlib>
 #include <sstream>
 #include <fcntl.h>
 #include <cassert>
@@ -42,6 +45,10 @@ namespace
 
 const int BLOCK_WRITE_MAX_ATTEMPTS = 4;
 
+// Number of consecutive requests that must follow an access pattern
+// before prefetching follows it.
+const int PREFETCH_PATTERN_MATCHES = 2;
+
 Cache* cache() { return &Cache::GetInstance(); }
 
 }
@@ -70,9 +77,8 @@ File::File(const std::string& path, long long iOffset, long long iFileSize) :
    m_resmon_token(-1),
    m_prefetch_state(kOff),
    m_prefetch_bytes(0),
-   m_prefetch_read_cnt(0),
-   m_prefetch_hit_cnt(0),
-   m_prefetch_score(0)
+   m_prefetch_useful_bytes(0),
+   m_prefetch_cursor(0)
 {}
 
 File::~File()
@@ -130,7 +136,9 @@ void File::Close()
       Cache::ResMon().register_file_close(m_resmon_token, time(0), m_stats);
    }
 
-   TRACEF(Debug, "Close() finished, prefetch score = " <<  m_prefetch_score);
+   TRACEF(Debug, "Close() finished, prefetch score = " <<  m_prefetch_score.Score() <<
+                 ", prefetch bytes useful = " << m_prefetch_useful_bytes <<
+                 ", wasted = " << m_prefetch_bytes - m_prefetch_useful_bytes);
 }
 
 //------------------------------------------------------------------------------
@@ -401,6 +409,7 @@ void File::RemoveIO(IO *io)
 
       m_delta_stats.IoDetach(now - io->m_attach_time);
       m_io_set.erase(mi);
+      m_io_access.erase(io);
       --m_ios_in_detach;
 
       if (m_io_set.empty() && m_prefetch_state != kStopped && m_prefetch_state != kComplete)
@@ -432,6 +441,9 @@ bool File::Open()
    // This function will wait internally if needed until it is safe to proceed.
    Cache::ResMon().CrossCheckIfScanIsInProgress(m_filename, m_state_cond);
 
+   // Let the namespace index know the directory is about to change.
+   Cache::ResMon().index_touch(m_filename);
+
    const Configuration &conf = Cache::GetInstance().RefConfiguration();
 
    XrdOss     &myOss  = * Cache::GetInstance().GetOss();
@@ -549,7 +561,7 @@ bool File::Open()
    m_data_file->Fstat(&data_stat);
    m_st_blocks = data_stat.st_blocks;
 
-   m_resmon_token = Cache::ResMon().register_file_open(m_filename, time(0), data_existed);
+   m_resmon_token = Cache::ResMon().register_file_open(m_filename, time(0), m_st_blocks, data_existed);
    constexpr long long MB = 1024 * 1024;
    m_resmon_report_threshold = std::min(std::max(10 * MB, m_file_size / 20), 500 * MB);
    // m_resmon_report_threshold_scaler; // something like 10% of original threshold, to adjust
@@ -648,7 +660,13 @@ Block* File::PrepareBlockRequest(int i, IO *io, void *req_id, bool prefetch)
 
       if (b)
       {
-         m_block_map[i] = b;
+         m_block_map.insert(i, b);
+
+         if (prefetch)
+         {
+            if (m_prefetch_use.empty()) m_prefetch_use.resize(m_num_blocks, 0);
+            m_prefetch_use[offsetIdx(i)] = 1;
+         }
 
          // Actual Read request is issued in ProcessBlockRequests().
 
@@ -771,6 +789,11 @@ int File::Read(IO *io, char* iUserBuff, long long iUserOff, int iUserSize, ReadR
          XrdSysCondVarHelper _lck(m_state_cond);
          m_delta_stats.AddBytesHit(ret);
          check_delta_stats();
+         if ( ! m_prefetch_use.empty())
+         {
+            for (int i = iUserOff / m_block_size; i <= (iUserOff + ret - 1) / m_block_size; ++i)
+               note_prefetch_use(offsetIdx(i));
+         }
       }
       return ret;
    }
@@ -837,6 +860,8 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
    int                      iovec_disk_total = 0;
    int                      iovec_direct_total = 0;
 
+   int req_first = INT_MAX, req_last = -1;
+
    for (int iov_idx = 0; iov_idx < readVnum; ++iov_idx)
    {
       const XrdOucIOVec &iov = readV[iov_idx];
@@ -847,6 +872,12 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
       const int idx_first = iUserOff / m_block_size;
       const int idx_last  = (iUserOff + iUserSize - 1) / m_block_size;
 
+      if (iUserSize > 0)
+      {
+         req_first = std::min(req_first, idx_first);
+         req_last  = std::max(req_last,  idx_last);
+      }
+
       TRACEF(DumpXL, tpfx << "sid: " << Xrd::hex1 << rh->m_seq_id << " idx_first: " << idx_first << " idx_last: " << idx_last);
 
       enum LastBlock_e { LB_other, LB_disk, LB_direct };
@@ -856,7 +887,7 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
       for (int block_idx = idx_first; block_idx <= idx_last; ++block_idx)
       {
          TRACEF(DumpXL, tpfx << "sid: " << Xrd::hex1 << rh->m_seq_id << " idx: " << block_idx);
-         BlockMap_i bi = m_block_map.find(block_idx);
+         Block *bi = m_block_map.find(block_idx);
 
          // overlap and read
          long long off;     // offset in user buffer
@@ -866,20 +897,23 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
          overlap(block_idx, m_block_size, iUserOff, iUserSize, off, blk_off, size);
 
          // In RAM or incoming?
-         if (bi != m_block_map.end())
+         if (bi != nullptr)
          {
-            inc_ref_count(bi->second);
-            TRACEF(Dump, tpfx << (void*) iUserBuff << " inc_ref_count for existing block " << bi->second << " idx = " <<  block_idx);
+            inc_ref_count(bi);
+            TRACEF(Dump, tpfx << (void*) iUserBuff << " inc_ref_count for existing block " << bi << " idx = " <<  block_idx);
+
+            if (bi->m_prefetch)
+               note_prefetch_use(offsetIdx(block_idx));
 
-            if (bi->second->is_finished())
+            if (bi->is_finished())
             {
                // note, blocks with error should not be here !!!
                // they should be either removed or reissued in ProcessBlockResponse()
-               assert(bi->second->is_ok());
+               assert(bi->is_ok());
 
-               blks_ready[bi->second].emplace_back( ChunkRequest(nullptr, iUserBuff + off, blk_off, size) );
+               blks_ready[bi].emplace_back( ChunkRequest(nullptr, iUserBuff + off, blk_off, size) );
 
-               if (bi->second->m_prefetch)
+               if (bi->m_prefetch)
                   ++prefetch_cnt;
             }
             else
@@ -890,7 +924,7 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
                // We have a lock on state_cond --> as we register the request before releasing the lock,
                // we are sure to get a call-in via the ChunkRequest handling when this block arrives.
 
-               bi->second->m_chunk_reqs.emplace_back( ChunkRequest(read_req, iUserBuff + off, blk_off, size) );
+               bi->m_chunk_reqs.emplace_back( ChunkRequest(read_req, iUserBuff + off, blk_off, size) );
                ++read_req->m_n_chunk_reqs;
             }
 
@@ -908,7 +942,10 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
             iovec_disk_total += size;
 
             if (m_cfi.TestBitPrefetch(offsetIdx(block_idx)))
+            {
                ++prefetch_cnt;
+               note_prefetch_use(offsetIdx(block_idx));
+            }
 
             lbe = LB_disk;
          }
@@ -963,6 +1000,9 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
 
    inc_prefetch_hit_cnt(prefetch_cnt);
 
+   if (req_last >= 0)
+      update_access_pattern(io, req_first, req_last);
+
    m_state_cond.UnLock();
 
    // First, send out remote requests for new blocks.
@@ -1065,82 +1105,140 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
 // WriteBlock and Sync
 //==============================================================================
 
-void File::WriteBlockToDisk(Block* b)
+int File::WriteBlocksToDisk(std::vector<Block*> &blks)
 {
-   // write block buffer into disk file
-   long long   offset = b->m_offset - m_offset;
-   long long   size   = b->get_size();
-   ssize_t     retval;
-
-   if (m_cfi.IsCkSumCache())
-      if (b->has_cksums())
-         retval = m_data_file->pgWrite(b->get_buff(), offset, size, b->ref_cksum_vec().data(), 0);
-      else
-         retval = m_data_file->pgWrite(b->get_buff(), offset, size, 0, 0);
-   else
-      retval = m_data_file->Write(b->get_buff(), offset, size);
-
-   if (retval < size)
+   // Blocks are sorted by offset. Runs of adjacent blocks are written with a
+   // single WriteV() which the oss turns into one pwritev(). Blocks carrying
+   // page checksums go through pgWrite() individually.
+   const int n_blks = (int) blks.size();
+   std::vector<bool>        ok(n_blks, false);
+   std::vector<XrdOucIOVec> iov;
+   int n_writes = 0;
+
+   for (int i = 0; i < n_blks; )
    {
-      if (retval < 0) {
-         TRACEF(Error, "WriteToDisk() write error " << retval);
-      } else {
-         TRACEF(Error, "WriteToDisk() incomplete block write ret=" << retval << " (should be " << size << ")");
+      Block    *b      = blks[i];
+      long long offset = b->m_offset - m_offset;
+      long long size   = b->get_size();
+      ssize_t   retval;
+
+      if (m_cfi.IsCkSumCache())
+      {
+         if (b->has_cksums())
+            retval = m_data_file->pgWrite(b->get_buff(), offset, size, b->ref_cksum_vec().data(), 0);
+         else
+            retval = m_data_file->pgWrite(b->get_buff(), offset, size, 0, 0);
+         ++n_writes;
+         ok[i] = retval >= size;
+         if ( ! ok[i])
+         {
+            if (retval < 0) {
+               TRACEF(Error, "WriteToDisk() write error " << retval);
+            } else {
+               TRACEF(Error, "WriteToDisk() incomplete block write ret=" << retval << " (should be " << size << ")");
+            }
+         }
+         ++i;
+         continue;
       }
 
-      XrdSysCondVarHelper _lck(m_state_cond);
+      int j = i;
+      iov.clear();
+      do
+      {
+         iov.push_back({ offset, (int) size, 0, b->get_buff() });
+         offset += size;
+         if (++j == n_blks) break;
+         b    = blks[j];
+         size = b->get_size();
+      } while (b->m_offset - m_offset == offset);
 
-      dec_ref_count(b);
+      long long run_size = offset - iov.front().offset;
 
-      return;
-   }
+      if (iov.size() == 1)
+         retval = m_data_file->Write(iov[0].data, iov[0].offset, iov[0].size);
+      else
+         retval = m_data_file->WriteV(iov.data(), (int) iov.size());
+      ++n_writes;
 
-   const int blk_idx =  (b->m_offset - m_offset) / m_block_size;
+      if (retval < run_size)
+      {
+         if (retval < 0) {
+            TRACEF(Error, "WriteToDisk() write error " << retval << " for " << iov.size() << " blocks");
+         } else {
+            TRACEF(Error, "WriteToDisk() incomplete write ret=" << retval << " (should be " << run_size << ")");
+         }
+      }
+      else
+      {
+         for (int k = i; k < j; ++k) ok[k] = true;
+      }
+      i = j;
+   }
 
-   // Set written bit.
-   TRACEF(Dump, "WriteToDisk() success set bit for block " <<  b->m_offset << " size=" <<  size);
+   // Set written bits for the whole batch under a single lock.
+   TRACEF(Dump, "WriteToDisk() " << n_blks << " blocks in " << n_writes << " writes");
 
    bool schedule_sync = false;
    {
       XrdSysCondVarHelper _lck(m_state_cond);
 
-      m_cfi.SetBitWritten(blk_idx);
-
-      if (b->m_prefetch)
+      bool written = false;
+      for (int i = 0; i < n_blks; ++i)
       {
-         m_cfi.SetBitPrefetch(blk_idx);
-      }
-      if (b->req_cksum_net() && ! b->has_cksums() && m_cfi.IsCkSumNet())
-      {
-         m_cfi.ResetCkSumNet();
-      }
+         Block *b = blks[i];
+
+         if ( ! ok[i])
+         {
+            dec_ref_count(b);
+            continue;
+         }
+         written = true;
 
-      dec_ref_count(b);
+         const int blk_idx = (b->m_offset - m_offset) / m_block_size;
 
-      // Set synced bit or stash block index if in actual sync.
-      // Synced state is only written out to cinfo file when data file is synced.
-      if (m_in_sync)
-      {
-         m_writes_during_sync.push_back(blk_idx);
-      }
-      else
-      {
-         m_cfi.SetBitSynced(blk_idx);
-         ++m_non_flushed_cnt;
-         if ((m_cfi.IsComplete() || m_non_flushed_cnt >= Cache::GetInstance().RefConfiguration().m_flushCnt) &&
-             ! m_in_shutdown)
+         m_cfi.SetBitWritten(blk_idx);
+
+         if (b->m_prefetch)
+         {
+            m_cfi.SetBitPrefetch(blk_idx);
+         }
+         if (b->req_cksum_net() && ! b->has_cksums() && m_cfi.IsCkSumNet())
+         {
+            m_cfi.ResetCkSumNet();
+         }
+
+         dec_ref_count(b);
+
+         // Set synced bit or stash block index if in actual sync.
+         // Synced state is only written out to cinfo file when data file is synced.
+         if (m_in_sync)
+         {
+            m_writes_during_sync.push_back(blk_idx);
+         }
+         else
          {
-            schedule_sync     = true;
-            m_in_sync         = true;
-            m_non_flushed_cnt = 0;
+            m_cfi.SetBitSynced(blk_idx);
+            ++m_non_flushed_cnt;
          }
       }
+
+      if (written && ! m_in_sync &&
+           (m_cfi.IsComplete() || m_non_flushed_cnt >= Cache::GetInstance().RefConfiguration().m_flushCnt) &&
+           ! m_in_shutdown)
+      {
+         schedule_sync     = true;
+         m_in_sync         = true;
+         m_non_flushed_cnt = 0;
+      }
    }
 
    if (schedule_sync)
    {
       cache()->ScheduleFileSync(this);
    }
+
+   return n_writes;
 }
 
 //------------------------------------------------------------------------------
@@ -1548,9 +1646,9 @@ int File::offsetIdx(int iIdx) const
 
 void File::Prefetch()
 {
-   // Check that block is not on disk and not in RAM.
-   // TODO: Could prefetch several blocks at once!
-   //       blks_max could be an argument
+   // Select a window of blocks that are neither on disk nor in RAM. Blocks
+   // predicted from the access pattern of the current IO go first, the rest
+   // of the window is filled with the lowest missing blocks of the file.
 
    BlockList_t blks;
 
@@ -1569,33 +1667,14 @@ void File::Prefetch()
          return;
       }
 
-      // Select block(s) to fetch.
-      for (int f = 0; f < m_num_blocks; ++f)
-      {
-         if ( ! m_cfi.TestBitWritten(f))
-         {
-            int f_act = f + m_offset / m_block_size;
+      IO        *io    = *m_current_io;
+      const int  n_max = prefetch_window();
 
-            BlockMap_i bi = m_block_map.find(f_act);
-            if (bi == m_block_map.end())
-            {
-               Block *b = PrepareBlockRequest(f_act, *m_current_io, nullptr, true);
-               if (b)
-               {
-                  TRACEF(Dump, "Prefetch take block " << f_act);
-                  blks.push_back(b);
-                  // Note: block ref_cnt not increased, it will be when placed into write queue.
+      prefetch_pattern(io, n_max, blks);
 
-                  inc_prefetch_read_cnt(1);
-               }
-               else
-               {
-                  // This shouldn't happen as prefetching stops when RAM is 70% full.
-                  TRACEF(Warning, "Prefetch allocation failed for block " << f_act);
-               }
-               break;
-            }
-         }
+      if ((int) blks.size() < n_max && m_prefetch_state == kOn)
+      {
+         prefetch_cursor(io, n_max - (int) blks.size(), blks);
       }
 
       if (blks.empty())
@@ -1606,7 +1685,7 @@ void File::Prefetch()
       }
       else
       {
-         (*m_current_io)->m_active_prefetches += (int) blks.size();
+         io->m_active_prefetches += (int) blks.size();
       }
    }
 
@@ -1616,12 +1695,181 @@ void File::Prefetch()
    }
 }
 
+//------------------------------------------------------------------------------
+
+int File::prefetch_window() const
+{
+   // Called under m_state_cond lock.
+   // The number of blocks requested per decision grows with the fraction of
+   // prefetched blocks that clients actually read, up to half of the
+   // per-file prefetch limit.
+
+   const int max_blocks = Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks;
+
+   return m_prefetch_score.Window(max_blocks, (int) m_block_map.size());
+}
+
+//------------------------------------------------------------------------------
+
+void File::prefetch_pattern(IO *io, int n_max, BlockList_t &blks)
+{
+   // Called under m_state_cond lock.
+   // Follow a sequential or strided access pattern of io, at most a few
+   // requests ahead of the reader.
+
+   auto ai = m_io_access.find(io);
+   if (ai == m_io_access.end()) return;
+
+   AccessPattern &ap = ai->second;
+   if (ap.m_matched < PREFETCH_PATTERN_MATCHES || ap.m_next < 0) return;
+
+   const int  off_blk = m_offset / m_block_size;
+   const int  end_blk = off_blk + m_num_blocks;
+   const int  span    = ap.m_last - ap.m_first + 1;
+   const bool strided = ap.m_stride > span;
+   const int  horizon = strided ? ap.m_first + 4 * ap.m_stride + span
+                                : ap.m_last + 1 + 2 * Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks;
+
+   int b = std::max(ap.m_next, off_blk);
+   while (b < end_blk && b < horizon && (int) blks.size() < n_max && m_prefetch_state == kOn)
+   {
+      if (strided)
+      {
+         int in_region = (b - ap.m_first) % ap.m_stride;
+         if (in_region >= span)
+         {
+            b += ap.m_stride - in_region;
+            continue;
+         }
+      }
+      if ( ! m_cfi.TestBitWritten(offsetIdx(b)) && m_block_map.find(b) == nullptr)
+      {
+         Block *blk = PrepareBlockRequest(b, io, nullptr, true);
+         if ( ! blk)
+         {
+            TRACEF(Warning, "Prefetch allocation failed for block " << b);
+            break;
+         }
+         TRACEF(Dump, "Prefetch take pattern block " << b);
+         blks.push_back(blk);
+         // Note: block ref_cnt not increased, it will be when placed into write queue.
+         inc_prefetch_read_cnt(1);
+      }
+      ++b;
+   }
+   ap.m_next = b;
+}
+
+//------------------------------------------------------------------------------
+
+void File::prefetch_cursor(IO *io, int n_want, BlockList_t &blks)
+{
+   // Called under m_state_cond lock.
+   // Take up to n_want of the lowest blocks that are neither on disk nor in
+   // RAM. The cursor skips the written prefix of the file so it is not
+   // rescanned.
+
+   while (m_prefetch_cursor < m_num_blocks && m_cfi.TestBitWritten(m_prefetch_cursor))
+   {
+      ++m_prefetch_cursor;
+   }
+
+   const int off_blk = m_offset / m_block_size;
+
+   auto missing = [&](int f)
+   {
+      return ! m_cfi.TestBitWritten(f) && m_block_map.find(f + off_blk) == nullptr;
+   };
+
+   auto take = [&](int f)
+   {
+      if (m_prefetch_state != kOn) return false;
+
+      int    f_act = f + off_blk;
+      Block *b     = PrepareBlockRequest(f_act, io, nullptr, true);
+      if ( ! b)
+      {
+         // This shouldn't happen as prefetching stops when RAM is 70% full.
+         TRACEF(Warning, "Prefetch allocation failed for block " << f_act);
+         return false;
+      }
+      TRACEF(Dump, "Prefetch take block " << f_act);
+      blks.push_back(b);
+      // Note: block ref_cnt not increased, it will be when placed into write queue.
+      inc_prefetch_read_cnt(1);
+      return true;
+   };
+
+   PrefetchTake(m_prefetch_cursor, m_num_blocks, n_want, missing, take);
+}
+
+//------------------------------------------------------------------------------
+
+void File::update_access_pattern(IO *io, int first, int last)
+{
+   // Called under m_state_cond lock.
+   // A request continuing at or before the end of the previous one is
+   // sequential; otherwise the distance between request starts must stay
+   // within 1/8 of the previous one to count as a strided pattern.
+
+   AccessPattern &ap = m_io_access[io];
+
+   if (ap.m_first >= 0)
+   {
+      const int stride = first - ap.m_first;
+
+      if (first >= ap.m_first && first <= ap.m_last + 1)
+      {
+         ap.m_matched = ap.m_stride == 0 ? ap.m_matched + 1 : 1;
+         ap.m_stride  = 0;
+      }
+      else if (stride > 0 && ap.m_stride > 0 && std::abs(stride - ap.m_stride) <= ap.m_stride / 8)
+      {
+         ++ap.m_matched;
+         ap.m_stride = stride;
+      }
+      else
+      {
+         ap.m_matched = stride > 0 ? 1 : 0;
+         ap.m_stride  = std::max(stride, 0);
+      }
+   }
+
+   ap.m_first = first;
+   ap.m_last  = last;
+
+   if (ap.m_matched >= PREFETCH_PATTERN_MATCHES)
+      ap.m_next = std::max(ap.m_next, ap.m_stride ? first + ap.m_stride : last + 1);
+   else
+      ap.m_next = -1;
+}
+
+//------------------------------------------------------------------------------
+
+void File::note_prefetch_use(int blk_idx)
+{
+   // Called under m_state_cond lock, blk_idx is relative to m_offset.
+   // Accounts the first read of a block prefetched by this File.
+
+   if (m_prefetch_use.empty() || m_prefetch_use[blk_idx] != 1) return;
+
+   m_prefetch_use[blk_idx] = 2;
+
+   m_prefetch_useful_bytes += (blk_idx == m_num_blocks - 1) ? m_file_size - (long long) blk_idx * m_block_size
+                                                            : m_block_size;
+}
 
 //------------------------------------------------------------------------------
 
 float File::GetPrefetchScore() const
 {
-   return m_prefetch_score;
+   return m_prefetch_score.Score();
+}
+
+float File::GetPrefetchPriority() const
+{
+   // Not under lock, called by Cache for files on the prefetch list.
+   return m_prefetch_score.Priority();
 }
 
 XrdSysError* File::GetLog()
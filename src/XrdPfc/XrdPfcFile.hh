@@ -19,7 +19,9 @@
 //----------------------------------------------------------------------------------
 
 #include "XrdPfcTypes.hh"
+#include "XrdPfcBlockIndex.hh"
 #include "XrdPfcInfo.hh"
+#include "XrdPfcPrefetchScore.hh"
 #include "XrdPfcStats.hh"
 
 #include "XrdOuc/XrdOucCache.hh"
@@ -250,12 +252,21 @@ public:
    //----------------------------------------------------------------------
    void Sync();
 
-   void WriteBlockToDisk(Block* b);
+   //----------------------------------------------------------------------
+   //! Write a batch of blocks of this file, sorted by offset, to disk.
+   //! Adjacent blocks are written with a single vector write and the cinfo
+   //! bits of the whole batch are updated under one lock. Returns the
+   //! number of write calls issued.
+   //----------------------------------------------------------------------
+   int WriteBlocksToDisk(std::vector<Block*> &blks);
 
    void Prefetch();
 
    float GetPrefetchScore() const;
 
+   //! Weight used by Cache when choosing the next file to prefetch from.
+   float GetPrefetchPriority() const;
+
    //! Log path
    const char* lPath() const;
 
@@ -278,6 +289,7 @@ public:
    int                GetNBlocks()           const { return m_cfi.GetNBlocks(); }
    int                GetNDownloadedBlocks() const { return m_cfi.GetNDownloadedBlocks(); }
    long long          GetPrefetchedBytes()   const { return m_prefetch_bytes; }
+   long long          GetPrefetchUsefulBytes() const { return m_prefetch_useful_bytes; }
    const Stats&       RefStats()             const { return m_stats; }
 
    int Fstat(struct stat &sbuff);
@@ -322,6 +334,21 @@ private:
 
    IoSet_t    m_io_set;
    IoSet_i    m_current_io;     //!< IO object to be used for prefetching.
+
+   // Block range touched by recent read requests of an IO, used to steer
+   // prefetching. Block indices are absolute, as in Read / ReadV. Sequential
+   // reads have stride 0; strided reads and readv clusters (as issued by
+   // TTreeCache) keep the distance between the starts of consecutive requests.
+   struct AccessPattern
+   {
+      int m_first   = -1;  //!< first block of the last request
+      int m_last    = -1;  //!< last block of the last request
+      int m_stride  =  0;  //!< distance between first blocks of the last two requests
+      int m_matched =  0;  //!< number of consecutive requests that followed the pattern
+      int m_next    = -1;  //!< next block to consider for prefetching
+   };
+
+   std::map<IO*, AccessPattern> m_io_access;
    int        m_ios_in_detach;  //!< Number of IO objects to which we replied false to ioActive() and will be removed soon.
 
    // FSync
@@ -337,8 +364,7 @@ private:
    typedef std::list<int>        IntList_t;
    typedef IntList_t::iterator   IntList_i;
 
-   typedef std::map<int, Block*> BlockMap_t;
-   typedef BlockMap_t::iterator  BlockMap_i;
+   typedef BlockIndex<Block>     BlockMap_t;
 
    BlockMap_t    m_block_map;
    XrdSysCondVar m_state_cond;
@@ -366,13 +392,19 @@ private:
    PrefetchState_e m_prefetch_state;
 
    long long m_prefetch_bytes;
-   int   m_prefetch_read_cnt;
-   int   m_prefetch_hit_cnt;
-   float m_prefetch_score;              // cached
-
-   void inc_prefetch_read_cnt(int prc) { if (prc) { m_prefetch_read_cnt += prc; calc_prefetch_score(); } }
-   void inc_prefetch_hit_cnt (int phc) { if (phc) { m_prefetch_hit_cnt  += phc; calc_prefetch_score(); } }
-   void calc_prefetch_score() { m_prefetch_score = float(m_prefetch_hit_cnt) / m_prefetch_read_cnt; }
+   long long m_prefetch_useful_bytes;   //!< prefetched bytes that were later read by a client
+   PrefetchScore m_prefetch_score;
+   int   m_prefetch_cursor;             //!< all blocks before this one are written
+   std::vector<char> m_prefetch_use;    //!< per block: 1 prefetched, 2 prefetched and read
+
+   int  prefetch_window() const;
+   void prefetch_pattern(IO *io, int n_max, BlockList_t &blks);
+   void prefetch_cursor(IO *io, int n_want, BlockList_t &blks);
+   void update_access_pattern(IO *io, int first, int last);
+   void note_prefetch_use(int blk_idx);
+
+   void inc_prefetch_read_cnt(int prc) { m_prefetch_score.AddReads(prc); }
+   void inc_prefetch_hit_cnt (int phc) { m_prefetch_score.AddHits(phc); }
 
    // Helpers
 
@@ -0,0 +1,368 @@
+#ifndef __XRDPFC_NSINDEX_HH__
+#define __XRDPFC_NSINDEX_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace XrdPfc
+{
+
+//----------------------------------------------------------------------------
+//! Index of the files in the cache namespace, keyed by LFN.
+//!
+//! Holds, for every cached file, its disk usage and the time it was last
+//! accessed, which is what purge needs to pick candidates and what the
+//! DirState tree needs for directory usages. The index is kept up to date
+//! from the ResourceMonitor event queues and every change is appended to a
+//! journal in a log-structured format; the ResourceMonitor writes the
+//! journal out to the index file. On startup the file is replayed to rebuild
+//! the index instead of traversing the cache directory tree.
+//!
+//! The file starts with a header and is followed by records, each being:
+//!   uint32 checksum of the payload (FNV-1a)
+//!   uint32 payload length
+//!   payload: char type ('S' set, 'D' delete), int64 st_blocks, int64 time, LFN
+//! Integers are in host byte order as the file never leaves the host. A torn
+//! or damaged record ends the replay; everything before it is kept.
+//!
+//! The whole index is held in memory, one map node per cached file. On a
+//! 64-bit build that is about 100 bytes per file plus, for LFNs longer than
+//! 15 characters, the LFN itself rounded up to 16 bytes: roughly 2 GB for
+//! ten million files with 80 character names. Size pfc.nsindex deployments
+//! accordingly.
+//!
+//! Not thread-safe, callers serialize access.
+//----------------------------------------------------------------------------
+
+class NsIndex
+{
+public:
+   struct Entry
+   {
+      long long m_StBlocks   = 0;      //!< data file usage in 512-byte blocks
+      time_t    m_AccessTime = 0;      //!< time of the last open or close
+      int       m_NOpen      = 0;      //!< opens not yet closed (not persisted)
+      bool      m_Purged     = false;  //!< removed while open, forget on close (not persisted)
+   };
+
+   using map_t = std::map<std::string, Entry>;
+
+   static constexpr size_t s_header_len = 16;
+
+   // --- Event processing, every change is journaled.
+
+   //! A file was opened; st_blocks is its usage at open time.
+   void Open(const std::string &lfn, long long st_blocks, time_t t)
+   {
+      Entry &e = insert(lfn);
+      e.m_StBlocks   = st_blocks;
+      e.m_AccessTime = t;
+      e.m_NOpen     += 1;
+      e.m_Purged     = false;
+      journal_set(lfn, e);
+   }
+
+   //! An open file grew (or shrunk) by st_blocks_added.
+   void Grow(const std::string &lfn, long long st_blocks_added)
+   {
+      auto it = m_map.find(lfn);
+      if (it == m_map.end() || st_blocks_added == 0) return;
+      it->second.m_StBlocks += st_blocks_added;
+      if (it->second.m_StBlocks < 0) it->second.m_StBlocks = 0;
+      journal_set(lfn, it->second);
+   }
+
+   //! A file was closed. Files that were purged while open are forgotten.
+   void Close(const std::string &lfn, time_t t)
+   {
+      auto it = m_map.find(lfn);
+      if (it == m_map.end()) return;
+      Entry &e = it->second;
+      if (e.m_NOpen > 0) --e.m_NOpen;
+      if (e.m_Purged && e.m_NOpen == 0)
+      {
+         Erase(lfn);
+         return;
+      }
+      e.m_AccessTime = t;
+      journal_set(lfn, e);
+   }
+
+   //! A file was removed, freeing st_blocks. An open file stays in the index
+   //! with its usage reduced until it is closed.
+   void Purge(const std::string &lfn, long long st_blocks)
+   {
+      auto it = m_map.find(lfn);
+      if (it == m_map.end()) return;
+      Entry &e = it->second;
+      if (e.m_NOpen == 0)
+      {
+         Erase(lfn);
+         return;
+      }
+      e.m_StBlocks = e.m_StBlocks > st_blocks ? e.m_StBlocks - st_blocks : 0;
+      e.m_Purged   = true;
+      journal_set(lfn, e);
+   }
+
+   //! Removes a file from the index.
+   void Erase(const std::string &lfn)
+   {
+      auto it = m_map.find(lfn);
+      if (it == m_map.end()) return;
+      append_record(m_journal, 'D', lfn, 0, 0);
+      remove(it);
+   }
+
+   // --- Loading, not journaled.
+
+   //! Adds or replaces a file, as found by a namespace traversal.
+   void Load(const std::string &lfn, long long st_blocks, time_t t)
+   {
+      Entry &e = insert(lfn);
+      e.m_StBlocks   = st_blocks;
+      e.m_AccessTime = t;
+   }
+
+   //! Replays records from buf. Returns the number of bytes consumed, which
+   //! is less than len when the last record is incomplete. Sets corrupt and
+   //! stops at the first record that fails the checks.
+   size_t Replay(const char *buf, size_t len, bool &corrupt)
+   {
+      size_t pos = 0;
+      corrupt = false;
+      while (len - pos >= 8)
+      {
+         uint32_t cksum, plen;
+         memcpy(&cksum, buf + pos,     4);
+         memcpy(&plen,  buf + pos + 4, 4);
+         if (plen < s_fixed_len || plen > s_max_payload) { corrupt = true; break; }
+         if (len - pos - 8 < plen) break;
+
+         const char *p = buf + pos + 8;
+         if (checksum(p, plen) != cksum) { corrupt = true; break; }
+
+         int64_t blocks, t;
+         memcpy(&blocks, p + 1, 8);
+         memcpy(&t,      p + 9, 8);
+         std::string lfn(p + s_fixed_len, plen - s_fixed_len);
+         if (*p == 'S')
+         {
+            Load(lfn, blocks, (time_t) t);
+         }
+         else if (*p == 'D')
+         {
+            auto it = m_map.find(lfn);
+            if (it != m_map.end()) remove(it);
+         }
+         else { corrupt = true; break; }
+
+         pos += 8 + plen;
+      }
+      return pos;
+   }
+
+   // --- Lookups.
+
+   const Entry* Find(const std::string &lfn) const
+   {
+      auto it = m_map.find(lfn);
+      return it == m_map.end() ? nullptr : &it->second;
+   }
+
+   //! Calls f(lfn, entry) for every file at or below directory dir, in LFN order.
+   template<typename F>
+   void ForEachUnder(const std::string &dir, F f) const
+   {
+      std::string pfx(dir);
+      if (pfx.empty() || pfx.back() != '/') pfx += '/';
+      for (auto it = m_map.lower_bound(pfx);
+           it != m_map.end() && it->first.compare(0, pfx.size(), pfx) == 0; ++it)
+      {
+         f(it->first, it->second);
+      }
+   }
+
+   //! Calls f(lfn, entry) for every file directly in directory dir, in LFN
+   //! order. Subdirectories are skipped over, not walked.
+   template<typename F>
+   void ForEachIn(const std::string &dir, F f) const
+   {
+      std::string pfx(dir);
+      if (pfx.empty() || pfx.back() != '/') pfx += '/';
+      auto it = m_map.lower_bound(pfx);
+      while (it != m_map.end() && it->first.compare(0, pfx.size(), pfx) == 0)
+      {
+         size_t slash = it->first.find('/', pfx.size());
+         if (slash == std::string::npos)
+         {
+            f(it->first, it->second);
+            ++it;
+         }
+         else
+         {
+            // Everything in the subdirectory sorts before its name plus '0',
+            // the character following '/'.
+            it = m_map.lower_bound(it->first.substr(0, slash) + '0');
+         }
+      }
+   }
+
+   //! True if a file directly in directory dir is open.
+   bool HasOpenIn(const std::string &dir) const
+   {
+      bool open = false;
+      ForEachIn(dir, [&](const std::string&, const Entry &e) { if (e.m_NOpen > 0) open = true; });
+      return open;
+   }
+
+   //! Copies up to max files at or below directory dir that sort after LFN
+   //! after (all of them if after is empty) to out, in LFN order. Used to
+   //! go through a subtree in chunks without holding the index all along.
+   void CopyUnder(const std::string &dir, const std::string &after, size_t max,
+                  std::vector<std::pair<std::string, Entry>> &out) const
+   {
+      std::string pfx(dir);
+      if (pfx.empty() || pfx.back() != '/') pfx += '/';
+      out.clear();
+      for (auto it = after.empty() ? m_map.lower_bound(pfx) : m_map.upper_bound(after);
+           it != m_map.end() && out.size() < max &&
+           it->first.compare(0, pfx.size(), pfx) == 0; ++it)
+      {
+         out.emplace_back(it->first, it->second);
+      }
+   }
+
+   const map_t& RefMap() const { return m_map; }
+   size_t       Size()   const { return m_map.size(); }
+
+   void Clear() { m_map.clear(); m_journal.clear(); m_live_bytes = 0; }
+
+   // --- Journal and snapshots.
+
+   //! Records of the changes since the journal was last taken.
+   std::string& RefJournal() { return m_journal; }
+
+   //! Size of the index file when written out as a snapshot.
+   long long SnapshotSize() const { return s_header_len + m_live_bytes; }
+
+   //! Writes out the whole index as a header followed by a set record per
+   //! file, in chunks of about chunk bytes. write(buf, len) returns false on
+   //! error, which aborts the snapshot.
+   template<typename F>
+   bool Snapshot(F write, size_t chunk = 1024 * 1024) const
+   {
+      std::string buf;
+      buf.reserve(chunk + s_fixed_len + 8 + 4096);
+      WriteHeader(buf);
+      for (auto &[lfn, e] : m_map)
+      {
+         append_record(buf, 'S', lfn, e.m_StBlocks, e.m_AccessTime);
+         if (buf.size() >= chunk)
+         {
+            if ( ! write(buf.data(), buf.size())) return false;
+            buf.clear();
+         }
+      }
+      return buf.empty() || write(buf.data(), buf.size());
+   }
+
+   static void WriteHeader(std::string &buf)
+   {
+      char hdr[s_header_len];
+      make_header(hdr);
+      buf.append(hdr, s_header_len);
+   }
+
+   static bool CheckHeader(const char *buf, size_t len)
+   {
+      char hdr[s_header_len];
+      make_header(hdr);
+      return len >= s_header_len && memcmp(buf, hdr, s_header_len) == 0;
+   }
+
+private:
+   static constexpr uint32_t s_version     = 1;
+   static constexpr uint32_t s_fixed_len   = 17;     // type, st_blocks, time
+   static constexpr uint32_t s_max_payload = 65536;
+
+   map_t       m_map;
+   std::string m_journal;
+   long long   m_live_bytes = 0;
+
+   static long long record_size(const std::string &lfn) { return 8 + s_fixed_len + lfn.size(); }
+
+   Entry& insert(const std::string &lfn)
+   {
+      auto res = m_map.try_emplace(lfn);
+      if (res.second) m_live_bytes += record_size(lfn);
+      return res.first->second;
+   }
+
+   void remove(map_t::iterator it)
+   {
+      m_live_bytes -= record_size(it->first);
+      m_map.erase(it);
+   }
+
+   void journal_set(const std::string &lfn, const Entry &e)
+   {
+      append_record(m_journal, 'S', lfn, e.m_StBlocks, e.m_AccessTime);
+   }
+
+   static void make_header(char *hdr)
+   {
+      uint32_t version = s_version;
+      memset(hdr, 0, s_header_len);
+      memcpy(hdr, "XrdPfcNsIdx", 11);
+      memcpy(hdr + 12, &version, 4);
+   }
+
+   static uint32_t checksum(const char *p, size_t len, uint32_t h = 2166136261u)
+   {
+      for (size_t i = 0; i < len; ++i) { h ^= (unsigned char) p[i]; h *= 16777619u; }
+      return h;
+   }
+
+   static void append_record(std::string &buf, char type, const std::string &lfn,
+                             long long st_blocks, long long t)
+   {
+      char     rec[8 + s_fixed_len];
+      uint32_t plen   = s_fixed_len + lfn.size();
+      int64_t  blocks = st_blocks, tt = t;
+      rec[8] = type;
+      memcpy(rec + 9,  &blocks, 8);
+      memcpy(rec + 17, &tt,     8);
+
+      uint32_t h = checksum(lfn.data(), lfn.size(), checksum(rec + 8, s_fixed_len));
+      memcpy(rec,     &h,    4);
+      memcpy(rec + 4, &plen, 4);
+      buf.append(rec, sizeof(rec));
+      buf.append(lfn);
+   }
+};
+
+}
+
+#endif
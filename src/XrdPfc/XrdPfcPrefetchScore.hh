@@ -0,0 +1,111 @@
+#ifndef __XRDPFC_PREFETCHSCORE_HH__
+#define __XRDPFC_PREFETCHSCORE_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by Board of Trustees of the Leland Stanford, Jr., University
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+
+namespace XrdPfc
+{
+
+//----------------------------------------------------------------------------
+//! Prefetch accounting of a File: the fraction of prefetched blocks that
+//! clients read, and what follows from it.
+//!
+//! The counters are updated under File::m_state_cond. The score and the
+//! priority are also read by Cache when it picks the next file to prefetch
+//! from, without holding the file's lock, so they are published atomically.
+//----------------------------------------------------------------------------
+
+class PrefetchScore
+{
+public:
+   //! Number of prefetched blocks after which the score is trusted.
+   static const int WarmupBlocks = 8;
+
+   PrefetchScore() : m_read_cnt(0), m_hit_cnt(0), m_score(0), m_priority(1.0f) {}
+
+   void AddReads(int n) { if (n) { m_read_cnt += n; update(); } }
+   void AddHits (int n) { if (n) { m_hit_cnt  += n; update(); } }
+
+   int   ReadCnt() const { return m_read_cnt; }
+   bool  Warm()    const { return m_read_cnt >= WarmupBlocks; }
+
+   //! Fraction of prefetched blocks that were read, safe to call without the lock.
+   float Score()   const { return m_score.load(std::memory_order_relaxed); }
+
+   //! Weight in the lottery over files to prefetch from, safe to call without
+   //! the lock. Files that have not prefetched enough to be judged get full
+   //! weight, the others are weighted by their score. The floor keeps files
+   //! with a poor score from being starved completely.
+   float Priority() const { return m_priority.load(std::memory_order_relaxed); }
+
+   //! Number of blocks to request per prefetch decision. It grows with the
+   //! score up to half of the per-file limit max_blocks, and never exceeds
+   //! the room left by the n_in_flight blocks the file already holds.
+   int Window(int max_blocks, int n_in_flight) const
+   {
+      const int max_window = std::max(1, max_blocks / 2);
+
+      int window;
+      if ( ! Warm())
+         window = std::min(2, max_window);
+      else
+         window = 1 + (int) (std::min(Score(), 1.0f) * (max_window - 1) + 0.5f);
+
+      return std::max(1, std::min(window, max_blocks - n_in_flight));
+   }
+
+private:
+   void update()
+   {
+      const float score = m_read_cnt ? float(m_hit_cnt) / m_read_cnt : 0;
+      m_score.store(score, std::memory_order_relaxed);
+      m_priority.store(Warm() ? 0.1f + std::min(score, 1.0f) : 1.0f, std::memory_order_relaxed);
+   }
+
+   int                m_read_cnt;
+   int                m_hit_cnt;
+   std::atomic<float> m_score;
+   std::atomic<float> m_priority;
+};
+
+//----------------------------------------------------------------------------
+//! Walk the blocks from first up to end and take those for which missing(b)
+//! holds, until n_want of them have been taken. take(b) requests a block and
+//! returns false if that was not possible, which ends the walk.
+//!
+//! @return number of blocks taken
+//----------------------------------------------------------------------------
+
+template<typename Missing, typename Take>
+int PrefetchTake(int first, int end, int n_want, Missing missing, Take take)
+{
+   int n_taken = 0;
+   for (int b = first; b < end && n_taken < n_want; ++b)
+   {
+      if ( ! missing(b)) continue;
+      if ( ! take(b)) break;
+      ++n_taken;
+   }
+   return n_taken;
+}
+
+}
+
+#endif
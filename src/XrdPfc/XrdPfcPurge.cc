@@ -83,6 +83,11 @@ long long UnlinkPurgeStateFilesInMap(FPurgeState& purgeState, long long bytes_to
 
          resmon.register_file_purge(dataPath, it->second.nStBlocks);
       }
+      else
+      {
+         // Gone without us noticing, do not offer it again.
+         resmon.index_forget(dataPath);
+      }
    }
    if (protected_cnt > 0)
    {
@@ -125,7 +130,8 @@ void OldStylePurgeDriver(DataFsPurgeshot &ps)
             TRACE(Debug, trc_pfx << "PurgePin scanning dir " << ppit->path.c_str() << " to remove " << ppit->nBytesToRecover << " bytes");
 
             FPurgeState fps(ppit->nBytesToRecover, oss);
-            bool scan_ok = fps.TraverseNamespace(ppit->path.c_str());
+            bool scan_ok = fps.TraverseIndex(ppit->path.c_str()) ||
+                           fps.TraverseNamespace(ppit->path.c_str());
             if ( ! scan_ok) {
                TRACE(Warning, trc_pfx << "purge-pin scan of directory failed for " << ppit->path);
                continue;
@@ -159,8 +165,10 @@ void OldStylePurgeDriver(DataFsPurgeshot &ps)
          purgeState.setUVKeepMinTime(time(0) - conf.m_cs_UVKeep);
       }
 
-      // Make a map of file paths, sorted by access time.
-      bool scan_ok = purgeState.TraverseNamespace("/");
+      // Make a map of file paths, sorted by access time. Take them from the
+      // namespace index when it is in use.
+      bool scan_ok = purgeState.TraverseIndex("/") ||
+                     purgeState.TraverseNamespace("/");
       if (!scan_ok)
       {
          TRACE(Error, trc_pfx << "default purge namespace traversal failed at top-directory, this should not happen.");
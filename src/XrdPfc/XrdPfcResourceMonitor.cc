@@ -9,8 +9,11 @@
 #include "XrdPfcPurgePin.hh"
 
 #include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucEnv.hh"
 
 #include <algorithm>
+#include <set>
+#include <fcntl.h>
 
 // #define RM_DEBUG
 #ifdef RM_DEBUG
@@ -25,6 +28,16 @@ namespace
 {
    XrdSysTrace* GetTrace() { return Cache::GetInstance().GetTrace(); }
    const char *m_traceID = "ResourceMonitor";
+
+   // The index lives next to the dir-stats dumps, a protected top directory
+   // that is never traversed.
+   const char *s_index_path     = "/pfc-stats/NsIndex.log";
+   const char *s_index_new_path = "/pfc-stats/NsIndex.log.new";
+   const char *s_dirty_path     = "/pfc-stats/NsIndex.dirty";
+
+   const size_t    s_index_read_chunk     = 4 * 1024 * 1024;
+   const long long s_index_min_compact    = 16 * 1024 * 1024;
+   const size_t    s_index_traverse_chunk = 4096;
 }
 
 //------------------------------------------------------------------------------
@@ -107,6 +120,8 @@ void ResourceMonitor::cross_check_or_process_oob_lfn(const std::string &lfn, FsT
             here.m_NFiles   += 1;
          }
       }
+      if (m_index_seeding)
+         index_seed_dir(dir + "/", fst);
    }
    delete dhp;
    ds->m_scanned = true;
@@ -139,6 +154,8 @@ void ResourceMonitor::scan_dir_and_recurse(FsTraversal &fst)
             here.m_NFiles   += 1;
          }
       }
+      if (m_index_seeding)
+         index_seed_dir(fst.m_current_path, fst);
       fst.m_dir_state->m_scanned = true;
    }
 
@@ -168,26 +185,39 @@ void ResourceMonitor::scan_dir_and_recurse(FsTraversal &fst)
 bool ResourceMonitor::perform_initial_scan()
 {
    // Called after PFC configuration is complete, but before full startup of the daemon.
-   // Base line usages are accumulated as part of the file-system, traversal.
+   // Base line usages are accumulated as part of the file-system, traversal, unless
+   // they can be taken from the namespace index.
+   static const char *trc_pfx = "perform_initial_scan() ";
 
    update_vs_and_file_usage_info();
 
-   DirState   *root_ds = m_fs_state.get_root();
-   FsTraversal fst(m_oss);
-   fst.m_protected_top_dirs.insert("pfc-stats"); // XXXX This should come from config. Also: N2N?
-
-   if ( ! fst.begin_traversal(root_ds, "/"))
-      return false;
+   DirState *root_ds = m_fs_state.get_root();
 
+   if (Cache::Conf().m_nsIndex && index_load() && index_reconcile())
    {
-      XrdSysMutexHelper _lock(m_dir_scan_mutex);
-      m_dir_scan_in_progress = true;
-      m_dir_scan_check_counter = 0; // recheck oob file-open requests periodically.
+      TRACE(Info, trc_pfx << "loaded namespace index, n_files=" << m_index.Size() << ", skipping directory scan.");
+      index_fill_dirstates();
    }
+   else
+   {
+      FsTraversal fst(m_oss);
+      fst.m_protected_top_dirs.insert("pfc-stats"); // XXXX This should come from config. Also: N2N?
 
-   scan_dir_and_recurse(fst);
+      if ( ! fst.begin_traversal(root_ds, "/"))
+         return false;
 
-   fst.end_traversal();
+      {
+         XrdSysMutexHelper _lock(m_dir_scan_mutex);
+         m_dir_scan_in_progress = true;
+         m_dir_scan_check_counter = 0; // recheck oob file-open requests periodically.
+      }
+
+      m_index_seeding = Cache::Conf().m_nsIndex;
+
+      scan_dir_and_recurse(fst);
+
+      fst.end_traversal();
+   }
 
    // We have all directories scanned, available in DirState tree, let all remaining files go
    // and then we shall do the upward propagation of usages.
@@ -214,6 +244,22 @@ bool ResourceMonitor::perform_initial_scan()
                                   root_ds->m_recursive_subdir_usage.m_StBlocks;
    update_vs_and_file_usage_info();
 
+   // Start the index afresh from what the scan found. An index left over from
+   // a run without it is stale and must not be picked up later.
+   if (m_index_seeding)
+   {
+      m_index_seeding = false;
+      if (index_write_snapshot() && index_dirty_reset()) {
+         TRACE(Info, trc_pfx << "created namespace index, n_files=" << m_index.Size());
+      }
+   }
+   else if ( ! m_index_on)
+   {
+      m_oss.Unlink(s_index_path);
+      m_oss.Unlink(s_index_new_path);
+      m_oss.Unlink(s_dirty_path);
+   }
+
    return true;
 }
 
@@ -243,6 +289,10 @@ int ResourceMonitor::process_queues()
       ++m_queue_swap_u1;
    }
 
+   // The index needs the file names, which are released with the close records.
+   if (m_index_on)
+      index_process_queues();
+
    for (auto &i : m_file_open_q.read_queue())
    {
       // i.id: LFN, i.record: OpenRecord
@@ -340,9 +390,589 @@ int ResourceMonitor::process_queues()
    // Read queues / vectors are cleared at swap time.
    // We might consider reducing their capacity by half if, say, their usage is below 25%.
 
+   if (m_index_on)
+      index_flush();
+
    return n_records;
 }
 
+//------------------------------------------------------------------------------
+// Namespace index
+//------------------------------------------------------------------------------
+
+void ResourceMonitor::index_seed_dir(const std::string &dir_path, FsTraversal &fst)
+{
+   // Runs during the initial scan, before the index is in use.
+   for (auto & [name, fps] : fst.m_current_files)
+   {
+      if (fps.has_both())
+         m_index.Load(dir_path + name, fps.stat_data.st_blocks, fps.stat_cinfo.st_mtime);
+   }
+}
+
+XrdOssDF* ResourceMonitor::index_open(const char *path, bool create)
+{
+   static const char *trc_pfx = "index_open() ";
+
+   const Configuration &conf = Cache::Conf();
+   const char *user = conf.m_username.c_str();
+   XrdOucEnv   env;
+   env.Put("oss.cgroup", conf.m_meta_space.c_str());
+
+   int ret;
+   if (create && (ret = m_oss.Create(user, path, 0600, env, XRDOSS_mkpath)) != XrdOssOK)
+   {
+      TRACE(Error, trc_pfx << "can't create " << path << ERRNO_AND_ERRSTR(-ret));
+      return nullptr;
+   }
+   XrdOssDF *fp = m_oss.newFile(user);
+   if ((ret = fp->Open(path, O_RDWR, 0600, env)) != XrdOssOK)
+   {
+      TRACE(Error, trc_pfx << "can't open " << path << ERRNO_AND_ERRSTR(-ret));
+      delete fp;
+      return nullptr;
+   }
+   if (create)
+      fp->Ftruncate(0);
+   return fp;
+}
+
+bool ResourceMonitor::index_load()
+{
+   static const char *trc_pfx = "index_load() ";
+
+   // A crash while installing a snapshot can leave only the new file behind,
+   // see index_write_snapshot(). Otherwise the new file is an incomplete one.
+   struct stat st;
+   if (m_oss.Stat(s_index_path, &st) != XrdOssOK &&
+       (m_oss.Stat(s_index_new_path, &st) != XrdOssOK ||
+        m_oss.Rename(s_index_new_path, s_index_path) != XrdOssOK))
+   {
+      TRACE(Info, trc_pfx << "no namespace index found, a directory scan will create it.");
+      return false;
+   }
+   m_oss.Unlink(s_index_new_path);
+
+   XrdOssDF *fp = index_open(s_index_path, false);
+   if ( ! fp)
+      return false;
+
+   std::vector<char> buf(s_index_read_chunk);
+   std::string       pending;
+   long long         off = 0, valid = 0;
+   bool              header_ok = false, corrupt = false;
+   ssize_t           n;
+
+   while ((n = fp->Read(buf.data(), off, buf.size())) > 0)
+   {
+      off += n;
+      pending.append(buf.data(), n);
+      if ( ! header_ok)
+      {
+         if (pending.size() < NsIndex::s_header_len)
+            continue;
+         if ( ! NsIndex::CheckHeader(pending.data(), pending.size()))
+            break;
+         header_ok = true;
+         valid     = NsIndex::s_header_len;
+         pending.erase(0, NsIndex::s_header_len);
+      }
+      size_t used = m_index.Replay(pending.data(), pending.size(), corrupt);
+      pending.erase(0, used);
+      valid += used;
+      if (corrupt)
+         break;
+   }
+
+   if (n < 0 || ! header_ok)
+   {
+      if (n < 0) {
+         TRACE(Error, trc_pfx << "read of namespace index failed" << ERRNO_AND_ERRSTR(-n));
+      } else {
+         TRACE(Warning, trc_pfx << "namespace index has an unknown format, it will be recreated.");
+      }
+      fp->Close();
+      delete fp;
+      m_index.Clear();
+      return false;
+   }
+
+   // Records past the last good one are either a torn write or damage. Drop
+   // them so new records can be appended.
+   if (fp->Fstat(&st) == XrdOssOK && st.st_size > valid)
+   {
+      TRACE(Warning, trc_pfx << "dropping " << st.st_size - valid << " bytes of " << (corrupt ? "damaged" : "incomplete")
+                             << " records at the end of the namespace index.");
+      fp->Ftruncate(valid);
+   }
+
+   m_index_file = fp;
+   m_index_size = valid;
+   m_index_on   = true;
+   return true;
+}
+
+bool ResourceMonitor::index_reconcile()
+{
+   static const char *trc_pfx = "index_reconcile() ";
+
+   // Files in the directories listed in the dirty file may have been created,
+   // grown or removed without the index knowing, there is no telling how the
+   // previous run ended. Rescan these directories and replace what the index
+   // has for them. A missing dirty file means nothing was touched.
+   std::set<std::string> dirs;
+   struct stat st;
+   if (m_oss.Stat(s_dirty_path, &st) == XrdOssOK)
+   {
+      XrdOssDF *fp = index_open(s_dirty_path, false);
+      std::string buf(fp && fp->Fstat(&st) == XrdOssOK ? st.st_size : 0, '\0');
+      if ( ! fp || fp->Read(buf.data(), 0, buf.size()) != (ssize_t) buf.size())
+      {
+         TRACE(Warning, trc_pfx << "can not read the list of dirty directories, the namespace will be rescanned.");
+         if (fp) { fp->Close(); delete fp; }
+         m_index_file->Close();
+         delete m_index_file;
+         m_index_file = nullptr;
+         m_index_on   = false;
+         m_index.Clear();
+         return false;
+      }
+      fp->Close();
+      delete fp;
+
+      // A torn last line was never synced, so the open that wrote it did not
+      // proceed. Skip it.
+      for (size_t beg = 0, end; (end = buf.find('\n', beg)) != std::string::npos; beg = end + 1)
+      {
+         if (end > beg && buf[beg] == '/' && buf[end - 1] == '/')
+            dirs.insert(buf.substr(beg, end - beg));
+      }
+   }
+
+   for (auto &dir : dirs)
+   {
+      std::vector<std::string> gone;
+      FsTraversal fst(m_oss);
+      bool found = fst.begin_traversal(dir.c_str());
+
+      m_index.ForEachIn(dir, [&](const std::string &lfn, const NsIndex::Entry&)
+      {
+         auto it = fst.m_current_files.find(lfn.substr(dir.size()));
+         if ( ! found || it == fst.m_current_files.end() || ! it->second.has_both())
+            gone.push_back(lfn);
+      });
+      for (auto &lfn : gone)
+         m_index.Erase(lfn);
+      if (found)
+         index_seed_dir(dir, fst);
+      fst.end_traversal();
+   }
+
+   if ( ! dirs.empty())
+   {
+      TRACE(Info, trc_pfx << "rescanned " << dirs.size() << " directories touched since the index was last up to date"
+                          << ", n_files=" << m_index.Size());
+      if ( ! index_write_snapshot())
+         return false;
+   }
+   return index_dirty_reset();
+}
+
+bool ResourceMonitor::index_dirty_reset()
+{
+   // Called once the index is known to be up to date for all directories.
+   XrdOssDF *fp = index_open(s_dirty_path, true);
+   if ( ! fp)
+   {
+      index_disable("can not create the list of dirty directories");
+      return false;
+   }
+
+   XrdSysCondVarHelper _lock(&m_dirty_cond);
+   while (m_dirty_syncing)
+      m_dirty_cond.Wait();
+   if (m_dirty_file)
+   {
+      m_dirty_file->Close();
+      delete m_dirty_file;
+   }
+   m_dirty_file   = fp;
+   m_dirty_size   = 0;
+   m_dirty_failed = false;
+   m_dirty.clear();
+   m_dirty_queue.clear();
+   m_dirty_synced = m_dirty_batch++;
+   m_dirty_on     = true;
+   m_dirty_cond.Broadcast();
+   return true;
+}
+
+void ResourceMonitor::index_dirty_commit()
+{
+   static const char *trc_pfx = "index_dirty_commit() ";
+
+   // Called with m_dirty_cond locked and no write in progress. Writes out the
+   // queued directories with a single fsync; the lock is dropped meanwhile so
+   // that further directories can queue up for the next batch.
+   std::string buf;
+   buf.swap(m_dirty_queue);
+   long long  batch = m_dirty_batch++;
+   long long  off   = m_dirty_size;
+   XrdOssDF  *fp    = m_dirty_file;
+   m_dirty_syncing  = true;
+
+   m_dirty_cond.UnLock();
+   bool ok = fp->Write(buf.data(), off, buf.size()) == (ssize_t) buf.size() &&
+             fp->Fsync() == XrdOssOK;
+   m_dirty_cond.Lock();
+
+   m_dirty_syncing = false;
+   if (ok)
+   {
+      m_dirty_size  += buf.size();
+      m_dirty_synced = batch;
+   }
+   else
+   {
+      // The index can not be trusted after a restart anymore. Remove it now;
+      // the monitor thread turns it off.
+      TRACE(Error, trc_pfx << "can not record dirty directories");
+      m_oss.Unlink(s_index_path);
+      m_dirty_failed = true;
+      m_dirty_on     = false;
+   }
+   m_dirty_cond.Broadcast();
+}
+
+void ResourceMonitor::index_dirty_update()
+{
+   // Runs after the index file caught up with the processed queues. Drop the
+   // directories that have no opens pending in the queues and no open files;
+   // the index file now reflects them.
+   std::vector<std::string> idle;
+   {
+      XrdSysCondVarHelper _lock(&m_dirty_cond);
+      if (m_dirty_failed)
+      {
+         _lock.UnLock();
+         index_disable("write to the list of dirty directories failed");
+         return;
+      }
+      for (auto &[dir, dd] : m_dirty)
+      {
+         if (dd.m_pending == 0)
+            idle.push_back(dir);
+      }
+   }
+   if (idle.empty())
+      return;
+   {
+      XrdSysMutexHelper _lock(&m_index_mutex);
+      idle.erase(std::remove_if(idle.begin(), idle.end(),
+                                [&](const std::string &dir) { return m_index.HasOpenIn(dir); }),
+                 idle.end());
+   }
+   if (idle.empty())
+      return;
+
+   XrdSysCondVarHelper _lock(&m_dirty_cond);
+   while (m_dirty_syncing)
+      m_dirty_cond.Wait();
+   if (m_dirty_failed)
+      return;
+   bool changed = false;
+   for (auto &dir : idle)
+   {
+      auto it = m_dirty.find(dir);
+      if (it != m_dirty.end() && it->second.m_pending == 0)
+      {
+         m_dirty.erase(it);
+         changed = true;
+      }
+   }
+   if ( ! changed)
+      return;
+
+   // Rewrite the list in place. Should we die halfway, the file still lists
+   // every directory that is dirty, possibly along with some that are not.
+   // The directories queued for the next batch are written out as well.
+   std::string buf;
+   for (auto &[dir, dd] : m_dirty)
+   {
+      buf += dir;
+      buf += '\n';
+   }
+   if ((! buf.empty() && m_dirty_file->Write(buf.data(), 0, buf.size()) != (ssize_t) buf.size()) ||
+       m_dirty_file->Ftruncate(buf.size()) != XrdOssOK || m_dirty_file->Fsync() != XrdOssOK)
+   {
+      _lock.UnLock();
+      index_disable("write to the list of dirty directories failed");
+      return;
+   }
+   m_dirty_size = buf.size();
+   m_dirty_queue.clear();
+   m_dirty_synced = m_dirty_batch++;
+   m_dirty_cond.Broadcast();
+}
+
+void ResourceMonitor::index_fill_dirstates()
+{
+   // Index entries are sorted by LFN so files of a directory come in a row.
+   std::string  dir;
+   DirState    *ds = nullptr;
+
+   for (auto & [lfn, e] : m_index.RefMap())
+   {
+      size_t dlen = lfn.rfind('/') + 1;
+      if ( ! ds || dir.size() != dlen || lfn.compare(0, dlen, dir) != 0)
+      {
+         dir.assign(lfn, 0, dlen);
+         ds = m_fs_state.find_dirstate_for_lfn(lfn);
+         ds->m_scanned = true;
+      }
+      ds->m_here_usage.m_StBlocks += e.m_StBlocks;
+      ds->m_here_usage.m_NFiles   += 1;
+   }
+}
+
+bool ResourceMonitor::index_write_snapshot()
+{
+   // The snapshot is written to a new file which then replaces the current
+   // one. Oss renames do not replace existing files so the current file is
+   // removed first; index_load() picks up the new file if we die in between.
+
+   XrdOssDF *fp = index_open(s_index_new_path, true);
+   if ( ! fp)
+   {
+      index_disable("can not create the index snapshot");
+      return false;
+   }
+
+   long long off = 0;
+   bool      ok;
+   {
+      XrdSysMutexHelper _lock(&m_index_mutex);
+      m_index.RefJournal().clear();
+      ok = m_index.Snapshot([&](const char *buf, size_t len) {
+         if (fp->Write(buf, off, len) != (ssize_t) len) return false;
+         off += len;
+         return true;
+      });
+   }
+   ok = ok && fp->Fsync() == XrdOssOK;
+   fp->Close();
+   delete fp;
+
+   if (m_index_file)
+   {
+      m_index_file->Close();
+      delete m_index_file;
+      m_index_file = nullptr;
+   }
+   if ( ! ok)
+   {
+      index_disable("writing of the index snapshot failed");
+      return false;
+   }
+
+   m_oss.Unlink(s_index_path);
+   if (m_oss.Rename(s_index_new_path, s_index_path) != XrdOssOK ||
+       ! (m_index_file = index_open(s_index_path, false)))
+   {
+      index_disable("can not install the index snapshot");
+      return false;
+   }
+
+   XrdSysMutexHelper _lock(&m_index_mutex);
+   m_index_size = off;
+   m_index_on   = true;
+   return true;
+}
+
+void ResourceMonitor::index_process_queues()
+{
+   // A purge reported in the same batch as an open of the same file is
+   // ambiguous as the order of the two is not known: the file could have
+   // been removed and then created anew or opened and then removed. Check
+   // if the file exists to tell.
+   std::set<std::string> opened;
+   const bool check_opened = ! m_file_purge_q3.read_queue_empty();
+
+   {
+      XrdSysCondVarHelper _lock(&m_dirty_cond);
+      for (auto &i : m_file_open_q.read_queue())
+      {
+         const std::string &lfn = token(i.id).m_filename;
+         auto it = m_dirty.find(lfn.substr(0, lfn.rfind('/') + 1));
+         if (it != m_dirty.end() && it->second.m_pending > 0)
+            --it->second.m_pending;
+      }
+   }
+
+   XrdSysMutexHelper _lock(&m_index_mutex);
+
+   for (auto &i : m_file_open_q.read_queue())
+   {
+      AccessToken &at = token(i.id);
+      m_index.Open(at.m_filename, i.record.m_st_blocks, i.record.m_open_time);
+      if (check_opened)
+         opened.insert(at.m_filename);
+   }
+   for (auto &i : m_file_update_stats_q.read_queue())
+   {
+      m_index.Grow(token(i.id).m_filename, i.record.m_StBlocksAdded);
+   }
+   for (auto &i : m_file_close_q.read_queue())
+   {
+      m_index.Close(token(i.id).m_filename, i.record.m_close_time);
+   }
+   // Purges by DirState or directory path (queues 1 and 2) name no files and
+   // are not used for cached files.
+   for (auto &i : m_file_purge_q3.read_queue())
+   {
+      struct stat st;
+      if (opened.count(i.id) && m_oss.Stat(i.id.c_str(), &st) == XrdOssOK)
+         continue;
+      m_index.Purge(i.id, i.record);
+   }
+}
+
+void ResourceMonitor::index_flush()
+{
+   std::string journal;
+   long long   snapshot_size;
+   {
+      XrdSysMutexHelper _lock(&m_index_mutex);
+      journal.swap(m_index.RefJournal());
+      snapshot_size = m_index.SnapshotSize();
+   }
+   if ( ! journal.empty())
+   {
+      if (m_index_file->Write(journal.data(), m_index_size, journal.size()) != (ssize_t) journal.size() ||
+          m_index_file->Fsync() != XrdOssOK)
+      {
+         index_disable("write to the index file failed");
+         return;
+      }
+      m_index_size += journal.size();
+
+      // Compact once most of the file is superseded records.
+      if (m_index_size > 2 * snapshot_size + s_index_min_compact && ! index_write_snapshot())
+         return;
+   }
+
+   index_dirty_update();
+}
+
+void ResourceMonitor::index_disable(const char *reason)
+{
+   static const char *trc_pfx = "index_disable() ";
+
+   TRACE(Error, trc_pfx << reason << ", namespace index is off until restart, purge will traverse the namespace.");
+
+   if (m_index_file)
+   {
+      m_index_file->Close();
+      delete m_index_file;
+      m_index_file = nullptr;
+   }
+   // A partial index must not be used on the next startup.
+   m_oss.Unlink(s_index_path);
+   m_oss.Unlink(s_index_new_path);
+   m_oss.Unlink(s_dirty_path);
+
+   {
+      XrdSysCondVarHelper _lock(&m_dirty_cond);
+      m_dirty_on = false;
+      while (m_dirty_syncing)
+         m_dirty_cond.Wait();
+      if (m_dirty_file)
+      {
+         m_dirty_file->Close();
+         delete m_dirty_file;
+         m_dirty_file = nullptr;
+      }
+      m_dirty.clear();
+      m_dirty_queue.clear();
+      m_dirty_cond.Broadcast();
+   }
+
+   XrdSysMutexHelper _lock(&m_index_mutex);
+   m_index_on = false;
+   m_index.Clear();
+}
+
+bool ResourceMonitor::index_traverse(const std::string &root_path,
+                                     const std::function<void(const std::string&, const NsIndex::Entry&)> &func)
+{
+   // Should the index be turned off midway the traversal ends early, purge
+   // then works with the candidates found so far.
+   std::vector<std::pair<std::string, NsIndex::Entry>> chunk;
+   bool first = true;
+   do
+   {
+      {
+         XrdSysMutexHelper _lock(&m_index_mutex);
+         if ( ! m_index_on)
+            return ! first;
+         m_index.CopyUnder(root_path, first ? std::string() : chunk.back().first,
+                           s_index_traverse_chunk, chunk);
+      }
+      for (auto &[lfn, e] : chunk)
+         func(lfn, e);
+      first = false;
+   } while (chunk.size() == s_index_traverse_chunk);
+   return true;
+}
+
+void ResourceMonitor::index_forget(const std::string &lfn)
+{
+   XrdSysMutexHelper _lock(&m_index_mutex);
+   if (m_index_on)
+      m_index.Erase(lfn);
+}
+
+void ResourceMonitor::index_touch(const std::string &lfn)
+{
+   // The directory must be on record before the file is created or written
+   // to. Its open then drops the pending count again, see
+   // index_process_queues(). An open that fails midway leaves the directory
+   // dirty until the next restart, which only costs its rescan.
+   if ( ! m_dirty_on.load(std::memory_order_relaxed))
+      return;
+
+   std::string dir = lfn.substr(0, lfn.rfind('/') + 1);
+
+   XrdSysCondVarHelper _lock(&m_dirty_cond);
+   if ( ! m_dirty_file || m_dirty_failed)
+      return;
+
+   long long batch;
+   auto it = m_dirty.find(dir);
+   if (it != m_dirty.end())
+   {
+      ++it->second.m_pending;
+      batch = it->second.m_batch;
+   }
+   else
+   {
+      m_dirty_queue += dir;
+      m_dirty_queue += '\n';
+      batch = m_dirty_batch;
+      m_dirty.emplace(dir, DirtyDir{1, batch});
+   }
+
+   // Group commit: the first thread to find no write in progress writes out
+   // everything queued so far, the others wait for their batch to land.
+   while (batch > m_dirty_synced && m_dirty_file && ! m_dirty_failed)
+   {
+      if (m_dirty_syncing)
+         m_dirty_cond.Wait();
+      else
+         index_dirty_commit();
+   }
+}
+
 //------------------------------------------------------------------------------
 // Heart beat
 //------------------------------------------------------------------------------
@@ -466,6 +1096,9 @@ void ResourceMonitor::heart_beat()
          const char* dumpfile = "/pfc-stats/DirStat.json";
          ss.write_json_file(dumpfile, m_oss, false);
          m_fs_state.reset_sshot_stats(queue_swap_time);
+
+         // Write-queue depth and batching histograms go out on the same cadence.
+         Cache::GetInstance().ReportWriteQStats();
       }
 
       if (do_purge_check || do_purge_report || do_purge_cold_files)
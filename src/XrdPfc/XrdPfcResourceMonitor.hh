@@ -2,14 +2,19 @@
 #define __XRDPFC_RESOURCEMONITOR_HH__
 
 #include "XrdPfcStats.hh"
+#include "XrdPfcNsIndex.hh"
 
 #include "XrdSys/XrdSysPthread.hh"
 
+#include <atomic>
+#include <functional>
+#include <map>
 #include <string>
 #include <vector>
 #include <list>
 
 class XrdOss;
+class XrdOssDF;
 
 namespace XrdPfc {
 
@@ -87,8 +92,9 @@ class ResourceMonitor
    std::vector<int>         m_access_tokens_free_slots;
 
    struct OpenRecord {
-      time_t m_open_time;
-      bool   m_existing_file;
+      time_t    m_open_time;
+      long long m_st_blocks;
+      bool      m_existing_file;
    };
 
    struct CloseRecord {
@@ -135,6 +141,53 @@ class ResourceMonitor
    void cross_check_or_process_oob_lfn(const std::string &lfn, FsTraversal &fst);
    long long get_file_usage_bytes_to_remove(const DataFsPurgeshot &ps, long long previous_file_usage, int logLeve);
 
+   // Persistent namespace index, see XrdPfcNsIndex.hh. It is maintained by
+   // the monitor thread and read by the purge task, the mutex serializes the
+   // two. The index file is only accessed from the monitor thread.
+   NsIndex      m_index;
+   XrdSysMutex  m_index_mutex;
+   XrdOssDF    *m_index_file    = nullptr;
+   long long    m_index_size    = 0;     // bytes in the index file
+   bool         m_index_on      = false; // index is complete and being maintained
+   bool         m_index_seeding = false; // initial scan fills the index
+
+   // Directories in which files were opened, and so possibly created or
+   // grown, since the index last caught up with them. They are recorded in
+   // the dirty file before the files are touched and are rescanned when the
+   // index is loaded as the index can not be trusted for them after a crash.
+   // A directory is dropped once its open records made it to the index file
+   // and none of its files are open anymore.
+   // New directories are queued and written out in batches, one fsync per
+   // batch, by whichever opening thread finds no write in progress.
+   struct DirtyDir
+   {
+      int       m_pending;   // opens not yet processed by the monitor thread
+      long long m_batch;     // batch the directory was written out with
+   };
+   XrdSysCondVar                     m_dirty_cond{0};
+   std::map<std::string, DirtyDir>   m_dirty;
+   std::string                       m_dirty_queue;       // records of the batch being filled
+   long long                         m_dirty_batch   = 1; // number of the batch being filled
+   long long                         m_dirty_synced  = 0; // last batch that is on disk
+   bool                              m_dirty_syncing = false;
+   XrdOssDF                         *m_dirty_file = nullptr;
+   long long                         m_dirty_size = 0;
+   bool                              m_dirty_failed  = false;
+   std::atomic<bool>                 m_dirty_on{false};   // lock-free check for index_touch()
+
+   void index_seed_dir(const std::string &dir_path, FsTraversal &fst);
+   XrdOssDF* index_open(const char *path, bool create);
+   bool index_load();
+   bool index_reconcile();
+   bool index_dirty_reset();
+   void index_dirty_commit();
+   void index_dirty_update();
+   void index_fill_dirstates();
+   bool index_write_snapshot();
+   void index_process_queues();
+   void index_flush();
+   void index_disable(const char *reason);
+
 public:
    ResourceMonitor(XrdOss& oss);
    ~ResourceMonitor();
@@ -146,7 +199,7 @@ public:
 
    // --- Event registration
 
-   int register_file_open(const std::string& filename, time_t open_timestamp, bool existing_file) {
+   int register_file_open(const std::string& filename, time_t open_timestamp, long long st_blocks, bool existing_file) {
       // Simply return a token, we will resolve it in the actual processing of the queue.
       XrdSysMutexHelper _lock(&m_queue_mutex);
       int token_id;
@@ -160,7 +213,7 @@ public:
          m_access_tokens.push_back({filename, m_queue_swap_u1 - 1});
       }
 
-      m_file_open_q.push(token_id, {open_timestamp, existing_file});
+      m_file_open_q.push(token_id, {open_timestamp, st_blocks, existing_file});
       return token_id;
    }
 
@@ -237,6 +290,19 @@ public:
    // Interface to other part of XCache -- note the CamelCase() notation.
    void CrossCheckIfScanIsInProgress(const std::string &lfn, XrdSysCondVar &cond);
 
+   // --- Namespace index access, from the purge task and File::Open().
+
+   // Calls func for every indexed file at or below root_path. Returns false,
+   // without calling func, if the index is not in use. The files are copied
+   // out in chunks so func is called without holding the index.
+   bool index_traverse(const std::string &root_path,
+                       const std::function<void(const std::string&, const NsIndex::Entry&)> &func);
+   // Drops a file the purge task found to be missing.
+   void index_forget(const std::string &lfn);
+   // Records the directory of a file that is about to be opened, and maybe
+   // created, as dirty. Called from File::Open() before the file is touched.
+   void index_touch(const std::string &lfn);
+
    // main function, steers startup then enters heart_beat. does not die.
    void init_before_main();      // called from startup thread / configuration processing
    void main_thread_function();  // run in dedicated thread
@@ -51,6 +51,7 @@
 
 #include "XrdNet/XrdNetSecurity.hh"
 #include "XrdPss/XrdPss.hh"
+#include "XrdPss/XrdPssCoalesce.hh"
 #include "XrdPss/XrdPssTrace.hh"
 #include "XrdPss/XrdPssUrlInfo.hh"
 #include "XrdPss/XrdPssUtils.hh"
@@ -63,6 +64,7 @@
 #include "XrdOss/XrdOssError.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucExport.hh"
+#include "XrdOuc/XrdOucHash.hh"
 #include "XrdOuc/XrdOucPgrwUtils.hh"
 #include "XrdOuc/XrdOucPrivateUtils.hh"
 #include "XrdSec/XrdSecEntity.hh"
@@ -112,6 +114,8 @@ static XrdPssSys   XrdProxySS;
 
        XrdSecsssID  *idMapper = 0;    // -> Auth ID mapper
 
+       XrdPssCoalesce *coalP = 0;     // -> Read coalescer, if any
+
 static const char   *ofslclCGI = "ofs.lcl=1";
 
 static const char   *osslclCGI = "oss.lcl=1";
@@ -540,7 +544,20 @@ int XrdPssSys::Stat(const char *path, struct stat *buff, int Opts, XrdOucEnv *eP
 */
 int XrdPssSys::Stats(char *bp, int bl)
 {
-   return XrdPosixConfig::Stats("pss", bp, bl);
+   int n;
+
+// Without read coalescing, the posix layer has all the statistics
+//
+   if (!coalP) return XrdPosixConfig::Stats("pss", bp, bl);
+
+// If the caller wants the maximum length, then provide it
+//
+   if (!bl) return XrdPosixConfig::Stats("pss", bp, 0) + coalP->Stats(bp, 0);
+
+// Append the coalescing statistics
+//
+   n = XrdPosixConfig::Stats("pss", bp, bl);
+   return n + coalP->Stats(bp + n, bl - n);
 }
 
 /******************************************************************************/
@@ -900,6 +917,14 @@ int XrdPssFile::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &Env)
        if (fd < 0) return -errno;
       }
 
+// Reads of files opened for reading only may be coalesced with reads of
+// other clients of the same file.
+//
+   if (coalP && !rwMode)
+      {sfPath = strdup(path);
+       sfHash = XrdOucHashVal(path);
+      }
+
 // All done
 //
    return XrdOssOK;
@@ -936,6 +961,7 @@ int XrdPssFile::Close(long long *retsz)
 //
     rc = XrdPosixXrootd::Close(fd);
     fd = -1;
+    if (sfPath) {free(sfPath); sfPath = 0;}
     return (rc == 0 ? XrdOssOK : -errno);
 }
 
@@ -975,6 +1001,16 @@ ssize_t XrdPssFile::pgRead(void     *buffer,
 //
    psxOpts = (csvec ? XrdPosixExtra::forceCS : 0);
 
+// A coalesced read cannot carry the origin's checksums as the bytes may have
+// been fetched by somebody else, so we compute them from what we received.
+//
+   if (sfPath)
+      {bytes = coalP->Read(fd, sfPath, sfHash, (char *)buffer, offset, rdlen);
+       if (bytes > 0 && csvec)
+          XrdOucPgrwUtils::csCalc((const char *)buffer, offset, bytes, csvec);
+       return bytes;
+      }
+
 // Issue the pgread
 //
    if ((bytes = XrdPosixExtra::pgRead(fd,buffer,offset,rdlen,vecCS,psxOpts)) < 0)
@@ -1096,6 +1132,9 @@ ssize_t XrdPssFile::Read(void *buff, off_t offset, size_t blen)
 
      if (fd < 0) return (ssize_t)-XRDOSS_E8004;
 
+     if (sfPath) return coalP->Read(fd, sfPath, sfHash, (char *)buff,
+                                    offset, blen);
+
      return (retval = XrdPosixXrootd::Pread(fd, buff, blen, offset)) < 0
             ? (ssize_t)-errno : retval;
 }
@@ -1123,6 +1162,8 @@ ssize_t XrdPssFile::ReadV(XrdOucIOVec     *readV,     // In
 
     if (fd < 0) return (ssize_t)-XRDOSS_E8004;
 
+    if (sfPath) return coalP->ReadV(fd, sfPath, sfHash, readV, readCount);
+
     return (retval = XrdPosixXrootd::VRead(fd, readV, readCount)) < 0 ? (ssize_t)-errno : retval;;
 }
 
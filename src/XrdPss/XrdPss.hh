@@ -110,11 +110,12 @@ int     Write(XrdSfsAio *aiop);
          // Constructor and destructor
          XrdPssFile(const char *tid)
                    : XrdOssDF(tid, XrdOssDF::DF_isFile|XrdOssDF::DF_isProxy),
-                     rpInfo(0), tpcPath(0), entity(0) {}
+                     rpInfo(0), tpcPath(0), sfPath(0), sfHash(0), entity(0) {}
 
 virtual ~XrdPssFile() {if (fd >= 0) Close();
                        if (rpInfo) delete(rpInfo);
                        if (tpcPath) free(tpcPath);
+                       if (sfPath) free(sfPath);
                       }
 
 private:
@@ -132,6 +133,8 @@ struct tprInfo
       } *rpInfo;
 
       char         *tpcPath;
+      char         *sfPath;  // Read coalescing key, if coalescing applies
+unsigned long       sfHash;
 const XrdSecEntity *entity;
 };
 
@@ -207,6 +210,8 @@ static int          Streams;
 static int          Workers;
 static int          Trace;
 static int          dcaCTime;
+static long long    coalWindow; // Read coalescing window, 0 if off
+static int          coalMaxRd;  // Largest read that is coalesced
 
 static bool         xLfn2Pfn;
 static bool         dcaCheck;
@@ -237,5 +242,6 @@ int    xexp( XrdSysError *Eroute, XrdOucStream &Config);
 int    xperm(XrdSysError *errp,   XrdOucStream &Config);
 int    xpers(XrdSysError *errp,   XrdOucStream &Config);
 int    xorig(XrdSysError *errp,   XrdOucStream &Config);
+int    xcoal(XrdSysError *errp,   XrdOucStream &Config);
 };
 #endif
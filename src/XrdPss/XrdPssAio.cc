@@ -36,8 +36,14 @@
 #include "XrdPosix/XrdPosixXrootd.hh"
 #include "XrdPss/XrdPss.hh"
 #include "XrdPss/XrdPssAioCB.hh"
+#include "XrdPss/XrdPssCoalesce.hh"
 #include "XrdSfs/XrdSfsAio.hh"
 
+namespace XrdProxy
+{
+extern XrdPssCoalesce *coalP;
+}
+
 // All AIO interfaces are defined here.
  
 /******************************************************************************/
@@ -76,8 +82,26 @@ int XrdPssFile::Fsync(XrdSfsAio *aiop)
   
 int XrdPssFile::pgRead(XrdSfsAio* aiop, uint64_t opts)
 {
+
+// A read joining a coalesced flight is synchronous, see Read() below
+//
+   XrdPssCoalesce::Flight *flight = 0;
+   if (sfPath
+   &&  XrdProxy::coalP->Start(sfPath, sfHash, (char *)aiop->sfsAio.aio_buf,
+                              (off_t)aiop->sfsAio.aio_offset,
+                              (size_t)aiop->sfsAio.aio_nbytes, flight)
+       == XrdPssCoalesce::aioJoin)
+      {aiop->Result = pgRead((void *)aiop->sfsAio.aio_buf,
+                             (off_t)aiop->sfsAio.aio_offset,
+                             (size_t)aiop->sfsAio.aio_nbytes,
+                             aiop->cksVec, opts);
+       aiop->doneRead();
+       return 0;
+      }
+
    XrdPssAioCB *aioCB = XrdPssAioCB::Alloc(aiop, false, true);
    uint64_t psxOpts = (aiop->cksVec ? XrdPosixExtra::forceCS : 0);
+   aioCB->flight = flight;
 
 // Execute this request in an asynchronous fashion
 //
@@ -165,12 +189,30 @@ int XrdPssFile::pgWrite(XrdSfsAio *aiop, uint64_t opts)
 int XrdPssFile::Read(XrdSfsAio *aiop)
 {
 
+// A read that overlaps another client's read in flight has to wait for it
+// to land, so it is done synchronously. Any other read stays asynchronous
+// and, if the window allows, leads a flight that later reads may join.
+//
+   XrdPssCoalesce::Flight *flight = 0;
+   if (sfPath
+   &&  XrdProxy::coalP->Start(sfPath, sfHash, (char *)aiop->sfsAio.aio_buf,
+                              (off_t)aiop->sfsAio.aio_offset,
+                              (size_t)aiop->sfsAio.aio_nbytes, flight)
+       == XrdPssCoalesce::aioJoin)
+      {aiop->Result = Read((void *)aiop->sfsAio.aio_buf,
+                           (off_t)aiop->sfsAio.aio_offset,
+                           (size_t)aiop->sfsAio.aio_nbytes);
+       aiop->doneRead();
+       return 0;
+      }
+
 // Execute this request in an asynchronous fashion
 //
+   XrdPssAioCB *aioCB = XrdPssAioCB::Alloc(aiop, false);
+   aioCB->flight = flight;
    XrdPosixXrootd::Pread(fd, (void *)aiop->sfsAio.aio_buf,
                              (size_t)aiop->sfsAio.aio_nbytes,
-                             (off_t)aiop->sfsAio.aio_offset,
-                             XrdPssAioCB::Alloc(aiop, false));
+                             (off_t)aiop->sfsAio.aio_offset, aioCB);
    return 0;
 }
 
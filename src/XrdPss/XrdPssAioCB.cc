@@ -33,6 +33,11 @@
 #include "XrdPss/XrdPssAioCB.hh"
 #include "XrdSfs/XrdSfsAio.hh"
 
+namespace XrdProxy
+{
+extern XrdPssCoalesce *coalP;
+}
+
 /******************************************************************************/
 /*                        S t a t i c   M e m b e r s                         */
 /******************************************************************************/
@@ -62,6 +67,7 @@ XrdPssAioCB *XrdPssAioCB::Alloc(XrdSfsAio *aiop, bool isWr, bool pgrw)
    newCB->theAIOP = aiop;
    newCB->isWrite = isWr;
    newCB->isPGrw  = pgrw;
+   newCB->flight  = 0;
    return newCB;
 }
 
@@ -80,6 +86,14 @@ void XrdPssAioCB::Complete(ssize_t result)
 //           <<" result " <<result <<std::endl;
    theAIOP->Result = (result < 0 ? -errno : result);
 
+// Hand the data to the reads that joined our flight while the buffer is
+// still ours
+//
+   if (flight)
+      {XrdProxy::coalP->Landed(flight, theAIOP->Result);
+       flight = 0;
+      }
+
 // Perform post processing for pgRead or pgWrite if successful
 //
    if (isPGrw && result >= 0)
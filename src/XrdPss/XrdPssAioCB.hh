@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "XrdPosix/XrdPosixCallBack.hh"
+#include "XrdPss/XrdPssCoalesce.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
 class XrdSfsAio;
@@ -52,8 +53,10 @@ static  void         SetMax(int mval) {maxFree = mval;}
 
 std::vector<uint32_t> csVec;
 
+XrdPssCoalesce::Flight *flight;  // Coalesced flight led by this read, if any
+
 private:
-             XrdPssAioCB() : theAIOP(0), isWrite(false) {}
+             XrdPssAioCB() : flight(0), theAIOP(0), isWrite(false) {}
 virtual     ~XrdPssAioCB() {}
 
 static  XrdSysMutex  myMutex;
@@ -0,0 +1,356 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d P s s C o a l e s c e . c c                      */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdPosix/XrdPosixXrootd.hh"
+#include "XrdPss/XrdPssCoalesce.hh"
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdPssCoalesce::XrdPssCoalesce(long long window, int maxread)
+                              : maxWindow(window), maxRead(maxread),
+                                inFlight(0), numLead(0), numJoin(0),
+                                numSkip(0), bytesSaved(0)
+{
+}
+
+/******************************************************************************/
+/*                                  R e a d                                   */
+/******************************************************************************/
+
+ssize_t XrdPssCoalesce::Read(int fd, const char *path, unsigned long hval,
+                             char *buff, off_t offset, size_t blen)
+{
+   Bucket &bkt = BucketOf(hval);
+   Flight *fP, myFlight;
+
+// If nothing we need is in flight, then we go upstream ourselves, letting
+// others join us if the window allows it.
+//
+   bkt.mtx.Lock();
+   if (!(fP = Find(bkt, path, offset, blen)))
+      {bool shared = Lead(bkt, myFlight, path, buff, offset, blen);
+       bkt.mtx.UnLock();
+       ssize_t rc = Pread(fd, buff, blen, offset);
+       if (shared) Land(bkt, myFlight, rc);
+       return rc;
+      }
+
+// Join the flight for the overlapping bytes. Whatever lies before and after
+// it we read ourselves, possibly joining other flights, while we wait.
+//
+   XrdSysSemaphore mySem(0);
+   Waiter myWait;
+   off_t  endOff = offset + blen;
+   off_t  jBeg   = std::max(offset, fP->offset);
+   off_t  jEnd   = std::min(endOff, (off_t)(fP->offset + fP->blen));
+   Join(*fP, myWait, buff + (jBeg - offset), jBeg, jEnd - jBeg, &mySem);
+   bkt.mtx.UnLock();
+
+   ssize_t head = 0, tail = 0;
+   if (jBeg > offset) head = Read(fd, path, hval, buff, offset, jBeg - offset);
+   if (jEnd < endOff) tail = Read(fd, path, hval, buff + (jEnd - offset),
+                                  jEnd, endOff - jEnd);
+   mySem.Wait();
+
+// If the flight failed we don't know why, so try on our own
+//
+   if (myWait.result < 0)
+      myWait.result = Pread(fd, myWait.buff, myWait.blen, myWait.offset);
+      else bytesSaved += myWait.result;
+
+// Put together the result. A short segment means we hit the end of file and
+// anything after it is irrelevant.
+//
+   if (head < 0) return head;
+   if (head < jBeg - offset) return head;
+   if (myWait.result < 0) return myWait.result;
+   if ((size_t)myWait.result < myWait.blen) return head + myWait.result;
+   if (tail < 0) return tail;
+   return head + myWait.result + tail;
+}
+
+/******************************************************************************/
+/*                                 R e a d V                                  */
+/******************************************************************************/
+
+ssize_t XrdPssCoalesce::ReadV(int fd, const char *path, unsigned long hval,
+                              XrdOucIOVec *readV, int readCount)
+{
+   Bucket &bkt = BucketOf(hval);
+   XrdSysSemaphore mySem(0);
+   std::vector<XrdOucIOVec> ownV;
+   std::vector<Flight> myFlights(readCount);
+   std::vector<Waiter> myWaits(readCount);
+   std::vector<bool>   shared(readCount, false);
+   int nWait = 0;
+
+// Segments entirely covered by a flight are taken from it, the rest go out
+// in a single vector read that others may join segment by segment. We do
+// not split segments here, a vector read is usually made of small ones.
+//
+   ownV.reserve(readCount);
+   bkt.mtx.Lock();
+   for (int i = 0; i < readCount; i++)
+       {Flight *fP = Find(bkt, path, readV[i].offset, readV[i].size);
+        if (fP && fP->offset <= readV[i].offset
+        &&  fP->offset + (off_t)fP->blen >= readV[i].offset + readV[i].size)
+           {Join(*fP, myWaits[nWait++], readV[i].data, readV[i].offset,
+                 readV[i].size, &mySem);
+            continue;
+           }
+        ownV.push_back(readV[i]);
+        if (!fP) shared[ownV.size()-1] = Lead(bkt, myFlights[ownV.size()-1],
+                                              path, readV[i].data,
+                                              readV[i].offset, readV[i].size);
+       }
+   bkt.mtx.UnLock();
+
+// Issue our part of the request. A vector read succeeds only as a whole so
+// the flights either all landed or all failed.
+//
+   ssize_t total = 0;
+   if (!ownV.empty())
+      {long long want = 0;
+       for (auto &v : ownV) want += v.size;
+       total = XrdPosixXrootd::VRead(fd, ownV.data(), ownV.size());
+       if (total < 0) total = -errno;
+       for (size_t i = 0; i < ownV.size(); i++)
+           if (shared[i]) Land(bkt, myFlights[i],
+                               (total == want ? ownV[i].size : -EIO));
+      }
+
+// Collect what the other flights brought us, re-reading anything that did
+// not fully arrive.
+//
+   for (int i = 0; i < nWait; i++)
+       {mySem.Wait();}
+   for (int i = 0; i < nWait; i++)
+       {Waiter &w = myWaits[i];
+        if (w.result != (ssize_t)w.blen)
+           w.result = Pread(fd, w.buff, w.blen, w.offset);
+           else bytesSaved += w.result;
+        if (total >= 0) total = (w.result < 0 ? w.result : total + w.result);
+       }
+   return total;
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+
+XrdPssCoalesce::AioMode XrdPssCoalesce::Start(const char *path,
+                                              unsigned long hval, char *buff,
+                                              off_t offset, size_t blen,
+                                              Flight *&fP)
+{
+   Bucket &bkt = BucketOf(hval);
+   Flight *newFlight = new Flight;
+
+// A read overlapping a flight must wait for it, the caller does that with a
+// synchronous Read(). Otherwise the read leads a flight if the window allows.
+//
+   bkt.mtx.Lock();
+   if (Find(bkt, path, offset, blen))
+      {bkt.mtx.UnLock();
+       delete newFlight;
+       fP = 0;
+       return aioJoin;
+      }
+   if (!Lead(bkt, *newFlight, path, buff, offset, blen))
+      {bkt.mtx.UnLock();
+       delete newFlight;
+       fP = 0;
+       return aioSkip;
+      }
+   newFlight->hval = hval;
+   bkt.mtx.UnLock();
+
+   fP = newFlight;
+   return aioLead;
+}
+
+/******************************************************************************/
+/*                                L a n d e d                                 */
+/******************************************************************************/
+
+// Completes an asynchronous flight started by Start().
+//
+void XrdPssCoalesce::Landed(Flight *fP, ssize_t result)
+{
+   Land(BucketOf(fP->hval), *fP, result);
+   delete fP;
+}
+
+/******************************************************************************/
+/*                                 S t a t s                                  */
+/******************************************************************************/
+
+int XrdPssCoalesce::Stats(char *buff, int blen)
+{
+   static const char statfmt[] = "<stats id=\"coalesce\">"
+          "<lead>%lld</lead><join>%lld</join><skip>%lld</skip>"
+          "<saved>%lld</saved><window>%lld</window></stats>";
+
+// If the caller wants the maximum length, then provide it
+//
+   if (!blen) return sizeof(statfmt) + (5*20);
+
+// Format the statistics
+//
+   int n = snprintf(buff, blen, statfmt,
+                    numLead.load(), numJoin.load(), numSkip.load(),
+                    bytesSaved.load(), maxWindow);
+   return (n < blen ? n : 0);
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                  F i n d                                   */
+/******************************************************************************/
+
+// Returns the first flight of the same file that overlaps the byte range. The
+// bucket must be locked.
+//
+XrdPssCoalesce::Flight *XrdPssCoalesce::Find(Bucket &bkt, const char *path,
+                                             off_t offset, size_t blen)
+{
+   for (Flight *fP = bkt.first; fP; fP = fP->next)
+       if (fP->offset < offset + (off_t)blen
+       &&  offset < fP->offset + (off_t)fP->blen
+       &&  !strcmp(fP->path, path)) return fP;
+   return 0;
+}
+
+/******************************************************************************/
+/*                                  J o i n                                   */
+/******************************************************************************/
+
+// Adds a waiter to a flight. The bucket must be locked.
+//
+void XrdPssCoalesce::Join(Flight &flt, Waiter &w, char *buff, off_t offset,
+                          size_t blen, XrdSysSemaphore *sem)
+{
+   w.buff   = buff;
+   w.offset = offset;
+   w.blen   = blen;
+   w.result = -EIO;
+   w.sem    = sem;
+   w.next   = flt.waiters;
+   flt.waiters = &w;
+   numJoin++;
+}
+
+/******************************************************************************/
+/*                                  L e a d                                   */
+/******************************************************************************/
+
+// Registers a flight if it fits the window. The bucket must be locked.
+//
+bool XrdPssCoalesce::Lead(Bucket &bkt, Flight &flt, const char *path,
+                          char *buff, off_t offset, size_t blen)
+{
+   if (blen > maxRead || bkt.count >= maxFlights)
+      {numSkip++;
+       return false;
+      }
+
+   if (inFlight.fetch_add(blen) + (long long)blen > maxWindow)
+      {inFlight -= blen;
+       numSkip++;
+       return false;
+      }
+
+   flt.hval    = 0;
+   flt.path    = path;
+   flt.buff    = buff;
+   flt.offset  = offset;
+   flt.blen    = blen;
+   flt.waiters = 0;
+   flt.next    = bkt.first;
+   bkt.first   = &flt;
+   bkt.count++;
+   numLead++;
+   return true;
+}
+
+/******************************************************************************/
+/*                                  L a n d                                   */
+/******************************************************************************/
+
+// Removes a flight from its bucket and hands its data to the waiters. This
+// must be called before the leader's buffer goes out of scope.
+//
+void XrdPssCoalesce::Land(Bucket &bkt, Flight &flt, ssize_t result)
+{
+   Waiter *wP, *wNext;
+
+// Once unlinked nobody else can join, so the waiter list is ours
+//
+   bkt.mtx.Lock();
+   Flight **pP = &bkt.first;
+   while(*pP != &flt) pP = &(*pP)->next;
+   *pP = flt.next;
+   bkt.count--;
+   bkt.mtx.UnLock();
+   inFlight -= flt.blen;
+
+// A short read means end of file, each waiter gets what lies before it
+//
+   for (wP = flt.waiters; wP; wP = wNext)
+       {wNext = wP->next;
+        if (result < 0) wP->result = result;
+           else {off_t  skip = wP->offset - flt.offset;
+                 size_t have = (result > skip ? result - skip : 0);
+                 if (have > wP->blen) have = wP->blen;
+                 if (have) memcpy(wP->buff, flt.buff + skip, have);
+                 wP->result = have;
+                }
+        wP->sem->Post();
+       }
+}
+
+/******************************************************************************/
+/*                                 P r e a d                                  */
+/******************************************************************************/
+
+ssize_t XrdPssCoalesce::Pread(int fd, char *buff, size_t blen, off_t offset)
+{
+   ssize_t rc = XrdPosixXrootd::Pread(fd, buff, blen, offset);
+   return (rc < 0 ? (ssize_t)-errno : rc);
+}
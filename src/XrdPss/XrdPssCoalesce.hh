@@ -0,0 +1,134 @@
+#ifndef __PSS_COALESCE_HH__
+#define __PSS_COALESCE_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d P s s C o a l e s c e . h h                      */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <atomic>
+#include <sys/types.h>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+struct XrdOucIOVec;
+
+/******************************************************************************/
+/*                        X r d P s s C o a l e s c e                         */
+/******************************************************************************/
+
+// This class implements single-flight reads for a proxy without a disk cache.
+// Every upstream read is registered as a "flight" keyed by the file's logical
+// path and byte range. A read that overlaps a flight already on its way does
+// not go upstream for the overlapping bytes; it waits for the flight to land
+// and receives a copy of them, reading only what is not covered on its own.
+// Flights are served straight out of the leader's buffer before the leader
+// returns, so no data is staged. The window bounds the bytes that may be in
+// flight and shareable at any one time; reads larger than maxRead or over the
+// window simply bypass the mechanism.
+//
+// Asynchronous reads are started with Start(). Only a read that overlaps a
+// flight has to wait and is done synchronously with Read(). Any other read
+// stays asynchronous; if it leads a flight the completion must call Landed()
+// before the read's buffer is handed back.
+//
+class XrdPssCoalesce
+{
+public:
+
+// A read waiting on a flight and an upstream read open to sharing
+//
+struct Waiter
+      {Waiter          *next;
+       char            *buff;
+       off_t            offset;
+       size_t           blen;
+       ssize_t          result;
+       XrdSysSemaphore *sem;
+      };
+
+struct Flight
+      {Flight          *next;
+       unsigned long    hval;
+       const char      *path;
+       char            *buff;
+       off_t            offset;
+       size_t           blen;
+       Waiter          *waiters;
+      };
+
+enum    AioMode {aioSkip = 0, // Not shareable, read asynchronously
+                 aioLead,     // Read asynchronously, then call Landed()
+                 aioJoin      // Overlaps a flight, use Read()
+                };
+
+ssize_t Read (int fd, const char *path, unsigned long hval,
+              char *buff, off_t offset, size_t blen);
+
+AioMode Start(const char *path, unsigned long hval,
+              char *buff, off_t offset, size_t blen, Flight *&fP);
+
+void    Landed(Flight *fP, ssize_t result);
+
+ssize_t ReadV(int fd, const char *path, unsigned long hval,
+              XrdOucIOVec *readV, int readCount);
+
+int     Stats(char *buff, int blen);
+
+        XrdPssCoalesce(long long window, int maxread);
+       ~XrdPssCoalesce() {}
+
+private:
+
+static const int nBuckets = 64;
+static const int maxFlights = 256;  // Per bucket
+
+struct alignas(64) Bucket
+      {XrdSysMutex      mtx;
+       Flight          *first;
+       int              count;
+                        Bucket() : first(0), count(0) {}
+      };
+
+Bucket &BucketOf(unsigned long hval) {return bucket[hval % nBuckets];}
+Flight *Find(Bucket &bkt, const char *path, off_t offset, size_t blen);
+void    Join(Flight &flt, Waiter &w, char *buff, off_t offset, size_t blen,
+             XrdSysSemaphore *sem);
+bool    Lead(Bucket &bkt, Flight &flt, const char *path, char *buff,
+             off_t offset, size_t blen);
+void    Land(Bucket &bkt, Flight &flt, ssize_t result);
+ssize_t Pread(int fd, char *buff, size_t blen, off_t offset);
+
+Bucket                 bucket[nBuckets];
+long long              maxWindow;
+size_t                 maxRead;
+std::atomic<long long> inFlight;
+
+std::atomic<long long> numLead;     // Upstream reads open to sharing
+std::atomic<long long> numJoin;     // Reads (or parts) served by another flight
+std::atomic<long long> numSkip;     // Reads that bypassed the window
+std::atomic<long long> bytesSaved;  // Bytes not fetched upstream
+};
+#endif
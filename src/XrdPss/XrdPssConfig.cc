@@ -45,6 +45,7 @@
 #include "XrdNet/XrdNetSecurity.hh"
 
 #include "XrdPss/XrdPss.hh"
+#include "XrdPss/XrdPssCoalesce.hh"
 #include "XrdPss/XrdPssTrace.hh"
 #include "XrdPss/XrdPssUrlInfo.hh"
 #include "XrdPss/XrdPssUtils.hh"
@@ -109,6 +110,8 @@ int          XrdPssSys::Streams   =512;
 int          XrdPssSys::Workers   = 16;
 int          XrdPssSys::Trace     =  0;
 int          XrdPssSys::dcaCTime  =  0;
+long long    XrdPssSys::coalWindow=  0;
+int          XrdPssSys::coalMaxRd =  0;
 
 bool         XrdPssSys::xLfn2Pfn  = false;
 bool         XrdPssSys::dcaCheck  = false;
@@ -128,6 +131,8 @@ extern XrdOucEnv       *envP;
 
 extern XrdSecsssID     *idMapper; // -> Auth ID mapper
 
+extern XrdPssCoalesce  *coalP;    // -> Read coalescer, if any
+
 extern int              rpFD;
 
 extern bool             idMapAll;
@@ -239,6 +244,17 @@ int XrdPssSys::Configure(const char *cfn, XrdOucEnv *envP)
 //
    if(psxConfig->hasCache()) myFeatures |= XRDOSS_HASCACH;
 
+// Read coalescing only makes sense when there is no cache in front of the
+// origin, a cache already merges concurrent reads of the same blocks.
+//
+   if (coalWindow)
+      {if (psxConfig->hasCache())
+          {eDest.Say("Config warning: ignoring 'pss.coalesce'; "
+                     "a cache is configured.");
+           coalWindow = 0;
+          } else coalP = new XrdPssCoalesce(coalWindow, coalMaxRd);
+      }
+
 // If we need to reproxy, then open the directory where the reproxy information
 // will ne placed. The path is in the Env.
 //
@@ -500,6 +516,7 @@ int XrdPssSys::ConfigXeq(char *var, XrdOucStream &Config)
    TS_PSX("cachelib",      ParseCLib);
    TS_PSX("ccmlib",        ParseMLib);
    TS_PSX("ciosync",       ParseCio);
+   TS_Xeq("coalesce",      xcoal);
    TS_Xeq("config",        xconf);
    TS_Xeq("dca",           xdca);
    TS_Xeq("defaults",      xdef);
@@ -640,6 +657,62 @@ int XrdPssSys::xdca(XrdSysError *errp, XrdOucStream &Config)
    return 0;
 }
   
+/******************************************************************************/
+/*                                 x c o a l                                  */
+/******************************************************************************/
+
+/* Function: xcoal
+
+   Purpose:  To parse the directive: coalesce {off | [window <sz>] [maxrd <sz>]}
+
+             off       do not coalesce reads (the default).
+             window    the maximum number of bytes being read upstream that
+                       may be shared at any one time. The default is 64m.
+             maxrd     the largest read that is shared; larger ones always go
+                       upstream on their own. The default is 8m.
+
+   Output: 0 upon success or 1 upon failure.
+*/
+
+int XrdPssSys::xcoal(XrdSysError *errp, XrdOucStream &Config)
+{
+    long long llval;
+    char *val;
+
+// Preset the defaults
+//
+   coalWindow = 64*1024*1024;
+   coalMaxRd  =  8*1024*1024;
+
+// Process the options
+//
+   while((val = Config.GetWord()))
+        {     if (!strcmp(val, "off")) coalWindow = 0;
+         else if (!strcmp(val, "window") || !strcmp(val, "maxrd"))
+                 {bool isWin = *val == 'w';
+                  if (!(val = Config.GetWord()))
+                     {errp->Emsg("Config", "coalesce", (isWin ? "window" : "maxrd"),
+                                 "value not specified");
+                      return 1;
+                     }
+                  if (isWin)
+                     {if (XrdOuca2x::a2sz(*errp, "coalesce window", val,
+                                          &llval, 65536)) return 1;
+                      coalWindow = llval;
+                     } else {
+                      if (XrdOuca2x::a2sz(*errp, "coalesce maxrd", val,
+                                          &llval, 1, 0x7fffffff)) return 1;
+                      coalMaxRd = static_cast<int>(llval);
+                     }
+                 }
+         else {errp->Emsg("Config","invalid coalesce option -", val); return 1;}
+        }
+
+// All done
+//
+   return 0;
+}
+
 /******************************************************************************/
 /*                                  x d e f                                   */
 /******************************************************************************/
@@ -2,17 +2,19 @@
 #include "XrdAcc/XrdAccAuthorize.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucGatherConf.hh"
-#include "XrdOuc/XrdOucPrivateUtils.hh"
 #include "XrdSec/XrdSecEntity.hh"
 #include "XrdSec/XrdSecEntityAttr.hh"
 #include "XrdSys/XrdSysLogger.hh"
 #include "XrdTls/XrdTlsContext.hh"
 #include "XrdVersion.hh"
 
+#include <chrono>
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <sstream>
 #include <fstream>
@@ -25,8 +27,11 @@
 #include "picojson.h"
 
 #include "scitokens/scitokens.h"
+#include "XrdSciTokens/XrdSciTokensCache.hh"
 #include "XrdSciTokens/XrdSciTokensHelper.hh"
+#include "XrdSciTokens/XrdSciTokensKeys.hh"
 #include "XrdSciTokens/XrdSciTokensMon.hh"
+#include "XrdSciTokens/XrdSciTokensPathTrie.hh"
 
 // The status-quo to retrieve the default object is to copy/paste the
 // linker definition and invoke directly.
@@ -350,11 +355,10 @@ protected:
 class XrdAccRules
 {
 public:
-    XrdAccRules(uint64_t expiry_time, const std::string &username, const std::string &token_subject,
+    XrdAccRules(const std::string &username, const std::string &token_subject,
         const std::string &issuer, const std::vector<MapRule> &rules, const std::vector<std::string> &groups,
         uint32_t authz_strategy) :
         m_authz_strategy(authz_strategy),
-        m_expiry_time(expiry_time),
         m_username(username),
         m_token_subject(token_subject),
         m_issuer(issuer),
@@ -364,35 +368,17 @@ public:
 
     ~XrdAccRules() {}
 
-    bool apply(Access_Operation oper, std::string path) {
-      for (const auto & rule : m_rules) {
-        // Skip rules that don't match the current operation
-        if (rule.first != oper)
-          continue;
-
-        // If the rule allows any path, allow the operation
-        if (rule.second == "/")
-          return true;
-
-        // Allow operation if path is a subdirectory of the rule's path
-        if (is_subdirectory(rule.second, path)) {
-          return true;
-        } else {
-          // Allow stat and mkdir of parent directories to comply with WLCG token specs
-          if (oper == AOP_Stat || oper == AOP_Mkdir)
-            if (is_subdirectory(path, rule.second))
-              return true;
-        }
-      }
-      return false;
+    // Allow the operation if the path is a subdirectory of a rule's path for it
+    // or, for stat and mkdir, a parent of one to comply with WLCG token specs.
+    bool apply(Access_Operation oper, const char *path) const {
+        return m_trie.Allowed(oper, path);
     }
 
-    bool expired() const {return monotonic_time() > m_expiry_time;}
-
     void parse(const AccessRulesRaw &rules) {
         m_rules.reserve(rules.size());
         for (const auto &entry : rules) {
             m_rules.emplace_back(entry.first, entry.second);
+            m_trie.Add(entry.first, entry.second);
         }
     }
 
@@ -442,7 +428,7 @@ public:
 private:
     uint32_t m_authz_strategy;
     AccessRulesRaw m_rules;
-    uint64_t m_expiry_time{0};
+    XrdSciTokensPathTrie m_trie;
     const std::string m_username;
     const std::string m_token_subject;
     const std::string m_issuer;
@@ -469,8 +455,11 @@ public:
     XrdAccSciTokens(XrdSysLogger *lp, const char *parms, XrdAccAuthorize* chain, XrdOucEnv *envP) :
         m_chain(chain),
         m_parms(parms ? parms : ""),
-        m_next_clean(monotonic_time() + m_expiry_secs),
-        m_log(lp, "scitokens_")
+        m_log(lp, "scitokens_"),
+        m_keys([this](const std::string &issuer, const std::string &jwks_file)
+               {return FetchKeys(issuer, jwks_file);}, 300, 10,
+               [this](const std::string &issuer)
+               {return HasCachedKeys(issuer);})
     {
         pthread_rwlock_init(&m_config_lock, nullptr);
         m_config_lock_initialized = true;
@@ -478,9 +467,24 @@ public:
         if (!Config(envP)) {
             throw std::runtime_error("Failed to configure SciTokens authorization.");
         }
+        // Give the issuers' keys a chance to arrive before the first request
+        m_keys.Start();
+        if (!m_keys.WaitTried(std::chrono::seconds(m_key_wait_secs))) {
+            m_log.Log(LogMask::Warning, "Config", "Not all issuer keys could be fetched yet; continuing in the background");
+        }
+        m_maintenance = std::thread(&XrdAccSciTokens::Maintain, this);
     }
 
     virtual ~XrdAccSciTokens() {
+        m_keys.Stop();
+        if (m_maintenance.joinable()) {
+            {
+                std::lock_guard<std::mutex> guard(m_maint_mutex);
+                m_shutdown = true;
+            }
+            m_maint_cv.notify_all();
+            m_maintenance.join();
+        }
         if (m_config_lock_initialized) {
             pthread_rwlock_destroy(&m_config_lock);
         }
@@ -510,20 +514,13 @@ public:
             return OnMissing(Entity, path, oper, env);
         }
         m_log.Log(LogMask::Debug, "Access", "Trying token-based access control");
-        std::shared_ptr<XrdAccRules> access_rules;
+        const std::string token(authz);
         uint64_t now = monotonic_time();
-        Check(now);
-        {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            const auto iter = m_map.find(authz);
-            if (iter != m_map.end() && !iter->second->expired()) {
-                access_rules = iter->second;
-            }
-        }
+        std::shared_ptr<XrdAccRules> access_rules = m_cache.Find(token, now);
         if (!access_rules) {
             m_log.Log(LogMask::Debug, "Access", "Token not found in recent cache; parsing.");
+            uint64_t cache_expiry = 0;
             try {
-                uint64_t cache_expiry;
                 AccessRulesRaw rules;
                 std::string username;
                 std::string token_subject;
@@ -532,7 +529,7 @@ public:
                 std::vector<std::string> groups;
                 uint32_t authz_strategy;
                 if (GenerateAcls(authz, cache_expiry, rules, username, token_subject, issuer, map_rules, groups, authz_strategy)) {
-                    access_rules.reset(new XrdAccRules(now + cache_expiry, username, token_subject, issuer, map_rules, groups, authz_strategy));
+                    access_rules.reset(new XrdAccRules(username, token_subject, issuer, map_rules, groups, authz_strategy));
                     access_rules->parse(rules);
                 } else {
                     m_log.Log(LogMask::Warning, "Access", "Failed to generate ACLs for token");
@@ -545,8 +542,7 @@ public:
                 m_log.Log(LogMask::Warning, "Access", "Error generating ACLs for authorization", exc.what());
                 return OnMissing(Entity, path, oper, env);
             }
-            std::lock_guard<std::mutex> guard(m_mutex);
-            m_map[authz] = access_rules;
+            m_cache.Insert(token, access_rules, now + cache_expiry);
         } else if (m_log.getMsgMask() & LogMask::Debug) {
             m_log.Log(LogMask::Debug, "Access", "Cached token", access_rules->str().c_str());
         }
@@ -681,6 +677,10 @@ public:
         SciToken scitoken;
         char *err_msg;
         if (!strncmp(token, "Bearer%20", 9)) token += 9;
+        if (KeysPending(token)) {
+            emsg = "the token issuer's keys are not available yet";
+            return false;
+        }
         pthread_rwlock_rdlock(&m_config_lock);
         auto retval = scitoken_deserialize(token, &scitoken, &m_valid_issuers_array[0], &err_msg);
         pthread_rwlock_unlock(&m_config_lock);
@@ -753,6 +753,72 @@ private:
         return XrdAccPriv_None;
     }
 
+    // Refuse, rather than wait for, a token whose issuer's keys have not been
+    // fetched yet and are not in the library's key cache either; the refresher
+    // is asked to fetch them now. Tokens from issuers that are not configured
+    // are left for the library to reject.
+    bool KeysPending(const std::string &token)
+    {
+        std::string issuer;
+        if (!XrdSciTokensKeys::TokenIssuer(token, issuer) || !m_keys.Pending(issuer)) {
+            return false;
+        }
+        m_keys.Kick(issuer, XrdSciTokensKeys::Now());
+        m_log.Log(LogMask::Warning, "KeysPending", "Keys of the token issuer are not available yet:", issuer.c_str());
+        return true;
+    }
+
+    // Check whether the library's key cache already holds keys for an issuer,
+    // in which case tokens can be validated while the first fetch is pending.
+    bool HasCachedKeys(const std::string &issuer)
+    {
+        char *jwks = nullptr, *err_msg = nullptr;
+        if (keycache_get_cached_jwks(issuer.c_str(), &jwks, &err_msg)) {
+            free(err_msg);
+            return false;
+        }
+        picojson::value val;
+        bool found = jwks && picojson::parse(val, jwks).empty()
+                  && val.is<picojson::object>() && val.contains("keys")
+                  && val.get("keys").is<picojson::array>()
+                  && !val.get("keys").get<picojson::array>().empty();
+        free(jwks);
+        if (found) {
+            m_log.Log(LogMask::Info, "HasCachedKeys", "Using the cached keys of issuer", issuer.c_str());
+        }
+        return found;
+    }
+
+    // Called from the key refresher thread only.
+    bool FetchKeys(const std::string &issuer, const std::string &jwks_file)
+    {
+        char *err_msg = nullptr;
+        if (!jwks_file.empty()) {
+            std::ifstream in(jwks_file);
+            std::stringstream jwks;
+            jwks << in.rdbuf();
+            if (!in.is_open() || in.bad()) {
+                std::stringstream ss;
+                ss << "Unable to read the keys of issuer " << issuer << " from " << jwks_file << ": " << strerror(errno);
+                m_log.Log(LogMask::Warning, "FetchKeys", ss.str().c_str());
+                return false;
+            }
+            if (keycache_set_jwks(issuer.c_str(), jwks.str().c_str(), &err_msg)) {
+                std::stringstream ss;
+                ss << "Unable to load the keys of issuer " << issuer << " from " << jwks_file << ": " << err_msg;
+                m_log.Log(LogMask::Warning, "FetchKeys", ss.str().c_str());
+                free(err_msg);
+                return false;
+            }
+        } else if (keycache_refresh_jwks(issuer.c_str(), &err_msg)) {
+            m_log.Log(LogMask::Warning, "FetchKeys", "Unable to refresh the keys of issuer", issuer.c_str(), err_msg);
+            free(err_msg);
+            return false;
+        }
+        m_log.Log(LogMask::Debug, "FetchKeys", "Refreshed the keys of issuer", issuer.c_str());
+        return true;
+    }
+
     bool GenerateAcls(const std::string &authz, uint64_t &cache_expiry, AccessRulesRaw &rules, std::string &username, std::string &token_subject, std::string &issuer, std::vector<MapRule> &map_rules, std::vector<std::string> &groups, uint32_t &authz_strategy) {
         // Does this look like a JWT?  If not, bail out early and
         // do not pollute the log.
@@ -780,6 +846,10 @@ private:
             return false;
         }
 
+        if (KeysPending(authz)) {
+            return false;
+        }
+
         char *err_msg;
         SciToken token = nullptr;
         pthread_rwlock_rdlock(&m_config_lock);
@@ -799,11 +869,13 @@ private:
             scitoken_destroy(token);
             return false;
         }
+        // Cache the result no longer than the token is valid, and in any case
+        // only until the next reconfiguration may have changed the outcome.
         if (expiry > 0) {
-            expiry = std::max(static_cast<int64_t>(monotonic_time() - expiry),
-                static_cast<int64_t>(60));
+            expiry = std::min(std::max(expiry - static_cast<long long>(time(nullptr)),
+                static_cast<long long>(1)), static_cast<long long>(m_expiry_secs));
         } else {
-            expiry = 60;
+            expiry = m_expiry_secs;
         }
 
         char *value = nullptr;
@@ -1169,6 +1241,9 @@ private:
         }
         std::vector<std::string> audiences;
         std::unordered_map<std::string, IssuerConfig> issuers;
+        long cache_size = m_cache_size;
+        long key_refresh = m_key_refresh_secs;
+        std::map<std::string, std::string> key_files;
         for (const auto &section : reader.Sections()) {
             std::string section_lower;
             std::transform(section.begin(), section.end(), std::back_inserter(section_lower),
@@ -1219,6 +1294,16 @@ private:
                     m_log.Log(LogMask::Error, "Reconfig", "Unknown value for onmissing key:", onmissing.c_str());
                     return false;
                 }
+                cache_size = reader.GetInteger(section, "cache_size", m_cache_size);
+                if (cache_size <= 0) {
+                    m_log.Log(LogMask::Error, "Reconfig", "cache_size must be a positive number of tokens.");
+                    return false;
+                }
+                key_refresh = reader.GetInteger(section, "key_refresh_interval", m_key_refresh_secs);
+                if (key_refresh <= 0) {
+                    m_log.Log(LogMask::Error, "Reconfig", "key_refresh_interval must be a positive number of seconds.");
+                    return false;
+                }
             }
 
             if (section_lower.substr(0, 7) != "issuer ") {continue;}
@@ -1292,6 +1377,8 @@ private:
                 }
             }
 
+            key_files.emplace(issuer, reader.Get(section, "jwks_file", ""));
+
             issuers.emplace(std::piecewise_construct,
                             std::forward_as_tuple(issuer),
                             std::forward_as_tuple(name, issuer, base_paths, restricted_paths,
@@ -1301,6 +1388,13 @@ private:
         if (issuers.empty()) {
             m_log.Log(LogMask::Warning, "Reconfig", "No issuers configured.");
         }
+        m_cache.SetMaxEntries(cache_size);
+        m_keys.SetIntervals(key_refresh, m_key_retry_secs);
+        m_keys.SetIssuers(key_files);
+#ifdef HAVE_SCITOKEN_CONFIG_SET_INT
+        // Leave refreshing to us; the library would do it in the request path
+        scitoken_config_set_int("keycache.update_interval_s", 4 * key_refresh, nullptr);
+#endif
 
         pthread_rwlock_wrlock(&m_config_lock);
         try {
@@ -1327,39 +1421,50 @@ private:
         return true;
     }
 
-    void Check(uint64_t now)
+    // Periodically drop expired tokens and pick up configuration changes. This
+    // runs in its own thread so that requests never wait for either.
+    void Maintain()
     {
-        if (now <= m_next_clean) {return;}
-        std::lock_guard<std::mutex> guard(m_mutex);
-
-        for (auto iter = m_map.begin(); iter != m_map.end(); ) {
-            if (iter->second->expired()) {
-                iter = m_map.erase(iter);
-            } else {
-                ++iter;
+        std::unique_lock<std::mutex> lock(m_maint_mutex);
+        while (!m_maint_cv.wait_for(lock, std::chrono::seconds(m_expiry_secs),
+                                    [this]{return m_shutdown;})) {
+            lock.unlock();
+            auto expired = m_cache.Expire(monotonic_time());
+            if (expired && (m_log.getMsgMask() & LogMask::Debug)) {
+                std::stringstream ss;
+                ss << "Expired " << expired << " cached tokens";
+                m_log.Log(LogMask::Debug, "Maintain", ss.str().c_str());
             }
+            Reconfig();
+            lock.lock();
         }
-        Reconfig();
-
-        m_next_clean = monotonic_time() + m_expiry_secs;
     }
 
     bool m_config_lock_initialized{false};
-    std::mutex m_mutex;
     pthread_rwlock_t m_config_lock;
     std::vector<std::string> m_audiences;
     std::vector<const char *> m_audiences_array;
-    std::map<std::string, std::shared_ptr<XrdAccRules>> m_map;
+    XrdSciTokensCache<XrdAccRules> m_cache;
     XrdAccAuthorize* m_chain;
     const std::string m_parms;
     std::vector<const char*> m_valid_issuers_array;
     std::unordered_map<std::string, IssuerConfig> m_issuers;
-    uint64_t m_next_clean{0};
     XrdSysError m_log;
     AuthzBehavior m_authz_behavior{AuthzBehavior::PASSTHROUGH};
     std::string m_cfg_file;
+    std::thread m_maintenance;
+    std::mutex m_maint_mutex;
+    std::condition_variable m_maint_cv;
+    bool m_shutdown{false};
 
     static constexpr uint64_t m_expiry_secs = 60;
+    static constexpr long m_cache_size = 16384;
+    static constexpr long m_key_refresh_secs = 300;
+    static constexpr uint64_t m_key_retry_secs = 10;
+    static constexpr int m_key_wait_secs = 10;
+
+    // Declared last so that its thread stops before anything it uses goes away
+    XrdSciTokensKeys m_keys;
 };
 
 void InitAccSciTokens(XrdSysLogger *lp, const char *cfn, const char *parm,
@@ -0,0 +1,184 @@
+#ifndef __XrdSciTokensCache_hh__
+#define __XrdSciTokensCache_hh__
+/******************************************************************************/
+/*                                                                            */
+/*                  X r d S c i T o k e n s C a c h e . h h                   */
+/*                                                                            */
+/******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+//-----------------------------------------------------------------------------
+//! A size bounded cache of objects derived from tokens, keyed by the token.
+//! The cache is split into shards, each with its own lock, so that requests
+//! presenting different tokens rarely contend. Every entry has an expiration
+//! time; expired entries are never returned and are removed by Expire(),
+//! which is meant to be called periodically off the request path. When a
+//! shard is full the least recently used entry in it is evicted.
+//-----------------------------------------------------------------------------
+
+template<class T>
+class XrdSciTokensCache
+{
+public:
+
+//-----------------------------------------------------------------------------
+//! Look up an entry.
+//!
+//! @param  key   - The token.
+//! @param  now   - The current time, in the units of the expiration times.
+//!
+//! @return The cached object or nil if it is not cached or has expired.
+//-----------------------------------------------------------------------------
+
+std::shared_ptr<T> Find(const std::string &key, uint64_t now)
+                       {Shard &shard = ShardOf(key);
+                        std::lock_guard<std::mutex> guard(shard.mtx);
+                        auto iter = shard.map.find(key);
+                        if (iter == shard.map.end()) return nullptr;
+                        if (iter->second.expiry < now)
+                           {shard.lru.erase(iter->second.lru);
+                            shard.map.erase(iter);
+                            return nullptr;
+                           }
+                        shard.lru.splice(shard.lru.begin(), shard.lru,
+                                         iter->second.lru);
+                        return iter->second.value;
+                       }
+
+//-----------------------------------------------------------------------------
+//! Add or replace an entry.
+//!
+//! @param  key   - The token.
+//! @param  value - The object to cache.
+//! @param  expiry- The time after which the entry is no longer valid.
+//-----------------------------------------------------------------------------
+
+void Insert(const std::string &key, std::shared_ptr<T> value, uint64_t expiry)
+           {Shard &shard = ShardOf(key);
+            std::lock_guard<std::mutex> guard(shard.mtx);
+            auto res = shard.map.emplace(key, Entry());
+            Entry &ent = res.first->second;
+            if (res.second)
+               {shard.lru.push_front(&res.first->first);
+                ent.lru = shard.lru.begin();
+               } else {
+                shard.lru.splice(shard.lru.begin(), shard.lru, ent.lru);
+               }
+            ent.value  = std::move(value);
+            ent.expiry = expiry;
+            while (shard.map.size() > m_shard_max)
+                  {shard.map.erase(*shard.lru.back());
+                   shard.lru.pop_back();
+                  }
+           }
+
+//-----------------------------------------------------------------------------
+//! Remove all expired entries.
+//!
+//! @param  now   - The current time.
+//!
+//! @return The number of entries removed.
+//-----------------------------------------------------------------------------
+
+size_t Expire(uint64_t now)
+             {size_t num = 0;
+              for (unsigned i = 0; i < m_num_shards; i++)
+                  {Shard &shard = m_shards[i];
+                   std::lock_guard<std::mutex> guard(shard.mtx);
+                   for (auto iter = shard.map.begin(); iter != shard.map.end(); )
+                       {if (iter->second.expiry < now)
+                           {shard.lru.erase(iter->second.lru);
+                            iter = shard.map.erase(iter);
+                            num++;
+                           } else ++iter;
+                       }
+                  }
+              return num;
+             }
+
+//-----------------------------------------------------------------------------
+//! Set the maximum number of entries. A smaller limit takes effect as new
+//! entries are added.
+//-----------------------------------------------------------------------------
+
+void SetMaxEntries(size_t max_entries)
+                  {m_shard_max = std::max(size_t(1),
+                               (max_entries + m_num_shards - 1) / m_num_shards);
+                  }
+
+//-----------------------------------------------------------------------------
+//! Return the number of entries, expired or not.
+//-----------------------------------------------------------------------------
+
+size_t Size()
+           {size_t num = 0;
+            for (unsigned i = 0; i < m_num_shards; i++)
+                {std::lock_guard<std::mutex> guard(m_shards[i].mtx);
+                 num += m_shards[i].map.size();
+                }
+            return num;
+           }
+
+//-----------------------------------------------------------------------------
+//! Constructor
+//!
+//! @param  max_entries - The maximum number of entries.
+//! @param  shards      - The number of shards, rounded up to a power of two.
+//-----------------------------------------------------------------------------
+
+XrdSciTokensCache(size_t max_entries=16384, unsigned shards=16)
+                 {m_num_shards = 1;
+                  while (m_num_shards < shards && m_num_shards < 1024)
+                        m_num_shards <<= 1;
+                  m_shards.reset(new Shard[m_num_shards]);
+                  SetMaxEntries(max_entries);
+                 }
+
+~XrdSciTokensCache() {}
+
+private:
+
+struct Entry
+      {std::shared_ptr<T> value;
+       uint64_t expiry = 0;
+       typename std::list<const std::string *>::iterator lru;
+      };
+
+// Only the end of a token is hashed. For a JWT that is the signature, which
+// differs between any two tokens and is far shorter than the whole token.
+// Tokens that do share it still work; they just land in the same bucket.
+//
+struct TokenHash
+      {size_t operator()(const std::string &key) const
+                        {size_t len = std::min(key.size(), size_t(64));
+                         return std::hash<std::string_view>()(std::string_view(
+                                key.data() + key.size() - len, len));
+                        }
+      };
+
+// The map nodes do not move so the LRU list can point at their keys
+//
+struct alignas(64) Shard
+      {std::mutex mtx;
+       std::unordered_map<std::string, Entry, TokenHash> map;
+       std::list<const std::string *> lru;
+      };
+
+Shard &ShardOf(const std::string &key)
+              {return m_shards[TokenHash()(key) & (m_num_shards - 1)];}
+
+std::unique_ptr<Shard[]> m_shards;
+unsigned                 m_num_shards;
+std::atomic<size_t>      m_shard_max;
+};
+#endif
@@ -0,0 +1,344 @@
+#ifndef __XrdSciTokensKeys_hh__
+#define __XrdSciTokensKeys_hh__
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d S c i T o k e n s K e y s . h h                    */
+/*                                                                            */
+/******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "picojson.h"
+
+//-----------------------------------------------------------------------------
+//! Keeps the signing keys of the configured token issuers fresh from a
+//! background thread, so that validating a token never has to wait for an
+//! issuer's keys to be fetched.
+//!
+//! Each issuer is fetched as soon as it is configured and then again every
+//! refresh interval. A failed fetch is retried after the retry interval,
+//! doubling with each further failure up to the refresh interval; keys that
+//! were fetched before stay in use meanwhile. The fetching itself is done by
+//! the supplied fetch function, which is handed the issuer and the local file
+//! holding its keys, if one was configured.
+//!
+//! Until its first fetch succeeds an issuer is only considered pending if
+//! the optional cache check finds no keys for it either (e.g. the library's
+//! persistent key cache still holds keys from an earlier run). A check that
+//! found nothing is not repeated before the next refresh pass.
+//-----------------------------------------------------------------------------
+
+class XrdSciTokensKeys
+{
+public:
+
+typedef std::function<bool(const std::string &issuer,
+                           const std::string &jwks_file)> FetchFunc;
+
+typedef std::function<bool(const std::string &issuer)> CachedFunc;
+
+//-----------------------------------------------------------------------------
+//! Replace the set of issuers. Issuers that are new are fetched at the next
+//! opportunity; the state of those that remain is kept, unless their key file
+//! changed.
+//!
+//! @param  issuers - Map of issuer to key file (empty to fetch over the net).
+//-----------------------------------------------------------------------------
+
+void SetIssuers(const std::map<std::string, std::string> &issuers)
+               {std::lock_guard<std::mutex> guard(m_mutex);
+                std::map<std::string, Issuer> keep;
+                for (const auto &ent : issuers)
+                    {auto iter = m_issuers.find(ent.first);
+                     if (iter != m_issuers.end()
+                     &&  iter->second.jwks_file == ent.second)
+                        keep.emplace(*iter);
+                        else keep[ent.first].jwks_file = ent.second;
+                    }
+                m_issuers.swap(keep);
+                m_cv.notify_all();
+               }
+
+//-----------------------------------------------------------------------------
+//! Set the refresh and the initial retry intervals, in seconds.
+//-----------------------------------------------------------------------------
+
+void SetIntervals(uint64_t refresh, uint64_t retry)
+                 {std::lock_guard<std::mutex> guard(m_mutex);
+                  m_refresh = std::max(refresh, uint64_t(1));
+                  m_retry   = std::min(std::max(retry, uint64_t(1)), m_refresh);
+                 }
+
+//-----------------------------------------------------------------------------
+//! Check whether a token from an issuer would have to wait for its keys.
+//!
+//! @param  issuer - The issuer.
+//!
+//! @return True if the issuer is configured, its keys have not been fetched
+//!         yet and none are cached, false otherwise.
+//-----------------------------------------------------------------------------
+
+bool Pending(const std::string &issuer)
+            {uint64_t pass;
+             {std::lock_guard<std::mutex> guard(m_mutex);
+              auto iter = m_issuers.find(issuer);
+              if (iter == m_issuers.end() || iter->second.ready) return false;
+              if (!m_cached || iter->second.missed == m_pass + 1) return true;
+              pass = m_pass;
+             }
+             bool found = m_cached(issuer);
+             std::lock_guard<std::mutex> guard(m_mutex);
+             auto iter = m_issuers.find(issuer);
+             if (iter != m_issuers.end())
+                {if (found) iter->second.ready = true;
+                    else iter->second.missed = pass + 1;
+                }
+             return !found;
+            }
+
+//-----------------------------------------------------------------------------
+//! Ask for an issuer's keys to be fetched early because a token needed them.
+//! Fetches are never attempted more often than the retry interval.
+//!
+//! @param  issuer - The issuer.
+//! @param  now    - The current time, in seconds.
+//-----------------------------------------------------------------------------
+
+void Kick(const std::string &issuer, uint64_t now)
+         {std::lock_guard<std::mutex> guard(m_mutex);
+          auto iter = m_issuers.find(issuer);
+          if (iter == m_issuers.end()) return;
+          uint64_t when = std::max(now, iter->second.last + m_retry);
+          if (iter->second.tried && when < iter->second.next)
+             {iter->second.next = when;
+              m_cv.notify_all();
+             }
+         }
+
+//-----------------------------------------------------------------------------
+//! Fetch the keys of all issuers that are due. The fetch function is called
+//! without holding any lock.
+//!
+//! @param  now    - The current time, in seconds.
+//!
+//! @return The time at which the next issuer is due, or zero if there are
+//!         no issuers.
+//-----------------------------------------------------------------------------
+
+uint64_t Refresh(uint64_t now)
+                {std::vector<std::pair<std::string, std::string>> due;
+                 {std::lock_guard<std::mutex> guard(m_mutex);
+                  m_pass++;
+                  for (const auto &ent : m_issuers)
+                      if (!ent.second.tried || ent.second.next <= now)
+                         due.emplace_back(ent.first, ent.second.jwks_file);
+                 }
+
+                 for (const auto &ent : due)
+                     {bool ok = m_fetch(ent.first, ent.second);
+                      std::lock_guard<std::mutex> guard(m_mutex);
+                      auto iter = m_issuers.find(ent.first);
+                      if (iter == m_issuers.end()
+                      ||  iter->second.jwks_file != ent.second) continue;
+                      Issuer &iss = iter->second;
+                      iss.last  = now;
+                      iss.tried = true;
+                      if (ok)
+                         {iss.ready = true;
+                          iss.failures = 0;
+                          iss.next = now + m_refresh;
+                         } else {
+                          uint64_t wait = m_retry;
+                          for (unsigned i = 0; i < iss.failures && wait < m_refresh; i++)
+                              wait *= 2;
+                          iss.failures++;
+                          iss.next = now + std::min(wait, m_refresh);
+                         }
+                     }
+
+                 std::lock_guard<std::mutex> guard(m_mutex);
+                 if (!due.empty()) m_cv.notify_all();
+                 uint64_t next = 0;
+                 for (const auto &ent : m_issuers)
+                     {uint64_t when = (ent.second.tried ? ent.second.next : now);
+                      if (!next || when < next) next = when;
+                     }
+                 return next;
+                }
+
+//-----------------------------------------------------------------------------
+//! Start the background thread that refreshes the keys.
+//-----------------------------------------------------------------------------
+
+void Start()
+          {std::lock_guard<std::mutex> guard(m_mutex);
+           if (m_thread.joinable()) return;
+           m_stop = false;
+           m_thread = std::thread(&XrdSciTokensKeys::Run, this);
+          }
+
+//-----------------------------------------------------------------------------
+//! Stop the background thread, waiting for a fetch in progress to finish.
+//-----------------------------------------------------------------------------
+
+void Stop()
+         {{std::lock_guard<std::mutex> guard(m_mutex);
+           m_stop = true;
+           m_cv.notify_all();
+          }
+          if (m_thread.joinable()) m_thread.join();
+         }
+
+//-----------------------------------------------------------------------------
+//! Wait until every issuer has had its keys fetched at least once, whether
+//! or not that succeeded.
+//!
+//! @param  timeout - The longest time to wait.
+//!
+//! @return True if every issuer was tried and false on timeout.
+//-----------------------------------------------------------------------------
+
+bool WaitTried(std::chrono::milliseconds timeout)
+              {std::unique_lock<std::mutex> lock(m_mutex);
+               return m_cv.wait_for(lock, timeout, [this]
+                         {for (const auto &ent : m_issuers)
+                              if (!ent.second.tried) return false;
+                          return true;
+                         });
+              }
+
+//-----------------------------------------------------------------------------
+//! Extract the issuer from a serialized token without validating it. This is
+//! only good enough to tell which issuer's keys a token will need.
+//!
+//! @param  token  - The token (a JWT).
+//! @param  issuer - Where the value of the "iss" claim is placed.
+//!
+//! @return True if the token carries an issuer and false otherwise.
+//-----------------------------------------------------------------------------
+
+static bool TokenIssuer(const std::string &token, std::string &issuer)
+                       {size_t beg = token.find('.');
+                        if (beg == std::string::npos) return false;
+                        size_t end = token.find('.', ++beg);
+                        if (end == std::string::npos) return false;
+
+                        std::string json;
+                        unsigned int bits = 0, nbits = 0;
+                        for (size_t i = beg; i < end; i++)
+                            {int val = B64Value(token[i]);
+                             if (val < 0) return false;
+                             bits = (bits << 6) | val;
+                             if ((nbits += 6) >= 8)
+                                {nbits -= 8;
+                                 json += static_cast<char>((bits >> nbits) & 0xff);
+                                }
+                            }
+
+                        picojson::value payload;
+                        if (!picojson::parse(payload, json).empty()
+                        ||  !payload.is<picojson::object>()) return false;
+                        const auto &claims = payload.get<picojson::object>();
+                        auto iter = claims.find("iss");
+                        if (iter == claims.end()
+                        ||  !iter->second.is<std::string>()) return false;
+                        issuer = iter->second.get<std::string>();
+                        return true;
+                       }
+
+//-----------------------------------------------------------------------------
+//! Return the current time, in seconds, as used by the background thread.
+//-----------------------------------------------------------------------------
+
+static uint64_t Now()
+                   {return std::chrono::duration_cast<std::chrono::seconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count();
+                   }
+
+//-----------------------------------------------------------------------------
+//! Constructor
+//!
+//! @param  fetch   - Function fetching an issuer's keys, returning success.
+//! @param  refresh - Seconds between refreshes of an issuer's keys.
+//! @param  retry   - Seconds before the first retry of a failed fetch.
+//! @param  cached  - Function telling whether keys for an issuer are already
+//!                   cached. It is only used while the issuer is pending and
+//!                   is called without holding any lock.
+//-----------------------------------------------------------------------------
+
+XrdSciTokensKeys(FetchFunc fetch, uint64_t refresh=300, uint64_t retry=10,
+                 CachedFunc cached=CachedFunc())
+                : m_fetch(std::move(fetch)), m_cached(std::move(cached))
+                {SetIntervals(refresh, retry);}
+
+~XrdSciTokensKeys() {Stop();}
+
+private:
+
+struct Issuer
+      {std::string jwks_file;
+       uint64_t    next     = 0;   // When the next fetch is due
+       uint64_t    last     = 0;   // When the last fetch was done
+       uint64_t    missed   = 0;   // Refresh pass + 1 the cache had nothing
+       unsigned    failures = 0;   // Consecutive failed fetches
+       bool        tried    = false;
+       bool        ready    = false;
+      };
+
+// Accept both the URL safe and the standard alphabet as tokens are seen
+// with either.
+//
+static int B64Value(char c)
+                   {if (c >= 'A' && c <= 'Z') return c - 'A';
+                    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+                    if (c >= '0' && c <= '9') return c - '0' + 52;
+                    if (c == '-' || c == '+') return 62;
+                    if (c == '_' || c == '/') return 63;
+                    return -1;
+                   }
+
+void Run()
+        {std::unique_lock<std::mutex> lock(m_mutex);
+         while (!m_stop)
+               {lock.unlock();
+                uint64_t now  = Now();
+                uint64_t next = Refresh(now);
+                lock.lock();
+                if (m_stop) break;
+                if (next && next <= now) continue;
+                uint64_t wait = (next ? next - now : m_refresh);
+                m_cv.wait_for(lock, std::chrono::seconds(wait), [this, next]
+                             {if (m_stop) return true;
+                              for (const auto &ent : m_issuers)
+                                  if (!ent.second.tried
+                                  ||  (next && ent.second.next < next))
+                                     return true;
+                              return false;
+                             });
+               }
+        }
+
+FetchFunc                     m_fetch;
+CachedFunc                    m_cached;
+std::map<std::string, Issuer> m_issuers;
+std::mutex                    m_mutex;
+std::condition_variable       m_cv;
+std::thread                   m_thread;
+uint64_t                      m_refresh;
+uint64_t                      m_retry;
+uint64_t                      m_pass = 0;  // Refresh passes started
+bool                          m_stop = false;
+};
+#endif
@@ -0,0 +1,133 @@
+#ifndef __XrdSciTokensPathTrie_hh__
+#define __XrdSciTokensPathTrie_hh__
+/******************************************************************************/
+/*                                                                            */
+/*               X r d S c i T o k e n s P a t h T r i e . h h                */
+/*                                                                            */
+/******************************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "XrdAcc/XrdAccAuthorize.hh"
+
+//-----------------------------------------------------------------------------
+//! The path rules of a token compiled into a trie of path components. Each
+//! node records the operations granted on its path (and therefore on all of
+//! the paths below it) as well as the operations granted anywhere in its
+//! subtree. A request is checked with a single walk down the request path
+//! instead of a string compare against every rule.
+//!
+//! The result is the same as testing every rule in turn: an operation is
+//! allowed if a rule for it names the requested path or one of its parent
+//! directories. Stat and mkdir are also allowed on the parents of a path
+//! that has a rule for them, as the WLCG token profile requires. Rule paths
+//! must be canonical; request paths are compared as given, so "/a//b" is not
+//! below "/a/b" and "/a/" is below "/a" but not a parent of "/a/b".
+//-----------------------------------------------------------------------------
+
+class XrdSciTokensPathTrie
+{
+public:
+
+//-----------------------------------------------------------------------------
+//! Add a rule allowing an operation on a path and everything below it.
+//!
+//! @param  oper  - The operation.
+//! @param  path  - The canonical absolute path; others are ignored.
+//-----------------------------------------------------------------------------
+
+void Add(Access_Operation oper, const std::string &path)
+        {if (path.empty() || path[0] != '/' || !Bit(oper)) return;
+         uint32_t node = 0;
+         size_t pos = 1;
+         m_nodes[0].below |= Bit(oper);
+         while (pos < path.size())
+               {size_t end = path.find('/', pos);
+                if (end == std::string::npos) end = path.size();
+                node = AddChild(node, path.c_str() + pos, end - pos);
+                m_nodes[node].below |= Bit(oper);
+                pos = end + 1;
+               }
+         m_nodes[node].here |= Bit(oper);
+        }
+
+//-----------------------------------------------------------------------------
+//! Check whether an operation is allowed on a path.
+//!
+//! @param  oper  - The operation.
+//! @param  path  - The requested path.
+//!
+//! @return True if the rules allow it and false otherwise.
+//-----------------------------------------------------------------------------
+
+bool Allowed(Access_Operation oper, const char *path) const
+            {const uint32_t bit = Bit(oper);
+             const bool toParent = (oper == AOP_Stat || oper == AOP_Mkdir);
+             const Node *np = &m_nodes[0];
+
+             if (np->here & bit) return true;
+             if (!path || *path != '/')
+                return toParent && (!path || !*path) && (np->below & bit);
+
+             if (path[1])
+                {const char *cp = path + 1, *ep;
+                 uint32_t node;
+                 while(true)
+                      {ep = strchr(cp, '/');
+                       size_t len = (ep ? ep - cp : strlen(cp));
+                       if (!len || !(node = Child(np - &m_nodes[0], cp, len)))
+                          return false;
+                       np = &m_nodes[node];
+                       if (np->here & bit) return true;
+                       if (!ep) break;
+                       cp = ep + 1;
+                      }
+                }
+             return toParent && (np->below & bit);
+            }
+
+//-----------------------------------------------------------------------------
+//! Return the number of nodes, including the root.
+//-----------------------------------------------------------------------------
+
+size_t Nodes() const {return m_nodes.size();}
+
+       XrdSciTokensPathTrie() : m_nodes(1) {}
+      ~XrdSciTokensPathTrie() {}
+
+private:
+
+struct Node
+      {uint32_t here  = 0;   // Operations allowed on this path and below
+       uint32_t below = 0;   // Operations allowed somewhere at or below
+       std::vector<std::pair<std::string, uint32_t>> kids;
+      };
+
+static uint32_t Bit(Access_Operation oper)
+                   {return (oper >= 0 && oper < 32 ? 1u << oper : 0);}
+
+// Node 0 is the root and never anyone's child so zero means "no child"
+//
+uint32_t AddChild(uint32_t node, const char *comp, size_t len)
+                 {uint32_t idx = Child(node, comp, len);
+                  if (idx) return idx;
+                  idx = m_nodes.size();
+                  m_nodes[node].kids.emplace_back(std::string(comp, len), idx);
+                  m_nodes.emplace_back();
+                  return idx;
+                 }
+
+uint32_t Child(uint32_t node, const char *comp, size_t len) const
+              {for (const auto &kid : m_nodes[node].kids)
+                   if (kid.first.size() == len
+                   &&  !memcmp(kid.first.data(), comp, len)) return kid.second;
+               return 0;
+              }
+
+std::vector<Node> m_nodes;
+};
+#endif
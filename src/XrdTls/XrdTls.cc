@@ -27,6 +27,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 #include <openssl/err.h>
@@ -54,6 +55,9 @@ bool echoMsg = false;
 namespace XrdTlsGlobal
 {
 XrdSysTrace      SysTrace("TLS",0);
+
+std::atomic<long long> hsFull[2]    = {{0}, {0}};
+std::atomic<long long> hsResumed[2] = {{0}, {0}};
 };
 
 /******************************************************************************/
@@ -120,6 +124,18 @@ void XrdTls::Emsg(const char *tid, const char *msg, bool flush)
   if (flush) ERR_print_errors_cb(ssl_msg_CB, (void *)tid);
 }
   
+/******************************************************************************/
+/*                               H S S t a t s                                */
+/******************************************************************************/
+
+void XrdTls::HSStats(bool server, long long &full, long long &resumed)
+{
+   int i = (server ? 0 : 1);
+
+   full    = XrdTlsGlobal::hsFull[i].load(std::memory_order_relaxed);
+   resumed = XrdTlsGlobal::hsResumed[i].load(std::memory_order_relaxed);
+}
+
 /******************************************************************************/
 /*                               R C 2 T e x t                                */
 /******************************************************************************/
@@ -63,6 +63,18 @@ enum RC {TLS_AOK = 0,          //!< All went well, will always be zero.
 
 static void Emsg(const char *tid, const char *msg=0, bool flush=true);
 
+//------------------------------------------------------------------------
+//! Obtain the number of completed handshakes.
+//!
+//! @param  server  - True for handshakes of accepted connections and false
+//!                   for those of connections we initiated.
+//! @param  full    - Receives the number of full handshakes.
+//! @param  resumed - Receives the number of handshakes that resumed an
+//!                   earlier session (session cache or ticket).
+//------------------------------------------------------------------------
+
+static void HSStats(bool server, long long &full, long long &resumed);
+
 //------------------------------------------------------------------------
 //! Convert TLS RC code to a reason string.
 //!
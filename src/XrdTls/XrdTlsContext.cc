@@ -16,16 +16,35 @@
 // along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
 //------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <cctype>
 #include <cstdio>
+#include <cstdint>
+#include <fcntl.h>
+#include <list>
+#include <map>
+#include <netdb.h>
 #include <openssl/bio.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 #include <openssl/opensslv.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#else
+#include <openssl/hmac.h>
+#endif
+#include <sys/socket.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 #include "XrdOuc/XrdOucUtils.hh"
 #include "XrdSys/XrdSysRAtomic.hh"
+#include "XrdSys/XrdSysE2T.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdSys/XrdSysTimer.hh"
@@ -296,6 +315,528 @@ bool Setup_Flusher(XrdTlsContextImpl *pImpl, int flushT)
 }
 }
   
+/******************************************************************************/
+/*                  S e s s i o n   T i c k e t   S u p p o r t               */
+/******************************************************************************/
+
+// Session ticket keys are shared by all server contexts in the process, and
+// optionally with other servers through a key file. The file has one key per
+// line as "<creation time> <160 hex digits>" (16 bytes of key name, 32 bytes
+// of AES key, and 32 bytes of HMAC key). Keys are kept newest first; tickets
+// encrypted with any listed key are accepted. A new key is only used for
+// encryption once it is keyGrace seconds old so that every server sharing the
+// file had a chance to load it.
+//
+namespace XrdTlsTicket
+{
+struct Key
+      {time_t        born;
+       unsigned char name[16];
+       unsigned char aes[32];
+       unsigned char mac[32];
+      };
+
+static const int maxKeys  = 3;
+static const int keyGrace = 60;
+static const int keyHex   = 2*(16+32+32);
+
+XrdSysRWLock     keyLock;
+std::vector<Key> keys;
+std::string      keyFile;
+time_t           keyMtime = 0;
+int              rotateT  = 0;
+int              lifeT    = 0;
+bool             manage   = false;
+bool             noTkt    = false;
+bool             haveKeys = false;
+
+/******************************************************************************/
+/*                            K e y   H a n d l i n g                         */
+/******************************************************************************/
+
+bool NewKey(Key &key)
+{
+   key.born = time(0);
+   return RAND_bytes(key.name, sizeof(key.name)) == 1
+       && RAND_bytes(key.aes,  sizeof(key.aes))  == 1
+       && RAND_bytes(key.mac,  sizeof(key.mac))  == 1;
+}
+
+bool FromHex(const char *hex, unsigned char *raw, int rlen)
+{
+   for (int i = 0; i < rlen; i++)
+       {unsigned int byte;
+        if (!isxdigit(hex[2*i]) || !isxdigit(hex[2*i+1])
+        ||  sscanf(hex + 2*i, "%2x", &byte) != 1) return false;
+        raw[i] = static_cast<unsigned char>(byte);
+       }
+   return true;
+}
+
+bool ReadKeys(std::vector<Key> &kVec, time_t &mtime, std::string &eTxt)
+{
+   struct stat Stat;
+   char line[512], hex[keyHex+2];
+   unsigned char raw[keyHex/2];
+   long long born;
+   FILE *fp;
+
+// Open the file and make sure nobody else can read it
+//
+   if (!(fp = fopen(keyFile.c_str(), "r")))
+      {eTxt = "Unable to open ticket key file "; eTxt += keyFile;
+       eTxt += "; "; eTxt += XrdSysE2T(errno);
+       return false;
+      }
+   if (fstat(fileno(fp), &Stat) || (Stat.st_mode & (S_IRWXG|S_IRWXO)))
+      {eTxt = "Ticket key file "; eTxt += keyFile;
+       eTxt += " is accessible by others";
+       fclose(fp);
+       return false;
+      }
+   mtime = Stat.st_mtime;
+
+// Read each key
+//
+   kVec.clear();
+   while(fgets(line, sizeof(line), fp))
+        {if (*line == '#' || *line == '\n') continue;
+         if (sscanf(line, "%lld %161s", &born, hex) != 2
+         ||  strlen(hex) != keyHex
+         ||  !FromHex(hex, raw, sizeof(raw)))
+            {eTxt = "Invalid ticket key in "; eTxt += keyFile;
+             fclose(fp);
+             return false;
+            }
+         Key key;
+         key.born = static_cast<time_t>(born);
+         memcpy(key.name, raw,      16);
+         memcpy(key.aes,  raw + 16, 32);
+         memcpy(key.mac,  raw + 48, 32);
+         kVec.push_back(key);
+        }
+   fclose(fp);
+
+// There must be at least one key
+//
+   if (kVec.empty())
+      {eTxt = "No ticket keys in "; eTxt += keyFile;
+       return false;
+      }
+
+// Order the keys newest first
+//
+   std::sort(kVec.begin(), kVec.end(),
+             [](const Key &a, const Key &b) {return a.born > b.born;});
+   return true;
+}
+
+bool WriteKeys(const std::vector<Key> &kVec, std::string &eTxt)
+{
+   std::string tmp = keyFile + ".new";
+   unsigned char raw[keyHex/2];
+   char hex[keyHex+1];
+   FILE *fp;
+   int fd;
+
+// Write the new file aside so that it replaces the old one atomically
+//
+   if ((fd = open(tmp.c_str(), O_WRONLY|O_CREAT|O_TRUNC, S_IRUSR|S_IWUSR)) < 0
+   ||  !(fp = fdopen(fd, "w")))
+      {eTxt = "Unable to create ticket key file "; eTxt += tmp;
+       eTxt += "; "; eTxt += XrdSysE2T(errno);
+       if (fd >= 0) close(fd);
+       return false;
+      }
+
+   fprintf(fp, "# TLS session ticket keys, newest first\n");
+   for (const Key &key : kVec)
+       {memcpy(raw,      key.name, 16);
+        memcpy(raw + 16, key.aes,  32);
+        memcpy(raw + 48, key.mac,  32);
+        XrdOucUtils::bin2hex((char *)raw, sizeof(raw), hex, sizeof(hex), false);
+        fprintf(fp, "%lld %s\n", static_cast<long long>(key.born), hex);
+       }
+
+   if (fflush(fp) || fsync(fd) || fclose(fp)
+   ||  rename(tmp.c_str(), keyFile.c_str()))
+      {eTxt = "Unable to write ticket key file "; eTxt += keyFile;
+       eTxt += "; "; eTxt += XrdSysE2T(errno);
+       unlink(tmp.c_str());
+       return false;
+      }
+   return true;
+}
+
+/******************************************************************************/
+/*                               R o t a t o r                                */
+/******************************************************************************/
+
+void *Rotator(void *)
+{
+   EPNAME("Rotator");
+   std::vector<Key> kVec;
+   std::string eTxt;
+   struct stat Stat;
+   time_t mtime;
+   int waitT;
+
+// When keys come from a file we check it often so that a new key is picked
+// up well before it is used to encrypt tickets.
+//
+   if (keyFile.empty()) waitT = rotateT;
+      else waitT = std::max(1, std::min(rotateT/4, keyGrace/2));
+
+do{XrdSysTimer::Snooze(waitT);
+
+// If we generate the keys, see if it's time for a new one
+//
+   if (keyFile.empty() || manage)
+      {keyLock.ReadLock();
+       kVec = keys;
+       keyLock.UnLock();
+       if (time(0) - kVec[0].born >= rotateT)
+          {Key key;
+           if (!NewKey(key))
+              {XrdTls::Emsg("TicketKeys:", "Unable to generate ticket key!");
+               continue;
+              }
+           kVec.insert(kVec.begin(), key);
+           if ((int)kVec.size() > maxKeys) kVec.resize(maxKeys);
+           if (keyFile.empty())
+              {keyLock.WriteLock();
+               keys.swap(kVec);
+               keyLock.UnLock();
+               DBG_CTX("Rotated session ticket key.");
+               continue;
+              }
+           if (!WriteKeys(kVec, eTxt))
+              {XrdTls::Emsg("TicketKeys:", eTxt.c_str(), false);
+               continue;
+              }
+          }
+      }
+
+// Reload the key file if it changed
+//
+   if (!keyFile.empty() && !stat(keyFile.c_str(), &Stat)
+   &&  Stat.st_mtime != keyMtime)
+      {if (!ReadKeys(kVec, mtime, eTxt))
+          {XrdTls::Emsg("TicketKeys:", eTxt.c_str(), false);
+           keyMtime = Stat.st_mtime;
+           continue;
+          }
+       keyLock.WriteLock();
+       keys.swap(kVec);
+       keyLock.UnLock();
+       keyMtime = mtime;
+       DBG_CTX("Reloaded session ticket keys from " <<keyFile);
+      }
+  } while(true);
+
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                             K e y   U s a g e                              */
+/******************************************************************************/
+
+// Returns the key used to encrypt new tickets, the newest one that is past
+// its grace period or, failing that, the oldest one. The lock must be held.
+//
+const Key &EncKey()
+{
+   time_t usable = time(0) - keyGrace;
+
+   for (const Key &key : keys) if (key.born <= usable) return key;
+   return keys.back();
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+int KeyCB(SSL *, unsigned char *name, unsigned char *iv,
+          EVP_CIPHER_CTX *cctx, EVP_MAC_CTX *hctx, int enc)
+#else
+int KeyCB(SSL *, unsigned char *name, unsigned char *iv,
+          EVP_CIPHER_CTX *cctx, HMAC_CTX *hctx, int enc)
+#endif
+{
+   const Key *kP = 0;
+   int rc = 1;
+
+   keyLock.ReadLock();
+
+// When encrypting, use the current key with a fresh iv
+//
+   if (enc)
+      {kP = &EncKey();
+       memcpy(name, kP->name, sizeof(kP->name));
+       if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1
+       ||  !EVP_EncryptInit_ex(cctx, EVP_aes_256_cbc(), 0, kP->aes, iv))
+          {keyLock.UnLock();
+           return -1;
+          }
+      } else {
+
+// When decrypting, find the key by name. An unknown key means a full
+// handshake. A key we no longer encrypt with asks for a new ticket.
+//
+       for (const Key &key : keys)
+           if (!memcmp(name, key.name, sizeof(key.name))) {kP = &key; break;}
+       if (!kP) {keyLock.UnLock(); return 0;}
+       if (kP != &EncKey()) rc = 2;
+       if (!EVP_DecryptInit_ex(cctx, EVP_aes_256_cbc(), 0, kP->aes, iv))
+          {keyLock.UnLock();
+           return -1;
+          }
+      }
+
+// Set the HMAC key
+//
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+   OSSL_PARAM params[3];
+   params[0] = OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY,
+                         (void *)kP->mac, sizeof(kP->mac));
+   params[1] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST,
+                         (char *)"SHA256", 0);
+   params[2] = OSSL_PARAM_construct_end();
+   if (!EVP_MAC_CTX_set_params(hctx, params)) rc = -1;
+#else
+   if (!HMAC_Init_ex(hctx, kP->mac, sizeof(kP->mac), EVP_sha256(), 0)) rc = -1;
+#endif
+
+   keyLock.UnLock();
+   return rc;
+}
+
+/******************************************************************************/
+/*                 P e e r   C e r t i f i c a t e   S a f e t y              */
+/******************************************************************************/
+
+// A resumed session skips peer certificate verification, so for contexts that
+// verify peers a session never outlives the peer's certificate and is not
+// resumed by a context loaded after it was created (i.e. with newer CRLs).
+//
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+#define X509_get0_notAfter X509_get_notAfter
+#endif
+
+int BornIdx()
+{
+   static int idx = SSL_CTX_get_ex_new_index(0, 0, 0, 0, 0);
+   return idx;
+}
+
+void Clamp(SSL_SESSION *sess)
+{
+   X509 *peer = SSL_SESSION_get0_peer(sess);
+   int days, secs;
+
+   if (peer && ASN1_TIME_diff(&days, &secs, 0, X509_get0_notAfter(peer)))
+      {long left = (days < 0 || secs < 0 ? 1 : days*86400L + secs);
+       if (left < SSL_SESSION_get_timeout(sess))
+          SSL_SESSION_set_timeout(sess, std::max(left, 1L));
+      }
+}
+
+bool Usable(SSL *ssl, SSL_SESSION *sess)
+{
+   time_t born = static_cast<time_t>(reinterpret_cast<intptr_t>(
+                 SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), BornIdx())));
+   X509 *peer = SSL_SESSION_get0_peer(sess);
+
+   if (SSL_SESSION_get_time(sess) < born) return false;
+   return !peer || X509_cmp_current_time(X509_get0_notAfter(peer)) > 0;
+}
+
+int NewSrvSess(SSL *, SSL_SESSION *sess)
+{
+   Clamp(sess);
+   return 0;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+int TktGen(SSL *ssl, void *)
+{
+   SSL_SESSION *sess = SSL_get_session(ssl);
+
+   if (sess) Clamp(sess);
+   return 1;
+}
+
+SSL_TICKET_RETURN TktDec(SSL *ssl, SSL_SESSION *sess, const unsigned char *,
+                         size_t, SSL_TICKET_STATUS status, void *)
+{
+   switch(status)
+         {case SSL_TICKET_EMPTY:
+          case SSL_TICKET_NO_DECRYPT:
+               return SSL_TICKET_RETURN_IGNORE_RENEW;
+          case SSL_TICKET_SUCCESS:
+               return (Usable(ssl, sess) ? SSL_TICKET_RETURN_USE
+                                         : SSL_TICKET_RETURN_IGNORE_RENEW);
+          case SSL_TICKET_SUCCESS_RENEW:
+               return (Usable(ssl, sess) ? SSL_TICKET_RETURN_USE_RENEW
+                                         : SSL_TICKET_RETURN_IGNORE_RENEW);
+          default: break;
+         }
+   return SSL_TICKET_RETURN_ABORT;
+}
+#endif
+
+/******************************************************************************/
+/*                                 S e t u p                                  */
+/******************************************************************************/
+
+// Applies the session settings to a new server context
+//
+void Setup(SSL_CTX *ctx, bool verify)
+{
+   SSL_CTX_set_ex_data(ctx, BornIdx(),
+                       reinterpret_cast<void *>(static_cast<intptr_t>(time(0))));
+
+   if (verify)
+      {SSL_CTX_sess_set_new_cb(ctx, NewSrvSess);
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+       SSL_CTX_set_session_ticket_cb(ctx, TktGen, TktDec, 0);
+#endif
+      }
+
+   if (noTkt) SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+      else if (haveKeys)
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+              SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, KeyCB);
+#else
+              SSL_CTX_set_tlsext_ticket_key_cb(ctx, KeyCB);
+#endif
+
+   if (lifeT > 0) SSL_CTX_set_timeout(ctx, lifeT);
+}
+}
+
+/******************************************************************************/
+/*           C l i e n t   S e s s i o n   R e s u m p t i o n                */
+/******************************************************************************/
+
+// Clients remember the last few resumable sessions of each server, keyed by
+// the server's host name (its address when connecting unverified) and port,
+// and offer the newest on the next connection. Keying by name keeps servers
+// behind one address apart and a server's sessions together across addresses.
+// TLS 1.3 tickets are meant to be used once, so those are taken out of the
+// cache when offered; the server sends new ones on the resumed connection.
+// Keeping more than one lets parallel streams opened right after a login all
+// resume. When too many servers are known, the least recently used is dropped.
+//
+namespace XrdTlsResume
+{
+static const size_t maxSrv  = 1024;
+static const size_t maxSess = 4;      // Per server
+
+struct SrvSess
+      {std::vector<SSL_SESSION*>       sVec;
+       std::list<std::string>::iterator lru;
+      };
+
+XrdSysMutex                    sessMutex;
+std::map<std::string, SrvSess> sessMap;
+std::list<std::string>         sessLRU;   // Least recently used server first
+
+void Touch(SrvSess &srv)
+{
+   sessLRU.splice(sessLRU.end(), sessLRU, srv.lru);
+}
+
+void FreeKey(void *, void *ptr, CRYPTO_EX_DATA *, int, long, void *)
+{
+   free(ptr);
+}
+
+int KeyIdx()
+{
+   static int idx = SSL_get_ex_new_index(0, 0, 0, 0, FreeKey);
+   return idx;
+}
+
+int Save(SSL *ssl, SSL_SESSION *sess)
+{
+   const char *key = static_cast<const char *>(SSL_get_ex_data(ssl, KeyIdx()));
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+   if (!key || !SSL_SESSION_is_resumable(sess)) return 0;
+#else
+   if (!key) return 0;
+#endif
+
+   XrdSysMutexHelper mHelp(sessMutex);
+   auto it = sessMap.find(key);
+   if (it == sessMap.end())
+      {if (sessMap.size() >= maxSrv)
+          {auto old = sessMap.find(sessLRU.front());
+           for (auto sP : old->second.sVec) SSL_SESSION_free(sP);
+           sessMap.erase(old);
+           sessLRU.pop_front();
+          }
+       it = sessMap.emplace(key, SrvSess()).first;
+       it->second.lru = sessLRU.insert(sessLRU.end(), it->first);
+      } else Touch(it->second);
+   std::vector<SSL_SESSION*> &sVec = it->second.sVec;
+   if (sVec.size() >= maxSess)
+      {SSL_SESSION_free(sVec.front());
+       sVec.erase(sVec.begin());
+      }
+   sVec.push_back(sess);
+   return 1;
+}
+
+void Prime(SSL *ssl, int fd, const char *hName)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+   struct sockaddr_storage addr;
+   socklen_t alen = sizeof(addr);
+   char host[NI_MAXHOST], port[NI_MAXSERV];
+   SSL_SESSION *sess = 0;
+
+// Only contexts with client caching enabled resume sessions and only before
+// the handshake has started.
+//
+   if (!SSL_in_before(ssl) || SSL_get_ex_data(ssl, KeyIdx())
+   ||  !(SSL_CTX_get_session_cache_mode(SSL_get_SSL_CTX(ssl))
+         & SSL_SESS_CACHE_CLIENT)) return;
+
+// Key sessions by the server's name, if we have it, and port
+//
+   if (getpeername(fd, (struct sockaddr *)&addr, &alen)
+   ||  getnameinfo((struct sockaddr *)&addr, alen, host, sizeof(host),
+                   port, sizeof(port), NI_NUMERICHOST|NI_NUMERICSERV)) return;
+   std::string key = std::string(hName && *hName ? hName : host) + '#' + port;
+   SSL_set_ex_data(ssl, KeyIdx(), strdup(key.c_str()));
+
+// Offer the newest session, if any
+//
+   sessMutex.Lock();
+   auto it = sessMap.find(key);
+   if (it != sessMap.end() && !it->second.sVec.empty())
+      {std::vector<SSL_SESSION*> &sVec = it->second.sVec;
+       Touch(it->second);
+       sess = sVec.back();
+       if (SSL_SESSION_get_protocol_version(sess) >= TLS1_3_VERSION)
+          sVec.pop_back();
+          else SSL_SESSION_up_ref(sess);
+      }
+   sessMutex.UnLock();
+
+   if (sess)
+      {SSL_set_session(ssl, sess);
+       SSL_SESSION_free(sess);
+      }
+#endif
+}
+}
+
+namespace XrdTlsGlobal
+{
+void Resume(SSL *ssl, int fd, const char *host)
+            {XrdTlsResume::Prime(ssl, fd, host);}
+}
+  
 /******************************************************************************/
 /*                 S S L   T h r e a d i n g   S u p p o r t                  */
 /******************************************************************************/
@@ -694,6 +1235,13 @@ XrdTlsContext::XrdTlsContext(const char *cert,  const char *key,
 //
    SSL_CTX_set_options(pImpl->ctx, sslOpts);
 
+// Have OpenSSL hand off the record layer to the kernel if so wanted. OpenSSL
+// silently falls back to user space TLS if the kernel or cipher can't do it.
+//
+#ifdef SSL_OP_ENABLE_KTLS
+   if (opts & ktlsOK) SSL_CTX_set_options(pImpl->ctx, SSL_OP_ENABLE_KTLS);
+#endif
+
 // Handle session re-negotiation automatically
 //
 // SSL_CTX_set_mode(pImpl->ctx, sslMode);
@@ -771,6 +1319,11 @@ XrdTlsContext::XrdTlsContext(const char *cert,  const char *key,
    if (SSL_CTX_check_private_key(pImpl->ctx) != 1 )
       FATAL_SSL("Unable to create TLS context; cert-key mismatch.");
 
+// Server contexts get the process-wide session settings (tickets, lifetime,
+// and, when verifying peers, the resumption safety checks).
+//
+   if (opts & servr) XrdTlsTicket::Setup(pImpl->ctx, caDir || caFile);
+
 // All went well, start the CRL refresh thread and keep the context.
 //
    if(opts & rfCRL) {
@@ -986,7 +1539,7 @@ int XrdTlsContext::SessionCache(int opts, const char *id, int idlen)
    int flushT = opts & scFMax;
 
    pImpl->sessionCacheOpts = opts;
-   pImpl->sessionCacheId = id;
+   if (id) pImpl->sessionCacheId = id;
 
 // If initialization failed there is nothing to do
 //
@@ -1006,6 +1559,8 @@ int XrdTlsContext::SessionCache(int opts, const char *id, int idlen)
    if (!(opts & doSet)) sslopt = SSL_CTX_get_session_cache_mode(pImpl->ctx);
       else {sslopt = SSL_CTX_set_session_cache_mode(pImpl->ctx, sslopt);
             if (opts & scOff) SSL_CTX_set_options(pImpl->ctx, SSL_OP_NO_TICKET);
+               else if (opts & scClnt && !(pImpl->Parm.opts & servr))
+                       SSL_CTX_sess_set_new_cb(pImpl->ctx, XrdTlsResume::Save);
            }
 
 // Compute what he previous cache options were
@@ -1036,6 +1591,73 @@ int XrdTlsContext::SessionCache(int opts, const char *id, int idlen)
    return opts;
 }
   
+/******************************************************************************/
+/*                         S e t T i c k e t K e y s                          */
+/******************************************************************************/
+
+bool XrdTlsContext::SetTicketKeys(const char *keyfile, int rotate, int lifetime,
+                                  int opts, std::string *eMsg)
+{
+   std::string eTxt;
+   pthread_t tid;
+   int rc;
+
+// This may only be done once
+//
+   if (XrdTlsTicket::haveKeys || XrdTlsTicket::noTkt) return true;
+
+// Record the lifetime and check if tickets are wanted at all
+//
+   XrdTlsTicket::lifeT = lifetime;
+   if (opts & tkOff)
+      {XrdTlsTicket::noTkt = true;
+       return true;
+      }
+   XrdTlsTicket::rotateT = (rotate > 0 ? rotate : 12*60*60);
+
+// Either load the keys or generate the first one
+//
+   if (keyfile)
+      {struct stat Stat;
+       XrdTlsTicket::keyFile = keyfile;
+       XrdTlsTicket::manage  = (opts & tkManage) != 0;
+       if (XrdTlsTicket::manage && stat(keyfile, &Stat) && errno == ENOENT)
+          {XrdTlsTicket::Key key;
+           std::vector<XrdTlsTicket::Key> kVec;
+           if (!XrdTlsTicket::NewKey(key)) eTxt = "Unable to generate ticket key";
+              else {kVec.push_back(key);
+                    XrdTlsTicket::WriteKeys(kVec, eTxt);
+                   }
+          }
+       if (eTxt.empty())
+          XrdTlsTicket::ReadKeys(XrdTlsTicket::keys, XrdTlsTicket::keyMtime, eTxt);
+      } else {
+       XrdTlsTicket::Key key;
+       if (!XrdTlsTicket::NewKey(key)) eTxt = "Unable to generate ticket key";
+          else XrdTlsTicket::keys.push_back(key);
+      }
+
+// Start the rotation thread
+//
+   if (eTxt.empty()
+   &&  (rc = XrdSysThread::Run(&tid, XrdTlsTicket::Rotator, 0, 0,
+                               "Ticket key rotation")))
+      {eTxt = "Unable to start ticket key rotation thread; ";
+       eTxt += XrdSysE2T(rc);
+      }
+
+// Check how we did
+//
+   if (!eTxt.empty())
+      {if (eMsg) *eMsg = eTxt;
+          else XrdTls::Emsg("TicketKeys:", eTxt.c_str(), false);
+       XrdTlsTicket::keys.clear();
+       return false;
+      }
+   XrdTlsTicket::haveKeys = true;
+   return true;
+}
+
 /******************************************************************************/
 /*                     S e t C o n t e x t C i p h e r s                      */
 /******************************************************************************/
@@ -125,8 +125,16 @@ void           *Session();
 //! @return The cache settings prior to any changes are returned. When setting
 //!         the id, the scIdErr may be returned if the name is too long.
 //!         If the context has been pprroperly initialized, zero is returned.
-//!         By default, the session cache is disabled as it is impossible to
-//!         verify a peer certificate chain when a cached session is reused.
+//!         By default, the session cache is disabled as a peer certificate
+//!         chain is not verified again when a cached session is reused. For
+//!         server contexts that verify peers, a cached session or ticket
+//!         never outlives the peer certificate and is not honoured by a
+//!         context loaded after it was created (e.g. by a CRL refresh).
+//!         A client context with scClnt keeps the last few sessions
+//!         obtained from each server, keyed by host name and port, and
+//!         offers one of them when it connects to that server again. When
+//!         too many servers are known the least recently used one is
+//!         dropped along with its sessions.
 //------------------------------------------------------------------------
 
 static const int scNone = 0x00000000; //!< Do not change any option settings
@@ -140,6 +148,32 @@ static const int scFMax = 0x00007fff; //!< Maximum flush interval in seconds
 
       int       SessionCache(int opts=scNone, const char *id=0, int idlen=0);
 
+//------------------------------------------------------------------------
+//! Set up stateless session tickets for server contexts created afterwards.
+//! This should be called once, before any server context is created.
+//!
+//! @param  keyfile  Path of the file holding the ticket keys. Servers that
+//!                  share the file honour each other's tickets. When nil,
+//!                  keys are generated and rotated in memory so that only
+//!                  this process honours its tickets.
+//! @param  rotate   Seconds between key rotations (default 12 hours). Keys
+//!                  read from a file are rotated by whoever writes the file.
+//! @param  lifetime Maximum session lifetime in seconds, 0 keeps the default.
+//! @param  opts     tkOff    - do not issue tickets at all.
+//!                  tkManage - this process writes the key file, creating it
+//!                             if need be, and rotates the keys in it.
+//! @param  eMsg     If non-zero, the reason for a failure is returned.
+//!
+//! @return True upon success and false otherwise.
+//------------------------------------------------------------------------
+
+static const int tkOff    = 0x0001; //!< Do not issue session tickets
+static const int tkManage = 0x0002; //!< Write and rotate the key file
+
+static bool     SetTicketKeys(const char *keyfile, int rotate=0,
+                              int lifetime=0, int opts=0,
+                              std::string *eMsg=0);
+
 //------------------------------------------------------------------------
 //! Set allowed ciphers for this context.
 //!
@@ -201,6 +235,8 @@ void            SetDefaultCiphers(const char *ciphers);
 //!                  crlRF   - Initial crl refresh interval in minutes.
 //!                  dnsok   - trust DNS when verifying hostname.
 //!                  hsto    - the handshake timeout value in seconds.
+//!                  ktlsOK  - Use kernel TLS when OpenSSL and the kernel
+//!                            support it (allows sendfile over TLS).
 //!                  logVF   - Turn on verification failure logging.
 //!                  nopxy   - Do not allow proxy cert (normally allowed)
 //!                  servr   - This is a server-side context and x509 peer
@@ -239,6 +275,7 @@ static const uint64_t crlFC = 0x000000C000000000; //!< Full crl chain checking
 static const uint64_t crlRF = 0x00000000ffff0000; //!< Mask to isolate crl refresh in min
 static const int      crlRS = 16;                 //!< Bits to shift   vdept
 static const uint64_t artON = 0x0000002000000000; //!< Auto retry Handshake
+static const uint64_t ktlsOK= 0x0000001000000000; //!< Use kernel TLS if possible
 
        XrdTlsContext(const char *cert=0,  const char *key=0,
                      const char *cadir=0, const char *cafile=0,
@@ -16,6 +16,7 @@
 // along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
 //------------------------------------------------------------------------------
 
+#include <atomic>
 #include <cstring>
 #include <cerrno>
 #include <fcntl.h>
@@ -97,6 +98,11 @@ XrdTlsSocketImpl *theImpl;
 namespace XrdTlsGlobal
 {
 extern XrdSysTrace SysTrace;
+
+extern std::atomic<long long> hsFull[2];    // [0] accepted, [1] connected
+extern std::atomic<long long> hsResumed[2];
+
+extern void Resume(SSL *ssl, int fd, const char *host);
 }
 
 /******************************************************************************/
@@ -189,6 +195,8 @@ do{if ((rc = SSL_accept( pImpl->ssl )) > 0)
               }
           }
        ImplTracker.KeepImpl();
+       if (SSL_session_reused(pImpl->ssl)) XrdTlsGlobal::hsResumed[0]++;
+          else XrdTlsGlobal::hsFull[0]++;
 
 // Reset the socket to blocking mode if we need to. Note that we have to brute
 // force this on the socket as setting a BIO after accept has no effect. We
@@ -266,6 +274,11 @@ XrdTls::RC XrdTlsSocket::Connect(const char *thehost, std::string *eWhy)
    DBG_SOK("Connecting to " <<(thehost ? thehost : "unverified host")
            <<(thehost && pImpl->cOpts & DNSok ? " dnsok" : "" ));
 
+// Offer a previous session of this host for resumption. This only happens
+// before the handshake starts; we are called again when it would block.
+//
+   if (pImpl->isClient) XrdTlsGlobal::Resume(pImpl->ssl, pImpl->sFD, thehost);
+
 // Do the connect.
 //
 do{int rc = SSL_connect( pImpl->ssl );
@@ -302,6 +315,8 @@ do{int rc = SSL_connect( pImpl->ssl );
 //  Set the hsDone flag!
 //
    pImpl->hsDone = bool( SSL_is_init_finished( pImpl->ssl ) );
+   if (SSL_session_reused(pImpl->ssl)) XrdTlsGlobal::hsResumed[1]++;
+      else XrdTlsGlobal::hsFull[1]++;
 
 // Validate the host name if so desired. Note that cert verification is
 // checked by the notary since hostname validation requires it. We currently
@@ -531,6 +546,26 @@ const char *XrdTlsSocket::Init( XrdTlsContext &ctx, int sfd,
    return 0;
 }
 
+/******************************************************************************/
+/*                                i s K T L S                                 */
+/******************************************************************************/
+
+bool XrdTlsSocket::isKTLS()
+{
+#if defined(BIO_get_ktls_send) && !defined(OPENSSL_NO_KTLS)
+   XrdSysMutexHelper mHelper;
+   BIO *wbio;
+
+   if (pImpl->isSerial) mHelper.Lock(&(pImpl->sslMutex));
+
+   if (!pImpl->ssl || pImpl->fatal || !(wbio = SSL_get_wbio(pImpl->ssl)))
+      return false;
+   return BIO_get_ktls_send(wbio) != 0;
+#else
+   return false;
+#endif
+}
+
 /******************************************************************************/
 /*                                  P e e k                                   */
 /******************************************************************************/
@@ -694,6 +729,76 @@ XrdTls::RC XrdTlsSocket::Read( char *buffer, size_t size, int &bytesRead )
     return XrdTls::TLS_SYS_Error;
   }
 
+/******************************************************************************/
+/*                              S e n d F i l e                               */
+/******************************************************************************/
+
+XrdTls::RC XrdTlsSocket::SendFile( int fd, off_t offset, size_t size,
+                                   int &bytesOut )
+{
+#if defined(BIO_get_ktls_send) && !defined(OPENSSL_NO_KTLS)
+    EPNAME("SendFile");
+    XrdSysMutexHelper mHelper;
+    int ssler;
+
+    //------------------------------------------------------------------------
+    // Serialize call if need be
+    //------------------------------------------------------------------------
+
+    if (pImpl->isSerial) mHelper.Lock(&(pImpl->sslMutex));
+
+    //------------------------------------------------------------------------
+    // Return an error if this socket received a fatal error as OpenSSL will
+    // SEGV when called after such an error.
+    //------------------------------------------------------------------------
+
+    if (pImpl->fatal)
+       {DBG_SIO("Failing due to previous error, fatal=" << (int)pImpl->fatal);
+        return (XrdTls::RC)pImpl->fatal;
+       }
+
+    //------------------------------------------------------------------------
+    // SSL_sendfile() requires that the handshake is complete and that kernel
+    // TLS is active for sending. It never negotiates a session itself.
+    //------------------------------------------------------------------------
+
+ do{ossl_ssize_t rc = SSL_sendfile( pImpl->ssl, fd, offset, size, 0 );
+
+    if (rc > 0)
+      {bytesOut = static_cast<int>(rc);
+       DBG_SIO(rc <<" out of " <<size <<" bytes.");
+       return XrdTls::TLS_AOK;
+      }
+
+    // We have a potential error. Get the SSL error code.
+    //
+    ssler = Diagnose("TLS_SendFile", static_cast<int>(rc), XrdTls::dbgSIO);
+    if (ssler == SSL_ERROR_NONE)
+       {bytesOut = 0;
+        DBG_SIO(rc <<" out of " <<size <<" bytes.");
+        return XrdTls::TLS_AOK;
+       }
+
+    // If the error isn't due to blocking issues, we are done.
+    //
+    if (ssler != SSL_ERROR_WANT_READ && ssler != SSL_ERROR_WANT_WRITE)
+       return XrdTls::ssl2RC(ssler);
+
+    // If the caller is non-blocking for writes, return the issue.
+    //
+    if (!(pImpl->cAttr & wBlocking)) return XrdTls::ssl2RC(ssler);
+
+    // Wait unil the write can get restarted
+
+   } while(Wait4OK(ssler == SSL_ERROR_WANT_READ));
+
+    return XrdTls::TLS_SYS_Error;
+#else
+    bytesOut = 0;
+    return XrdTls::TLS_UNK_Error;
+#endif
+}
+
 /******************************************************************************/
 /*                            S e t T r a c e I D                             */
 /******************************************************************************/
@@ -19,6 +19,7 @@
 //------------------------------------------------------------------------------
 
 #include <string>
+#include <sys/types.h>
 
 #include "XrdTls/XrdTls.hh"
 
@@ -165,6 +166,15 @@ XrdTlsPeerCerts *getCerts(bool ver=true);
   const char *Init( XrdTlsContext &ctx, int sfd, RW_Mode rwm, HS_Mode hsm,
                     bool isClient, bool serial=true, const char *tid="" );
 
+//------------------------------------------------------------------------
+//! Check if the kernel encrypts data sent on this connection (kTLS). This
+//! only becomes true after the handshake has completed.
+//!
+//! @return true if kernel TLS is used for sending, false otherwise.
+//------------------------------------------------------------------------
+
+  bool isKTLS();
+
 //------------------------------------------------------------------------
 //! Peek at the TLS connection data. If necessary, a handshake will be done.
 //!
@@ -205,6 +215,21 @@ XrdTlsPeerCerts *getCerts(bool ver=true);
 
   XrdTls::RC Read( char *buffer, size_t size, int &bytesRead );
 
+//------------------------------------------------------------------------
+//! Send data from a file over the TLS connection using sendfile(). This
+//! may only be used when isKTLS() returns true.
+//!
+//! @param  fd         - The file descriptor of the file holding the data.
+//! @param  offset     - The offset in the file of the data.
+//! @param  size       - The number of bytes to send.
+//! @param  bytesOut   - Number of bytes actually sent, if successful.
+//!
+//! @return TLS_AOK if the operation was successful; otherwise the appropraite
+//!                 return code indicating the problem.
+//------------------------------------------------------------------------
+
+  XrdTls::RC SendFile( int fd, off_t offset, size_t size, int &bytesOut );
+
 //------------------------------------------------------------------------
 //! Set the trace identifier (used when it's updated).
 //!
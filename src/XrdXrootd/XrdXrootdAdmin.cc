@@ -285,17 +285,17 @@ int XrdXrootdAdmin::do_Lsd()
    const char *fmt2 = "<c r=\"%c\" t=\"%lld\" v=\"%d\" m=\"%s\">";
    const char *fmt2a= "<io u=\"%d\"><nf>%d</nf><p>%lld<n>%d</n></p>"
                       "<i>%lld<n>%d</n></i><o>%lld<n>%d</n></o>"
-                      "<s>%d</s><t>%d</t></io>";
+                      "<s>%d</s><t>%d</t>%s</io>";
    const char *fmt3 = "<auth p=\"%s\"><n>";
    const char *fmt3e= "</r></auth>";
    const char *fmt4 = "</resp>\n";
    static int fmt3elen= strlen(fmt3e);
    static int fmt4len = strlen(fmt4);
    char ctyp, monit[3], *mm, cname[1024], buff[100];
-   char aprot[XrdSecPROTOIDSIZE+2], abuff[32], iobuff[256];
+   char aprot[XrdSecPROTOIDSIZE+2], abuff[32], iobuff[256], kbuff[48];
    const char *mdat[24]= {buff, cname, iobuff};
          int   mlen[24]= {0};
-   long long conn, inBytes, outBytes;
+   long long conn, inBytes, outBytes, ktlsBytes;
    int i, rc, cver, inuse, stalls, tardies, curr = -1;
    XrdLink *lp;
    XrdProtocol *xp;
@@ -323,6 +323,9 @@ int XrdXrootdAdmin::do_Lsd()
              if (pp->Monitor.InOut()) *mm++ = 'i';
              *mm = '\0';
              inuse = lp->getIOStats(inBytes, outBytes, stalls, tardies);
+             if (lp->getKTLSStats(ktlsBytes))
+                snprintf(kbuff, sizeof(kbuff), "<k>%lld</k>", ktlsBytes);
+                else *kbuff = '\0';
              mlen[0] = sprintf(buff, fmt2, ctyp, conn, cver, monit);
              mlen[1] = lp->Client(cname, sizeof(cname));
              mlen[2] = sprintf(iobuff, fmt2a,inuse-1,pp->numFiles,pp->totReadP,
@@ -331,7 +334,7 @@ int XrdXrootdAdmin::do_Lsd()
                                          pp->cumWritV + pp->numWritV),
                                outBytes,(pp->cumReads + pp->numReads +
                                          pp->cumReadV + pp->numReadV),
-                               stalls, tardies);
+                               stalls, tardies, kbuff);
              i = 3;
              if ((pp->Client) && pp->Client != &(pp->Entity))
                 {strncpy(aprot, pp->Client->prot, XrdSecPROTOIDSIZE);
@@ -324,6 +324,7 @@ static int   ConfigSecurity(XrdOucEnv &xEnv, const char *cfn);
        bool  logLogin(bool xauth=false);
 static int   mapMode(int mode);
        void  Reset();
+       int   sendBuff(XResponseType rcode, int dlen);
 static int   rpCheck(char *fn, char **opaque);
        int   rpEmsg(const char *op, char *fn);
        int   vpEmsg(const char *op, char *fn);
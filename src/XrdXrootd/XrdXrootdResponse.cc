@@ -33,6 +33,7 @@
 #include <cstring>
 #include <sys/types.h>
 
+#include "Xrd/XrdBuffer.hh"
 #include "Xrd/XrdLinkCtl.hh"
 #include "XrdOuc/XrdOucCRC.hh"
 #include "XrdXrootd/XrdXrootdResponse.hh"
@@ -46,6 +47,11 @@
   
 extern XrdSysTrace  XrdXrootdTrace;
 
+namespace XrdXrootd
+{
+extern XrdBuffManager *BPool;
+}
+
 const char *XrdXrootdResponse::TraceID = "Response";
 
 /******************************************************************************/
@@ -130,6 +136,33 @@ int XrdXrootdResponse::Send(XResponseType rcode, void *data, int dlen)
 
 /******************************************************************************/
 
+// The buffer is handed over to the link which recycles it once the data has
+// left (possibly well after we return). It must not be touched afterwards.
+//
+int XrdXrootdResponse::Send(XResponseType rcode, void *data, int dlen,
+                            XrdBuffer *bP)
+{
+    if (Bridge || !bP)
+       {int rc = Send(rcode, data, dlen);
+        if (bP) XrdXrootd::BPool->Release(bP);
+        return rc;
+       }
+
+    TRACES(RSP, "handing off " <<dlen <<" data bytes; status=" <<rcode);
+
+    RespIO[1].iov_base = (caddr_t)data;
+    RespIO[1].iov_len  = dlen;
+
+    Resp.status        = static_cast<kXR_unt16>(htons(rcode));
+    Resp.dlen          = static_cast<kXR_int32>(htonl(dlen));
+
+    if (Link->Send(RespIO, 2, sizeof(Resp) + dlen, bP) < 0)
+       return Link->setEtext("send failure");
+    return 0;
+}
+
+/******************************************************************************/
+
 int XrdXrootdResponse::Send(XResponseType rcode,
                             struct iovec *IOResp,int iornum, int iolen)
 {
@@ -208,6 +241,13 @@ int XrdXrootdResponse::Send(void *data, int dlen)
 
 /******************************************************************************/
 
+int XrdXrootdResponse::Send(void *data, int dlen, XrdBuffer *bP)
+{
+    return Send(kXR_ok, data, dlen, bP);
+}
+
+/******************************************************************************/
+
 int XrdXrootdResponse::Send(struct iovec *IOResp, int iornum, int iolen)
 {
     static kXR_unt16 isOK = static_cast<kXR_unt16>(htons(kXR_ok));
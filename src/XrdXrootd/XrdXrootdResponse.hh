@@ -41,6 +41,7 @@
 /*                       x r o o t d _ R e s p o n s e                        */
 /******************************************************************************/
   
+class XrdBuffer;
 class XrdLink;
 class XrdXrootdTransit;
 struct XrdOucSFVec;
@@ -55,9 +56,11 @@ const  char *ID() {return (const char *)trsid;}
        int   Send(const char *msg);
        int   Send(XErrorCode ecode, const char *msg);
        int   Send(void *data, int dlen);
+       int   Send(void *data, int dlen, XrdBuffer *bP);
        int   Send(struct iovec *, int iovcnt, int iolen=-1);
 
        int   Send(XResponseType rcode, void *data, int dlen);
+       int   Send(XResponseType rcode, void *data, int dlen, XrdBuffer *bP);
        int   Send(XResponseType rcode, struct iovec *IOResp,
                  int iornum, int iolen=-1);
        int   Send(XResponseType rcode, int info, const char *data, int dsz=-1);
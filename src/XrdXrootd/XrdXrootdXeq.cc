@@ -2398,7 +2398,8 @@ int XrdXrootdProtocol::do_Read()
 // will use and if possible, do a fast dispatch.
 //
         if (IO.File->isMMapped) IO.Mode = XrdXrootd::IOParms::useMMap;
-   else if (IO.File->sfEnabled && !isTLS && IO.IOLen >= as_minsfsz
+   else if (IO.File->sfEnabled && (!isTLS || Link->hasKTLS())
+        &&  IO.IOLen >= as_minsfsz
         &&  IO.Offset+IO.IOLen <= IO.File->Stats.fSize)
            IO.Mode = XrdXrootd::IOParms::useSF;
    else if (IO.File->AsyncMode && IO.IOLen >= as_miniosz
@@ -2481,6 +2482,27 @@ int XrdXrootdProtocol::do_ReadAll()
 // amount of the request even if we really do not get to read that much!
 //
    IO.File->Stats.rdOps(IO.IOLen);
+
+// When the link can send zero-copy we hand the filled buffer over to it and
+// continue reading into a fresh one. The link recycles the buffer once the
+// kernel reports the data has left. Should no buffer be available we simply
+// fall back to the normal copying path for the rest of the request.
+//
+   if (Response.isOurs() && Link->hasZC(Quantum))
+      {XrdBuffer *nP;
+       do {if ((xframt = IO.File->XrdSfsp->read(IO.Offset, buff, Quantum)) <= 0)
+              break;
+           if (!(nP = BPool->Obtain(argp->bsize))) break;
+           XrdBuffer *xP = argp; argp = nP; buff = argp->buff;
+           if (xframt >= IO.IOLen) return Response.Send(xP->buff, xframt, xP);
+           if (Response.Send(kXR_oksofar, xP->buff, xframt, xP) < 0) return -1;
+           IO.Offset += xframt; IO.IOLen -= xframt;
+           if (IO.IOLen < Quantum) Quantum = IO.IOLen;
+          } while(IO.IOLen);
+       if (xframt == 0) return Response.Send();
+       if (xframt <  0) return fsError(xframt, 0, IO.File->XrdSfsp->error, 0, 0);
+      }
+
    do {if ((xframt = IO.File->XrdSfsp->read(IO.Offset, buff, Quantum)) <= 0) break;
        if (xframt >= IO.IOLen) return Response.Send(buff, xframt);
        if (Response.Send(kXR_oksofar, buff, xframt) < 0) return -1;
@@ -2671,8 +2693,7 @@ int XrdXrootdProtocol::do_ReadV()
                {xfrSZ = IO.File->XrdSfsp->readv(&rdVec[rdVNow], i-rdVNow);
                 if (xfrSZ != rdVAmt) break;
                }
-            if (Response.Send(kXR_oksofar,argp->buff,Quantum-Qleft) < 0)
-               return -1;
+            if (sendBuff(kXR_oksofar, Quantum-Qleft) < 0) return -1;
             Qleft = Quantum;
             buffp = argp->buff;
             rdVNow = i; rdVXfr += rdVAmt; rdVAmt = 0;
@@ -2699,7 +2720,7 @@ int XrdXrootdProtocol::do_ReadV()
 
 // All done, return result of the last segment or just zero
 //
-   return (Quantum != Qleft ? Response.Send(argp->buff, Quantum-Qleft) : 0);
+   return (Quantum != Qleft ? sendBuff(kXR_ok, Quantum-Qleft) : 0);
 }
 
 /******************************************************************************/
@@ -3968,6 +3989,27 @@ int XrdXrootdProtocol::getBuff(const int isRead, int Quantum)
    return 1;
 }
 
+/******************************************************************************/
+/*                              s e n d B u f f                               */
+/******************************************************************************/
+
+// Send the first dlen bytes of the current buffer. When the link can send
+// zero-copy the buffer is handed over to it and replaced by a fresh one so
+// that the caller can keep filling argp (see do_ReadAll()).
+//
+int XrdXrootdProtocol::sendBuff(XResponseType rcode, int dlen)
+{
+   XrdBuffer *nP;
+
+   if (Response.isOurs() && Link->hasZC(dlen)
+   &&  (nP = BPool->Obtain(argp->bsize)))
+      {XrdBuffer *xP = argp;
+       argp = nP;
+       return Response.Send(rcode, xP->buff, dlen, xP);
+      }
+   return Response.Send(rcode, argp->buff, dlen);
+}
+
 /******************************************************************************/
 /* Private:                   g e t C k s T y p e                             */
 /******************************************************************************/
@@ -4016,7 +4058,7 @@ bool XrdXrootdProtocol::logLogin(bool xauth)
 // Check if TLS was or will be used
 //
    tMsg = Link->verTLS();
-   if (*tMsg) zMsg = " ";
+   if (*tMsg) zMsg = (Link->hasKTLS() ? " ktls " : " ");
 
 // Format the line
 //
@@ -0,0 +1,54 @@
+/*
+ * Measure the throughput of every checksum kernel the cpu supports.
+ *
+ * Usage: xrdcks-kernel-bench [<size_kb> [<total_mb>]]
+ *
+ * Each kernel checksums a buffer of <size_kb> (default 1024) kilobytes
+ * repeatedly until <total_mb> (default 2048) megabytes have been processed.
+ * The kernel that would be selected at run time is marked with a '*'.
+ */
+
+#include "XrdCks/XrdCksKernels.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+  size_t bsize = (argc > 1 ? strtoul(argv[1], 0, 10) : 1024) * 1024;
+  size_t total = (argc > 2 ? strtoul(argv[2], 0, 10) : 2048) * 1024 * 1024;
+
+  if (!bsize || total < bsize) {
+    fprintf(stderr, "Usage: %s [<size_kb> [<total_mb>]]\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<unsigned char> buff(bsize);
+  for (size_t i = 0; i < bsize; i++) buff[i] = (i * 2654435761u) >> 13;
+
+  const size_t loops = total / bsize;
+  const double gbytes = (double)loops * bsize / 1e9;
+
+  printf("%-8s %-8s %10s %10s\n", "cksum", "impl", "GB/s", "value");
+  for (const char *csName : {"adler32", "crc32", "crc32c"}) {
+    const char *best = XrdCksKernels::Using(csName);
+    XrdCksKernels::Kernel func;
+    const char *name;
+
+    for (int i = 0; (name = XrdCksKernels::Impl(csName, i, func)); i++) {
+      uint32_t cs = 0;
+      auto t0 = std::chrono::steady_clock::now();
+      for (size_t n = 0; n < loops; n++)
+        cs = func(cs, buff.data(), bsize);
+      auto t1 = std::chrono::steady_clock::now();
+      double secs = std::chrono::duration<double>(t1 - t0).count();
+
+      printf("%-8s %-7s%c %10.2f   %08x\n", csName, name,
+             (!strcmp(name, best) ? '*' : ' '), gbytes / secs, cs);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,235 @@
+#undef NDEBUG
+
+#include "XrdCks/XrdCksCalcadler32.hh"
+#include "XrdCks/XrdCksCalccrc32.hh"
+#include "XrdCks/XrdCksData.hh"
+#include "XrdCks/XrdCksKernels.hh"
+#include "XrdCks/XrdCksManager.hh"
+#include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucCRC32C.hh"
+#include "XrdOuc/XrdOucPgrwUtils.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+#include "XrdVersion.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <gtest/gtest.h>
+
+class XrdCksTests : public ::testing::Test {};
+
+/*
+ * Bitwise reference for the non-reflected (Posix) crc without the length
+ * bits and final inversion, which is what the crc32 kernels compute.
+ */
+
+static uint32_t crc32_ref(uint32_t crc, const unsigned char *p, size_t n)
+{
+  while (n--) {
+    crc ^= (uint32_t)*p++ << 24;
+    for (int i = 0; i < 8; i++)
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+  }
+  return crc;
+}
+
+static std::vector<unsigned char> make_data(size_t size, unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::vector<unsigned char> data(size);
+  for (auto &c : data) c = gen() & 0xff;
+  return data;
+}
+
+/*
+ * Lengths chosen to hit every block boundary and the overflow limits of the
+ * vector kernels (adler32 runs of 5552 bytes, crc32 folds of 16 to 256 bytes).
+ */
+
+static const size_t lengths[] = {
+  0, 1, 2, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129,
+  255, 256, 257, 511, 512, 513, 1000, 4096, 5551, 5552, 5553, 5567, 5568,
+  11104, 11200, 65536, 65537, 100003, 1048576 + 13
+};
+
+static void check_kernels(const char *csName, unsigned seed,
+                          uint32_t start, uint32_t (*ref)(uint32_t,
+                          const unsigned char *, size_t))
+{
+  std::vector<unsigned char> buff = make_data(1048576 + 64 + 13, seed);
+  XrdCksKernels::Kernel func;
+  const char *name;
+  int num = 0;
+
+  ASSERT_NE(XrdCksKernels::Using(csName), nullptr);
+
+  while ((name = XrdCksKernels::Impl(csName, num++, func))) {
+    for (size_t len : lengths) {
+      for (size_t align : {0, 1, 3, 8, 13}) {
+        const unsigned char *p = buff.data() + align;
+        uint32_t expect = ref(start, p, len);
+
+        EXPECT_EQ(func(start, p, len), expect)
+          << csName << " " << name << " len " << len << " align " << align;
+
+        /* The same data fed in two uneven pieces must give the same result */
+        size_t cut = len / 3;
+        EXPECT_EQ(func(func(start, p, cut), p + cut, len - cut), expect)
+          << csName << " " << name << " split len " << len;
+      }
+    }
+  }
+
+  /* At least the portable implementation must always be present */
+  ASSERT_GT(num, 1);
+}
+
+TEST(XrdCksTests, Adler32Kernels)
+{
+  check_kernels("adler32", 1, 1,
+    [](uint32_t cs, const unsigned char *p, size_t n) -> uint32_t
+    { return adler32(cs, p, n); });
+
+  /* All 0xff bytes give the largest sums and so the worst case overflow */
+  std::vector<unsigned char> ones(1048576, 0xff);
+  XrdCksKernels::Kernel func;
+  const char *name;
+  for (int i = 0; (name = XrdCksKernels::Impl("adler32", i, func)); i++)
+    EXPECT_EQ(func(1, ones.data(), ones.size()),
+              adler32(1, ones.data(), ones.size())) << name;
+}
+
+TEST(XrdCksTests, CRC32Kernels)
+{
+  check_kernels("crc32", 2, 0, crc32_ref);
+  check_kernels("crc32", 3, 0xdeadbeef, crc32_ref);
+}
+
+TEST(XrdCksTests, CRC32CKernels)
+{
+  check_kernels("crc32c", 4, 0,
+    [](uint32_t cs, const unsigned char *p, size_t n) -> uint32_t
+    { return crc32c_sw(cs, p, n); });
+}
+
+TEST(XrdCksTests, PageChecksums)
+{
+  /* Page checksums go through the crc32c kernel, including a partial page
+     at the start and at the end */
+  std::vector<unsigned char> buff = make_data(5 * 4096, 5);
+  const off_t  offset = 1000;
+  const size_t count  = 3 * 4096 + 500;
+  std::vector<uint32_t> csVec;
+
+  XrdOucPgrwUtils::csCalc((const char *)buff.data(), offset, count, csVec);
+  ASSERT_EQ(csVec.size(), 4u);
+
+  size_t pos = 0;
+  for (size_t i = 0; i < csVec.size(); i++) {
+    size_t len = (i == 0 ? 4096 - offset : std::min<size_t>(4096, count - pos));
+    EXPECT_EQ(csVec[i], crc32c_sw(0, buff.data() + pos, len)) << "page " << i;
+    pos += len;
+  }
+  EXPECT_EQ(pos, count);
+
+  EXPECT_EQ(XrdOucCRC::Calc32C(buff.data(), count, 0u),
+            crc32c_sw(0, buff.data(), count));
+}
+
+TEST(XrdCksTests, UnknownChecksum)
+{
+  XrdCksKernels::Kernel func;
+  EXPECT_EQ(XrdCksKernels::Impl("md5", 0, func), nullptr);
+  EXPECT_EQ(XrdCksKernels::Using("md5"), nullptr);
+}
+
+TEST(XrdCksTests, Calculators)
+{
+  const char *check = "123456789";
+  int csSize;
+
+  /* Same value as "printf 123456789 | cksum" */
+  XrdCksCalccrc32 crc32;
+  crc32.Update(check, 4);
+  crc32.Update(check + 4, 5);
+  uint32_t crcVal;
+  memcpy(&crcVal, crc32.Final(), sizeof(crcVal));
+  EXPECT_EQ(ntohl(crcVal), 930766865u);
+  crc32.Type(csSize);
+  EXPECT_EQ(csSize, 4);
+
+  XrdCksCalcadler32 adler;
+  adler.Update(check, 9);
+  uint32_t adlerVal;
+  memcpy(&adlerVal, adler.Final(), sizeof(adlerVal));
+  EXPECT_EQ(ntohl(adlerVal), 0x091E01DEu);
+}
+
+TEST(XrdCksTests, Combine)
+{
+  std::vector<unsigned char> buff = make_data(200003, 5);
+  const unsigned char *p = buff.data();
+  size_t len = buff.size();
+
+  for (size_t cut : {0, 1, 15, 4096, 65537, 200002, 200003}) {
+    size_t len2 = len - cut;
+    EXPECT_EQ(XrdCksKernels::Adler32Combine(adler32(1, p, cut),
+              adler32(1, p + cut, len2), len2), adler32(1, p, len));
+    EXPECT_EQ(XrdCksKernels::CRC32Combine(crc32_ref(0, p, cut),
+              crc32_ref(0, p + cut, len2), len2), crc32_ref(0, p, len));
+    EXPECT_EQ(XrdCksKernels::CRC32CCombine(crc32c_sw(0, p, cut),
+              crc32c_sw(0, p + cut, len2), len2), crc32c_sw(0, p, len));
+  }
+}
+
+/*
+ * The manager splits a file into slices checksummed by separate threads when
+ * the file spans at least two i/o segments; a small read size forces this.
+ */
+
+TEST(XrdCksTests, ManagerParallel)
+{
+  static XrdVERSIONINFODEF(myVer, XrdCksTests, XrdVNUMBER, XrdVERSION);
+  XrdSysLogger logger;
+  XrdSysError eDest(&logger, "XrdCksTests");
+  char path[] = "/tmp/xrdcks-testXXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+
+  std::vector<unsigned char> data = make_data(3 * 1048576 + 12345, 6);
+  ASSERT_EQ(write(fd, data.data(), data.size()), (ssize_t)data.size());
+  close(fd);
+
+  for (int threads : {1, 3, 8}) {
+    XrdCksManager manager(&eDest, 131072, myVer);
+    manager.SetThreads(threads);
+    ASSERT_TRUE(manager.Init(0));
+
+    for (const char *name : {"adler32", "crc32", "crc32c", "md5"}) {
+      XrdCksCalc *csP = manager.Object(name);
+      ASSERT_NE(csP, nullptr);
+      int csSize;
+      csP->Type(csSize);
+      std::vector<char> expect(csSize);
+      memcpy(expect.data(), csP->Calc((const char *)data.data(),
+                                      data.size()), csSize);
+      csP->Recycle();
+
+      XrdCksData cks;
+      cks.Set(name);
+      ASSERT_EQ(manager.Calc(path, cks, 0), 0) << name;
+      ASSERT_EQ(cks.Length, csSize);
+      EXPECT_EQ(memcmp(cks.Value, expect.data(), csSize), 0)
+        << name << " with " << threads << " threads";
+    }
+  }
+  unlink(path);
+}
@@ -0,0 +1,167 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "XrdCl/XrdClAdaptiveWindow.hh"
+
+using XrdCl::AdaptiveWindow;
+
+namespace
+{
+  typedef AdaptiveWindow::clock_t::time_point time_point;
+  typedef std::chrono::microseconds           usec;
+
+  const uint32_t MB = 1024 * 1024;
+
+  //----------------------------------------------------------------------------
+  // Feed one full round of completions at the given throughput (bytes/s),
+  // each chunk having taken lat microseconds
+  //----------------------------------------------------------------------------
+  time_point Round( AdaptiveWindow &w, time_point t, uint64_t rate, int64_t lat )
+  {
+    uint32_t gen   = w.Generation();
+    uint32_t chunk = w.ChunkSize();
+    usec     dt( uint64_t( chunk ) * 1000000 / rate );
+    uint32_t n     = std::max<uint32_t>( w.InFlight(), 4 );
+    for( uint32_t i = 0; i < n && w.Generation() == gen; ++i )
+    {
+      t += dt;
+      w.Sample( gen, chunk, t - usec( lat ), t );
+    }
+    return t;
+  }
+
+  //----------------------------------------------------------------------------
+  // The first completion only opens the first round
+  //----------------------------------------------------------------------------
+  time_point Open( AdaptiveWindow &w )
+  {
+    time_point t = AdaptiveWindow::clock_t::now();
+    w.Sample( w.Generation(), w.ChunkSize(), t, t );
+    return t;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Throughput gains double the parallelism, then grow the chunk size
+//------------------------------------------------------------------------------
+TEST(AdaptiveWindowTest, Grow)
+{
+  AdaptiveWindow w( MB, 2, 4 * MB, 8, uint64_t( 1 ) << 30 );
+  time_point t = Open( w );
+
+  t = Round( w, t, 100 * MB, 1000 );
+  EXPECT_EQ( w.Parallel(), 4 );
+  EXPECT_EQ( w.ChunkSize(), MB );
+
+  t = Round( w, t, 200 * MB, 1000 );
+  EXPECT_EQ( w.Parallel(), 8 );
+
+  t = Round( w, t, 400 * MB, 1000 );
+  EXPECT_EQ( w.Parallel(), 8 );
+  EXPECT_EQ( w.ChunkSize(), 2 * MB );
+
+  t = Round( w, t, 800 * MB, 1000 );
+  t = Round( w, t, 1600 * MB, 1000 );
+  EXPECT_EQ( w.ChunkSize(), 4 * MB );
+  EXPECT_EQ( w.PeakRate(), uint64_t( 1600 ) * MB );
+}
+
+//------------------------------------------------------------------------------
+// Rising latency without a throughput gain shrinks the window by one step
+//------------------------------------------------------------------------------
+TEST(AdaptiveWindowTest, ShrinkOnLatency)
+{
+  AdaptiveWindow w( MB, 2, 4 * MB, 8, uint64_t( 1 ) << 30 );
+  time_point t = Open( w );
+
+  t = Round( w, t, 100 * MB, 1000 );
+  ASSERT_EQ( w.Parallel(), 4 );
+
+  t = Round( w, t, 100 * MB, 3000 );
+  EXPECT_EQ( w.Parallel(), 3 );
+  EXPECT_EQ( w.ChunkSize(), MB );
+
+  // a steady round at the baseline latency leaves the window alone
+  uint32_t gen = w.Generation();
+  t = Round( w, t, 100 * MB, 1000 );
+  EXPECT_EQ( w.Generation(), gen );
+  EXPECT_EQ( w.Parallel(), 3 );
+}
+
+//------------------------------------------------------------------------------
+// A sharp throughput drop halves the parallelism
+//------------------------------------------------------------------------------
+TEST(AdaptiveWindowTest, HalveOnDrop)
+{
+  AdaptiveWindow w( MB, 2, 4 * MB, 8, uint64_t( 1 ) << 30 );
+  time_point t = Open( w );
+
+  t = Round( w, t, 100 * MB, 1000 );
+  t = Round( w, t, 200 * MB, 1000 );
+  ASSERT_EQ( w.Parallel(), 8 );
+
+  t = Round( w, t, 50 * MB, 1000 );
+  EXPECT_EQ( w.Parallel(), 4 );
+  EXPECT_EQ( w.ChunkSize(), MB );
+}
+
+//------------------------------------------------------------------------------
+// The bytes in flight on all streams never exceed the ceiling
+//------------------------------------------------------------------------------
+TEST(AdaptiveWindowTest, Ceiling)
+{
+  AdaptiveWindow w( MB, 2, 16 * MB, 32, 8 * MB );
+  w.Streams( 2 );
+  time_point t = Open( w );
+
+  uint64_t rate = 100 * MB;
+  for( int i = 0; i < 10; ++i, rate *= 2 )
+  {
+    t = Round( w, t, rate, 1000 );
+    EXPECT_LE( uint64_t( w.ChunkSize() ) * w.Parallel() * 2, 8 * MB );
+    EXPECT_LE( uint64_t( w.ChunkSize() ) * w.InFlight(), 8 * MB );
+  }
+  EXPECT_EQ( w.Parallel(), 4 );
+  EXPECT_EQ( w.ChunkSize(), MB );
+  EXPECT_EQ( w.InFlight(), 8u );
+
+  // more streams than the ceiling allows are capped in the chunks in flight
+  w.Streams( 4 );
+  EXPECT_EQ( w.InFlight(), 8u );
+}
+
+//------------------------------------------------------------------------------
+// A ceiling below the initial window does not shrink the configured values
+//------------------------------------------------------------------------------
+TEST(AdaptiveWindowTest, CeilingBelowStart)
+{
+  AdaptiveWindow w( 8 * MB, 4, 16 * MB, 32, MB );
+  EXPECT_EQ( w.InFlight(), 4u );
+
+  time_point t = Open( w );
+  t = Round( w, t, 100 * MB, 1000 );
+  t = Round( w, t, 200 * MB, 1000 );
+  EXPECT_EQ( w.Parallel(), 4 );
+  EXPECT_EQ( w.ChunkSize(), 8 * MB );
+}
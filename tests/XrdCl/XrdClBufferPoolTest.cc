@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "GTestXrdHelpers.hh"
+#include "XrdCl/XrdClBufferPool.hh"
+#include "XrdCl/XrdClFile.hh"
+
+#include <climits>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using XrdCl::BufferPool;
+
+//------------------------------------------------------------------------------
+// Buffers are page aligned and recycled within the budget
+//------------------------------------------------------------------------------
+TEST(BufferPoolTest, Recycle)
+{
+  BufferPool pool;
+  pool.Attach( 4 * BufferPool::PageSize );
+
+  char *b1 = pool.Get( 1000 );
+  EXPECT_EQ( (uintptr_t)b1 % BufferPool::PageSize, 0u );
+  pool.Put( b1 );
+  EXPECT_EQ( pool.IdleBytes(), BufferPool::PageSize );
+
+  // a request that fits reuses the idle buffer
+  char *b2 = pool.Get( BufferPool::PageSize );
+  EXPECT_EQ( b1, b2 );
+  EXPECT_EQ( pool.IdleBytes(), 0u );
+
+  // an idle buffer more than twice as large as asked for is not reused
+  char *b3 = pool.Get( 4 * BufferPool::PageSize );
+  pool.Put( b3 );
+  char *b4 = pool.Get( 100 );
+  EXPECT_NE( b3, b4 );
+  EXPECT_EQ( pool.IdleBytes(), 4 * BufferPool::PageSize );
+
+  pool.Put( b2 );
+  pool.Put( b4 );
+  pool.Detach( 4 * BufferPool::PageSize );
+  EXPECT_EQ( pool.IdleBytes(), 0u );
+}
+
+//------------------------------------------------------------------------------
+// Idle memory never exceeds the sum of the budgets of the attached jobs
+//------------------------------------------------------------------------------
+TEST(BufferPoolTest, Budget)
+{
+  const size_t chunk = 16 * BufferPool::PageSize;
+  BufferPool pool;
+  pool.Attach( 2 * chunk );
+  pool.Attach( 2 * chunk );
+
+  std::vector<char*> buffers;
+  for( int i = 0; i < 8; ++i ) buffers.push_back( pool.Get( chunk ) );
+  for( char *b : buffers ) pool.Put( b );
+  EXPECT_EQ( pool.IdleBytes(), 4 * chunk );
+
+  // one job leaves, the idle buffers are trimmed to the other's budget
+  pool.Detach( 2 * chunk );
+  EXPECT_EQ( pool.IdleBytes(), 2 * chunk );
+
+  // the last job leaves, everything is given back
+  pool.Detach( 2 * chunk );
+  EXPECT_EQ( pool.IdleBytes(), 0u );
+}
+
+//------------------------------------------------------------------------------
+// Buffers the pool did not allocate are deleted, not kept
+//------------------------------------------------------------------------------
+TEST(BufferPoolTest, Foreign)
+{
+  BufferPool pool;
+  pool.Attach( 1024 * BufferPool::PageSize );
+  pool.Put( new char[BufferPool::PageSize] );
+  EXPECT_EQ( pool.IdleBytes(), 0u );
+  pool.Put( nullptr );
+  pool.Detach( 1024 * BufferPool::PageSize );
+}
+
+//------------------------------------------------------------------------------
+// Direct I/O on a local file: aligned writes from pool buffers and an
+// unaligned tail (which switches the file to buffered I/O) all land on disk,
+// whether or not the file system supports O_DIRECT
+//------------------------------------------------------------------------------
+TEST(BufferPoolTest, DirectIOFallback)
+{
+  using namespace XrdCl;
+
+  char cwd[PATH_MAX];
+  ASSERT_TRUE( getcwd( cwd, sizeof( cwd ) ) );
+  std::string path = std::string( cwd ) + "/xrdcl-directio-test.dat";
+  std::string url  = "file://" + path + "?xrdcl.directio=1";
+
+  const uint32_t chunk = 64 * 1024;
+  const uint32_t tail  = 1000;
+  BufferPool pool;
+  pool.Attach( 2 * chunk );
+  char *b1 = pool.Get( chunk );
+  char *b2 = pool.Get( chunk );
+  memset( b1, 'a', chunk );
+  memset( b2, 'b', chunk );
+  std::vector<char> t( tail + 1, 'c' ); // t.data() + 1 is not aligned
+
+  File file;
+  EXPECT_XRDST_OK( file.Open( url, OpenFlags::Delete | OpenFlags::Update,
+                              Access::UR | Access::UW ) );
+  EXPECT_XRDST_OK( file.Write( 0,     chunk, b1 ) );
+  EXPECT_XRDST_OK( file.Write( chunk, chunk, b2 ) );
+  EXPECT_XRDST_OK( file.Write( 2 * chunk, tail, t.data() + 1 ) );
+  EXPECT_XRDST_OK( file.Close() );
+  pool.Put( b1 );
+  pool.Put( b2 );
+  pool.Detach( 2 * chunk );
+
+  int fd = open( path.c_str(), O_RDONLY );
+  ASSERT_NE( fd, -1 );
+  std::vector<char> data( 2 * chunk + tail + 1 );
+  ssize_t rc = read( fd, data.data(), data.size() );
+  close( fd );
+  unlink( path.c_str() );
+  ASSERT_EQ( rc, ssize_t( 2 * chunk + tail ) );
+  EXPECT_EQ( std::string( data.data(), chunk ), std::string( chunk, 'a' ) );
+  EXPECT_EQ( std::string( data.data() + chunk, chunk ), std::string( chunk, 'b' ) );
+  EXPECT_EQ( std::string( data.data() + 2 * chunk, tail ), std::string( tail, 'c' ) );
+}
@@ -0,0 +1,232 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Measure the cost of request bookkeeping in XrdCl: stream ID allocation and,
+// when a server is given, request round trips with many requests in flight.
+//
+// Usage: xrdcl-sid-bench [<threads> [<window> [<url> [<depth> [<seconds>]]]]]
+//
+// Each of <threads> (default 4) threads repeatedly allocates <window>
+// (default 1024) SIDs from a shared SIDManager and releases them again, as a
+// process does when it keeps that many requests outstanding per channel.
+//
+// If <url> names a readable file (e.g. root://localhost:1094//tmp/f), the
+// file is opened and 4 KiB reads at random offsets are issued asynchronously,
+// keeping <depth> (default 1024) of them in flight for <seconds> (default 10)
+// and the completed round trips per second are reported.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClSIDManager.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  const uint32_t ReadSize = 4096;
+
+  //----------------------------------------------------------------------------
+  // Allocate and release SIDs from several threads
+  //----------------------------------------------------------------------------
+  void SIDBench( int nThreads, int window )
+  {
+    using namespace XrdCl;
+    std::shared_ptr<SIDManager> mgr =
+      SIDMgrPool::Instance().GetSIDMgr( URL( "root://sidbench:1094//" ) );
+    const int                rounds = 2000;
+    std::atomic<long long>   failed( 0 );
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for( int t = 0; t < nThreads; ++t )
+    {
+      threads.emplace_back( [&]()
+      {
+        std::vector<uint8_t> sids( 2 * window );
+        for( int r = 0; r < rounds; ++r )
+        {
+          for( int i = 0; i < window; ++i )
+            if( !mgr->AllocateSID( &sids[2 * i] ).IsOK() ) ++failed;
+          for( int i = 0; i < window; ++i )
+            mgr->ReleaseSID( &sids[2 * i] );
+        }
+      } );
+    }
+    for( auto &thread : threads )
+      thread.join();
+    double secs = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start ).count();
+
+    double ops = 2.0 * nThreads * window * rounds;
+    printf( "SID alloc+release: %d threads, window %d: %.2f Mops/s "
+            "(%lld failed)\n", nThreads, window, ops / secs / 1e6,
+            (long long)failed );
+  }
+
+  //----------------------------------------------------------------------------
+  // Keep a number of asynchronous reads in flight against a server
+  //----------------------------------------------------------------------------
+  class ReadLoop : public XrdCl::ResponseHandler
+  {
+    public:
+      ReadLoop( XrdCl::File &file, uint64_t size, int depth, double secs ):
+        pDone( 0 ), pErrors( 0 ), pFile( file ), pSize( size ),
+        pDepth( depth ), pInFlight( depth ), pRng( 42 ),
+        pBuffers( depth * (size_t)ReadSize )
+      {
+        pStop = std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double>( secs ) );
+      }
+
+      void Run()
+      {
+        for( int i = 0; i < pDepth; ++i )
+          Issue( i );
+        pFinished.Wait();
+      }
+
+      void HandleResponse( XrdCl::XRootDStatus *status,
+                           XrdCl::AnyObject    *response ) override
+      {
+        int slot = -1;
+        if( response )
+        {
+          XrdCl::ChunkInfo *chunk = 0;
+          response->Get( chunk );
+          if( chunk )
+            slot = ( (char *)chunk->buffer - pBuffers.data() ) / ReadSize;
+        }
+        if( status->IsOK() ) ++pDone;
+        else ++pErrors;
+        delete status;
+        delete response;
+
+        if( slot >= 0 && std::chrono::steady_clock::now() < pStop )
+          Issue( slot );
+        else
+          Retire();
+      }
+
+      long long Done()   const { return pDone; }
+      long long Errors() const { return pErrors; }
+
+    private:
+      void Issue( int slot )
+      {
+        uint64_t offset;
+        {
+          std::lock_guard<std::mutex> lock( pRngMutex );
+          offset = ( pSize > ReadSize ? pRng() % ( pSize - ReadSize ) : 0 );
+        }
+        if( !pFile.Read( offset, ReadSize, &pBuffers[slot * (size_t)ReadSize],
+                         this ).IsOK() )
+        {
+          ++pErrors;
+          Retire();
+        }
+      }
+
+      void Retire()
+      {
+        if( --pInFlight == 0 ) pFinished.Post();
+      }
+
+      std::atomic<long long>                pDone;
+      std::atomic<long long>                pErrors;
+      XrdCl::File                          &pFile;
+      uint64_t                              pSize;
+      int                                   pDepth;
+      std::chrono::steady_clock::time_point pStop;
+      std::atomic<int>                      pInFlight;
+      std::mutex                            pRngMutex;
+      std::mt19937_64                       pRng;
+      std::vector<char>                     pBuffers;
+      XrdSysSemaphore                       pFinished{ 0 };
+  };
+
+  //----------------------------------------------------------------------------
+  // Measure request round trips against the file at url
+  //----------------------------------------------------------------------------
+  int ReadBench( const char *url, int depth, double secs )
+  {
+    using namespace XrdCl;
+    File         file;
+    XRootDStatus st = file.Open( url, OpenFlags::Read );
+    if( !st.IsOK() )
+    {
+      fprintf( stderr, "open %s: %s\n", url, st.ToString().c_str() );
+      return 1;
+    }
+    StatInfo *info = 0;
+    if( !file.Stat( false, info ).IsOK() || !info )
+    {
+      fprintf( stderr, "stat %s failed\n", url );
+      return 1;
+    }
+    uint64_t size = info->GetSize();
+    delete info;
+
+    ReadLoop loop( file, size, depth, secs );
+    auto start = std::chrono::steady_clock::now();
+    loop.Run();
+    double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start ).count();
+
+    printf( "reads: depth %d, %lld round trips in %.2f s: %.0f req/s "
+            "(%lld errors)\n", depth, loop.Done(), elapsed,
+            loop.Done() / elapsed, loop.Errors() );
+    if( !file.Close().IsOK() )
+      fprintf( stderr, "close %s failed\n", url );
+    return 0;
+  }
+}
+
+int main( int argc, char **argv )
+{
+  int    nThreads = ( argc > 1 ? atoi( argv[1] ) : 4 );
+  int    window   = ( argc > 2 ? atoi( argv[2] ) : 1024 );
+  int    depth    = ( argc > 4 ? atoi( argv[4] ) : 1024 );
+  double secs     = ( argc > 5 ? atof( argv[5] ) : 10.0 );
+
+  if( nThreads < 1 || window < 1 || window > 60000 / nThreads || depth < 1 )
+  {
+    fprintf( stderr, "usage: %s [<threads> [<window> [<url> [<depth> "
+                     "[<seconds>]]]]]\n", argv[0] );
+    return 1;
+  }
+
+  SIDBench( nThreads, window );
+  if( argc > 3 )
+    return ReadBench( argv[3], depth, secs );
+  return 0;
+}
@@ -23,9 +23,13 @@
 //------------------------------------------------------------------------------
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <vector>
 #include "XrdCl/XrdClAnyObject.hh"
 #include "GTestXrdHelpers.hh"
 #include "XrdCl/XrdClTaskManager.hh"
+#include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClSIDManager.hh"
 #include "XrdCl/XrdClPropertyList.hh"
 
@@ -163,6 +167,65 @@ TEST(UtilsTest, TaskManagerTest)
   EXPECT_TRUE( taskMan.Stop() );
 }
 
+//------------------------------------------------------------------------------
+// A job that counts its runs and, optionally, queues follow up jobs
+//------------------------------------------------------------------------------
+class CountingJob: public XrdCl::Job
+{
+  public:
+    CountingJob( XrdCl::JobManager &mgr, std::atomic<int> &runs,
+                 std::atomic<int> &notWorker, XrdSysSemaphore &done,
+                 int total ):
+      pMgr( mgr ), pRuns( runs ), pNotWorker( notWorker ), pDone( done ),
+      pTotal( total ) {}
+
+    virtual void Run( void *arg )
+    {
+      if( !pMgr.IsWorker() ) ++pNotWorker;
+      if( arg ) pMgr.QueueJob( this, 0 );
+      if( ++pRuns == pTotal ) pDone.Post();
+    }
+
+  private:
+    XrdCl::JobManager &pMgr;
+    std::atomic<int>  &pRuns;
+    std::atomic<int>  &pNotWorker;
+    XrdSysSemaphore   &pDone;
+    int                pTotal;
+};
+
+//------------------------------------------------------------------------------
+// Job Manager test, shared queue and work stealing
+//------------------------------------------------------------------------------
+TEST(UtilsTest, JobManagerTest)
+{
+  using namespace XrdCl;
+
+  for( bool steal : { false, true } )
+  {
+    JobManager jobMan( 4, steal );
+    EXPECT_FALSE( jobMan.IsWorker() );
+    EXPECT_TRUE( jobMan.Start() );
+
+    //--------------------------------------------------------------------------
+    // Half of the jobs are queued from outside with an affinity key, each of
+    // those queues one more job from inside a worker
+    //--------------------------------------------------------------------------
+    const int n = 10000;
+    std::atomic<int> runs( 0 ), notWorker( 0 );
+    XrdSysSemaphore done( 0 );
+    CountingJob job( jobMan, runs, notWorker, done, n );
+    for( int i = 0; i < n / 2; ++i )
+      jobMan.QueueJob( &job, (void*)1, i % 7 );
+
+    done.Wait();
+    EXPECT_EQ( runs.load(), n );
+    EXPECT_EQ( notWorker.load(), 0 );
+    EXPECT_TRUE( jobMan.Stop() );
+    EXPECT_TRUE( jobMan.Finalize() );
+  }
+}
+
 //------------------------------------------------------------------------------
 // SID Manager test
 //------------------------------------------------------------------------------
@@ -199,6 +262,55 @@ TEST(UtilsTest, SIDManagerTest)
   EXPECT_EQ( manager->NumberOfTimedOutSIDs(), 0 );
 }
 
+//------------------------------------------------------------------------------
+// SID Manager exhaustion and reuse test
+//------------------------------------------------------------------------------
+TEST(UtilsTest, SIDManagerExhaustionTest)
+{
+  using namespace XrdCl;
+  std::shared_ptr<SIDManager> manager = SIDMgrPool::Instance().GetSIDMgr( "root://fake2:1094//dir/file" );
+
+  //----------------------------------------------------------------------------
+  // SIDs 0 and 0xffff are reserved, everything else must be handed out once
+  //----------------------------------------------------------------------------
+  std::vector<bool> seen( 65536, false );
+  uint8_t sid[2];
+  uint16_t s = 0;
+  for( int i = 0; i < 65534; ++i )
+  {
+    ASSERT_XRDST_OK( manager->AllocateSID( sid ) );
+    memcpy( &s, sid, 2 );
+    EXPECT_NE( s, 0 );
+    EXPECT_NE( s, 0xffff );
+    EXPECT_FALSE( seen[s] );
+    seen[s] = true;
+  }
+  EXPECT_EQ( manager->GetNumberOfAllocatedSIDs(), 65534 );
+  EXPECT_FALSE( manager->AllocateSID( sid ).IsOK() );
+
+  //----------------------------------------------------------------------------
+  // Released and timed out SIDs become available again
+  //----------------------------------------------------------------------------
+  uint16_t relSID = 4242, toSID = 777;
+  memcpy( sid, &relSID, 2 );
+  manager->ReleaseSID( sid );
+  memcpy( sid, &toSID, 2 );
+  manager->TimeOutSID( sid );
+  EXPECT_EQ( manager->GetNumberOfAllocatedSIDs(), 65532 );
+  EXPECT_TRUE( manager->IsTimedOut( sid ) );
+
+  ASSERT_XRDST_OK( manager->AllocateSID( sid ) );
+  memcpy( &s, sid, 2 );
+  EXPECT_EQ( s, relSID );
+  EXPECT_FALSE( manager->AllocateSID( sid ).IsOK() );
+
+  manager->ReleaseAllTimedOut();
+  ASSERT_XRDST_OK( manager->AllocateSID( sid ) );
+  memcpy( &s, sid, 2 );
+  EXPECT_EQ( s, toSID );
+  EXPECT_FALSE( manager->IsTimedOut( sid ) );
+}
+
 //------------------------------------------------------------------------------
 // Property List test
 //------------------------------------------------------------------------------
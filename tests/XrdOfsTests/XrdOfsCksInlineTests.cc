@@ -0,0 +1,207 @@
+#include "XrdCks/XrdCks.hh"
+#include "XrdCks/XrdCksCalcadler32.hh"
+#include "XrdCks/XrdCksData.hh"
+#include "XrdOfs/XrdOfsCksInline.hh"
+#include "XrdOfs/XrdOfsHandle.hh"
+#include "XrdOss/XrdOss.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// A checksum manager that only knows adler32 and remembers what was set.
+class TestCks : public XrdCks
+{
+public:
+  int Calc(const char *, XrdCksData &, int) override {return -ENOTSUP;}
+  int Del(const char *, XrdCksData &) override {return -ENOTSUP;}
+  int Get(const char *, XrdCksData &) override {return -ENOTSUP;}
+  int Config(const char *, char *) override {return 0;}
+  int Init(const char *, const char *) override {return 1;}
+  char *List(const char *, char *, int, char) override {return 0;}
+  const char *Name(int seqNum) override {return seqNum ? 0 : "adler32";}
+  XrdCksCalc *Object(const char *name) override
+    {return strcmp(name, "adler32") ? 0 : new XrdCksCalcadler32;}
+  int Size(const char *name) override
+    {return !name || !strcmp(name, "adler32") ? 4 : 0;}
+  int Set(const char *xfn, XrdCksData &cks, int) override
+    {stored[xfn] = std::string(cks.Value, cks.Length); return 0;}
+  int Ver(const char *, XrdCksData &) override {return -ENOTSUP;}
+
+  TestCks() : XrdCks(0) {}
+
+  std::map<std::string, std::string> stored;
+};
+
+// A file whose size is whatever the test says it is.
+class TestDF : public XrdOssDF
+{
+public:
+  int Close(long long *retsz) override {if (retsz) *retsz = size; return 0;}
+  int Fstat(struct stat *buf) override
+    {memset(buf, 0, sizeof(struct stat)); buf->st_size = size; return 0;}
+
+  long long size = 0;
+};
+
+std::string Adler32(const std::string &data)
+{
+  XrdCksCalcadler32 calc;
+  calc.Init();
+  calc.Update(data.data(), data.size());
+  return std::string(calc.Final(), 4);
+}
+
+class XrdOfsCksInlineTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_TRUE(XrdOfsCksInline::Init(&cks, false, "default", eDest));
+    ASSERT_TRUE(XrdOfsCksInline::Enabled());
+    data = std::string(3000, '\0');
+    for (size_t i = 0; i < data.size(); i++) data[i] = char(i * 7 + 3);
+  }
+
+  void Write(XrdOfsCksInline *ilP, long long offset, long long len)
+  {
+    ilP->Update(offset, data.data() + offset, len);
+  }
+
+  XrdSysLogger logger;
+  XrdSysError  eDest{&logger, "test"};
+  TestCks      cks;
+  TestDF       file;
+  std::string  data;
+};
+}
+
+TEST_F(XrdOfsCksInlineTests, SequentialWrites)
+{
+  XrdOfsCksInline *ilP = XrdOfsCksInline::Alloc();
+  ASSERT_NE(ilP, nullptr);
+
+  Write(ilP, 0, 1000);
+  Write(ilP, 1000, 1);
+  Write(ilP, 1001, 1999);
+  file.size = 3000;
+  ilP->Finish("/cks/seq", file);
+  delete ilP;
+
+  ASSERT_EQ(cks.stored.count("/cks/seq"), 1u);
+  EXPECT_EQ(cks.stored["/cks/seq"], Adler32(data));
+}
+
+TEST_F(XrdOfsCksInlineTests, OutOfOrderWrites)
+{
+  XrdOfsCksInline *ilP = XrdOfsCksInline::Alloc();
+  ASSERT_NE(ilP, nullptr);
+
+  // All of the data gets written, just not in order.
+  Write(ilP, 1000, 2000);
+  Write(ilP, 0, 1000);
+  file.size = 3000;
+  ilP->Finish("/cks/order", file);
+  delete ilP;
+
+  EXPECT_EQ(cks.stored.count("/cks/order"), 0u);
+}
+
+TEST_F(XrdOfsCksInlineTests, OverlappingWrites)
+{
+  XrdOfsCksInline *ilP = XrdOfsCksInline::Alloc();
+  ASSERT_NE(ilP, nullptr);
+
+  Write(ilP, 0, 2000);
+  Write(ilP, 1500, 1500);
+  file.size = 3000;
+  ilP->Finish("/cks/overlap", file);
+  delete ilP;
+
+  EXPECT_EQ(cks.stored.count("/cks/overlap"), 0u);
+}
+
+TEST_F(XrdOfsCksInlineTests, Truncate)
+{
+  // Truncating to the checksummed length changes nothing.
+  XrdOfsCksInline *ilP = XrdOfsCksInline::Alloc();
+  ASSERT_NE(ilP, nullptr);
+  Write(ilP, 0, 3000);
+  ilP->Truncate(3000);
+  file.size = 3000;
+  ilP->Finish("/cks/trunc-same", file);
+  delete ilP;
+  EXPECT_EQ(cks.stored["/cks/trunc-same"], Adler32(data));
+
+  // Any other length does, even if later writes make up for it.
+  ilP = XrdOfsCksInline::Alloc();
+  ASSERT_NE(ilP, nullptr);
+  Write(ilP, 0, 3000);
+  ilP->Truncate(1000);
+  Write(ilP, 1000, 2000);
+  ilP->Finish("/cks/trunc", file);
+  delete ilP;
+  EXPECT_EQ(cks.stored.count("/cks/trunc"), 0u);
+}
+
+TEST_F(XrdOfsCksInlineTests, PartialFile)
+{
+  // Overwriting the start of a longer file must not record a checksum.
+  XrdOfsCksInline *ilP = XrdOfsCksInline::Alloc();
+  ASSERT_NE(ilP, nullptr);
+
+  Write(ilP, 0, 1000);
+  file.size = 3000;
+  ilP->Finish("/cks/partial", file);
+  delete ilP;
+
+  EXPECT_EQ(cks.stored.count("/cks/partial"), 0u);
+}
+
+TEST_F(XrdOfsCksInlineTests, MultipleOpens)
+{
+  XrdOfsHandle *h1 = 0, *h2 = 0;
+  TestDF *dfP = new TestDF;
+  int retc;
+
+  ASSERT_EQ(XrdOfsHandle::Alloc("/cks/multi", XrdOfsHandle::opRW, &h1), 0);
+  h1->Activate(dfP);
+  h1->cksIL = XrdOfsCksInline::Alloc();
+  ASSERT_NE(h1->cksIL, nullptr);
+  h1->UnLock();
+  ASSERT_EQ(XrdOfsHandle::Alloc("/cks/multi", XrdOfsHandle::opRW, &h2), 0);
+  ASSERT_EQ(h1, h2);
+  h2->UnLock();
+
+  h1->Lock();
+  Write(h1->cksIL, 0, 1500);
+  h1->UnLock();
+  h2->Lock();
+  Write(h2->cksIL, 1500, 1500);
+  h2->UnLock();
+  dfP->size = 3000;
+
+  // The first close leaves the checksum to the remaining writer.
+  h2->Lock();
+  XrdOfsCksInline::Close(h2);
+  EXPECT_NE(h2->cksIL, nullptr);
+  EXPECT_EQ(cks.stored.count("/cks/multi"), 0u);
+  EXPECT_EQ(h2->Retire(retc), 1);
+
+  // The last one records it.
+  h1->Lock();
+  XrdOfsCksInline::Close(h1);
+  EXPECT_EQ(h1->cksIL, nullptr);
+  EXPECT_EQ(h1->Retire(retc), 0);
+
+  ASSERT_EQ(cks.stored.count("/cks/multi"), 1u);
+  EXPECT_EQ(cks.stored["/cks/multi"], Adler32(data));
+}
@@ -0,0 +1,69 @@
+/*
+ * Measure the open/close rate of the ofs file handle tables.
+ *
+ * Usage: xrdofs-handle-bench [<threads> [<opens> [<paths>]]]
+ *
+ * Each of <threads> (default 8) threads allocates and retires <opens>
+ * (default 500000) handles, cycling over <paths> (default 100000) distinct
+ * paths of its own, which is what a server sees with many short-lived
+ * opens of different files. A second pass has all threads share the same
+ * 16 paths.
+ */
+
+#include "XrdOfs/XrdOfsHandle.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+double Run(int nThreads, int nOpens, int nPaths, bool shared)
+{
+  std::vector<std::thread> thr;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int t = 0; t < nThreads; t++)
+    thr.emplace_back([=]() {
+      std::vector<std::string> paths(nPaths);
+      for (int p = 0; p < nPaths; p++)
+        paths[p] = "/store/bench/" + (shared ? std::string("shared")
+                                             : std::to_string(t))
+                 + "/file" + std::to_string(p);
+      XrdOfsHandle *hP;
+      int retc;
+      for (int i = 0; i < nOpens; i++) {
+        if (XrdOfsHandle::Alloc(paths[i % nPaths].c_str(), 0, &hP)) continue;
+        hP->Retire(retc);
+      }
+    });
+  for (auto &th : thr) th.join();
+  auto t1 = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double>(t1 - t0).count();
+}
+}
+
+int main(int argc, char *argv[])
+{
+  int nThreads = argc > 1 ? atoi(argv[1]) : 8;
+  int nOpens   = argc > 2 ? atoi(argv[2]) : 500000;
+  int nPaths   = argc > 3 ? atoi(argv[3]) : 100000;
+
+  if (nThreads < 1 || nOpens < 1 || nPaths < 1) {
+    fprintf(stderr, "Usage: %s [<threads> [<opens> [<paths>]]]\n", argv[0]);
+    return 1;
+  }
+
+  const double total = (double)nThreads * nOpens;
+
+  double secs = Run(nThreads, nOpens, nPaths, false);
+  printf("distinct paths: %10.0f open+close/s\n", total / secs);
+
+  secs = Run(nThreads, nOpens, 16, true);
+  printf("shared paths:   %10.0f open+close/s\n", total / secs);
+  return 0;
+}
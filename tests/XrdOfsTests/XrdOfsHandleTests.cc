@@ -0,0 +1,107 @@
+#include "XrdOfs/XrdOfsHandle.hh"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+XrdOfsHandle *Open(const std::string &path, int opts)
+{
+  XrdOfsHandle *hP = 0;
+  EXPECT_EQ(XrdOfsHandle::Alloc(path.c_str(), opts, &hP), 0);
+  if (hP) hP->UnLock();
+  return hP;
+}
+
+int Close(XrdOfsHandle *hP)
+{
+  int retc;
+  hP->Lock();
+  return hP->Retire(retc);
+}
+}
+
+TEST(XrdOfsHandleTests, SharedOpens)
+{
+  XrdOfsHandle *r1 = Open("/ofs/shared", 0);
+  XrdOfsHandle *r2 = Open("/ofs/shared", 0);
+  XrdOfsHandle *w1 = Open("/ofs/shared", XrdOfsHandle::opRW);
+
+  // Opens of the same path in the same mode share the handle, r/o and r/w
+  // opens do not.
+  ASSERT_EQ(r1, r2);
+  ASSERT_NE(r1, w1);
+  EXPECT_EQ(r1->Usage(), 2);
+  EXPECT_EQ(w1->Usage(), 1);
+  EXPECT_STREQ(r1->Name(), "/ofs/shared");
+
+  EXPECT_EQ(Close(r2), 1);
+  EXPECT_EQ(Close(r1), 0);
+  EXPECT_EQ(Close(w1), 0);
+
+  // Once retired, a new open gets a fresh handle.
+  XrdOfsHandle *r3 = Open("/ofs/shared", 0);
+  EXPECT_EQ(r3->Usage(), 1);
+  EXPECT_EQ(Close(r3), 0);
+}
+
+TEST(XrdOfsHandleTests, Hide)
+{
+  XrdOfsHandle *h1 = Open("/ofs/hidden", 0);
+  XrdOfsHandle::Hide("/ofs/hidden");
+
+  // A hidden handle is not found by later opens.
+  XrdOfsHandle *h2 = Open("/ofs/hidden", 0);
+  EXPECT_NE(h1, h2);
+
+  EXPECT_EQ(Close(h2), 0);
+  EXPECT_EQ(Close(h1), 0);
+}
+
+TEST(XrdOfsHandleTests, ManyPaths)
+{
+  // Enough paths to spread over every shard and grow the tables.
+  const int n = 20000;
+  std::vector<XrdOfsHandle *> hv(n);
+
+  for (int i = 0; i < n; i++)
+    hv[i] = Open("/ofs/many/" + std::to_string(i), 0);
+  for (int i = 0; i < n; i++)
+    ASSERT_EQ(Open("/ofs/many/" + std::to_string(i), 0), hv[i]);
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(Close(hv[i]), 1);
+    ASSERT_EQ(Close(hv[i]), 0);
+  }
+}
+
+TEST(XrdOfsHandleTests, ConcurrentSharing)
+{
+  // Threads repeatedly open and close a small set of paths; every open of a
+  // path that is held open elsewhere must return the held handle.
+  const int nThreads = 8, nPaths = 4, nLoops = 20000;
+  XrdOfsHandle *held[nPaths];
+  std::atomic<int> mismatches(0);
+
+  for (int p = 0; p < nPaths; p++)
+    held[p] = Open("/ofs/concurrent/" + std::to_string(p), 0);
+
+  std::vector<std::thread> thr;
+  for (int t = 0; t < nThreads; t++)
+    thr.emplace_back([&, t]() {
+      for (int i = 0; i < nLoops; i++) {
+        int p = (t + i) % nPaths;
+        XrdOfsHandle *hP = Open("/ofs/concurrent/" + std::to_string(p), 0);
+        if (hP != held[p]) mismatches++;
+        if (hP) Close(hP);
+      }
+    });
+  for (auto &th : thr) th.join();
+
+  EXPECT_EQ(mismatches.load(), 0);
+  for (int p = 0; p < nPaths; p++)
+    EXPECT_EQ(Close(held[p]), 0);
+}
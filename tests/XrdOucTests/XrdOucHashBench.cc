@@ -0,0 +1,98 @@
+/*
+ * Compare lookup rates of XrdOucHash behind a mutex and XrdOucHashMT.
+ *
+ * Usage: xrdouc-hash-bench [<threads> [<lookups> [<keys>]]]
+ *
+ * The table is loaded with <keys> (default 100000) paths, then each of
+ * <threads> (default 8) threads does <lookups> (default 1000000) lookups of
+ * random keys, one in every 16 being a replacement instead, which is how the
+ * server's name and handle caches are used.
+ */
+
+#include "XrdOuc/XrdOucHash.hh"
+#include "XrdOuc/XrdOucHashMT.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Locked
+{
+  XrdOucHash<char> tab;
+  XrdSysMutex      mtx;
+
+  char *Find(const char *key) { XrdSysMutexHelper mh(mtx); return tab.Find(key); }
+  void  Rep(const char *key)  { XrdSysMutexHelper mh(mtx);
+                                tab.Rep(key, 0, 0, Hash_data_is_key); }
+};
+
+struct Striped
+{
+  XrdOucHashMT<char> tab;
+
+  char *Find(const char *key) { return tab.Find(key); }
+  void  Rep(const char *key)  { tab.Rep(key, 0, 0, Hash_data_is_key); }
+};
+
+template<class H>
+double Run(H &h, const std::vector<std::string> &keys,
+           int nThreads, int nLookups)
+{
+  std::vector<std::thread> thr;
+
+  for (auto &k : keys) h.Rep(k.c_str());
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int t = 0; t < nThreads; t++)
+    thr.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+      size_t hits = 0;
+      for (int i = 0; i < nLookups; i++) {
+        const char *key = keys[pick(rng)].c_str();
+        if (i % 16 == 0) h.Rep(key);
+           else if (h.Find(key)) hits++;
+      }
+      if (!hits) fprintf(stderr, "thread %d found nothing\n", t);
+    });
+  for (auto &th : thr) th.join();
+  auto t1 = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double>(t1 - t0).count();
+}
+}
+
+int main(int argc, char *argv[])
+{
+  int nThreads = argc > 1 ? atoi(argv[1]) : 8;
+  int nLookups = argc > 2 ? atoi(argv[2]) : 1000000;
+  int nKeys    = argc > 3 ? atoi(argv[3]) : 100000;
+
+  if (nThreads < 1 || nLookups < 1 || nKeys < 1) {
+    fprintf(stderr, "Usage: %s [<threads> [<lookups> [<keys>]]]\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<std::string> keys(nKeys);
+  for (int i = 0; i < nKeys; i++)
+    keys[i] = "/store/bench/dir" + std::to_string(i % 97)
+            + "/file" + std::to_string(i);
+
+  const double total = (double)nThreads * nLookups;
+
+  Locked locked;
+  double secs = Run(locked, keys, nThreads, nLookups);
+  printf("XrdOucHash + mutex: %10.0f ops/s\n", total / secs);
+
+  Striped striped;
+  secs = Run(striped, keys, nThreads, nLookups);
+  printf("XrdOucHashMT:       %10.0f ops/s\n", total / secs);
+  return 0;
+}
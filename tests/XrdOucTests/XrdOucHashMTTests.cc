@@ -0,0 +1,173 @@
+#undef NDEBUG
+
+#include "XrdOuc/XrdOucHashMT.hh"
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class XrdOucHashMTTests : public ::testing::Test {};
+
+namespace
+{
+std::string Key(int i) { return "/store/data/file" + std::to_string(i); }
+
+int Collect(const char *key, char *, void *arg)
+{
+  static_cast<std::set<std::string> *>(arg)->insert(key);
+  return 0;
+}
+
+int DropOdd(const char *, char *data, void *)
+{
+  return (atoi(data) & 1) ? -1 : 0;
+}
+
+int Stop(const char *key, char *, void *arg)
+{
+  return !strcmp(key, static_cast<const char *>(arg)) ? 1 : 0;
+}
+}
+
+TEST(XrdOucHashMTTests, AddFindDel)
+{
+  XrdOucHashMT<char> tab(4, 8);
+
+  EXPECT_EQ(tab.Add("a", strdup("1"), 0, Hash_dofree), nullptr);
+  EXPECT_EQ(tab.Add("b", strdup("2"), 0, Hash_dofree), nullptr);
+  EXPECT_EQ(tab.Num(), 2);
+  EXPECT_STREQ(tab.Find("a"), "1");
+  EXPECT_STREQ(tab.Find("b"), "2");
+  EXPECT_EQ(tab.Find("c"), nullptr);
+
+  // Adding an existing key returns the current data and keeps it
+  char *dup = strdup("3");
+  EXPECT_STREQ(tab.Add("a", dup), "1");
+  free(dup);
+  EXPECT_STREQ(tab.Find("a"), "1");
+
+  // Replacing does not
+  EXPECT_EQ(tab.Rep("a", strdup("4"), 0, Hash_dofree), nullptr);
+  EXPECT_STREQ(tab.Find("a"), "4");
+  EXPECT_EQ(tab.Num(), 2);
+
+  EXPECT_EQ(tab.Del("a"), 0);
+  EXPECT_EQ(tab.Del("a"), -ENOENT);
+  EXPECT_EQ(tab.Find("a"), nullptr);
+  EXPECT_EQ(tab.Num(), 1);
+}
+
+TEST(XrdOucHashMTTests, Options)
+{
+  XrdOucHashMT<char> tab;
+  static char keep[] = "kept";
+
+  // The data may be the key itself
+  tab.Add("self", 0, 0, Hash_data_is_key);
+  EXPECT_STREQ(tab.Find("self"), "self");
+
+  // Counted entries need as many deletes as adds
+  tab.Add("cnt", keep, 0, (XrdOucHash_Options)(Hash_count | Hash_keepdata));
+  tab.Add("cnt", keep, 0, (XrdOucHash_Options)(Hash_count | Hash_keepdata));
+  EXPECT_EQ(tab.Del("cnt"), 0);
+  EXPECT_EQ(tab.Find("cnt"), keep);
+  EXPECT_EQ(tab.Del("cnt"), 0);
+  EXPECT_EQ(tab.Find("cnt"), nullptr);
+
+  // Kept data outlives the table entry
+  tab.Add("keep", keep, 0, Hash_keepdata);
+  tab.Purge();
+  EXPECT_EQ(tab.Num(), 0);
+  EXPECT_STREQ(keep, "kept");
+}
+
+TEST(XrdOucHashMTTests, Expiry)
+{
+  XrdOucHashMT<char> tab;
+  time_t when;
+
+  tab.Add("old", strdup("x"), -10, Hash_dofree);
+  tab.Add("new", strdup("y"), 3600, Hash_dofree);
+  EXPECT_EQ(tab.Find("old", &when), nullptr);
+  EXPECT_EQ(when, 0);
+  EXPECT_EQ(tab.Num(), 1);
+  EXPECT_STREQ(tab.Find("new", &when), "y");
+  EXPECT_GT(when, time(0));
+}
+
+TEST(XrdOucHashMTTests, GrowAndShrink)
+{
+  // A single tiny stripe grows many times, with lookups and deletes
+  // interleaved while it drains.
+  XrdOucHashMT<char> tab(1, 8);
+  const int n = 20000;
+
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(tab.Add(Key(i).c_str(), strdup(std::to_string(i).c_str()), 0,
+                      Hash_dofree), nullptr);
+    ASSERT_NE(tab.Find(Key(i).c_str()), nullptr);
+    if (i % 3 == 0) { ASSERT_EQ(tab.Del(Key(i / 3).c_str()), 0); }
+  }
+
+  int left = 0;
+  for (int i = 0; i < n; i++) {
+    const char *data = tab.Find(Key(i).c_str());
+    bool gone = (i <= (n - 1) / 3);
+    ASSERT_EQ(data == nullptr, gone) << i;
+    if (data) { EXPECT_EQ(atoi(data), i); left++; }
+  }
+  EXPECT_EQ(tab.Num(), left);
+
+  // Delete everything, each lookup must still work as holes appear
+  for (int i = 0; i < n; i++) tab.Del(Key(i).c_str());
+  EXPECT_EQ(tab.Num(), 0);
+}
+
+TEST(XrdOucHashMTTests, Apply)
+{
+  XrdOucHashMT<char> tab(8, 8);
+  const int n = 1000;
+
+  for (int i = 0; i < n; i++)
+    tab.Add(Key(i).c_str(), strdup(std::to_string(i).c_str()), 0, Hash_dofree);
+
+  std::set<std::string> seen;
+  EXPECT_EQ(tab.Apply(Collect, &seen), nullptr);
+  EXPECT_EQ((int)seen.size(), n);
+
+  EXPECT_EQ(tab.Apply(DropOdd, 0), nullptr);
+  EXPECT_EQ(tab.Num(), n / 2);
+  for (int i = 0; i < n; i++)
+    EXPECT_EQ(tab.Find(Key(i).c_str()) == nullptr, (i & 1) != 0) << i;
+
+  std::string want = Key(10);
+  EXPECT_STREQ(tab.Apply(Stop, (void *)want.c_str()), "10");
+}
+
+TEST(XrdOucHashMTTests, Concurrent)
+{
+  XrdOucHashMT<char> tab(16, 8);
+  const int nThreads = 8, n = 5000;
+  std::atomic<int> bad(0);
+  std::vector<std::thread> thr;
+
+  for (int t = 0; t < nThreads; t++)
+    thr.emplace_back([&, t]() {
+      for (int i = 0; i < n; i++) {
+        std::string k = Key(t * n + i);
+        tab.Add(k.c_str(), 0, 0, Hash_data_is_key);
+        if (!tab.Find(k.c_str())) bad++;
+        if (i & 1) tab.Del(k.c_str());
+      }
+      for (int i = 0; i < n; i++)
+        if ((tab.Find(Key(t * n + i).c_str()) == nullptr) != (i & 1)) bad++;
+    });
+  for (auto &th : thr) th.join();
+
+  EXPECT_EQ(bad.load(), 0);
+  EXPECT_EQ(tab.Num(), nThreads * n / 2);
+}
@@ -0,0 +1,100 @@
+/*
+ * Compare the in-flight block lookup structures of XrdPfc::File under a
+ * readv-heavy synthetic workload.
+ *
+ * Usage: xrdpfc-blockindex-bench [<threads> [<blocks> [<readvs>]]]
+ *
+ * <blocks> (default 256) blocks are registered in the index, roughly what a
+ * hot file holds in flight with a large prefetch window. Each of <threads>
+ * (default 4) threads then issues <readvs> (default 200000) vector reads of
+ * 64 chunks at random offsets, looking up every chunk's block under a single
+ * per-file mutex, as File::ReadOpusCoalescere does.
+ */
+
+#include "XrdPfc/XrdPfcBlockIndex.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Block { int m_idx; };
+
+const int chunksPerReadV = 64;
+
+template<typename Index, typename Find>
+double Run(Index &index, Find find, int nThreads, int nBlocks, int nReadV,
+           long long &hits)
+{
+  std::mutex mtx;
+  std::vector<std::thread> thr;
+  std::vector<long long> found(nThreads, 0);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int t = 0; t < nThreads; t++)
+    thr.emplace_back([&, t]() {
+      std::mt19937 rng(t + 1);
+      std::vector<int> chunks(chunksPerReadV);
+      long long n = 0;
+      for (int r = 0; r < nReadV; r++) {
+        // Chunks span twice the in-flight range, about half hit RAM.
+        for (int &c : chunks) c = rng() % (2 * nBlocks);
+        std::lock_guard<std::mutex> lck(mtx);
+        for (int c : chunks) if (find(index, c)) n++;
+      }
+      found[t] = n;
+    });
+  for (auto &th : thr) th.join();
+  auto t1 = std::chrono::steady_clock::now();
+
+  hits = 0;
+  for (long long n : found) hits += n;
+  return std::chrono::duration<double>(t1 - t0).count();
+}
+}
+
+int main(int argc, char *argv[])
+{
+  int nThreads = argc > 1 ? atoi(argv[1]) : 4;
+  int nBlocks  = argc > 2 ? atoi(argv[2]) : 256;
+  int nReadV   = argc > 3 ? atoi(argv[3]) : 200000;
+
+  if (nThreads < 1 || nBlocks < 1 || nReadV < 1) {
+    fprintf(stderr, "Usage: %s [<threads> [<blocks> [<readvs>]]]\n", argv[0]);
+    return 1;
+  }
+
+  // Register every other block so lookups mix hits and misses, and the
+  // indices are not simply dense.
+  std::vector<Block> blocks(2 * nBlocks);
+  std::map<int, Block*> map;
+  XrdPfc::BlockIndex<Block> flat;
+  for (int i = 0; i < 2 * nBlocks; i += 2) {
+    blocks[i].m_idx = i;
+    map[i] = &blocks[i];
+    flat.insert(i, &blocks[i]);
+  }
+
+  const double lookups = (double)nThreads * nReadV * chunksPerReadV;
+  long long hits;
+  double secs;
+
+  printf("%-10s %12s %12s\n", "index", "Mlookup/s", "hits");
+
+  secs = Run(map, [](std::map<int, Block*> &m, int i) -> Block* {
+           auto it = m.find(i); return it == m.end() ? nullptr : it->second; },
+         nThreads, nBlocks, nReadV, hits);
+  printf("%-10s %12.2f %12lld\n", "std::map", lookups / secs / 1e6, hits);
+
+  secs = Run(flat, [](XrdPfc::BlockIndex<Block> &b, int i) { return b.find(i); },
+         nThreads, nBlocks, nReadV, hits);
+  printf("%-10s %12.2f %12lld\n", "flat", lookups / secs / 1e6, hits);
+
+  return 0;
+}
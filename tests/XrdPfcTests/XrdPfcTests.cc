@@ -1,4 +1,13 @@
+#include "XrdPfc/XrdPfcBlockIndex.hh"
+#include "XrdPfc/XrdPfcNsIndex.hh"
 #include "XrdPfc/XrdPfcPathParseTools.hh"
+#include "XrdPfc/XrdPfcPrefetchScore.hh"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -83,3 +92,373 @@ TEST_F(PathParseToolTest, PathTokenizer)
     }
     clear_path();
 }
+
+TEST(BlockIndexTest, Basic)
+{
+    int blocks[4];
+    BlockIndex<int> bi;
+
+    EXPECT_TRUE(bi.empty());
+    EXPECT_EQ(bi.find(0), nullptr);
+    EXPECT_EQ(bi.erase(0), 0u);
+
+    for (int i = 0; i < 4; ++i)
+        bi.insert(i * 1000, &blocks[i]);
+    EXPECT_EQ(bi.size(), 4u);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(bi.find(i * 1000), &blocks[i]);
+    EXPECT_EQ(bi.find(1), nullptr);
+
+    bi.insert(0, &blocks[3]);
+    EXPECT_EQ(bi.size(), 4u);
+    EXPECT_EQ(bi.find(0), &blocks[3]);
+
+    EXPECT_EQ(bi.erase(2000), 1u);
+    EXPECT_EQ(bi.erase(2000), 0u);
+    EXPECT_EQ(bi.find(2000), nullptr);
+    EXPECT_EQ(bi.size(), 3u);
+
+    int n = 0;
+    bi.for_each([&](int, int*) { ++n; });
+    EXPECT_EQ(n, 3);
+}
+
+TEST(BlockIndexTest, MatchesStdMap)
+{
+    // Random insert / erase / lookup sequence, with growth and shrinkage,
+    // checked step by step against std::map.
+    std::vector<int>     pool(4096);
+    std::map<int, int*>  ref;
+    BlockIndex<int>      bi;
+    std::mt19937         rng(1234);
+
+    for (int step = 0; step < 200000; ++step)
+    {
+        // Mostly inserts in even phases, mostly erases in odd ones.
+        bool grow = (step / 20000) % 2 == 0;
+        int  idx  = rng() % 4096;
+        bool ins  = (int) (rng() % 4) < (grow ? 3 : 1);
+
+        if (ins)
+        {
+            bi.insert(idx, &pool[idx]);
+            ref[idx] = &pool[idx];
+        }
+        else
+        {
+            EXPECT_EQ(bi.erase(idx), ref.erase(idx));
+        }
+
+        int q = rng() % 4096;
+        auto it = ref.find(q);
+        ASSERT_EQ(bi.find(q), it == ref.end() ? nullptr : it->second);
+        ASSERT_EQ(bi.size(), ref.size());
+    }
+
+    for (auto &kv : ref)
+        EXPECT_EQ(bi.find(kv.first), kv.second);
+}
+
+namespace
+{
+    // Replays a whole index file image into a fresh index.
+    size_t ReplayImage(const std::string &image, NsIndex &idx, bool &corrupt)
+    {
+        EXPECT_TRUE(NsIndex::CheckHeader(image.data(), image.size()));
+        return NsIndex::s_header_len +
+               idx.Replay(image.data() + NsIndex::s_header_len,
+                          image.size() - NsIndex::s_header_len, corrupt);
+    }
+
+    void ExpectSame(const NsIndex &a, const NsIndex &b)
+    {
+        ASSERT_EQ(a.Size(), b.Size());
+        for (auto &[lfn, e] : a.RefMap())
+        {
+            const NsIndex::Entry *f = b.Find(lfn);
+            ASSERT_NE(f, nullptr) << lfn;
+            EXPECT_EQ(f->m_StBlocks, e.m_StBlocks) << lfn;
+            EXPECT_EQ(f->m_AccessTime, e.m_AccessTime) << lfn;
+        }
+    }
+}
+
+TEST(NsIndexTest, Events)
+{
+    NsIndex idx;
+    const NsIndex::Entry *e;
+
+    idx.Open("/a/f1", 0, 100);
+    idx.Grow("/a/f1", 64);
+    ASSERT_NE(e = idx.Find("/a/f1"), nullptr);
+    EXPECT_EQ(e->m_StBlocks, 64);
+    EXPECT_EQ(e->m_NOpen, 1);
+    idx.Close("/a/f1", 110);
+    EXPECT_EQ(e->m_AccessTime, 110);
+    EXPECT_EQ(e->m_NOpen, 0);
+
+    // Removal of a closed file forgets it.
+    idx.Purge("/a/f1", 64);
+    EXPECT_EQ(idx.Find("/a/f1"), nullptr);
+
+    // Removal of an open file only takes effect on close.
+    idx.Open("/a/f2", 32, 200);
+    idx.Purge("/a/f2", 32);
+    ASSERT_NE(e = idx.Find("/a/f2"), nullptr);
+    EXPECT_EQ(e->m_StBlocks, 0);
+    idx.Close("/a/f2", 210);
+    EXPECT_EQ(idx.Find("/a/f2"), nullptr);
+
+    // Events for unknown files are ignored.
+    idx.Grow("/a/f3", 8);
+    idx.Close("/a/f3", 300);
+    idx.Purge("/a/f3", 8);
+    EXPECT_EQ(idx.Size(), 0u);
+}
+
+TEST(NsIndexTest, ForEachUnder)
+{
+    NsIndex idx;
+    for (const char *lfn : { "/a/x", "/a/b/y", "/a/b/z", "/ab/w", "/a0", "/c" })
+        idx.Load(lfn, 8, 1);
+
+    auto under = [&](const char *dir) {
+        std::vector<std::string> v;
+        idx.ForEachUnder(dir, [&](const std::string &lfn, const NsIndex::Entry &) { v.push_back(lfn); });
+        return v;
+    };
+    EXPECT_EQ(under("/a"),   (std::vector<std::string>{ "/a/b/y", "/a/b/z", "/a/x" }));
+    EXPECT_EQ(under("/a/b/"), (std::vector<std::string>{ "/a/b/y", "/a/b/z" }));
+    EXPECT_EQ(under("/"),    (std::vector<std::string>{ "/a/b/y", "/a/b/z", "/a/x", "/a0", "/ab/w", "/c" }));
+    EXPECT_TRUE(under("/d").empty());
+}
+
+TEST(NsIndexTest, ForEachIn)
+{
+    NsIndex idx;
+    for (const char *lfn : { "/a/b-x", "/a/b/y", "/a/b/c/z", "/a/b0", "/a/x", "/ab/w", "/c" })
+        idx.Load(lfn, 8, 1);
+
+    auto in = [&](const char *dir) {
+        std::vector<std::string> v;
+        idx.ForEachIn(dir, [&](const std::string &lfn, const NsIndex::Entry &) { v.push_back(lfn); });
+        return v;
+    };
+    EXPECT_EQ(in("/a/"), (std::vector<std::string>{ "/a/b-x", "/a/b0", "/a/x" }));
+    EXPECT_EQ(in("/a/b"), (std::vector<std::string>{ "/a/b/y" }));
+    EXPECT_EQ(in("/"),   (std::vector<std::string>{ "/c" }));
+    EXPECT_TRUE(in("/d/").empty());
+
+    // Only open files directly in the directory count.
+    EXPECT_FALSE(idx.HasOpenIn("/a/"));
+    idx.Open("/a/b/c/z", 8, 2);
+    EXPECT_FALSE(idx.HasOpenIn("/a/b/"));
+    EXPECT_TRUE(idx.HasOpenIn("/a/b/c/"));
+    idx.Close("/a/b/c/z", 3);
+    EXPECT_FALSE(idx.HasOpenIn("/a/b/c/"));
+}
+
+TEST(NsIndexTest, CopyUnder)
+{
+    // Going through a subtree in chunks yields what ForEachUnder does, even
+    // when files are added and removed between the chunks.
+    NsIndex idx;
+    for (int i = 0; i < 100; ++i)
+        idx.Load("/d/" + std::to_string(1000 + i), i, 1);
+    idx.Load("/e/1", 1, 1);
+
+    std::vector<std::pair<std::string, NsIndex::Entry>> chunk;
+    std::vector<std::string> seen;
+    std::string after;
+    do
+    {
+        idx.CopyUnder("/d", after, 7, chunk);
+        for (auto &c : chunk) seen.push_back(c.first);
+        if ( ! chunk.empty()) after = chunk.back().first;
+        if (seen.size() == 14)
+        {
+            idx.Erase("/d/1014");
+            idx.Erase("/d/1003");
+            idx.Load("/d/1099a", 1, 1);
+        }
+    } while (chunk.size() == 7);
+
+    ASSERT_EQ(seen.size(), 100u);
+    EXPECT_EQ(seen[13], "/d/1013");
+    EXPECT_EQ(seen[14], "/d/1015");
+    EXPECT_EQ(seen.back(), "/d/1099a");
+    EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+}
+
+TEST(NsIndexTest, JournalReplay)
+{
+    // A log made of a snapshot followed by journals replays into the same
+    // index, and compacts into a snapshot of the expected size.
+    NsIndex      idx;
+    std::mt19937 rng(4321);
+    std::string  image;
+
+    NsIndex::WriteHeader(image);
+    for (int step = 0; step < 20000; ++step)
+    {
+        std::string lfn = "/store/d" + std::to_string(rng() % 16) + "/f" + std::to_string(rng() % 256);
+        switch (rng() % 5)
+        {
+            case 0: idx.Open(lfn, rng() % 1000, step);  break;
+            case 1: idx.Grow(lfn, rng() % 100);         break;
+            case 2: idx.Close(lfn, step);               break;
+            case 3: idx.Purge(lfn, rng() % 1000);       break;
+            case 4: idx.Erase(lfn);                     break;
+        }
+        if (step % 1000 == 999)
+        {
+            image += idx.RefJournal();
+            idx.RefJournal().clear();
+        }
+    }
+
+    NsIndex re;
+    bool    corrupt;
+    EXPECT_EQ(ReplayImage(image, re, corrupt), image.size());
+    EXPECT_FALSE(corrupt);
+    ExpectSame(idx, re);
+    ExpectSame(re, idx);
+
+    std::string snap;
+    EXPECT_TRUE(idx.Snapshot([&](const char *buf, size_t len) { snap.append(buf, len); return true; }, 4096));
+    EXPECT_EQ((long long) snap.size(), idx.SnapshotSize());
+    EXPECT_EQ((long long) snap.size(), re.SnapshotSize());
+    EXPECT_LT(snap.size(), image.size());
+
+    NsIndex re2;
+    EXPECT_EQ(ReplayImage(snap, re2, corrupt), snap.size());
+    ExpectSame(idx, re2);
+}
+
+TEST(NsIndexTest, DamagedTail)
+{
+    NsIndex idx;
+    std::string image;
+    NsIndex::WriteHeader(image);
+    idx.Open("/f1", 10, 1);
+    idx.Open("/f2", 20, 2);
+    image += idx.RefJournal();
+    size_t good = image.size();
+    idx.RefJournal().clear();
+    idx.Open("/f3", 30, 3);
+    std::string last = idx.RefJournal();
+
+    bool corrupt;
+
+    // A torn last record is left unconsumed.
+    {
+        NsIndex re;
+        std::string torn = image + last.substr(0, last.size() - 2);
+        EXPECT_EQ(ReplayImage(torn, re, corrupt), good);
+        EXPECT_FALSE(corrupt);
+        EXPECT_EQ(re.Size(), 2u);
+    }
+    // A damaged record stops the replay.
+    {
+        NsIndex re;
+        std::string bad = image + last;
+        bad[bad.size() - 1] ^= 0x20;
+        EXPECT_EQ(ReplayImage(bad, re, corrupt), good);
+        EXPECT_TRUE(corrupt);
+        EXPECT_EQ(re.Find("/f3"), nullptr);
+        const NsIndex::Entry *e = re.Find("/f2");
+        ASSERT_NE(e, nullptr);
+        EXPECT_EQ(e->m_StBlocks, 20);
+    }
+    // Garbage is not mistaken for an index.
+    EXPECT_FALSE(NsIndex::CheckHeader("XrdPfcNsIdx", 11));
+    EXPECT_FALSE(NsIndex::CheckHeader(last.data(), last.size()));
+}
+
+TEST(PrefetchScoreTest, Warmup)
+{
+    PrefetchScore ps;
+    EXPECT_FLOAT_EQ(ps.Priority(), 1.0f);
+    EXPECT_EQ(ps.Window(20, 0), 2);
+    EXPECT_EQ(ps.Window(2, 0), 1);
+
+    // not trusted yet, even with nothing read
+    ps.AddReads(PrefetchScore::WarmupBlocks - 1);
+    EXPECT_FLOAT_EQ(ps.Score(), 0.0f);
+    EXPECT_FLOAT_EQ(ps.Priority(), 1.0f);
+    EXPECT_EQ(ps.Window(20, 0), 2);
+
+    ps.AddReads(1);
+    EXPECT_TRUE(ps.Warm());
+    EXPECT_FLOAT_EQ(ps.Priority(), 0.1f);
+    EXPECT_EQ(ps.Window(20, 0), 1);
+}
+
+TEST(PrefetchScoreTest, Scoring)
+{
+    PrefetchScore ps;
+    ps.AddReads(10);
+    ps.AddHits(5);
+    EXPECT_FLOAT_EQ(ps.Score(), 0.5f);
+    EXPECT_FLOAT_EQ(ps.Priority(), 0.6f);
+    EXPECT_EQ(ps.Window(20, 0), 6);
+
+    ps.AddHits(5);
+    EXPECT_FLOAT_EQ(ps.Score(), 1.0f);
+    EXPECT_FLOAT_EQ(ps.Priority(), 1.1f);
+    EXPECT_EQ(ps.Window(20, 0), 10);
+
+    // blocks read by clients without being counted as prefetched do not
+    // push the score past one
+    ps.AddHits(10);
+    EXPECT_FLOAT_EQ(ps.Priority(), 1.1f);
+    EXPECT_EQ(ps.Window(20, 0), 10);
+}
+
+TEST(PrefetchScoreTest, Throttling)
+{
+    PrefetchScore ps;
+    ps.AddReads(10);
+    ps.AddHits(10);
+
+    // the window is limited by the room left for blocks in flight
+    EXPECT_EQ(ps.Window(20, 15), 5);
+    EXPECT_EQ(ps.Window(20, 19), 1);
+
+    // but a file always gets at least one block per decision
+    EXPECT_EQ(ps.Window(20, 20), 1);
+    EXPECT_EQ(ps.Window(20, 30), 1);
+    EXPECT_EQ(ps.Window(1, 0), 1);
+}
+
+TEST(PrefetchScoreTest, TakeFillsWindow)
+{
+    // A window of 8 blocks, 6 of which the access pattern already took from
+    // further down the file. The lowest missing blocks fill the rest.
+    const int n_max = 8;
+    std::vector<int> blks = { 40, 41, 42, 43, 44, 45 };
+    std::vector<bool> written(64, false);
+    written[0] = written[2] = true;
+
+    auto missing = [&](int b) {
+        return ! written[b] && std::find(blks.begin(), blks.end(), b) == blks.end();
+    };
+    auto take = [&](int b) { blks.push_back(b); return true; };
+
+    EXPECT_EQ(PrefetchTake(0, 64, n_max - (int) blks.size(), missing, take), 2);
+    EXPECT_EQ(blks.size(), 8u);
+    EXPECT_EQ(blks[6], 1);
+    EXPECT_EQ(blks[7], 3);
+
+    // Nothing more fits.
+    EXPECT_EQ(PrefetchTake(0, 64, n_max - (int) blks.size(), missing, take), 0);
+
+    // A failed request ends the walk.
+    int calls = 0;
+    auto fail = [&](int) { ++calls; return false; };
+    EXPECT_EQ(PrefetchTake(0, 64, 4, missing, fail), 0);
+    EXPECT_EQ(calls, 1);
+
+    // The end of the file ends it too.
+    EXPECT_EQ(PrefetchTake(60, 64, 10, missing, take), 4);
+}
@@ -0,0 +1,134 @@
+#include "XrdPss/XrdPssCoalesce.hh"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const char          *thePath = "/pss/coalesce";
+const unsigned long  theHash = 42;
+
+// Waits until n reads have joined a flight
+void WaitJoins(XrdPssCoalesce &coal, int n)
+{
+  std::string want = "<join>" + std::to_string(n) + "</join>";
+  char buff[512];
+  for (int i = 0; i < 5000; i++)
+      {int len = coal.Stats(buff, sizeof(buff));
+       if (std::string(buff, len).find(want) != std::string::npos) return;
+       std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+  FAIL() << "no " << want;
+}
+}
+
+TEST(XrdPssCoalesceTests, StartModes)
+{
+  XrdPssCoalesce coal(1 << 20, 1 << 16);
+  std::vector<char> b1(4096), b2(4096), b3(4096);
+  XrdPssCoalesce::Flight *f1, *f2, *f3;
+
+  EXPECT_EQ(coal.Start(thePath, theHash, b1.data(), 0, 4096, f1),
+            XrdPssCoalesce::aioLead);
+  ASSERT_NE(f1, nullptr);
+
+  // overlapping reads must wait, disjoint ones lead their own flight
+  EXPECT_EQ(coal.Start(thePath, theHash, b2.data(), 1000, 4096, f2),
+            XrdPssCoalesce::aioJoin);
+  EXPECT_EQ(f2, nullptr);
+  EXPECT_EQ(coal.Start(thePath, theHash, b2.data(), 4096, 4096, f2),
+            XrdPssCoalesce::aioLead);
+  ASSERT_NE(f2, nullptr);
+
+  // the same range of another file is a different flight
+  EXPECT_EQ(coal.Start("/pss/other", theHash, b3.data(), 0, 4096, f3),
+            XrdPssCoalesce::aioLead);
+  ASSERT_NE(f3, nullptr);
+
+  // once landed, the range is free again
+  coal.Landed(f1, 4096);
+  EXPECT_EQ(coal.Start(thePath, theHash, b1.data(), 1000, 2000, f1),
+            XrdPssCoalesce::aioLead);
+  coal.Landed(f1, 2000);
+  coal.Landed(f2, 4096);
+  coal.Landed(f3, 4096);
+}
+
+TEST(XrdPssCoalesceTests, Window)
+{
+  XrdPssCoalesce coal(1000, 600);
+  std::vector<char> buff(4096);
+  XrdPssCoalesce::Flight *f1, *f2;
+
+  // too large to be shared
+  EXPECT_EQ(coal.Start(thePath, theHash, buff.data(), 0, 700, f1),
+            XrdPssCoalesce::aioSkip);
+  EXPECT_EQ(f1, nullptr);
+
+  EXPECT_EQ(coal.Start(thePath, theHash, buff.data(), 0, 600, f1),
+            XrdPssCoalesce::aioLead);
+
+  // the window is full
+  EXPECT_EQ(coal.Start(thePath, theHash, buff.data(), 1000, 600, f2),
+            XrdPssCoalesce::aioSkip);
+  EXPECT_EQ(f2, nullptr);
+
+  coal.Landed(f1, 600);
+  EXPECT_EQ(coal.Start(thePath, theHash, buff.data(), 1000, 600, f2),
+            XrdPssCoalesce::aioLead);
+  coal.Landed(f2, 600);
+}
+
+TEST(XrdPssCoalesceTests, JoinAsyncFlight)
+{
+  XrdPssCoalesce coal(1 << 20, 1 << 16);
+  std::vector<char> lead(8192), mine(1000, 0);
+  for (size_t i = 0; i < lead.size(); i++) lead[i] = char(i * 7);
+  XrdPssCoalesce::Flight *fP;
+
+  ASSERT_EQ(coal.Start(thePath, theHash, lead.data(), 0, 8192, fP),
+            XrdPssCoalesce::aioLead);
+
+  // a read entirely covered by the flight never goes upstream (the file
+  // descriptor is not even valid)
+  ssize_t rc = 0;
+  std::thread joiner([&]()
+    {rc = coal.Read(-1, thePath, theHash, mine.data(), 3000, mine.size());});
+  WaitJoins(coal, 1);
+  coal.Landed(fP, 8192);
+  joiner.join();
+
+  EXPECT_EQ(rc, 1000);
+  EXPECT_EQ(memcmp(mine.data(), lead.data() + 3000, mine.size()), 0);
+
+  char buff[512];
+  int len = coal.Stats(buff, sizeof(buff));
+  EXPECT_NE(std::string(buff, len).find("<saved>1000</saved>"),
+            std::string::npos);
+}
+
+TEST(XrdPssCoalesceTests, JoinShortFlight)
+{
+  XrdPssCoalesce coal(1 << 20, 1 << 16);
+  std::vector<char> lead(8192, 'x'), mine(2000, 0);
+  XrdPssCoalesce::Flight *fP;
+
+  ASSERT_EQ(coal.Start(thePath, theHash, lead.data(), 0, 8192, fP),
+            XrdPssCoalesce::aioLead);
+
+  // the flight hits the end of file half way through our range
+  ssize_t rc = 0;
+  std::thread joiner([&]()
+    {rc = coal.Read(-1, thePath, theHash, mine.data(), 4000, mine.size());});
+  WaitJoins(coal, 1);
+  coal.Landed(fP, 5000);
+  joiner.join();
+
+  EXPECT_EQ(rc, 1000);
+  EXPECT_EQ(std::string(mine.data(), 1000), std::string(1000, 'x'));
+}
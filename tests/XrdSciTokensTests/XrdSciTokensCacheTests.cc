@@ -0,0 +1,175 @@
+#undef NDEBUG
+
+#include "XrdSciTokens/XrdSciTokensCache.hh"
+#include "XrdSciTokens/XrdSciTokensPathTrie.hh"
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class XrdSciTokensCacheTests : public ::testing::Test {};
+
+namespace
+{
+typedef std::vector<std::pair<Access_Operation, std::string>> Rules;
+
+// The rule check the trie replaces: a linear scan with prefix compares
+bool IsSubdir(const std::string &dir, const std::string &subdir)
+{
+  if (subdir.size() < dir.size()) return false;
+  if (subdir.compare(0, dir.size(), dir) != 0) return false;
+  return dir.size() == subdir.size() || subdir[dir.size()] == '/' || dir == "/";
+}
+
+bool Linear(const Rules &rules, Access_Operation oper, const std::string &path)
+{
+  for (const auto &rule : rules) {
+    if (rule.first != oper) continue;
+    if (rule.second == "/") return true;
+    if (IsSubdir(rule.second, path)) return true;
+    if ((oper == AOP_Stat || oper == AOP_Mkdir) && IsSubdir(path, rule.second))
+      return true;
+  }
+  return false;
+}
+
+XrdSciTokensPathTrie Compile(const Rules &rules)
+{
+  XrdSciTokensPathTrie trie;
+  for (const auto &rule : rules) trie.Add(rule.first, rule.second);
+  return trie;
+}
+}
+
+TEST(XrdSciTokensCacheTests, TrieRules)
+{
+  Rules rules = {{AOP_Read, "/store/data"},  {AOP_Stat, "/store/data"},
+                 {AOP_Create, "/store/user/alice"}, {AOP_Mkdir, "/store/user/alice"},
+                 {AOP_Read, "/public"}};
+  auto trie = Compile(rules);
+
+  EXPECT_TRUE(trie.Allowed(AOP_Read, "/store/data"));
+  EXPECT_TRUE(trie.Allowed(AOP_Read, "/store/data/run1/f.root"));
+  EXPECT_FALSE(trie.Allowed(AOP_Read, "/store/database"));
+  EXPECT_FALSE(trie.Allowed(AOP_Read, "/store"));
+  EXPECT_FALSE(trie.Allowed(AOP_Update, "/store/data/f"));
+
+  // Stat and mkdir extend to the parents of their rules
+  EXPECT_TRUE(trie.Allowed(AOP_Stat, "/"));
+  EXPECT_TRUE(trie.Allowed(AOP_Stat, "/store"));
+  EXPECT_TRUE(trie.Allowed(AOP_Mkdir, "/store/user"));
+  EXPECT_FALSE(trie.Allowed(AOP_Mkdir, "/store/data"));
+  EXPECT_FALSE(trie.Allowed(AOP_Stat, "/public"));
+
+  // A rule on the root allows everything
+  XrdSciTokensPathTrie all;
+  all.Add(AOP_Read, "/");
+  EXPECT_TRUE(all.Allowed(AOP_Read, "/any/where"));
+  EXPECT_TRUE(all.Allowed(AOP_Read, "relative"));
+  EXPECT_FALSE(all.Allowed(AOP_Stat, "/any/where"));
+}
+
+TEST(XrdSciTokensCacheTests, TrieMatchesLinearScan)
+{
+  // Random rules and paths over a tiny alphabet so that prefixes, parents,
+  // repeated and trailing slashes all occur often.
+  const char *comps[] = {"a", "b", "ab", "a.b"};
+  const Access_Operation ops[] = {AOP_Read, AOP_Stat, AOP_Mkdir, AOP_Create};
+  std::mt19937 rng(12345);
+
+  auto randPath = [&](bool canonical) {
+    if (!canonical && rng() % 8 == 0) return std::string(rng() % 2 ? "" : "a/b");
+    std::string path;
+    int depth = rng() % 4;
+    for (int i = 0; i < depth; i++) {
+      path += "/";
+      if (!canonical && rng() % 10 == 0) path += "/";
+      path += comps[rng() % 4];
+    }
+    if (path.empty() || (!canonical && rng() % 6 == 0)) path += "/";
+    return path;
+  };
+
+  for (int round = 0; round < 500; round++) {
+    Rules rules;
+    int n = rng() % 5;
+    for (int i = 0; i < n; i++)
+      rules.emplace_back(ops[rng() % 4], randPath(true));
+    auto trie = Compile(rules);
+
+    for (int i = 0; i < 200; i++) {
+      std::string path = randPath(false);
+      for (auto op : ops)
+        ASSERT_EQ(trie.Allowed(op, path.c_str()), Linear(rules, op, path))
+            << "op " << op << " path '" << path << "' round " << round;
+    }
+  }
+}
+
+TEST(XrdSciTokensCacheTests, CacheExpiry)
+{
+  XrdSciTokensCache<int> cache(100, 4);
+
+  cache.Insert("t1", std::make_shared<int>(1), 10);
+  cache.Insert("t2", std::make_shared<int>(2), 20);
+  ASSERT_TRUE(cache.Find("t1", 5));
+  EXPECT_EQ(*cache.Find("t1", 10), 1);
+  EXPECT_FALSE(cache.Find("t1", 11));
+  EXPECT_EQ(cache.Size(), 1u);
+
+  cache.Insert("t2", std::make_shared<int>(3), 40);
+  EXPECT_EQ(*cache.Find("t2", 30), 3);
+  cache.Insert("t4", std::make_shared<int>(4), 25);
+  EXPECT_EQ(cache.Expire(30), 1u);
+  EXPECT_EQ(cache.Size(), 1u);
+  EXPECT_FALSE(cache.Find("t4", 0));
+}
+
+TEST(XrdSciTokensCacheTests, CacheEviction)
+{
+  // One shard so that the least recently used entry is well defined
+  XrdSciTokensCache<int> cache(3, 1);
+
+  for (int i = 0; i < 3; i++)
+    cache.Insert("t" + std::to_string(i), std::make_shared<int>(i), 100);
+  ASSERT_TRUE(cache.Find("t0", 0));
+  cache.Insert("t3", std::make_shared<int>(3), 100);
+
+  EXPECT_EQ(cache.Size(), 3u);
+  EXPECT_TRUE(cache.Find("t0", 0));
+  EXPECT_FALSE(cache.Find("t1", 0));
+  EXPECT_TRUE(cache.Find("t3", 0));
+
+  cache.SetMaxEntries(1);
+  cache.Insert("t4", std::make_shared<int>(4), 100);
+  EXPECT_EQ(cache.Size(), 1u);
+  EXPECT_TRUE(cache.Find("t4", 0));
+}
+
+TEST(XrdSciTokensCacheTests, CacheConcurrent)
+{
+  XrdSciTokensCache<int> cache(1000, 8);
+  std::vector<std::thread> thr;
+  std::atomic<int> bad(0);
+
+  for (int t = 0; t < 8; t++)
+    thr.emplace_back([&, t]() {
+      for (int i = 0; i < 20000; i++) {
+        std::string key = "tok" + std::to_string((t * 7919 + i) % 1500);
+        auto val = cache.Find(key, i);
+        if (val && *val != (t * 7919 + i) % 1500) bad++;
+        if (!val) cache.Insert(key, std::make_shared<int>((t * 7919 + i) % 1500),
+                               i + 100);
+        if (i % 5000 == 0) cache.Expire(i);
+      }
+    });
+  for (auto &th : thr) th.join();
+
+  EXPECT_EQ(bad.load(), 0);
+  EXPECT_LE(cache.Size(), 1000u);
+}
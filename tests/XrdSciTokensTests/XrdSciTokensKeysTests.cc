@@ -0,0 +1,195 @@
+#undef NDEBUG
+
+#include "XrdSciTokens/XrdSciTokensKeys.hh"
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+class XrdSciTokensKeysTests : public ::testing::Test {};
+
+namespace
+{
+// A fetcher standing in for the issuers: it records what was fetched and
+// fails for the issuers listed as down.
+struct Fetcher
+{
+  std::map<std::string, int> calls;
+  std::map<std::string, std::string> files;
+  std::set<std::string> down;
+
+  XrdSciTokensKeys::FetchFunc Func()
+  {
+    return [this](const std::string &issuer, const std::string &jwks_file) {
+      calls[issuer]++;
+      files[issuer] = jwks_file;
+      return !down.count(issuer);
+    };
+  }
+};
+}
+
+TEST(XrdSciTokensKeysTests, RefreshSchedule)
+{
+  Fetcher fetcher;
+  XrdSciTokensKeys keys(fetcher.Func(), 300, 10);
+
+  keys.SetIssuers({{"https://a.example", ""},
+                   {"https://b.example", "/etc/xrootd/b.jwks"}});
+  EXPECT_TRUE(keys.Pending("https://a.example"));
+  EXPECT_FALSE(keys.Pending("https://unknown.example"));
+
+  // Both are fetched at once, and not again until the refresh interval
+  EXPECT_EQ(keys.Refresh(1000), 1300u);
+  EXPECT_EQ(fetcher.calls["https://a.example"], 1);
+  EXPECT_EQ(fetcher.files["https://b.example"], "/etc/xrootd/b.jwks");
+  EXPECT_FALSE(keys.Pending("https://a.example"));
+  EXPECT_FALSE(keys.Pending("https://b.example"));
+
+  EXPECT_EQ(keys.Refresh(1299), 1300u);
+  EXPECT_EQ(fetcher.calls["https://a.example"], 1);
+  EXPECT_EQ(keys.Refresh(1300), 1600u);
+  EXPECT_EQ(fetcher.calls["https://a.example"], 2);
+  EXPECT_EQ(fetcher.calls["https://b.example"], 2);
+
+  // Keeping an issuer keeps its state; changing its key file refetches it
+  keys.SetIssuers({{"https://a.example", ""},
+                   {"https://b.example", "/etc/xrootd/b2.jwks"}});
+  EXPECT_FALSE(keys.Pending("https://a.example"));
+  EXPECT_TRUE(keys.Pending("https://b.example"));
+  EXPECT_EQ(keys.Refresh(1301), 1600u);
+  EXPECT_EQ(fetcher.calls["https://a.example"], 2);
+  EXPECT_EQ(fetcher.calls["https://b.example"], 3);
+
+  // Dropped issuers are forgotten
+  keys.SetIssuers({{"https://b.example", "/etc/xrootd/b2.jwks"}});
+  EXPECT_FALSE(keys.Pending("https://a.example"));
+  EXPECT_EQ(keys.Refresh(1600), 1601u);
+  EXPECT_EQ(fetcher.calls["https://a.example"], 2);
+
+  keys.SetIssuers({});
+  EXPECT_EQ(keys.Refresh(2000), 0u);
+}
+
+TEST(XrdSciTokensKeysTests, RetryBackoff)
+{
+  Fetcher fetcher;
+  XrdSciTokensKeys keys(fetcher.Func(), 300, 10);
+  const std::string iss = "https://a.example";
+
+  keys.SetIssuers({{iss, ""}});
+  fetcher.down.insert(iss);
+
+  // Retries back off from the retry interval up to the refresh interval
+  uint64_t now = 1000;
+  for (uint64_t wait : {10, 20, 40, 80, 160, 300, 300}) {
+    EXPECT_EQ(keys.Refresh(now), now + wait);
+    EXPECT_TRUE(keys.Pending(iss));
+    now += wait;
+  }
+
+  // A token needing the keys brings the next try forward, but never sooner
+  // than the retry interval after the last one
+  now -= 300;
+  keys.Kick(iss, now + 1);
+  EXPECT_EQ(keys.Refresh(now + 1), now + 10);
+  EXPECT_EQ(keys.Refresh(now + 10), now + 10 + 300);
+  EXPECT_EQ(fetcher.calls[iss], 8);
+
+  // Success resets the backoff, and a later failure keeps the keys in use
+  fetcher.down.clear();
+  now += 10 + 300;
+  EXPECT_EQ(keys.Refresh(now), now + 300);
+  EXPECT_FALSE(keys.Pending(iss));
+  fetcher.down.insert(iss);
+  now += 300;
+  EXPECT_EQ(keys.Refresh(now), now + 10);
+  EXPECT_FALSE(keys.Pending(iss));
+
+  // Kicking an issuer whose keys are fine changes nothing
+  keys.Kick("https://unknown.example", now);
+  keys.Kick(iss, now + 10);
+  EXPECT_EQ(keys.Refresh(now + 9), now + 10);
+}
+
+TEST(XrdSciTokensKeysTests, CachedKeys)
+{
+  Fetcher fetcher;
+  std::set<std::string> cached = {"https://a.example"};
+  int probes = 0;
+  XrdSciTokensKeys keys(fetcher.Func(), 300, 10,
+                        [&](const std::string &issuer) {
+                          probes++;
+                          return cached.count(issuer) != 0;
+                        });
+
+  // An issuer with cached keys is usable before its first fetch, even if
+  // that fetch fails, and the cache is not consulted again
+  keys.SetIssuers({{"https://a.example", ""}, {"https://b.example", ""}});
+  fetcher.down = {"https://a.example", "https://b.example"};
+  EXPECT_FALSE(keys.Pending("https://a.example"));
+  EXPECT_FALSE(keys.Pending("https://a.example"));
+  EXPECT_EQ(probes, 1);
+  keys.Refresh(1000);
+  EXPECT_FALSE(keys.Pending("https://a.example"));
+
+  // An issuer without cached keys stays pending until a fetch succeeds,
+  // picking up keys that get cached meanwhile at the next refresh pass
+  probes = 0;
+  EXPECT_TRUE(keys.Pending("https://b.example"));
+  EXPECT_TRUE(keys.Pending("https://b.example"));
+  EXPECT_EQ(probes, 1);
+  cached.insert("https://b.example");
+  EXPECT_TRUE(keys.Pending("https://b.example"));
+  EXPECT_EQ(probes, 1);
+  keys.Refresh(1001);
+  EXPECT_FALSE(keys.Pending("https://b.example"));
+  EXPECT_EQ(probes, 2);
+
+  // Unknown issuers are never looked up
+  probes = 0;
+  EXPECT_FALSE(keys.Pending("https://unknown.example"));
+  EXPECT_EQ(probes, 0);
+}
+
+TEST(XrdSciTokensKeysTests, BackgroundThread)
+{
+  Fetcher fetcher;
+  XrdSciTokensKeys keys(fetcher.Func(), 300, 10);
+
+  keys.SetIssuers({{"https://a.example", ""}});
+  keys.Start();
+  EXPECT_TRUE(keys.WaitTried(std::chrono::seconds(10)));
+  EXPECT_FALSE(keys.Pending("https://a.example"));
+
+  // Issuers added later are picked up without waiting for the next refresh
+  fetcher.down.insert("https://b.example");
+  keys.SetIssuers({{"https://a.example", ""}, {"https://b.example", ""}});
+  EXPECT_TRUE(keys.WaitTried(std::chrono::seconds(10)));
+  EXPECT_TRUE(keys.Pending("https://b.example"));
+  keys.Stop();
+
+  EXPECT_EQ(fetcher.calls["https://a.example"], 1);
+  EXPECT_EQ(fetcher.calls["https://b.example"], 1);
+}
+
+TEST(XrdSciTokensKeysTests, TokenIssuer)
+{
+  std::string iss;
+
+  // {"alg":"ES256","kid":"key-rs256","typ":"JWT"}.{"iss":"https://demo.scitokens.org","sub":"u"}
+  EXPECT_TRUE(XrdSciTokensKeys::TokenIssuer(
+      "eyJhbGciOiJFUzI1NiIsImtpZCI6ImtleS1yczI1NiIsInR5cCI6IkpXVCJ9."
+      "eyJpc3MiOiJodHRwczovL2RlbW8uc2NpdG9rZW5zLm9yZyIsInN1YiI6InUifQ.sig",
+      iss));
+  EXPECT_EQ(iss, "https://demo.scitokens.org");
+
+  // {"sub":"u"} has no issuer
+  EXPECT_FALSE(XrdSciTokensKeys::TokenIssuer("e30.eyJzdWIiOiJ1In0.sig", iss));
+  EXPECT_FALSE(XrdSciTokensKeys::TokenIssuer("eyJzdWIiOiJ1In0", iss));
+  EXPECT_FALSE(XrdSciTokensKeys::TokenIssuer("e30.!!!!.sig", iss));
+  EXPECT_FALSE(XrdSciTokensKeys::TokenIssuer("e30.bm90IGpzb24.sig", iss));
+}
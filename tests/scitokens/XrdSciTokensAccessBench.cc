@@ -0,0 +1,245 @@
+/*
+ * Measure the SciTokens authorization plugin's Access() throughput.
+ *
+ * Usage: xrdscitokens-access-bench <issuerdir> [<threads> [<tokens> [<requests>]]]
+ *
+ * The issuer directory is the one made by setup.sh. Its first key pair signs
+ * <tokens> (default 1000) WLCG profile tokens. Each token carries the scopes a
+ * VO typically grants a user: read of the VO area, plus create and modify of
+ * the user's own area. The plugin loads the issuer's public keys from the
+ * JWKS file in the issuer directory, so no issuer has to be reachable.
+ *
+ * The <threads> (default 8) threads first present each token once, which
+ * parses it, and then each makes <requests> (default 200000) requests for
+ * random tokens, operations and paths. All requests should be allowed. The
+ * rate of the first (parsing) pass and the rate of the cached requests are
+ * reported separately.
+ */
+
+#include "XrdAcc/XrdAccAuthorize.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSec/XrdSecEntity.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <scitokens/scitokens.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const char *issuer   = "https://bench.example.org/vo";
+const char *audience = "https://xrootd.example.org:1094";
+
+bool ReadFile(const std::string &fn, std::string &data)
+{
+  std::ifstream in(fn);
+  if (!in) {
+    fprintf(stderr, "Unable to read %s\n", fn.c_str());
+    return false;
+  }
+  std::stringstream ss;
+  ss << in.rdbuf();
+  data = ss.str();
+  return true;
+}
+
+bool WriteFile(const std::string &fn, const std::string &data)
+{
+  std::ofstream out(fn, std::ios::trunc);
+  out << data;
+  if (!out) {
+    fprintf(stderr, "Unable to write %s\n", fn.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::string MakeToken(SciTokenKey key, int user)
+{
+  using TokenPtr = std::unique_ptr<void, decltype(&scitoken_destroy)>;
+  TokenPtr token(scitoken_create(key), scitoken_destroy);
+  std::string sub = "user" + std::to_string(user);
+  std::string scope = "openid offline_access storage.read:/store"
+                      " storage.create:/store/user/" + sub +
+                      " storage.modify:/store/user/" + sub + "/out";
+  char *err = nullptr, *value = nullptr;
+
+  if (scitoken_set_claim_string(token.get(), "iss", issuer, &err) ||
+      scitoken_set_claim_string(token.get(), "aud", audience, &err) ||
+      scitoken_set_claim_string(token.get(), "sub", sub.c_str(), &err) ||
+      scitoken_set_claim_string(token.get(), "scope", scope.c_str(), &err) ||
+      scitoken_set_claim_string(token.get(), "client_id", "bench-client", &err)) {
+    fprintf(stderr, "Unable to set token claims: %s\n", err);
+    free(err);
+    return "";
+  }
+  scitoken_set_lifetime(token.get(), 3600);
+  scitoken_set_serialize_profile(token.get(), SciTokenProfile::WLCG_1_0);
+
+  if (scitoken_serialize(token.get(), &value, &err)) {
+    fprintf(stderr, "Unable to serialize token: %s\n", err);
+    free(err);
+    return "";
+  }
+  std::string result(value);
+  free(value);
+  return result;
+}
+
+struct Request
+{
+  Access_Operation oper;
+  std::string      path;
+};
+
+// The mix of operations a user's jobs do: mostly reads of the VO area, then
+// stat, writes, and directory creation in the user's own area.
+Request MakeRequest(int user, std::mt19937 &rng)
+{
+  std::string home = "/store/user/user" + std::to_string(user);
+  int n = rng() % 10, k = rng() % 1000;
+
+  if (n < 5)
+    return {AOP_Read, "/store/data/run" + std::to_string(k % 50) + "/file" +
+                      std::to_string(k) + ".root"};
+  if (n < 7)
+    return {AOP_Stat, home};
+  if (n < 9)
+    return {AOP_Update, home + "/out/file" + std::to_string(k) + ".root"};
+  return {AOP_Mkdir, home + "/dir" + std::to_string(k)};
+}
+
+double Seconds(std::chrono::steady_clock::time_point t0)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+         .count();
+}
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <issuerdir> [<threads> [<tokens> [<requests>]]]\n",
+            argv[0]);
+    return 1;
+  }
+  const std::string dir = argv[1];
+  int nThreads  = argc > 2 ? atoi(argv[2]) : 8;
+  int nTokens   = argc > 3 ? atoi(argv[3]) : 1000;
+  int nRequests = argc > 4 ? atoi(argv[4]) : 200000;
+  if (nThreads < 1 || nTokens < 1 || nRequests < 1) {
+    fprintf(stderr, "The counts must be positive\n");
+    return 1;
+  }
+
+  // Keep the key cache in the issuer directory rather than the user's home
+  std::string pubkey, privkey;
+  if (!ReadFile(dir + "/issuer_pub_1.pem", pubkey) ||
+      !ReadFile(dir + "/issuer_key_1.pem", privkey))
+    return 2;
+  setenv("XDG_CACHE_HOME", dir.c_str(), 1);
+  char *err = nullptr;
+
+  using KeyPtr = std::unique_ptr<void, decltype(&scitoken_key_destroy)>;
+  KeyPtr key(scitoken_key_create("test_1", "ES256", pubkey.c_str(),
+                                 privkey.c_str(), &err),
+             scitoken_key_destroy);
+  if (!key) {
+    fprintf(stderr, "Unable to load the issuer's key: %s\n", err);
+    return 2;
+  }
+
+  std::vector<std::string> tokens(nTokens);
+  for (int i = 0; i < nTokens; i++)
+    if ((tokens[i] = MakeToken(key.get(), i)).empty()) return 3;
+  printf("token size: %zu bytes\n", tokens[0].size());
+
+  // Load the plugin the way the server would, with a configuration trusting
+  // our issuer, whose keys are read from a file, for the whole namespace.
+  std::string cfg = dir + "/bench-scitokens.cfg", xcfg = dir + "/bench-xrootd.cfg";
+  if (!WriteFile(cfg, std::string("[Global]\naudience = ") + audience +
+                      "\n\n[Issuer bench]\nissuer = " + issuer +
+                      "\nbase_path = /\njwks_file = " + dir +
+                      "/issuer_1.jwks\n") ||
+      !WriteFile(xcfg, ""))
+    return 4;
+  setenv("XRDCONFIGFN", xcfg.c_str(), 1);
+
+  void *lib = dlopen(XRDSCITOKENS_PLUGIN, RTLD_NOW);
+  if (!lib) {
+    fprintf(stderr, "Unable to load %s: %s\n", XRDSCITOKENS_PLUGIN, dlerror());
+    return 4;
+  }
+  typedef XrdAccAuthorize *(*ObjFunc)(XrdSysLogger *, const char *, const char *);
+  auto getObj = reinterpret_cast<ObjFunc>(dlsym(lib, "XrdAccAuthorizeObject"));
+  XrdSysLogger logger;
+  std::string parms = "config=" + cfg;
+  XrdAccAuthorize *auth = getObj ? getObj(&logger, xcfg.c_str(), parms.c_str())
+                                 : nullptr;
+  if (!auth) {
+    fprintf(stderr, "Unable to initialize the SciTokens plugin\n");
+    return 4;
+  }
+
+  // Each thread has its own entity and environments as Access() updates them
+  std::vector<std::unique_ptr<XrdSecEntity>> entities;
+  std::vector<std::vector<std::unique_ptr<XrdOucEnv>>> envSets(nThreads);
+  for (int t = 0; t < nThreads; t++) {
+    entities.emplace_back(new XrdSecEntity("https"));
+    for (auto &tok : tokens)
+      envSets[t].emplace_back(new XrdOucEnv(("authz=Bearer%20" + tok).c_str()));
+  }
+
+  std::atomic<long> denied(0);
+  auto run = [&](bool parse) {
+    std::vector<std::thread> thr;
+    for (int t = 0; t < nThreads; t++)
+      thr.emplace_back([&, t]() {
+        XrdSecEntity &entity = *entities[t];
+        auto &envs = envSets[t];
+        std::mt19937 rng(t);
+        long bad = 0;
+        int first = (int)((long)nTokens * t / nThreads);
+        int count = (parse ? (int)((long)nTokens * (t + 1) / nThreads) - first
+                           : nRequests);
+        for (int i = 0; i < count; i++) {
+          int user = (parse ? first + i : static_cast<int>(rng() % nTokens));
+          Request req = MakeRequest(user, rng);
+          if (!auth->Access(&entity, req.path.c_str(), req.oper,
+                            envs[user].get()))
+            bad++;
+        }
+        denied += bad;
+      });
+    for (auto &th : thr) th.join();
+  };
+
+  auto t0 = std::chrono::steady_clock::now();
+  run(true);
+  double secs = Seconds(t0);
+  printf("first use:  %10.0f Access()/s (%d tokens parsed by %d threads)\n",
+         (double)nTokens / secs, nTokens, nThreads);
+
+  t0 = std::chrono::steady_clock::now();
+  run(false);
+  secs = Seconds(t0);
+  printf("cached:     %10.0f Access()/s (%d threads)\n",
+         (double)nRequests * nThreads / secs, nThreads);
+
+  if (denied) {
+    fprintf(stderr, "%ld requests were denied\n", denied.load());
+    return 5;
+  }
+  return 0;
+}